@@ -0,0 +1,545 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "aot.h"
+
+#include <locale.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../expressions/evaluation.h"
+#include "../expressions/lambda.h"
+#include "../expressions/native.h"
+#include "../parser/parser.h"
+#include "../scanner/scanner.h"
+#include "../types/procedure.h"
+#include "../utils/port.h"
+#include "../utils/string.h"
+
+struct aot_emitter {
+  /// Code of the function that is being translated
+  FILE *code;
+  char *code_buffer;
+  size_t code_size;
+  size_t indent;
+  size_t temps;
+  /// Number of stack frames created in the current function
+  size_t frames;
+  char frame_name[32];
+  /// C expressions that initialize the constants
+  listptr constants;
+  listptr builtins;
+  /// Quoted source code of the expressions that are interpreted
+  listptr fallbacks;
+  /// Quoted source code of the lambdas and the names of their functions
+  listptr lambdas;
+  /// Translated functions
+  listptr functions;
+};
+
+/* Generated code */
+
+static void write_indent(aot_emitter_ptr em) {
+  for (size_t i = 0; i < em->indent; ++i) {
+    fputs("  ", em->code);
+  }
+}
+
+static void write_line(aot_emitter_ptr em, const char *fmt, va_list args) {
+  write_indent(em);
+  vfprintf(em->code, fmt, args);
+  fputc('\n', em->code);
+}
+
+void aot_line(aot_emitter_ptr em, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  write_line(em, fmt, args);
+  va_end(args);
+}
+
+void aot_open(aot_emitter_ptr em, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  write_line(em, fmt, args);
+  va_end(args);
+  ++em->indent;
+}
+
+void aot_reopen(aot_emitter_ptr em, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  --em->indent;
+  write_line(em, fmt, args);
+  va_end(args);
+  ++em->indent;
+}
+
+void aot_close(aot_emitter_ptr em, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  --em->indent;
+  write_line(em, fmt, args);
+  va_end(args);
+}
+
+char *aot_quote(const char *str) {
+  size_t length = strlen(str);
+  char *result = malloc(4 * length + 3);
+  char *p = result;
+
+  *p++ = '"';
+  for (const char *c = str; *c; ++c) {
+    switch (*c) {
+      case '"':
+      case '\\':
+      case '?':
+        *p++ = '\\';
+        *p++ = *c;
+        break;
+      case '\n':
+        *p++ = '\\';
+        *p++ = 'n';
+        break;
+      case '\t':
+        *p++ = '\\';
+        *p++ = 't';
+        break;
+      default:
+        if ((unsigned char)*c < ' ' || (unsigned char)*c == 127) {
+          p += sprintf(p, "\\%03o", (unsigned char)*c);
+        } else {
+          *p++ = *c;
+        }
+    }
+  }
+  *p++ = '"';
+  *p = '\0';
+
+  return result;
+}
+
+size_t aot_unique(aot_emitter_ptr em) {
+  return em->temps++;
+}
+
+size_t aot_temp(aot_emitter_ptr em) {
+  size_t temp = aot_unique(em);
+  aot_line(em, "objectptr t%zu;", temp);
+  return temp;
+}
+
+const char *aot_frame(aot_emitter_ptr em) {
+  if (em->frames == 0) {
+    return "sf";
+  }
+
+  snprintf(em->frame_name, sizeof em->frame_name, "f%zu", em->frames);
+  return em->frame_name;
+}
+
+void aot_enter_frame(aot_emitter_ptr em) {
+  char *previous = strdup(aot_frame(em));
+  ++em->frames;
+  aot_open(em, "{");
+  aot_line(em, "stack_frame_ptr %s = new_stack_frame(%s);", aot_frame(em),
+           previous);
+  free(previous);
+}
+
+void aot_leave_frame(aot_emitter_ptr em) {
+  aot_line(em, "delete_stack_frame(%s);", aot_frame(em));
+  aot_close(em, "}");
+  --em->frames;
+}
+
+void aot_open_unless_error(aot_emitter_ptr em, size_t value, size_t result) {
+  aot_open(em, "if (is_error(t%zu)) {", value);
+  aot_line(em, "t%zu = t%zu;", result, value);
+  aot_reopen(em, "} else {");
+}
+
+void aot_open_condition(aot_emitter_ptr em, size_t condition, size_t result,
+                        const char *message) {
+  char *quoted = aot_quote(message);
+  aot_open(em, "if (is_error(t%zu)) {", condition);
+  aot_line(em, "t%zu = t%zu;", result, condition);
+  aot_reopen(em, "} else if (!is_boolean(t%zu)) {", condition);
+  aot_line(em, "delete_object(t%zu);", condition);
+  aot_line(em, "t%zu = make_error(%s);", result, quoted);
+  aot_reopen(em, "} else if (aot_truth(t%zu)) {", condition);
+  free(quoted);
+}
+
+/* Tables of the generated program */
+
+static size_t add_fallback(aot_emitter_ptr em, const char *source) {
+  list_add(em->fallbacks, aot_quote(source));
+  return list_size(em->fallbacks) - 1;
+}
+
+char *aot_constant(aot_emitter_ptr em, objectptr value) {
+  char *init = NULL;
+  if (is_integer(value)) {
+    init = format("make_integer(%ldL)", int_value(value));
+  } else if (is_real(value) && isfinite(real_value(value))) {
+    init = format("make_real(%a)", real_value(value));
+  } else if (is_string(value)) {
+    char *quoted = aot_quote(string_value(value));
+    init = format("make_string(%s)", quoted);
+    free(quoted);
+  } else if (is_boolean(value)) {
+    init = format("make_boolean(%s)", boolean_value(value) ? "true" : "false");
+  } else if (is_null(value)) {
+    init = format("make_null()");
+  } else if (is_void(value)) {
+    init = format("make_void()");
+  } else {
+    /* Other values are constructed from their string representations */
+    char *source = object_tostring(value);
+    init = format("interpret_expr(fallbacks[%zu], sf)", add_fallback(em, source));
+    free(source);
+  }
+
+  list_add(em->constants, init);
+  return format("clone_object(constants[%zu])", list_size(em->constants) - 1);
+}
+
+size_t aot_builtin(aot_emitter_ptr em, const builtin_function *func) {
+  for (size_t i = 0; i < list_size(em->builtins); ++i) {
+    if (list_get(em->builtins, i) == func) {
+      return i;
+    }
+  }
+
+  list_add(em->builtins, (void *)func);
+  return list_size(em->builtins) - 1;
+}
+
+/* Starts translating a new function. The state of the function that
+ * was being translated is saved in saved. */
+static void begin_function(aot_emitter_ptr em, aot_emitter_ptr saved,
+                           const char *name) {
+  *saved = *em;
+  em->code = open_memstream(&em->code_buffer, &em->code_size);
+  em->indent = 0;
+  em->frames = 0;
+  aot_open(em, "static objectptr %s(stack_frame_ptr sf) {", name);
+}
+
+/* Finishes the function that returns the given temporary */
+static void end_function(aot_emitter_ptr em, aot_emitter_ptr saved,
+                         size_t result) {
+  aot_line(em, "return t%zu;", result);
+  aot_close(em, "}");
+  fclose(em->code);
+  list_add(em->functions, em->code_buffer);
+
+  em->code = saved->code;
+  em->code_buffer = saved->code_buffer;
+  em->code_size = saved->code_size;
+  em->indent = saved->indent;
+  em->frames = saved->frames;
+}
+
+size_t aot_lambda(aot_emitter_ptr em, exprptr lambda, exprptr body) {
+  size_t index = list_size(em->lambdas);
+  char *source = expr_tostring(lambda);
+  list_add(em->lambdas, aot_quote(source));
+  free(source);
+
+  char *name = format("lambda_%zu", index);
+  struct aot_emitter saved;
+  begin_function(em, &saved, name);
+  size_t result = aot_temp(em);
+  aot_emit_expr(em, body, result);
+  end_function(em, &saved, result);
+  free(name);
+
+  return index;
+}
+
+void aot_emit_expr(aot_emitter_ptr em, exprptr e, size_t result) {
+  if (!emit_expr(e, em, result)) {
+    char *source = expr_tostring(e);
+    aot_line(em, "t%zu = interpret_expr(fallbacks[%zu], %s);", result,
+             add_fallback(em, source), aot_frame(em));
+    free(source);
+  }
+}
+
+/* Variables that are defined while the program is parsed */
+
+typedef struct {
+  aot_emitter_ptr em;
+  /// Code that defines the variables
+  listptr definitions;
+} global_definitions;
+
+static void emit_global_definition(const char *name, objectptr value,
+                                   void *context) {
+  global_definitions *gd = context;
+
+  /* Macros are only used by the parser, and builtin functions are
+   * defined by the generated program itself */
+  if (name[0] == '#' || is_builtin_name(name)) {
+    return;
+  }
+
+  char *quoted = aot_quote(name);
+  if (is_procedure(value) && is_lambda_expr(procedure_get_lambda(value))) {
+    exprptr lambda = procedure_get_lambda(value);
+    if (lambda_expr_has_captures(lambda)) {
+      list_add(gd->definitions,
+               format("/* %s captures variables and is not defined */", name));
+    } else {
+      size_t index = aot_lambda(gd->em, lambda, lambda_expr_get_body(lambda));
+      list_add(gd->definitions,
+               format("aot_define(sf, %s, interpret_expr(lambdas[%zu], sf));",
+                      quoted, index));
+    }
+  } else {
+    char *constant = aot_constant(gd->em, value);
+    list_add(gd->definitions,
+             format("aot_define(sf, %s, %s);", quoted, constant));
+    free(constant);
+  }
+  free(quoted);
+}
+
+/* Program */
+
+static void write_table(FILE *out, const char *type, const char *name,
+                        size_t size) {
+  if (size > 0) {
+    fprintf(out, "static %s%s[%zu];\n", type, name, size);
+  }
+}
+
+static void write_cleanup(FILE *out, const char *function, const char *name,
+                          size_t size) {
+  if (size > 0) {
+    fprintf(out, "  for (size_t i = 0; i < %zu; ++i) {\n", size);
+    fprintf(out, "    %s(%s[i]);\n", function, name);
+    fprintf(out, "  }\n");
+  }
+}
+
+static void delete_strings(listptr lst) {
+  for (size_t i = 0; i < list_size(lst); ++i) {
+    free(list_get(lst, i));
+  }
+  delete_list(lst);
+}
+
+void aot_emit_program(FILE *out, listptr parse_tree, stack_frame_ptr sf) {
+  struct aot_emitter emitter = {
+    .code = NULL,
+    .indent = 0,
+    .temps = 0,
+    .frames = 0,
+    .constants = new_list(),
+    .builtins = new_list(),
+    .fallbacks = new_list(),
+    .lambdas = new_list(),
+    .functions = new_list()
+  };
+  aot_emitter_ptr em = &emitter;
+
+  global_definitions gd = {em, new_list()};
+  stack_frame_foreach_local(sf, emit_global_definition, &gd);
+
+  size_t nexpressions = list_size(parse_tree);
+  for (size_t i = 0; i < nexpressions; ++i) {
+    char *name = format("expression_%zu", i);
+    struct aot_emitter saved;
+    begin_function(em, &saved, name);
+    size_t result = aot_temp(em);
+    aot_emit_expr(em, list_get(parse_tree, i), result);
+    end_function(em, &saved, result);
+    free(name);
+  }
+
+  size_t nconstants = list_size(em->constants);
+  size_t nbuiltins = list_size(em->builtins);
+  size_t nfallbacks = list_size(em->fallbacks);
+  size_t nlambdas = list_size(em->lambdas);
+
+  fprintf(out, "/* Generated by tlisp --emit-c */\n\n");
+  fprintf(out, "#include \"aot/aot.h\"\n\n");
+  write_table(out, "objectptr ", "constants", nconstants);
+  write_table(out, "const builtin_function *", "builtins", nbuiltins);
+  write_table(out, "exprptr ", "fallbacks", nfallbacks);
+  write_table(out, "exprptr ", "lambdas", nlambdas);
+
+  for (size_t i = 0; i < list_size(em->functions); ++i) {
+    fprintf(out, "\n%s", (char *)list_get(em->functions, i));
+  }
+
+  fprintf(out, "\nstatic void initialize(stack_frame_ptr sf) {\n");
+  for (size_t i = 0; i < nfallbacks; ++i) {
+    fprintf(out, "  fallbacks[%zu] = aot_parse(%s, sf);\n", i,
+            (char *)list_get(em->fallbacks, i));
+  }
+  for (size_t i = 0; i < nlambdas; ++i) {
+    fprintf(out, "  lambdas[%zu] = aot_native_lambda(%s, lambda_%zu, sf);\n",
+            i, (char *)list_get(em->lambdas, i), i);
+  }
+  for (size_t i = 0; i < nconstants; ++i) {
+    fprintf(out, "  constants[%zu] = %s;\n", i,
+            (char *)list_get(em->constants, i));
+  }
+  for (size_t i = 0; i < nbuiltins; ++i) {
+    const builtin_function *func = list_get(em->builtins, i);
+    char *quoted = aot_quote(func->name);
+    fprintf(out, "  builtins[%zu] = find_builtin_function(%s);\n", i, quoted);
+    free(quoted);
+  }
+  for (size_t i = 0; i < list_size(gd.definitions); ++i) {
+    fprintf(out, "  %s\n", (char *)list_get(gd.definitions, i));
+  }
+  fprintf(out, "}\n");
+
+  fprintf(out, "\nstatic void finalize(void) {\n");
+  write_cleanup(out, "delete_object", "constants", nconstants);
+  write_cleanup(out, "delete_expr", "lambdas", nlambdas);
+  write_cleanup(out, "delete_expr", "fallbacks", nfallbacks);
+  fprintf(out, "}\n");
+
+  fprintf(out, "\nstatic const aot_expression program[] = {");
+  for (size_t i = 0; i < nexpressions; ++i) {
+    fprintf(out, "%s\n  expression_%zu", i > 0 ? "," : "", i);
+  }
+  fprintf(out, "%s};\n", nexpressions > 0 ? "\n" : "NULL");
+
+  fprintf(out, "\nint main(int argc, char **argv) {\n");
+  fprintf(out, "  return aot_main(argc, argv, initialize, finalize, program, "
+               "%zu);\n", nexpressions);
+  fprintf(out, "}\n");
+
+  delete_strings(em->constants);
+  delete_list(em->builtins);
+  delete_strings(em->fallbacks);
+  delete_strings(em->lambdas);
+  delete_strings(em->functions);
+  delete_strings(gd.definitions);
+}
+
+/* Runtime */
+
+exprptr aot_parse(const char *source, stack_frame_ptr sf) {
+  tokenstreamptr tokens = scanner(source);
+  listptr parse_tree = tokens ? parser(tokens, sf) : NULL;
+  delete_tokenstream(tokens);
+
+  if (!parse_tree || list_size(parse_tree) != 1) {
+    fprintf(stderr, "Cannot parse the expression %s\n", source);
+    exit(EXIT_FAILURE);
+  }
+
+  exprptr e = list_get(parse_tree, 0);
+  delete_list(parse_tree);
+  return e;
+}
+
+exprptr aot_native_lambda(const char *source, aot_expression function,
+                          stack_frame_ptr sf) {
+  exprptr lambda = aot_parse(source, sf);
+  char *body = expr_tostring(lambda_expr_get_body(lambda));
+  lambda_expr_set_body(lambda, new_native_expr(function, body));
+  free(body);
+  return lambda;
+}
+
+void aot_define(stack_frame_ptr sf, const char *name, objectptr value) {
+  stack_frame_set_global_variable(sf, name, value);
+  delete_object(value);
+}
+
+bool aot_truth(objectptr condition) {
+  bool value = boolean_value(condition);
+  delete_object(condition);
+  return value;
+}
+
+void aot_release(size_t nargs, objectptr *args) {
+  for (size_t i = 0; i < nargs; ++i) {
+    delete_object(args[i]);
+  }
+}
+
+objectptr aot_call_builtin(const builtin_function *func, size_t nargs,
+                           objectptr *args, stack_frame_ptr sf) {
+  objectptr result = interpret_builtin_call(func, sf, nargs, args);
+  aot_release(nargs, args);
+  return result;
+}
+
+objectptr aot_call(objectptr proc, size_t nargs, objectptr *args,
+                   stack_frame_ptr sf) {
+  objectptr result = proc;
+  if (!is_error(proc)) {
+    result = object_op_call(proc, nargs, args, sf);
+    delete_object(proc);
+  }
+
+  aot_release(nargs, args);
+  return result;
+}
+
+int aot_main(int argc, char **argv, void (*initialize)(stack_frame_ptr sf),
+             void (*finalize)(void), const aot_expression *program,
+             size_t program_size) {
+  setlocale(LC_ALL, "");
+  srand(time(0));
+
+  bool quiet = false;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-q") == 0) {
+      quiet = true;
+    } else {
+      fprintf(stderr, "Usage: %s [-q]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  stack_frame_ptr global_frame = new_stack_frame(NULL);
+  define_builtin_function_wrappers(global_frame);
+  initialize(global_frame);
+
+  /* Results are printed in the same way as the interpreter prints them */
+  objectptr result = make_void();
+  for (size_t i = 0; !is_error(result) && i < program_size; ++i) {
+    assign_object(&result, program[i](global_frame));
+
+    bool show_result = !quiet && !is_void(result);
+    if (!is_exit(result) && (is_error(result) || show_result)) {
+      object_print(result, standard_output());
+      port_putc(standard_output(), '\n');
+    }
+  }
+
+  delete_object(result);
+  delete_stack_frame(global_frame);
+  finalize();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file aot.h
+
+#ifndef THEORYLISP_AOT_AOT_H
+#define THEORYLISP_AOT_AOT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "../builtin/builtin.h"
+#include "../expressions/expression.h"
+#include "../interpreter/stack_frame.h"
+#include "../types/boolean.h"
+#include "../types/error.h"
+#include "../types/integer.h"
+#include "../types/null.h"
+#include "../types/object.h"
+#include "../types/real.h"
+#include "../types/string.h"
+#include "../types/void.h"
+#include "../utils/list.h"
+
+/**
+ * Ahead-of-time translation of programs to C.
+ *
+ * Each top-level expression and each lambda body becomes a C function
+ * that evaluates the expression with the same semantics as the
+ * interpreter: variables are looked up in the stack frames at runtime,
+ * calls to builtin functions go directly through the builtin function
+ * table, and errors are returned as error objects. Expressions that have
+ * no translation are parsed from their source code when the program
+ * starts and are evaluated by the interpreter.
+ *
+ * The generated program includes this header and is linked against
+ * libtlisp. It prints the result of each top-level expression like
+ * tlisp -x does, and the -q option silences the results.
+ */
+
+/**
+ * Translates the parse tree to a C program. Variables that were defined
+ * in the global stack frame sf while the program was parsed, such as
+ * the functions of included libraries, are defined again when the
+ * generated program starts.
+ */
+void aot_emit_program(FILE *out, listptr parse_tree, stack_frame_ptr sf);
+
+/* The following functions are used by the expressions while they
+ * translate themselves. Generated code is written one line at a time
+ * into the function that is being translated. Each value is stored in
+ * a temporary variable named t<number>. */
+
+/**
+ * Writes code that evaluates e and stores the result in the temporary
+ * result. Expressions that cannot be translated are interpreted.
+ */
+void aot_emit_expr(aot_emitter_ptr em, exprptr e, size_t result);
+
+/**
+ * Declares a new temporary variable and returns its number.
+ */
+size_t aot_temp(aot_emitter_ptr em);
+
+/**
+ * Returns a number that is not used in the name of any other variable.
+ */
+size_t aot_unique(aot_emitter_ptr em);
+
+/**
+ * Writes a line of code.
+ */
+void aot_line(aot_emitter_ptr em, const char *fmt, ...);
+
+/**
+ * Writes a line of code that opens a block.
+ */
+void aot_open(aot_emitter_ptr em, const char *fmt, ...);
+
+/**
+ * Writes a line of code that closes a block and opens another one,
+ * such as "} else {".
+ */
+void aot_reopen(aot_emitter_ptr em, const char *fmt, ...);
+
+/**
+ * Writes a line of code that closes a block.
+ */
+void aot_close(aot_emitter_ptr em, const char *fmt, ...);
+
+/**
+ * Returns a C string literal with the given contents. The result must
+ * be freed.
+ */
+char *aot_quote(const char *str);
+
+/**
+ * Returns the name of the C variable that holds the current stack frame.
+ */
+const char *aot_frame(aot_emitter_ptr em);
+
+/**
+ * Writes code that creates a new stack frame on top of the current one,
+ * and makes it the current stack frame.
+ */
+void aot_enter_frame(aot_emitter_ptr em);
+
+/**
+ * Writes code that deletes the current stack frame, and makes the
+ * previous one the current stack frame again.
+ */
+void aot_leave_frame(aot_emitter_ptr em);
+
+/**
+ * Writes an if statement that stores the error in the temporary value
+ * into the temporary result if value is an error. The else branch of the
+ * statement is left open.
+ */
+void aot_open_unless_error(aot_emitter_ptr em, size_t value, size_t result);
+
+/**
+ * Writes an if statement that checks the condition in the temporary
+ * condition like an if expression does. Errors are stored in the
+ * temporary result, and a condition that is not a boolean stores an error
+ * with the given message. The branch that is taken when the condition is
+ * true is left open.
+ */
+void aot_open_condition(aot_emitter_ptr em, size_t condition, size_t result,
+                        const char *message);
+
+/**
+ * Returns the C expression that evaluates to a new reference to the
+ * given constant.
+ */
+char *aot_constant(aot_emitter_ptr em, objectptr value);
+
+/**
+ * Returns the index of the builtin function in the builtin table of the
+ * generated program.
+ */
+size_t aot_builtin(aot_emitter_ptr em, const builtin_function *func);
+
+/**
+ * Translates the body of the lambda expression into a C function, and
+ * returns the index of the lambda in the lambda table of the generated
+ * program.
+ */
+size_t aot_lambda(aot_emitter_ptr em, exprptr lambda, exprptr body);
+
+/* The following functions are called by generated programs. */
+
+typedef objectptr (*aot_expression)(stack_frame_ptr sf);
+
+/**
+ * Parses an expression from its source code.
+ */
+exprptr aot_parse(const char *source, stack_frame_ptr sf);
+
+/**
+ * Parses a lambda expression from its source code, and replaces its body
+ * with a native expression that calls function.
+ */
+exprptr aot_native_lambda(const char *source, aot_expression function,
+                          stack_frame_ptr sf);
+
+/**
+ * Defines a global variable and deletes the value.
+ */
+void aot_define(stack_frame_ptr sf, const char *name, objectptr value);
+
+/**
+ * Returns the value of a condition that is known to be a boolean,
+ * and deletes the condition.
+ */
+bool aot_truth(objectptr condition);
+
+/**
+ * Deletes the arguments that were evaluated before an error occured.
+ */
+void aot_release(size_t nargs, objectptr *args);
+
+/**
+ * Calls a builtin function and deletes the arguments.
+ */
+objectptr aot_call_builtin(const builtin_function *func, size_t nargs,
+                           objectptr *args, stack_frame_ptr sf);
+
+/**
+ * Calls a procedure and deletes the procedure and the arguments.
+ */
+objectptr aot_call(objectptr proc, size_t nargs, objectptr *args,
+                   stack_frame_ptr sf);
+
+/**
+ * Runs a translated program. initialize is called with the global stack
+ * frame before the top-level expressions are evaluated, and finalize is
+ * called after them. Returns the exit status of the program.
+ */
+int aot_main(int argc, char **argv, void (*initialize)(stack_frame_ptr sf),
+             void (*finalize)(void), const aot_expression *program,
+             size_t program_size);
+
+#endif
@@ -31,11 +31,17 @@
 #include "../types/boolean.h"
 #include "../types/integer.h"
 #include "../types/error.h"
+#include "../types/mapped_tape.h"
 #include "../expressions/lambda.h"
 
 typedef struct tape {
   size_t head;
+  /// Cells of the tape. For a mapped tape, only the visited cells.
   listptr data;
+  /// Mapped tape that the unvisited cells are read from, or NULL
+  objectptr source;
+  /// Position of the next unvisited symbol in the source
+  size_t position;
 } tape_t;
 
 static void destroy_head_operation(size_t arity, head_op_t *op) {
@@ -91,6 +97,9 @@ static void delete_tape_list(listptr lst) {
   for (size_t i = 0; i < list_size(lst); ++i) {
     tape_t *tp = list_get(lst, i);
     delete_object_list(tp->data);
+    if (tp->source) {
+      delete_object(tp->source);
+    }
     free(tp);
   }
 
@@ -120,7 +129,7 @@ static objectptr check_arguments(size_t arity, size_t nargs, objectptr *args) {
     }
     
     objectptr second = pair_second(tape_obj);
-    if (!is_pair(second)) {
+    if (!is_pair(second) && !is_mapped_tape(second)) {
       return make_error("Tape contents is not a list");
     }
   }
@@ -143,7 +152,13 @@ static objectptr get_tapes(listptr output, size_t arity, size_t nargs, objectptr
     objectptr contents_obj = pair_second(tape_obj);
 
     listptr contents = new_list();
-    if (!cons_list_to_internal_list(contents_obj, contents)) {
+    objectptr source = NULL;
+    size_t position = 0;
+    if (is_mapped_tape(contents_obj)) {
+      mapped_tape_get_cells(contents_obj, contents);
+      source = clone_object(contents_obj);
+      position = mapped_tape_position(contents_obj);
+    } else if (!cons_list_to_internal_list(contents_obj, contents)) {
       delete_object_list(contents);
       return make_error("Given tape is not in proper list form");
     }
@@ -151,12 +166,17 @@ static objectptr get_tapes(listptr output, size_t arity, size_t nargs, objectptr
     tape_t *tp = malloc(sizeof *tp);
     tp->head = int_value(position_obj);
     tp->data = contents;
+    tp->source = source;
+    tp->position = position;
     list_add(output, tp);
   }
 
   return make_void();
 }
 
+/* Returns the symbols under the tape heads. The symbols are borrowed
+ * from the tapes, so they must not be deleted, and a symbol that is
+ * overwritten must be kept until the array is no longer used. */
 static objectptr *make_args_array(listptr tapes) {
   size_t ntapes = list_size(tapes);
   
@@ -249,8 +269,15 @@ static void run_transition_output(transition_t *tr, objectptr *args_array,
   }
 }
 
+/* Applies the head operations. The symbols that are overwritten are
+ * stored in replaced, and NULL is stored for the other tapes. */
 static void apply_head_operations(size_t ntapes, listptr tapes, 
-                                  head_op_t *head_operations, stack_frame_ptr sf) {
+                                  head_op_t *head_operations, objectptr *replaced,
+                                  stack_frame_ptr sf) {
+  for (size_t j = 0; j < ntapes; ++j) {
+    replaced[j] = NULL;
+  }
+
   for (size_t j = 0; j < ntapes; ++j) {
     tape_t *tp = list_get(tapes, j);
     if (tp->head == 0) {
@@ -267,14 +294,16 @@ static void apply_head_operations(size_t ntapes, listptr tapes,
         break;
       case HEAD_OP_MOVE_RIGHT:
         if (++tp->head >= list_size(tp->data)) {
-          list_add(tp->data, make_null());
+          /* Cells of a mapped tape are read when they are first visited */
+          objectptr symbol = tp->source ?
+              mapped_tape_next_symbol(tp->source, &tp->position) : make_null();
+          list_add(tp->data, symbol);
         }
         break;
       case HEAD_OP_WRITE:
         {
           objectptr new_value = interpret_expr(head_op->write_value, sf);
-          objectptr old_value = list_set(tp->data, tp->head, new_value);
-          delete_object(old_value);
+          replaced[j] = list_set(tp->data, tp->head, new_value);
         }
         break;
       case HEAD_NOP:
@@ -311,8 +340,16 @@ static objectptr run_normal_state(automaton_t *self, listptr tapes, objectptr *a
     bool satisfied = boolean_value(condition_result);
     delete_object(condition_result);
     if (satisfied) {
-      apply_head_operations(self->number_of_tapes, tapes, tr->head_operations, sf);
+      /* The overwritten symbols are still used by the transition output */
+      objectptr replaced[self->number_of_tapes + 1];
+      apply_head_operations(self->number_of_tapes, tapes, tr->head_operations,
+                            replaced, sf);
       run_transition_output(tr, args, self->number_of_tapes, sf);
+      for (size_t j = 0; j < self->number_of_tapes; ++j) {
+        if (replaced[j]) {
+          delete_object(replaced[j]);
+        }
+      }
 
       switch(tr->action) {
         case ACT_HALT:
@@ -346,7 +383,14 @@ static objectptr construct_results(objectptr exitcode, listptr tapes) {
   objectptr tape_result = make_null();
   for (size_t i = 0; i < list_size(tapes); ++i) {
     tape_t *tp = list_get(tapes, i);
-    objectptr tape_contents = internal_list_to_cons_list(tp->data);
+    objectptr tape_contents;
+    if (tp->source) {
+      /* The unvisited cells are still read from the same file */
+      tape_contents = mapped_tape_with_cells(tp->source, tp->data, tp->position);
+      tp->data = new_list();
+    } else {
+      tape_contents = internal_list_to_cons_list(tp->data);
+    }
     objectptr head_position = make_integer((long)tp->head);
     objectptr tape_obj = make_pair(head_position, tape_contents);
     delete_object(tape_contents);
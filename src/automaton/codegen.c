@@ -0,0 +1,638 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "codegen.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../aot/aot.h"
+#include "../expressions/automaton.h"
+#include "../expressions/data.h"
+#include "../expressions/identifier.h"
+#include "../expressions/polish.h"
+#include "../types/boolean.h"
+#include "../types/error.h"
+#include "../types/null.h"
+#include "../types/procedure.h"
+#include "../types/string.h"
+#include "../types/void.h"
+#include "../utils/list.h"
+#include "automaton.h"
+
+/* Limits the number of generated functions when base machines
+ * that capture variables use each other recursively */
+#define MAX_MACHINES 256
+
+#define NO_MACHINE ((size_t)(-1))
+
+/* Symbol index of symbols that do not appear in the automaton */
+#define OTHER_SYMBOL 0
+
+/* Symbol index of the blank symbol (null) */
+#define BLANK_SYMBOL 2
+
+typedef enum {
+  COND_ALWAYS,
+  COND_NEVER,
+  COND_EQUAL,
+  COND_NOT_EQUAL
+} condition_kind;
+
+typedef struct {
+  condition_kind kind;
+  size_t symbol;
+} condition_t;
+
+typedef struct {
+  size_t base_machine;
+  condition_t *conditions;
+  size_t *writes;
+} machine_state_t;
+
+typedef struct {
+  exprptr lambda;
+  automaton_t *aut;
+  machine_state_t *states;
+} machine_t;
+
+typedef struct {
+  listptr machines;
+  listptr symbols;
+} codegen_t;
+
+static void delete_machine(machine_t *m) {
+  for (size_t i = 0; i < m->aut->number_of_states; ++i) {
+    free(m->states[i].conditions);
+    free(m->states[i].writes);
+  }
+  free(m->states);
+  free(m);
+}
+
+static objectptr untranslatable(const char *what, exprptr e) {
+  char *str = expr_tostring(e);
+  objectptr err = make_error("%s %s cannot be translated to C", what, str);
+  free(str);
+  return err;
+}
+
+/**
+ * Evaluates a literal or a variable and returns the index of the
+ * resulting symbol, adding the symbol to the alphabet if it is new.
+ */
+static objectptr resolve_symbol(codegen_t *cg, exprptr e, stack_frame_ptr sf,
+                                size_t *symbol) {
+  if (!is_data_expr(e) && !is_identifier_expr(e)) {
+    return untranslatable("Symbol", e);
+  }
+
+  objectptr value = interpret_expr(e, sf);
+  if (is_error(value)) {
+    return value;
+  }
+
+  if (is_procedure(value)) {
+    delete_object(value);
+    return untranslatable("Symbol", e);
+  }
+
+  for (size_t i = 0; i < list_size(cg->symbols); ++i) {
+    if (object_equals(list_get(cg->symbols, i), value)) {
+      delete_object(value);
+      *symbol = i + 1;
+      return make_void();
+    }
+  }
+
+  list_add(cg->symbols, value);
+  *symbol = list_size(cg->symbols);
+  return make_void();
+}
+
+static objectptr resolve_condition(codegen_t *cg, exprptr e, size_t ntapes,
+                                   stack_frame_ptr sf, condition_t *cond) {
+  if (!is_pn_expr(e)) {
+    return untranslatable("Transition condition", e);
+  }
+
+  listptr body = pn_expr_get_body(e);
+
+  /* {#t}, {else} */
+  if (list_size(body) == 1) {
+    exprptr value_expr = list_get(body, 0);
+    if (!is_data_expr(value_expr) && !is_identifier_expr(value_expr)) {
+      return untranslatable("Transition condition", e);
+    }
+
+    objectptr value = interpret_expr(value_expr, sf);
+    if (is_error(value)) {
+      return value;
+    }
+
+    bool is_constant = is_boolean(value);
+    if (is_constant) {
+      cond->kind = boolean_value(value) ? COND_ALWAYS : COND_NEVER;
+    }
+    delete_object(value);
+    return is_constant ? make_void() : untranslatable("Transition condition", e);
+  }
+
+  /* {= symbol}, {!= symbol} */
+  if (list_size(body) == 2 && ntapes != 0) {
+    exprptr op = list_get(body, 0);
+    if (is_identifier_expr(op)) {
+      const char *name = identifier_expr_get_name(op);
+      if (strcmp(name, "=") == 0 || strcmp(name, "!=") == 0) {
+        cond->kind = strcmp(name, "=") == 0 ? COND_EQUAL : COND_NOT_EQUAL;
+        return resolve_symbol(cg, list_get(body, 1), sf, &cond->symbol);
+      }
+    }
+  }
+
+  return untranslatable("Transition condition", e);
+}
+
+static objectptr add_machine(codegen_t *cg, objectptr procedure,
+                             stack_frame_ptr sf, size_t *index);
+
+static objectptr resolve_base_machine(codegen_t *cg, exprptr e, size_t ntapes,
+                                      stack_frame_ptr sf, size_t *index) {
+  objectptr base_machine = interpret_expr(e, sf);
+  if (is_error(base_machine)) {
+    return base_machine;
+  }
+
+  objectptr result = NULL;
+  if (!is_procedure(base_machine)) {
+    result = untranslatable("Base machine", e);
+  } else if (procedure_get_arity(base_machine) != ntapes) {
+    result = make_error("Number of tapes is %d, but the base machine requires %d tapes",
+                        ntapes, procedure_get_arity(base_machine));
+  } else {
+    result = add_machine(cg, base_machine, sf, index);
+  }
+
+  delete_object(base_machine);
+  return result;
+}
+
+static objectptr resolve_state(codegen_t *cg, automaton_t *aut, size_t i,
+                               stack_frame_ptr sf, machine_state_t *mst) {
+  state_t *st = &aut->states[i];
+  if (st->output) {
+    return untranslatable("State output", st->output);
+  }
+
+  if (st->base_machine) {
+    objectptr err = resolve_base_machine(cg, st->base_machine,
+                                         aut->number_of_tapes, sf, &mst->base_machine);
+    if (is_error(err)) {
+      return err;
+    }
+    delete_object(err);
+  }
+
+  for (size_t j = 0; j < st->number_of_transitions; ++j) {
+    transition_t *tr = &st->transitions[j];
+    if (tr->output) {
+      return untranslatable("Transition output", tr->output);
+    }
+
+    objectptr err = resolve_condition(cg, tr->condition, aut->number_of_tapes,
+                                      sf, &mst->conditions[j]);
+    if (is_error(err)) {
+      return err;
+    }
+    delete_object(err);
+
+    for (size_t k = 0; k < aut->number_of_tapes; ++k) {
+      head_op_t *op = &tr->head_operations[k];
+      if (op->op == HEAD_OP_WRITE) {
+        size_t *symbol = &mst->writes[j * aut->number_of_tapes + k];
+        err = resolve_symbol(cg, op->write_value, sf, symbol);
+        if (is_error(err)) {
+          return err;
+        }
+        delete_object(err);
+      }
+    }
+  }
+
+  return make_void();
+}
+
+/**
+ * Adds the automaton procedure and its base machines to the generated
+ * functions. Automata that do not capture variables are generated once.
+ */
+static objectptr add_machine(codegen_t *cg, objectptr procedure,
+                             stack_frame_ptr sf, size_t *index) {
+  exprptr lambda = procedure_get_lambda(procedure);
+  if (!is_automaton_expr(lambda)) {
+    char *str = object_tostring(procedure);
+    objectptr err = make_error("%s is not an automaton", str);
+    free(str);
+    return err;
+  }
+
+  automaton_t *aut = automaton_expr_get_compiled(lambda);
+  if (!aut || aut->number_of_states == 0) {
+    return make_error("Automaton has no states");
+  }
+
+  if (!automaton_expr_has_captures(lambda)) {
+    for (size_t i = 0; i < list_size(cg->machines); ++i) {
+      machine_t *other = list_get(cg->machines, i);
+      if (other->lambda == lambda) {
+        *index = i;
+        return make_void();
+      }
+    }
+  }
+
+  if (list_size(cg->machines) == MAX_MACHINES) {
+    return make_error("Automaton uses more than %d base machines", MAX_MACHINES);
+  }
+
+  machine_t *m = malloc(sizeof *m);
+  m->lambda = lambda;
+  m->aut = aut;
+  m->states = malloc(aut->number_of_states * sizeof *m->states);
+  for (size_t i = 0; i < aut->number_of_states; ++i) {
+    size_t ntransitions = aut->states[i].number_of_transitions;
+    m->states[i].base_machine = NO_MACHINE;
+    m->states[i].conditions = calloc(ntransitions, sizeof(condition_t));
+    m->states[i].writes = calloc(ntransitions * aut->number_of_tapes, sizeof(size_t));
+  }
+
+  *index = list_size(cg->machines);
+  list_add(cg->machines, m);
+
+  /* Conditions and writes are evaluated in the frame that
+   * automaton_run_internal would use */
+  stack_frame_ptr frame = procedure_new_frame(procedure, sf);
+  for (size_t i = 0; i < aut->number_of_states; ++i) {
+    objectptr err = resolve_state(cg, aut, i, frame, &m->states[i]);
+    if (is_error(err)) {
+      delete_stack_frame(frame);
+      return err;
+    }
+    delete_object(err);
+  }
+
+  delete_stack_frame(frame);
+  return make_void();
+}
+
+static bool condition_holds(condition_t *cond, size_t symbol) {
+  switch (cond->kind) {
+    case COND_ALWAYS:
+      return true;
+    case COND_NEVER:
+      return false;
+    case COND_EQUAL:
+      return symbol == cond->symbol;
+    case COND_NOT_EQUAL:
+      return symbol != cond->symbol;
+  }
+
+  return false;
+}
+
+static void indent(FILE *out, size_t level) {
+  fprintf(out, "%*s", (int)(2 * level), "");
+}
+
+/**
+ * Emits the head operations of a transition. The left end check of
+ * apply_head_operations stops at the first tape whose head is on the
+ * left end symbol, so the operations on the remaining tapes are nested
+ * in the else branch.
+ */
+static void emit_head_operations(FILE *out, const char *name, machine_t *m,
+                                 size_t st, size_t tr, size_t k, size_t level) {
+  size_t ntapes = m->aut->number_of_tapes;
+  if (k == ntapes) {
+    return;
+  }
+
+  head_op_t *op = &m->aut->states[st].transitions[tr].head_operations[k];
+  indent(out, level);
+  fprintf(out, "if (tapes[%zu].head == 0) {\n", k);
+  indent(out, level + 1);
+  fprintf(out, "tapes[%zu].head = 1;\n", k);
+  indent(out, level);
+
+  if (op->op == HEAD_NOP && k + 1 == ntapes) {
+    fprintf(out, "}\n");
+    return;
+  }
+
+  fprintf(out, "} else {\n");
+  switch (op->op) {
+    case HEAD_OP_MOVE_LEFT:
+      indent(out, level + 1);
+      fprintf(out, "--tapes[%zu].head;\n", k);
+      break;
+    case HEAD_OP_MOVE_RIGHT:
+      indent(out, level + 1);
+      fprintf(out, "if (++tapes[%zu].head >= tapes[%zu].length && !%s_grow(&tapes[%zu])) {\n",
+              k, k, name, k);
+      indent(out, level + 2);
+      fprintf(out, "return %s_OUT_OF_MEMORY;\n", name);
+      indent(out, level + 1);
+      fprintf(out, "}\n");
+      break;
+    case HEAD_OP_WRITE:
+      indent(out, level + 1);
+      fprintf(out, "tapes[%zu].symbols[tapes[%zu].head] = %zu;\n", k, k,
+              m->states[st].writes[tr * ntapes + k]);
+      break;
+    case HEAD_NOP:
+      break;
+  }
+
+  emit_head_operations(out, name, m, st, tr, k + 1, level + 1);
+  indent(out, level);
+  fprintf(out, "}\n");
+}
+
+static void emit_transition(FILE *out, const char *name, machine_t *m,
+                            size_t st, size_t tr) {
+  transition_t *t = &m->aut->states[st].transitions[tr];
+  fprintf(out, "          case %zu:\n", tr);
+  emit_head_operations(out, name, m, st, tr, 0, 6);
+
+  switch (t->action) {
+    case ACT_HALT:
+      fprintf(out, "            return %s_HALT;\n", name);
+      break;
+    case ACT_ACCEPT:
+      fprintf(out, "            return %s_ACCEPT;\n", name);
+      break;
+    case ACT_REJECT:
+      fprintf(out, "            return %s_REJECT;\n", name);
+      break;
+    case ACT_CONTINUE:
+      fprintf(out, "            state = %zu;\n", t->next_state_index);
+      fprintf(out, "            break;\n");
+      break;
+  }
+}
+
+static void emit_state(FILE *out, const char *name, machine_t *m, size_t st) {
+  automaton_t *aut = m->aut;
+  state_t *s = &aut->states[st];
+  machine_state_t *mst = &m->states[st];
+
+  fprintf(out, "      case %zu: /* %s */\n", st,
+          automaton_expr_get_state_name(m->lambda, st));
+
+  if (mst->base_machine != NO_MACHINE) {
+    fprintf(out, "        if ((code = %s_m%zu(tapes)) != %s_HALT) {\n",
+            name, mst->base_machine, name);
+    fprintf(out, "          return code;\n");
+    fprintf(out, "        }\n");
+  }
+
+  if (s->number_of_transitions == 0) {
+    if (st + 1 < aut->number_of_states) {
+      fprintf(out, "        state = %zu;\n", st + 1);
+      fprintf(out, "        break;\n");
+    } else {
+      fprintf(out, "        return %s_HALT;\n", name);
+    }
+    return;
+  }
+
+  if (aut->number_of_tapes) {
+    fprintf(out, "        switch (q%zu[%s_symbol(&tapes[0])]) {\n", st, name);
+  } else {
+    fprintf(out, "        switch (q%zu[0]) {\n", st);
+  }
+  for (size_t tr = 0; tr < s->number_of_transitions; ++tr) {
+    emit_transition(out, name, m, st, tr);
+  }
+  fprintf(out, "          default:\n");
+  fprintf(out, "            return %s_NO_TRANSITION;\n", name);
+  fprintf(out, "        }\n");
+  fprintf(out, "        break;\n");
+}
+
+/**
+ * Emits the transition table of a state. The table gives the first
+ * transition whose condition holds for each symbol under the first
+ * head, or -1 if there is none.
+ */
+static void emit_table(FILE *out, const char *name, machine_t *m,
+                       size_t st, size_t nsymbols) {
+  state_t *s = &m->aut->states[st];
+  fprintf(out, "  static const int q%zu[%s_SYMBOLS] = {", st, name);
+  for (size_t symbol = 0; symbol < nsymbols; ++symbol) {
+    long tr = -1;
+    for (size_t j = 0; j < s->number_of_transitions; ++j) {
+      if (condition_holds(&m->states[st].conditions[j], symbol)) {
+        tr = (long)j;
+        break;
+      }
+    }
+    fprintf(out, "%s%ld", symbol ? ", " : "", tr);
+  }
+  fprintf(out, "};\n");
+}
+
+static void emit_machine(FILE *out, const char *name, machine_t *m,
+                         size_t index, size_t nsymbols) {
+  automaton_t *aut = m->aut;
+  bool has_base_machines = false;
+  for (size_t i = 0; i < aut->number_of_states; ++i) {
+    has_base_machines |= m->states[i].base_machine != NO_MACHINE;
+  }
+
+  fprintf(out, "static int %s_m%zu(struct tlisp_tape *tapes) {\n", name, index);
+  for (size_t i = 0; i < aut->number_of_states; ++i) {
+    if (aut->states[i].number_of_transitions != 0) {
+      emit_table(out, name, m, i, nsymbols);
+    }
+  }
+  fprintf(out, "  size_t state = 0;\n");
+  if (has_base_machines) {
+    fprintf(out, "  int code;\n");
+  }
+  fprintf(out, "\n");
+  fprintf(out, "  for (;;) {\n");
+  fprintf(out, "    switch (state) {\n");
+  for (size_t i = 0; i < aut->number_of_states; ++i) {
+    emit_state(out, name, m, i);
+  }
+  fprintf(out, "    }\n");
+  fprintf(out, "  }\n");
+  fprintf(out, "}\n\n");
+}
+
+/* Emits the function that appends a blank symbol to a tape */
+static void emit_grow(FILE *out, const char *name) {
+  fprintf(out, "static int %s_grow(struct tlisp_tape *tp) {\n", name);
+  fprintf(out, "  if (tp->length >= tp->capacity) {\n");
+  fprintf(out, "    size_t capacity = tp->length ? 2 * tp->length : 16;\n");
+  fprintf(out, "    int *symbols = realloc(tp->symbols, capacity * sizeof *symbols);\n");
+  fprintf(out, "    if (!symbols) {\n");
+  fprintf(out, "      return 0;\n");
+  fprintf(out, "    }\n");
+  fprintf(out, "    tp->symbols = symbols;\n");
+  fprintf(out, "    tp->capacity = capacity;\n");
+  fprintf(out, "  }\n");
+  fprintf(out, "  tp->symbols[tp->length++] = %d;\n", BLANK_SYMBOL);
+  fprintf(out, "  return 1;\n");
+  fprintf(out, "}\n\n");
+}
+
+/* Emits the function that reads the symbol under the head */
+static void emit_read_symbol(FILE *out, const char *name) {
+  fprintf(out, "static int %s_symbol(const struct tlisp_tape *tp) {\n", name);
+  fprintf(out, "  int symbol = tp->symbols[tp->head];\n");
+  fprintf(out, "  return symbol > 0 && symbol < %s_SYMBOLS ? symbol : %d;\n",
+          name, OTHER_SYMBOL);
+  fprintf(out, "}\n\n");
+}
+
+static void emit_prelude(FILE *out, const char *name, codegen_t *cg) {
+  machine_t *main_machine = list_get(cg->machines, 0);
+  size_t nsymbols = list_size(cg->symbols) + 1;
+
+  fprintf(out, "/* Generated by Theory Lisp */\n\n");
+  fprintf(out, "#include <stdlib.h>\n\n");
+  fprintf(out, "#ifndef TLISP_TAPE\n");
+  fprintf(out, "#define TLISP_TAPE\n");
+  fprintf(out, "/* A tape of symbol indices. Moving past the end appends a blank\n");
+  fprintf(out, " * symbol, and the array is reallocated when it is full. */\n");
+  fprintf(out, "struct tlisp_tape {\n");
+  fprintf(out, "  int *symbols;\n");
+  fprintf(out, "  size_t head;\n");
+  fprintf(out, "  size_t length;\n");
+  fprintf(out, "  size_t capacity;\n");
+  fprintf(out, "};\n");
+  fprintf(out, "#endif\n\n");
+
+  fprintf(out, "enum {\n");
+  fprintf(out, "  %s_HALT = 0,\n", name);
+  fprintf(out, "  %s_ACCEPT = 1,\n", name);
+  fprintf(out, "  %s_REJECT = -1,\n", name);
+  fprintf(out, "  %s_NO_TRANSITION = -2,\n", name);
+  fprintf(out, "  %s_OUT_OF_MEMORY = -3\n", name);
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "#define %s_TAPES %zu\n", name, main_machine->aut->number_of_tapes);
+  fprintf(out, "#define %s_SYMBOLS %zu\n\n", name, nsymbols);
+
+  /* Symbol names */
+  fprintf(out, "/* Symbols that are not in this table have index %d */\n", OTHER_SYMBOL);
+  fprintf(out, "const char *const %s_symbols[%s_SYMBOLS] = {\n", name, name);
+  fprintf(out, "  NULL");
+  for (size_t i = 0; i < list_size(cg->symbols); ++i) {
+    char *str = object_tostring(list_get(cg->symbols, i));
+    char *quoted = aot_quote(str);
+    fprintf(out, ",\n  %s", quoted);
+    free(quoted);
+    free(str);
+  }
+  fprintf(out, "\n};\n\n");
+
+  bool moves_right = false;
+  bool reads_symbols = false;
+  for (size_t i = 0; i < list_size(cg->machines); ++i) {
+    automaton_t *aut = ((machine_t *)list_get(cg->machines, i))->aut;
+    for (size_t j = 0; j < aut->number_of_states; ++j) {
+      state_t *st = &aut->states[j];
+      reads_symbols |= st->number_of_transitions != 0 && aut->number_of_tapes != 0;
+      for (size_t k = 0; k < st->number_of_transitions; ++k) {
+        for (size_t l = 0; l < aut->number_of_tapes; ++l) {
+          moves_right |= st->transitions[k].head_operations[l].op == HEAD_OP_MOVE_RIGHT;
+        }
+      }
+    }
+  }
+
+  if (moves_right) {
+    emit_grow(out, name);
+  }
+
+  if (reads_symbols) {
+    emit_read_symbol(out, name);
+  }
+}
+
+objectptr automaton_to_c(objectptr procedure, const char *name,
+                         stack_frame_ptr sf) {
+  codegen_t cg;
+  cg.machines = new_list();
+  cg.symbols = new_list();
+
+  /* The left end symbol and the blank symbol of automata.tl
+   * always have indices 1 and 2 */
+  list_add(cg.symbols, make_void());
+  list_add(cg.symbols, make_null());
+
+  size_t index = 0;
+  objectptr result = add_machine(&cg, procedure, sf, &index);
+
+  if (!is_error(result)) {
+    delete_object(result);
+
+    char *code = NULL;
+    size_t code_size = 0;
+    FILE *out = open_memstream(&code, &code_size);
+    size_t nmachines = list_size(cg.machines);
+    size_t nsymbols = list_size(cg.symbols) + 1;
+
+    emit_prelude(out, name, &cg);
+
+    for (size_t i = 0; i < nmachines; ++i) {
+      fprintf(out, "static int %s_m%zu(struct tlisp_tape *tapes);\n", name, i);
+    }
+    fprintf(out, "\n");
+
+    for (size_t i = 0; i < nmachines; ++i) {
+      machine_t *m = list_get(cg.machines, i);
+      emit_machine(out, name, m, i, nsymbols);
+    }
+
+    fprintf(out, "int %s(struct tlisp_tape *tapes) {\n", name);
+    fprintf(out, "  return %s_m0(tapes);\n", name);
+    fprintf(out, "}\n");
+
+    fclose(out);
+    result = make_string(code);
+    free(code);
+  }
+
+  for (size_t i = 0; i < list_size(cg.machines); ++i) {
+    delete_machine(list_get(cg.machines, i));
+  }
+  delete_list(cg.machines);
+
+  for (size_t i = 0; i < list_size(cg.symbols); ++i) {
+    delete_object(list_get(cg.symbols, i));
+  }
+  delete_list(cg.symbols);
+
+  return result;
+}
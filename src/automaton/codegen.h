@@ -0,0 +1,46 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file codegen.h
+
+#ifndef THEORYLISP_AUTOMATON_CODEGEN_H
+#define THEORYLISP_AUTOMATON_CODEGEN_H
+
+#include "../types/object.h"
+#include "../interpreter/stack_frame.h"
+
+/**
+ * Translates an automaton procedure into a self-contained C function
+ * named name that runs the same machine on tapes of symbol indices.
+ *
+ * The machine and its base machines must not have state or transition
+ * outputs. Transition conditions must be constant booleans such as
+ * {#t} and {else}, or comparisons of the symbol under the first head
+ * with a literal symbol such as {= 0} and {!= blank}. Written symbols
+ * must be literals or variables. Variables, including the captured
+ * variables of the automaton, and base machines are evaluated once
+ * while the code is generated.
+ *
+ * Returns a string object containing the C code, or an error object
+ * if the automaton cannot be translated.
+ */
+objectptr automaton_to_c(objectptr procedure, const char *name,
+                         stack_frame_ptr sf);
+
+#endif
@@ -21,61 +21,64 @@
 #include <stdio.h>
 #include <assert.h>
 #include "../types/integer.h"
+#include "../types/real.h"
 #include "../types/error.h"
 #include "../interpreter/stack_frame.h"
 
-objectptr builtin_add(size_t n, objectptr *args, stack_frame_ptr sf) {
-  objectptr result = make_integer(0);
+/* Applies op to the result and each operand in turn. The result is kept
+ * temporary while no other object refers to it, so that the operations
+ * store their results in it instead of allocating new objects. */
+static objectptr accumulate(objectptr result, size_t n, objectptr *args,
+                            objectptr (*op)(objectptr, objectptr)) {
   for (size_t i = 0; i < n; ++i) {
-    assign_object(&result, object_op_add(result, args[i]));
+    if (is_unique(result)) {
+      move(result);
+    }
+    assign_object(&result, op(result, args[i]));
+  }
+  return settle(result);
+}
+
+/* A temporary first operand is given to the function by the caller (see
+ * interpret_update), and it becomes the initial result. */
+
+objectptr builtin_add(size_t n, objectptr *args, stack_frame_ptr sf) {
+  if (n > 0 && is_temporary(*args)) {
+    /* 0 + x is x for every number except negative zero */
+    objectptr result = clone_object(*args);
+    if (is_real(result) && real_value(result) == 0) {
+      assign_object(&result, make_real(0));
+    }
+    return accumulate(result, n - 1, args + 1, object_op_add);
   }
-  return result; 
+
+  return accumulate(make_integer(0), n, args, object_op_add);
 }
 
 objectptr builtin_mul(size_t n, objectptr *args, stack_frame_ptr sf) {
-  objectptr result = make_integer(1);
-  for (size_t i = 0; i < n; ++i) {
-    assign_object(&result, object_op_mul(result, args[i]));
+  if (n > 0 && is_temporary(*args)) {
+    return accumulate(clone_object(*args), n - 1, args + 1, object_op_mul);
   }
-  return result;
+
+  return accumulate(make_integer(1), n, args, object_op_mul);
 }
 
 objectptr builtin_sub(size_t n, objectptr *args, stack_frame_ptr sf) {
   assert(n >= 1);
 
   if (n == 1) {
-    objectptr result = make_integer(0);
-    assign_object(&result, object_op_sub(result, *args));
-    return result;
-  }
-
-  if (n >= 2) {
-    objectptr result = clone_object(*args);
-    for (size_t i = 1; i < n; ++i) {
-      assign_object(&result, object_op_sub(result, args[i]));
-    }
-    return result;
+    return accumulate(make_integer(0), 1, args, object_op_sub);
   }
 
-  abort();
+  return accumulate(clone_object(*args), n - 1, args + 1, object_op_sub);
 }
 
 objectptr builtin_div(size_t n, objectptr *args, stack_frame_ptr sf) {
   assert(n >= 1);
 
   if (n == 1) {
-    objectptr result = make_integer(1);
-    assign_object(&result, object_op_div(result, *args));
-    return result;
-  }
-
-  if (n >= 2) {
-    objectptr result = clone_object(*args);
-    for (size_t i = 1; i < n; ++i) {
-      assign_object(&result, object_op_div(result, args[i]));
-    }
-    return result;
+    return accumulate(make_integer(1), 1, args, object_op_div);
   }
 
-  abort();
+  return accumulate(clone_object(*args), n - 1, args + 1, object_op_div);
 }
@@ -0,0 +1,105 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "automaton.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <string.h>
+
+#include "../automaton/codegen.h"
+#include "../types/error.h"
+#include "../types/integer.h"
+#include "../types/mapped_tape.h"
+#include "../types/pair.h"
+#include "../types/procedure.h"
+#include "../types/string.h"
+
+static bool is_c_identifier(const char *str) {
+  if (!isalpha((unsigned char)*str) && *str != '_') {
+    return false;
+  }
+
+  for (; *str; ++str) {
+    if (!isalnum((unsigned char)*str) && *str != '_') {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+objectptr builtin_automaton_to_c(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  if (!is_procedure(args[0])) {
+    return make_error("automaton-to-c first argument is not an automaton");
+  }
+
+  if (!is_string(args[1]) || !is_c_identifier(string_value(args[1]))) {
+    return make_error("automaton-to-c second argument is not a C identifier");
+  }
+
+  return automaton_to_c(args[0], string_value(args[1]), sf);
+}
+
+objectptr builtin_map_tape(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n >= 1);
+  if (n > 2) {
+    return make_error("map-tape takes at most two arguments");
+  }
+  if (!is_string(args[0])) {
+    return make_error("map-tape first argument is not a string");
+  }
+
+  tape_format_t format = TAPE_BYTES;
+  if (n == 2) {
+    if (!is_string(args[1])) {
+      return make_error("map-tape second argument is not a string");
+    }
+
+    const char *name = string_value(args[1]);
+    if (strcmp(name, "symbols") == 0) {
+      format = TAPE_SYMBOLS;
+    } else if (strcmp(name, "bytes") != 0) {
+      return make_error("map-tape second argument must be \"bytes\" or "
+                        "\"symbols\"");
+    }
+  }
+
+  objectptr contents = make_mapped_tape(string_value(args[0]), format);
+  if (is_error(contents)) {
+    return contents;
+  }
+
+  /* The head starts on the blank after the left end, as in make-tape */
+  objectptr head = make_integer(1);
+  objectptr tape = make_pair(head, contents);
+  delete_object(head);
+  delete_object(contents);
+  return tape;
+}
+
+objectptr builtin_mapped_tape_to_list(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_mapped_tape(*args)) {
+    return make_error("mapped-tape->list argument is not a mapped tape");
+  }
+
+  return mapped_tape_to_list(*args);
+}
@@ -51,6 +51,13 @@ const builtin_function builtin_functions[] = {
     {"display", builtin_display, 1, 1, true},
     {"getchar", builtin_getchar, 0},
     {"putchar", builtin_putchar, 0, 1, true},
+    {"flush-output", builtin_flush_output, 0},
+    {"open-input-file", builtin_open_input_file, 1},
+    {"read-line", builtin_read_line, 1},
+    {"read-bytes", builtin_read_bytes, 2},
+    {"read-all", builtin_read_all, 1},
+    {"read-symbols", builtin_read_symbols, 1, 1, true},
+    {"close-input-port", builtin_close_input_port, 1},
     {"system", builtin_system, 1},
     {"current-seconds", builtin_current_seconds, 0},
 
@@ -73,6 +80,13 @@ const builtin_function builtin_functions[] = {
     {"string?", builtin_is_string, 1},
     {"pair?", builtin_is_pair, 1},
     {"procedure?", builtin_is_procedure, 1},
+    {"input-port?", builtin_is_input_port, 1},
+    {"mapped-tape?", builtin_is_mapped_tape, 1},
+    {"vector?", builtin_is_vector, 1},
+    {"f64vector?", builtin_is_f64vector, 1},
+    {"i64vector?", builtin_is_i64vector, 1},
+    {"dict?", builtin_is_dict, 1},
+    {"mutable-dict?", builtin_is_mutable_dict, 1},
 
     /* Arithmetic operators */
     {"+", builtin_add, 0, 2, true},
@@ -92,6 +106,59 @@ const builtin_function builtin_functions[] = {
     {"cdr", builtin_cdr, 1},
     {"list", builtin_list, 0, MAX_PN_ARITY, true},
 
+    /* Vector functions */
+    {"make-vector", builtin_make_vector, 1, 1, true},
+    {"vector", builtin_vector, 0, MAX_PN_ARITY, true},
+    {"vector-ref", builtin_vector_ref, 2},
+    {"vector-set!", builtin_vector_set, 3},
+    {"vector-push!", builtin_vector_push, 2},
+    {"vector-length", builtin_vector_length, 1},
+    {"vector->list", builtin_vector_to_list, 1},
+    {"list->vector", builtin_list_to_vector, 1},
+
+    /* Dictionary functions */
+    {"make-dict", builtin_make_dict, 0, MAX_PN_ARITY, true},
+    {"make-mutable-dict", builtin_make_mutable_dict, 0, MAX_PN_ARITY, true},
+    {"dict-ref", builtin_dict_ref, 2, 2, true},
+    {"dict-contains?", builtin_dict_contains, 2},
+    {"dict-size", builtin_dict_size, 1},
+    {"dict-set", builtin_dict_set, 3},
+    {"dict-remove", builtin_dict_remove, 2},
+    {"dict-merge", builtin_dict_merge, 2},
+    {"dict-set!", builtin_dict_set_mutable, 3},
+    {"dict-remove!", builtin_dict_remove_mutable, 2},
+    {"dict->list", builtin_dict_to_list, 1},
+    {"list->dict", builtin_list_to_dict, 1},
+    {"list->mutable-dict", builtin_list_to_mutable_dict, 1},
+
+    /* Numeric vector functions */
+    {"make-f64vector", builtin_make_f64vector, 1, 1, true},
+    {"f64vector", builtin_f64vector, 0, MAX_PN_ARITY, true},
+    {"f64vector-ref", builtin_f64vector_ref, 2},
+    {"f64vector-set!", builtin_f64vector_set, 3},
+    {"f64vector-length", builtin_f64vector_length, 1},
+    {"f64vector->list", builtin_f64vector_to_list, 1},
+    {"list->f64vector", builtin_list_to_f64vector, 1},
+    {"make-i64vector", builtin_make_i64vector, 1, 1, true},
+    {"i64vector", builtin_i64vector, 0, MAX_PN_ARITY, true},
+    {"i64vector-ref", builtin_i64vector_ref, 2},
+    {"i64vector-set!", builtin_i64vector_set, 3},
+    {"i64vector-length", builtin_i64vector_length, 1},
+    {"i64vector->list", builtin_i64vector_to_list, 1},
+    {"list->i64vector", builtin_list_to_i64vector, 1},
+    {"v+", builtin_vadd, 2},
+    {"v-", builtin_vsub, 2},
+    {"v*", builtin_vmul, 2},
+    {"v/", builtin_vdiv, 2},
+    {"vsqrt", builtin_vsqrt, 1},
+    {"vexp", builtin_vexp, 1},
+    {"vlog", builtin_vlog, 1},
+    {"vsum", builtin_vsum, 1},
+    {"vdot", builtin_vdot, 2},
+    {"vmin", builtin_vmin, 1},
+    {"vmax", builtin_vmax, 1},
+    {"vprefix-sum", builtin_vprefix_sum, 1},
+
     /* String functions */
     {"strlen", builtin_strlen, 1},
     {"strcat", builtin_strcat, 0, 2, true},
@@ -99,6 +166,10 @@ const builtin_function builtin_functions[] = {
     {"substr", builtin_substr, 3},
     {"strcar", builtin_strcar, 1},
     {"strcdr", builtin_strcdr, 1},
+    {"string-index", builtin_string_index, 2},
+    {"string-contains", builtin_string_contains, 2},
+    {"string-split", builtin_string_split, 2},
+    {"string-replace", builtin_string_replace, 3},
     {"newline", builtin_newline, 0},
     {"tab", builtin_tab, 0},
     {"backspace", builtin_backspace, 0},
@@ -106,6 +177,11 @@ const builtin_function builtin_functions[] = {
     {"i2s", builtin_i2s, 0, MAX_PN_ARITY, true},
     {"s2i", builtin_s2i, 1},
 
+    /* Automata */
+    {"automaton-to-c", builtin_automaton_to_c, 2},
+    {"map-tape", builtin_map_tape, 1, 1, true},
+    {"mapped-tape->list", builtin_mapped_tape_to_list, 1},
+
     /* Reflection */
     {"eval", builtin_eval, 1},
     {"defined?", builtin_defined, 1},
@@ -114,6 +190,10 @@ const builtin_function builtin_functions[] = {
     {"error", builtin_error, 1},
     {"exit", builtin_exit, 0},
 
+    /* Memory management */
+    {"collect-garbage", builtin_collect_garbage, 0},
+    {"gc-threshold", builtin_gc_threshold, 1},
+
     /* Math functions */
     {"cos", builtin_cos, 1},
     {"sin", builtin_sin, 1},
@@ -166,40 +246,52 @@ bool is_builtin_name(const char *name) {
   return find_builtin_function(name) != NULL;
 }
 
-void define_builtin_function_wrappers(stack_frame_ptr sf) {
-  for (size_t i = 0; i < number_of_builtin_functions; ++i) {
-    const builtin_function *f = &builtin_functions[i];
-
-    exprptr lambda_body = new_evaluation_expr(new_identifier_expr(f->name, NULL), NULL);
-    if (f->variadic) {
-      evaluation_expr_add_arg(lambda_body, 
-          new_expanded_expr(new_identifier_expr("va_args", NULL), NULL));
-    } else {
-      for (size_t i = 0; i < f->arity; ++i) {
-        char *id = format("arg%ld", i);
-        evaluation_expr_add_arg(lambda_body, new_identifier_expr(id, NULL));
-        free(id);
-      }
+/* Creates a procedure object that calls the given builtin function */
+static objectptr make_builtin_function_wrapper(const builtin_function *f,
+                                               stack_frame_ptr sf) {
+  exprptr lambda_body = new_evaluation_expr(new_identifier_expr(f->name, NULL), NULL);
+  if (f->variadic) {
+    evaluation_expr_add_arg(lambda_body, 
+        new_expanded_expr(new_identifier_expr("va_args", NULL), NULL));
+  } else {
+    for (size_t i = 0; i < f->arity; ++i) {
+      char *id = format("arg%ld", i);
+      evaluation_expr_add_arg(lambda_body, new_identifier_expr(id, NULL));
+      free(id);
     }
+  }
 
-    exprptr lambda = new_lambda_expr(lambda_body, f->variadic, NULL);
-    if (f->variadic) {
-      lambda_expr_set_pn_arity(lambda, f->pn_arity);
-    }
-    else {
-      lambda_expr_set_pn_arity(lambda, f->arity);
-      for (size_t i = 0; i < f->arity; ++i) {
-        char *id = format("arg%ld", i);
-        lambda_expr_add_param(lambda, id);
-        free(id);
-      }
+  exprptr lambda = new_lambda_expr(lambda_body, f->variadic, NULL);
+  if (f->variadic) {
+    lambda_expr_set_pn_arity(lambda, f->pn_arity);
+  }
+  else {
+    lambda_expr_set_pn_arity(lambda, f->arity);
+    for (size_t i = 0; i < f->arity; ++i) {
+      char *id = format("arg%ld", i);
+      lambda_expr_add_param(lambda, id);
+      free(id);
     }
+  }
+
+  objectptr procedure = make_procedure(lambda, NULL, sf);
+  delete_expr(lambda);
+  return procedure;
+}
 
-    objectptr procedure = make_procedure(lambda, NULL, sf);
-    stack_frame_set_global_variable(sf, f->name, procedure);
-    delete_object(procedure);
-    delete_expr(lambda);
+/* Global frame miss handler that materializes builtin wrappers on first use */
+static objectptr builtin_function_wrapper_miss_handler(stack_frame_ptr sf,
+                                                       const char *name) {
+  const builtin_function *f = find_builtin_function(name);
+  if (!f) {
+    return NULL;
   }
+
+  return make_builtin_function_wrapper(f, sf);
+}
+
+void define_builtin_function_wrappers(stack_frame_ptr sf) {
+  stack_frame_set_miss_handler(sf, builtin_function_wrapper_miss_handler);
 }
 
 
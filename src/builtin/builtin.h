@@ -29,11 +29,16 @@
 #include "object.h"
 #include "boolean.h"
 #include "list.h"
+#include "vector.h"
+#include "numeric_vector.h"
+#include "dict.h"
 #include "string.h"
 #include "eval.h"
 #include "error.h"
+#include "memory.h"
 #include "math.h"
 #include "macro_utils.h"
+#include "automaton.h"
 
 typedef objectptr (*builtin_function_ptr)(size_t, objectptr *, stack_frame_ptr);
 
@@ -49,6 +54,11 @@ const builtin_function *find_builtin_function(const char *name);
 
 bool is_builtin_name(const char *name);
 
+/**
+ * Makes builtin functions accessible as procedure objects in the given
+ * global stack frame. A wrapper procedure is created only when the name
+ * of a builtin function is referenced for the first time.
+ */
 void define_builtin_function_wrappers(stack_frame_ptr sf);
 
 objectptr builtin_begin(size_t n, objectptr *args, stack_frame_ptr sf);
@@ -0,0 +1,246 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dict.h"
+#include "list.h"
+#include "../types/dict.h"
+#include "../types/boolean.h"
+#include "../types/error.h"
+#include "../types/integer.h"
+#include "../types/null.h"
+#include "../types/pair.h"
+#include "../types/void.h"
+
+#include <assert.h>
+
+/* Association lists, including the empty list, are accepted wherever a
+ * dict is expected, so that dictionaries that were built as lists by
+ * collection.tl keep working. A dict that is created from a list is
+ * stored in *converted and must be deleted by the caller. It is
+ * temporary, so that dict-set can change it instead of copying it, and
+ * the results of the functions that update dicts are therefore settled. */
+static objectptr dict_argument(objectptr obj, objectptr *converted) {
+  *converted = NULL;
+  if (is_null(obj) || is_pair(obj)) {
+    objectptr dict = list_to_dict(obj);
+    *converted = is_error(dict) ? dict : move(dict);
+    return *converted;
+  }
+  return obj;
+}
+
+static bool is_dictionary(objectptr obj) {
+  return is_dict(obj) || is_mutable_dict(obj);
+}
+
+static bool are_pairs(size_t n, objectptr *args) {
+  for (size_t i = 0; i < n; ++i) {
+    if (!is_pair(args[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+objectptr builtin_make_dict(size_t n, objectptr *args, stack_frame_ptr sf) {
+  if (!are_pairs(n, args)) {
+    return make_error("make-dict arguments are not pairs");
+  }
+
+  objectptr list = builtin_list(n, args, sf);
+  objectptr result = list_to_dict(list);
+  delete_object(list);
+  return result;
+}
+
+objectptr builtin_make_mutable_dict(size_t n, objectptr *args,
+                                    stack_frame_ptr sf) {
+  if (!are_pairs(n, args)) {
+    return make_error("make-mutable-dict arguments are not pairs");
+  }
+
+  objectptr list = builtin_list(n, args, sf);
+  objectptr result = list_to_mutable_dict(list);
+  delete_object(list);
+  return result;
+}
+
+objectptr builtin_dict_ref(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n >= 2);
+  if (n > 3) {
+    return make_error("dict-ref takes at most three arguments");
+  }
+
+  objectptr converted;
+  objectptr dict = dict_argument(args[0], &converted);
+  if (!is_dictionary(dict)) {
+    return converted ? converted
+                     : make_error("dict-ref first argument is not a dict");
+  }
+
+  /* Missing keys give void unless a default value is given */
+  objectptr value = dict_get(dict, args[1]);
+  objectptr result;
+  if (value) {
+    result = clone_object(value);
+  } else {
+    result = n == 3 ? clone_object(args[2]) : make_void();
+  }
+  if (converted) {
+    delete_object(converted);
+  }
+  return result;
+}
+
+objectptr builtin_dict_contains(size_t n, objectptr *args,
+                                stack_frame_ptr sf) {
+  assert(n == 2);
+  objectptr converted;
+  objectptr dict = dict_argument(args[0], &converted);
+  if (!is_dictionary(dict)) {
+    return converted
+               ? converted
+               : make_error("dict-contains? first argument is not a dict");
+  }
+
+  objectptr result = make_boolean(dict_get(dict, args[1]) != NULL);
+  if (converted) {
+    delete_object(converted);
+  }
+  return result;
+}
+
+objectptr builtin_dict_size(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  objectptr converted;
+  objectptr dict = dict_argument(args[0], &converted);
+  if (!is_dictionary(dict)) {
+    return converted ? converted
+                     : make_error("dict-size argument is not a dict");
+  }
+
+  objectptr result = make_integer((integer_t)dict_size(dict));
+  if (converted) {
+    delete_object(converted);
+  }
+  return result;
+}
+
+objectptr builtin_dict_set(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 3);
+  objectptr converted;
+  objectptr dict = dict_argument(args[0], &converted);
+  if (!is_dict(dict)) {
+    return converted ? converted
+                     : make_error("dict-set first argument is not a dict");
+  }
+
+  objectptr result = dict_set(dict, args[1], args[2]);
+  if (converted) {
+    delete_object(converted);
+  }
+  return settle(result);
+}
+
+objectptr builtin_dict_remove(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  objectptr converted;
+  objectptr dict = dict_argument(args[0], &converted);
+  if (!is_dict(dict)) {
+    return converted ? converted
+                     : make_error("dict-remove first argument is not a dict");
+  }
+
+  objectptr result = dict_remove(dict, args[1]);
+  if (converted) {
+    delete_object(converted);
+  }
+  return settle(result);
+}
+
+objectptr builtin_dict_merge(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  objectptr first_converted;
+  objectptr first = dict_argument(args[0], &first_converted);
+  if (!is_dict(first)) {
+    return first_converted
+               ? first_converted
+               : make_error("dict-merge first argument is not a dict");
+  }
+
+  objectptr second_converted;
+  objectptr second = dict_argument(args[1], &second_converted);
+  objectptr result;
+  if (is_dictionary(second)) {
+    result = dict_merge(first, second);
+    if (second_converted) {
+      delete_object(second_converted);
+    }
+  } else {
+    result = second_converted
+                 ? second_converted
+                 : make_error("dict-merge second argument is not a dict");
+  }
+
+  if (first_converted) {
+    delete_object(first_converted);
+  }
+  return settle(result);
+}
+
+objectptr builtin_dict_set_mutable(size_t n, objectptr *args,
+                                   stack_frame_ptr sf) {
+  assert(n == 3);
+  if (!is_mutable_dict(args[0])) {
+    return make_error("dict-set! first argument is not a mutable dict");
+  }
+
+  return mutable_dict_set(args[0], args[1], args[2]);
+}
+
+objectptr builtin_dict_remove_mutable(size_t n, objectptr *args,
+                                      stack_frame_ptr sf) {
+  assert(n == 2);
+  if (!is_mutable_dict(args[0])) {
+    return make_error("dict-remove! first argument is not a mutable dict");
+  }
+
+  mutable_dict_remove(args[0], args[1]);
+  return make_void();
+}
+
+objectptr builtin_dict_to_list(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_dictionary(args[0])) {
+    return make_error("dict->list argument is not a dict");
+  }
+
+  return dict_to_list(args[0]);
+}
+
+objectptr builtin_list_to_dict(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return list_to_dict(args[0]);
+}
+
+objectptr builtin_list_to_mutable_dict(size_t n, objectptr *args,
+                                       stack_frame_ptr sf) {
+  assert(n == 1);
+  return list_to_mutable_dict(args[0]);
+}
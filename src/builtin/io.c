@@ -20,6 +20,7 @@
 #include "io.h"
 
 #include <stdio.h>
+#include <stdint.h>
 #include <assert.h>
 #include <time.h>
 
@@ -28,8 +29,10 @@
 #include "../types/void.h"
 #include "../types/string.h"
 #include "../types/error.h"
+#include "../types/input_port.h"
 #include "../types/integer.h"
 #include "../utils/file.h"
+#include "../utils/port.h"
 #include "../utils/string.h"
 
 /* 
@@ -40,9 +43,9 @@
 #define LIBRARY_DIR "/usr/local/lib/tlisp"
 #endif
 
-char *read_code(char *file_name) {
+mapped_file_ptr read_code(char *file_name) {
   /* Try to read the file at the given path */
-  char *code = read_file(file_name);
+  mapped_file_ptr code = map_file(file_name);
   if (code) {
     return code;
   }
@@ -50,7 +53,7 @@ char *read_code(char *file_name) {
   /* If the file at the given path is not accessible, search
    * for the file in the Theory Lisp library directory */
   char *library_file_name = format("%s/%s", LIBRARY_DIR, file_name);
-  code = read_file(library_file_name);
+  code = map_file(library_file_name);
   if (code) {
     free(library_file_name);
     return code;
@@ -80,7 +83,7 @@ objectptr builtin_load(size_t n, objectptr *args, stack_frame_ptr sf) {
   }
 
   /* Read file */
-  char *code = read_code(file_name);
+  mapped_file_ptr code = read_code(file_name);
   if (!code) {
     free(include_guard);
     return make_error("%s is not accessible.", file_name);
@@ -92,11 +95,11 @@ objectptr builtin_load(size_t n, objectptr *args, stack_frame_ptr sf) {
   free(include_guard);
 
   /* Parse included file */
-  tokenstreamptr tkns = scanner(code);
+  tokenstreamptr tkns = scanner_n(code->data, code->length);
+  unmap_file(code);
   listptr parse_tree = parser(tkns, sf);
   if (!parse_tree) {
     delete_tokenstream(tkns);
-    free(code);
     return make_error("An error occured in the included file");
   }
 
@@ -106,7 +109,6 @@ objectptr builtin_load(size_t n, objectptr *args, stack_frame_ptr sf) {
 
   delete_tokenstream(tkns);
   delete_parse_tree(parse_tree);
-  free(code);
 
   return make_void();
 }
@@ -118,26 +120,26 @@ objectptr builtin_system(size_t n, objectptr *args, stack_frame_ptr sf) {
     return make_error("system argument is not a string");
   }
 
+  /* The command writes to the same stdout */
+  flush_standard_output();
   return make_integer(system(string_value(*args)));
 }
 
 objectptr builtin_display(size_t n, objectptr *args, stack_frame_ptr sf) {
   assert(n >= 1);
 
+  output_port_ptr port = standard_output();
   for (size_t i = 0; i < n; ++i) {
-    char *str = NULL;
-
     if (is_string(args[i])) {
-      str = string_value(args[i]);
-      printf("%s", str);
+      port_write(port, string_chars(args[i]), string_size(args[i]));
     } else {
-      str = object_tostring(args[i]);
-      printf("%s", str);
-      free(str);
+      object_print(args[i], port);
     }
   }
 
-  fflush(stdout);
+  if (port_failed(port)) {
+    return make_error("Cannot write to standard output");
+  }
 
   return make_void();
 }
@@ -148,6 +150,8 @@ objectptr builtin_getchar(size_t n, objectptr *args, stack_frame_ptr sf) {
     return make_void();
   }
 
+  flush_standard_output();
+
   int result = getchar();
   if (result == EOF) {
     return make_error("getchar failed");
@@ -159,8 +163,7 @@ objectptr builtin_getchar(size_t n, objectptr *args, stack_frame_ptr sf) {
 objectptr builtin_putchar(size_t n, objectptr *args, stack_frame_ptr sf) {
   for (size_t i = 0; i < n; i++) {
     if (is_integer(args[i])) {
-      int result = putchar((int)int_value(args[i]));
-      if (result == EOF) {
+      if (!port_putc(standard_output(), (char)int_value(args[i]))) {
         return make_error("Cannot write to standard output");
       }
     } else {
@@ -168,8 +171,87 @@ objectptr builtin_putchar(size_t n, objectptr *args, stack_frame_ptr sf) {
     }
   }
 
-  fflush(stdout);
+  return make_void();
+}
+
+objectptr builtin_flush_output(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 0);
+  if (!port_flush(standard_output())) {
+    return make_error("Cannot write to standard output");
+  }
+
+  return make_void();
+}
+
+objectptr builtin_open_input_file(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_string(*args)) {
+    return make_error("open-input-file argument is not a string");
+  }
+
+  return make_input_port(string_value(*args));
+}
+
+objectptr builtin_read_line(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_input_port(*args)) {
+    return make_error("read-line argument is not an input port");
+  }
+
+  return input_port_read_line(*args);
+}
+
+objectptr builtin_read_bytes(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  if (!is_input_port(args[0])) {
+    return make_error("First argument of read-bytes is not an input port");
+  }
+  if (!is_integer(args[1]) || int_value(args[1]) < 0) {
+    return make_error("Second argument of read-bytes is not a "
+                      "non-negative integer");
+  }
+
+  return input_port_read_bytes(args[0], (size_t)int_value(args[1]));
+}
+
+objectptr builtin_read_all(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_input_port(*args)) {
+    return make_error("read-all argument is not an input port");
+  }
+
+  return input_port_read_all(*args);
+}
+
+objectptr builtin_read_symbols(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n >= 1);
+  if (n > 2) {
+    return make_error("read-symbols takes at most two arguments");
+  }
+  if (!is_input_port(args[0])) {
+    return make_error("First argument of read-symbols is not an input port");
+  }
+
+  /* All remaining symbols are read if no count is given */
+  size_t count = SIZE_MAX;
+  if (n == 2) {
+    if (!is_integer(args[1]) || int_value(args[1]) < 0) {
+      return make_error("Second argument of read-symbols is not a "
+                        "non-negative integer");
+    }
+    count = (size_t)int_value(args[1]);
+  }
+
+  return input_port_read_symbols(args[0], count);
+}
+
+objectptr builtin_close_input_port(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_input_port(*args)) {
+    return make_error("close-input-port argument is not an input port");
+  }
 
+  input_port_close(*args);
   return make_void();
 }
 
@@ -36,6 +36,20 @@ objectptr builtin_getchar(size_t n, objectptr *args, stack_frame_ptr sf);
 
 objectptr builtin_putchar(size_t n, objectptr *args, stack_frame_ptr sf);
 
+objectptr builtin_flush_output(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_open_input_file(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_read_line(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_read_bytes(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_read_all(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_read_symbols(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_close_input_port(size_t n, objectptr *args, stack_frame_ptr sf);
+
 objectptr builtin_current_seconds(size_t n, objectptr *args, stack_frame_ptr sf);
 
 #endif
@@ -0,0 +1,46 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "memory.h"
+
+#include <assert.h>
+
+#include "../types/collector.h"
+#include "../types/error.h"
+#include "../types/integer.h"
+
+objectptr builtin_collect_garbage(size_t n, objectptr *args,
+                                  stack_frame_ptr sf) {
+  assert(n == 0);
+  return make_integer((integer_t)collect_cycles());
+}
+
+objectptr builtin_gc_threshold(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_integer(*args)) {
+    return make_error("gc-threshold argument is not an integer");
+  }
+
+  integer_t threshold = int_value(*args);
+  if (threshold < 0) {
+    return make_error("gc-threshold argument is negative");
+  }
+
+  return make_integer((integer_t)collector_set_threshold((size_t)threshold));
+}
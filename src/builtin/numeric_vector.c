@@ -0,0 +1,299 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "numeric_vector.h"
+#include "../types/numeric_vector.h"
+#include "../types/error.h"
+#include "../types/integer.h"
+#include "../types/real.h"
+
+#include <assert.h>
+#include <math.h>
+
+/* Returns true if obj is an index of the numeric vector */
+static bool is_index(objectptr vec, objectptr obj) {
+  return is_integer(obj) && int_value(obj) >= 0 &&
+         (size_t)int_value(obj) < numeric_vector_length(vec);
+}
+
+objectptr builtin_make_f64vector(size_t n, objectptr *args,
+                                 stack_frame_ptr sf) {
+  assert(n >= 1);
+  if (n > 2) {
+    return make_error("make-f64vector takes at most two arguments");
+  }
+  if (!is_integer(args[0]) || int_value(args[0]) < 0) {
+    return make_error("make-f64vector length is not a non-negative integer");
+  }
+  if (n == 2 && !is_number(args[1])) {
+    return make_error("make-f64vector fill value is not a number");
+  }
+
+  /* Elements are zero unless a fill value is given */
+  real_t fill = n == 2 ? cast_real(args[1]) : 0;
+  return make_f64vector((size_t)int_value(args[0]), fill);
+}
+
+objectptr builtin_f64vector(size_t n, objectptr *args, stack_frame_ptr sf) {
+  objectptr result = make_f64vector(n, 0);
+  real_t *data = f64vector_data(result);
+  for (size_t i = 0; i < n; ++i) {
+    if (!is_number(args[i])) {
+      delete_object(result);
+      return make_error("f64vector arguments are not numbers");
+    }
+    data[i] = cast_real(args[i]);
+  }
+  return result;
+}
+
+objectptr builtin_f64vector_ref(size_t n, objectptr *args,
+                                stack_frame_ptr sf) {
+  assert(n == 2);
+  if (!is_f64vector(args[0])) {
+    return make_error("f64vector-ref first argument is not an f64vector");
+  }
+  if (!is_index(args[0], args[1])) {
+    return make_error("f64vector-ref index is out of bounds");
+  }
+
+  return numeric_vector_ref(args[0], (size_t)int_value(args[1]));
+}
+
+objectptr builtin_f64vector_set(size_t n, objectptr *args,
+                                stack_frame_ptr sf) {
+  assert(n == 3);
+  if (!is_f64vector(args[0])) {
+    return make_error("f64vector-set! first argument is not an f64vector");
+  }
+  if (!is_index(args[0], args[1])) {
+    return make_error("f64vector-set! index is out of bounds");
+  }
+
+  return numeric_vector_set(args[0], (size_t)int_value(args[1]), args[2]);
+}
+
+objectptr builtin_f64vector_length(size_t n, objectptr *args,
+                                   stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_f64vector(args[0])) {
+    return make_error("f64vector-length argument is not an f64vector");
+  }
+
+  return make_integer((integer_t)numeric_vector_length(args[0]));
+}
+
+objectptr builtin_f64vector_to_list(size_t n, objectptr *args,
+                                    stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_f64vector(args[0])) {
+    return make_error("f64vector->list argument is not an f64vector");
+  }
+
+  return numeric_vector_to_list(args[0]);
+}
+
+objectptr builtin_list_to_f64vector(size_t n, objectptr *args,
+                                    stack_frame_ptr sf) {
+  assert(n == 1);
+  return list_to_f64vector(args[0]);
+}
+
+objectptr builtin_make_i64vector(size_t n, objectptr *args,
+                                 stack_frame_ptr sf) {
+  assert(n >= 1);
+  if (n > 2) {
+    return make_error("make-i64vector takes at most two arguments");
+  }
+  if (!is_integer(args[0]) || int_value(args[0]) < 0) {
+    return make_error("make-i64vector length is not a non-negative integer");
+  }
+  if (n == 2 && !is_integer(args[1])) {
+    return make_error("make-i64vector fill value is not an integer");
+  }
+
+  integer_t fill = n == 2 ? int_value(args[1]) : 0;
+  return make_i64vector((size_t)int_value(args[0]), fill);
+}
+
+objectptr builtin_i64vector(size_t n, objectptr *args, stack_frame_ptr sf) {
+  objectptr result = make_i64vector(n, 0);
+  integer_t *data = i64vector_data(result);
+  for (size_t i = 0; i < n; ++i) {
+    if (!is_integer(args[i])) {
+      delete_object(result);
+      return make_error("i64vector arguments are not integers");
+    }
+    data[i] = int_value(args[i]);
+  }
+  return result;
+}
+
+objectptr builtin_i64vector_ref(size_t n, objectptr *args,
+                                stack_frame_ptr sf) {
+  assert(n == 2);
+  if (!is_i64vector(args[0])) {
+    return make_error("i64vector-ref first argument is not an i64vector");
+  }
+  if (!is_index(args[0], args[1])) {
+    return make_error("i64vector-ref index is out of bounds");
+  }
+
+  return numeric_vector_ref(args[0], (size_t)int_value(args[1]));
+}
+
+objectptr builtin_i64vector_set(size_t n, objectptr *args,
+                                stack_frame_ptr sf) {
+  assert(n == 3);
+  if (!is_i64vector(args[0])) {
+    return make_error("i64vector-set! first argument is not an i64vector");
+  }
+  if (!is_index(args[0], args[1])) {
+    return make_error("i64vector-set! index is out of bounds");
+  }
+
+  return numeric_vector_set(args[0], (size_t)int_value(args[1]), args[2]);
+}
+
+objectptr builtin_i64vector_length(size_t n, objectptr *args,
+                                   stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_i64vector(args[0])) {
+    return make_error("i64vector-length argument is not an i64vector");
+  }
+
+  return make_integer((integer_t)numeric_vector_length(args[0]));
+}
+
+objectptr builtin_i64vector_to_list(size_t n, objectptr *args,
+                                    stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_i64vector(args[0])) {
+    return make_error("i64vector->list argument is not an i64vector");
+  }
+
+  return numeric_vector_to_list(args[0]);
+}
+
+objectptr builtin_list_to_i64vector(size_t n, objectptr *args,
+                                    stack_frame_ptr sf) {
+  assert(n == 1);
+  return list_to_i64vector(args[0]);
+}
+
+/* Checks the operands of an elementwise operation before it is applied.
+ * At least one of them must be a numeric vector, and the other one may
+ * be a number. */
+static objectptr elementwise(const char *name, kernel_op_t op,
+                             objectptr *args) {
+  bool first_vector = is_numeric_vector(args[0]);
+  bool second_vector = is_numeric_vector(args[1]);
+  if ((!first_vector && !second_vector) ||
+      (!first_vector && !is_number(args[0])) ||
+      (!second_vector && !is_number(args[1]))) {
+    return make_error("%s arguments are not numeric vectors or numbers",
+                      name);
+  }
+
+  return numeric_vector_op(op, args[0], args[1]);
+}
+
+objectptr builtin_vadd(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  return elementwise("v+", KERNEL_ADD, args);
+}
+
+objectptr builtin_vsub(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  return elementwise("v-", KERNEL_SUB, args);
+}
+
+objectptr builtin_vmul(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  return elementwise("v*", KERNEL_MUL, args);
+}
+
+objectptr builtin_vdiv(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  return elementwise("v/", KERNEL_DIV, args);
+}
+
+objectptr builtin_vsqrt(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_numeric_vector(*args)) {
+    return make_error("vsqrt argument is not a numeric vector");
+  }
+  return numeric_vector_sqrt(*args);
+}
+
+objectptr builtin_vexp(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_numeric_vector(*args)) {
+    return make_error("vexp argument is not a numeric vector");
+  }
+  return numeric_vector_map(*args, exp);
+}
+
+objectptr builtin_vlog(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_numeric_vector(*args)) {
+    return make_error("vlog argument is not a numeric vector");
+  }
+  return numeric_vector_map(*args, log);
+}
+
+objectptr builtin_vsum(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_numeric_vector(*args)) {
+    return make_error("vsum argument is not a numeric vector");
+  }
+  return numeric_vector_sum(*args);
+}
+
+objectptr builtin_vdot(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  if (!is_numeric_vector(args[0]) || !is_numeric_vector(args[1])) {
+    return make_error("vdot arguments are not numeric vectors");
+  }
+  return numeric_vector_dot(args[0], args[1]);
+}
+
+objectptr builtin_vmin(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_numeric_vector(*args)) {
+    return make_error("vmin argument is not a numeric vector");
+  }
+  return numeric_vector_min(*args);
+}
+
+objectptr builtin_vmax(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_numeric_vector(*args)) {
+    return make_error("vmax argument is not a numeric vector");
+  }
+  return numeric_vector_max(*args);
+}
+
+objectptr builtin_vprefix_sum(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_numeric_vector(*args)) {
+    return make_error("vprefix-sum argument is not a numeric vector");
+  }
+  return numeric_vector_prefix_sum(*args);
+}
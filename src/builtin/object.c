@@ -28,6 +28,11 @@
 #include "../types/pair.h"
 #include "../types/boolean.h"
 #include "../types/procedure.h"
+#include "../types/input_port.h"
+#include "../types/mapped_tape.h"
+#include "../types/vector.h"
+#include "../types/numeric_vector.h"
+#include "../types/dict.h"
 
 #include <assert.h>
 #include <stdio.h>
@@ -129,3 +134,38 @@ objectptr builtin_is_procedure(size_t n, objectptr *args, stack_frame_ptr sf) {
   return make_boolean(is_procedure(*args));
 }
 
+objectptr builtin_is_input_port(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return make_boolean(is_input_port(*args));
+}
+
+objectptr builtin_is_mapped_tape(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return make_boolean(is_mapped_tape(*args));
+}
+
+objectptr builtin_is_vector(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return make_boolean(is_vector(*args));
+}
+
+objectptr builtin_is_f64vector(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return make_boolean(is_f64vector(*args));
+}
+
+objectptr builtin_is_i64vector(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return make_boolean(is_i64vector(*args));
+}
+
+objectptr builtin_is_dict(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return make_boolean(is_dict(*args));
+}
+
+objectptr builtin_is_mutable_dict(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return make_boolean(is_mutable_dict(*args));
+}
+
@@ -57,4 +57,18 @@ objectptr builtin_is_pair(size_t n, objectptr *args, stack_frame_ptr sf);
 
 objectptr builtin_is_procedure(size_t n, objectptr *args, stack_frame_ptr sf);
 
+objectptr builtin_is_input_port(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_is_mapped_tape(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_is_vector(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_is_f64vector(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_is_i64vector(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_is_dict(size_t n, objectptr *args, stack_frame_ptr sf);
+
+objectptr builtin_is_mutable_dict(size_t n, objectptr *args, stack_frame_ptr sf);
+
 #endif
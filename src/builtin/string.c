@@ -38,12 +38,25 @@ objectptr builtin_strlen(size_t n, objectptr *args, stack_frame_ptr sf) {
 }
 
 objectptr builtin_strcat(size_t n, objectptr *args, stack_frame_ptr sf) {
-  objectptr result = make_string("");
-  for (size_t i = 0; i < n; ++i) {
+  /* A temporary first argument is given to the function by the caller
+   * (see interpret_update), and the other arguments are appended to it */
+  size_t i = 0;
+  objectptr result = NULL;
+  if (n > 0 && is_temporary(*args)) {
+    result = clone_object(*args);
+    i = 1;
+  } else {
+    result = make_string("");
+  }
+
+  for (; i < n; ++i) {
+    if (is_unique(result)) {
+      move(result);
+    }
     assign_object(&result, string_concat(result, args[i]));
-  } 
+  }
 
-  return result;
+  return settle(result);
 }
 
 objectptr builtin_charat(size_t n, objectptr *args, stack_frame_ptr sf) {
@@ -73,7 +86,35 @@ objectptr builtin_strcdr(size_t n, objectptr *args, stack_frame_ptr sf) {
     return make_error("strcdr argument is not a string");
   }
 
-  return make_string(&string_value(*args)[1]);
+  if (string_size(*args) == 0) {
+    return make_error("strcdr argument is empty");
+  }
+
+  return string_substring(*args, 1, string_size(*args));
+}
+
+objectptr builtin_string_index(size_t n, objectptr *args,
+                               stack_frame_ptr sf) {
+  assert(n == 2);
+  return string_index(args[0], args[1]);
+}
+
+objectptr builtin_string_contains(size_t n, objectptr *args,
+                                  stack_frame_ptr sf) {
+  assert(n == 2);
+  return string_contains(args[0], args[1]);
+}
+
+objectptr builtin_string_split(size_t n, objectptr *args,
+                               stack_frame_ptr sf) {
+  assert(n == 2);
+  return string_split(args[0], args[1]);
+}
+
+objectptr builtin_string_replace(size_t n, objectptr *args,
+                                 stack_frame_ptr sf) {
+  assert(n == 3);
+  return string_replace(args[0], args[1], args[2]);
 }
 
 objectptr builtin_newline(size_t n, objectptr *args, stack_frame_ptr sf) {
@@ -138,8 +179,8 @@ objectptr builtin_s2i(size_t n, objectptr *args, stack_frame_ptr sf) {
   /* Convert internally stored char array in the string object
    * to a list of integer objects */
   listptr integers = new_list(); 
-  const char *strval = string_value(*args);
-  for (size_t i = 0; i < strlen(strval); ++i) {
+  const char *strval = string_chars(*args);
+  for (size_t i = 0; i < string_size(*args); ++i) {
     list_add(integers, make_integer(strval[i]));
   }
 
@@ -37,6 +37,18 @@ objectptr builtin_strcar(size_t n, objectptr *args, stack_frame_ptr sf);
 
 objectptr builtin_strcdr(size_t n, objectptr *args, stack_frame_ptr sf);
 
+objectptr builtin_string_index(size_t n, objectptr *args,
+                               stack_frame_ptr sf);
+
+objectptr builtin_string_contains(size_t n, objectptr *args,
+                                  stack_frame_ptr sf);
+
+objectptr builtin_string_split(size_t n, objectptr *args,
+                               stack_frame_ptr sf);
+
+objectptr builtin_string_replace(size_t n, objectptr *args,
+                                 stack_frame_ptr sf);
+
 objectptr builtin_newline(size_t n, objectptr *args, stack_frame_ptr sf);
 
 objectptr builtin_tab(size_t n, objectptr *args, stack_frame_ptr sf);
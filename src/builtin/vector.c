@@ -0,0 +1,120 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "vector.h"
+#include "../types/vector.h"
+#include "../types/error.h"
+#include "../types/integer.h"
+#include "../types/null.h"
+#include "../types/void.h"
+
+#include <assert.h>
+
+/* Returns true if obj is an index of the vector */
+static bool is_index(objectptr vec, objectptr obj) {
+  return is_integer(obj) && int_value(obj) >= 0 &&
+         (size_t)int_value(obj) < vector_length(vec);
+}
+
+objectptr builtin_make_vector(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n >= 1);
+  if (n > 2) {
+    return make_error("make-vector takes at most two arguments");
+  }
+  if (!is_integer(args[0]) || int_value(args[0]) < 0) {
+    return make_error("make-vector length is not a non-negative integer");
+  }
+
+  /* Elements are null unless a fill value is given */
+  if (n == 2) {
+    return make_vector((size_t)int_value(args[0]), args[1]);
+  }
+
+  objectptr fill = make_null();
+  objectptr result = make_vector((size_t)int_value(args[0]), fill);
+  delete_object(fill);
+  return result;
+}
+
+objectptr builtin_vector(size_t n, objectptr *args, stack_frame_ptr sf) {
+  objectptr fill = make_null();
+  objectptr result = make_vector(0, fill);
+  delete_object(fill);
+  for (size_t i = 0; i < n; ++i) {
+    vector_push(result, args[i]);
+  }
+  return result;
+}
+
+objectptr builtin_vector_ref(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  if (!is_vector(args[0])) {
+    return make_error("vector-ref first argument is not a vector");
+  }
+  if (!is_index(args[0], args[1])) {
+    return make_error("vector-ref index is out of bounds");
+  }
+
+  return clone_object(vector_get(args[0], (size_t)int_value(args[1])));
+}
+
+objectptr builtin_vector_set(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 3);
+  if (!is_vector(args[0])) {
+    return make_error("vector-set! first argument is not a vector");
+  }
+  if (!is_index(args[0], args[1])) {
+    return make_error("vector-set! index is out of bounds");
+  }
+
+  return vector_set(args[0], (size_t)int_value(args[1]), args[2]);
+}
+
+objectptr builtin_vector_push(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 2);
+  if (!is_vector(args[0])) {
+    return make_error("vector-push! first argument is not a vector");
+  }
+
+  vector_push(args[0], args[1]);
+  return make_void();
+}
+
+objectptr builtin_vector_length(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_vector(args[0])) {
+    return make_error("vector-length argument is not a vector");
+  }
+
+  return make_integer((integer_t)vector_length(args[0]));
+}
+
+objectptr builtin_vector_to_list(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  if (!is_vector(args[0])) {
+    return make_error("vector->list argument is not a vector");
+  }
+
+  return vector_to_list(args[0]);
+}
+
+objectptr builtin_list_to_vector(size_t n, objectptr *args, stack_frame_ptr sf) {
+  assert(n == 1);
+  return list_to_vector(args[0]);
+}
@@ -29,6 +29,7 @@
 #include "../types/void.h"
 #include "../types/object.h"
 #include "../utils/list.h"
+#include "../optimizer/optimizer.h"
 #include "../utils/string.h"
 #include "../automaton/automaton.h"
 #include "common.h"
@@ -79,7 +80,8 @@ static const expr_vtable automaton_expr_vtable = {
     .call = call_automaton,
     .call_internal = call_automaton_internal,
     .get_arity = automaton_expr_get_arity,
-    .get_pn_arity = automaton_expr_get_pn_arity};
+    .get_pn_arity = automaton_expr_get_pn_arity,
+    .optimize = optimize_automaton};
 
 bool is_automaton_expr(exprptr e) {
   return strcmp(e->expr_name, automaton_expr_name) == 0;
@@ -599,6 +601,22 @@ objectptr call_automaton_internal(exprptr self, void *args, stack_frame_ptr sf)
   return automaton_run_internal(aut, args, sf);
 }
 
+automaton_t *automaton_expr_get_compiled(exprptr self) {
+  automaton_expr *ae = self->data;
+  return ae->compiled;
+}
+
+const char *automaton_expr_get_state_name(exprptr self, size_t index) {
+  automaton_expr *ae = self->data;
+  state_expr *st = list_get(ae->states, index);
+  return st->name;
+}
+
+bool automaton_expr_has_captures(exprptr self) {
+  automaton_expr *ae = self->data;
+  return list_size(ae->captures) != 0;
+}
+
 size_t automaton_expr_get_arity(exprptr self) {
   automaton_expr *ae = self->data;
   return ae->number_of_tapes;
@@ -608,3 +626,44 @@ size_t automaton_expr_get_pn_arity(exprptr self) {
   automaton_expr *ae = self->data;
   return ae->number_of_tapes;
 }
+
+static exprptr optimize_optional_expr(exprptr e, optimizer_ptr opt) {
+  return e ? optimize_expr(e, opt) : NULL;
+}
+
+/*
+ * Optimizes the expressions in the states and transitions
+ * of the automaton.
+ */
+exprptr optimize_automaton(exprptr self, optimizer_ptr opt) {
+  automaton_expr *ae = self->data;
+
+  for (size_t i = 0; i < list_size(ae->captures); ++i) {
+    optimizer_note_binding(opt, list_get(ae->captures, i));
+  }
+
+  for (size_t i = 0; i < list_size(ae->states); ++i) {
+    state_expr *st = list_get(ae->states, i);
+    st->base_machine = optimize_optional_expr(st->base_machine, opt);
+    st->output = optimize_optional_expr(st->output, opt);
+
+    for (size_t j = 0; j < list_size(st->transitions); ++j) {
+      transition_expr *tr = list_get(st->transitions, j);
+      tr->condition = optimize_expr(tr->condition, opt);
+      tr->output = optimize_optional_expr(tr->output, opt);
+
+      for (size_t k = 0; k < list_size(tr->head_operations); ++k) {
+        head_operation_expr *op = list_get(tr->head_operations, k);
+        op->write_value = optimize_optional_expr(op->write_value, opt);
+      }
+    }
+  }
+
+  /* The compiled automaton refers to the old expressions */
+  if (ae->compiled) {
+    delete_automaton(ae->compiled);
+    ae->compiled = NULL;
+  }
+
+  return self;
+}
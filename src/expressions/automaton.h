@@ -26,6 +26,7 @@
 #include "../interpreter/interpreter.h"
 #include "../scanner/scanner.h"
 #include "../types/object.h"
+#include "../automaton/automaton.h"
 
 #include <stdbool.h>
 
@@ -46,8 +47,19 @@ objectptr call_automaton(exprptr self, size_t nargs, objectptr *args,
 
 objectptr call_automaton_internal(exprptr self, void *, stack_frame_ptr sf);
 
+/* Returns the compiled automaton, or NULL if it is not compiled yet */
+automaton_t *automaton_expr_get_compiled(exprptr self);
+
+/* Returns the name of the state with the given index */
+const char *automaton_expr_get_state_name(exprptr self, size_t index);
+
+/* Returns true if the automaton captures variables */
+bool automaton_expr_has_captures(exprptr self);
+
 size_t automaton_expr_get_arity(exprptr self);
 
 size_t automaton_expr_get_pn_arity(exprptr self);
 
+exprptr optimize_automaton(exprptr self, optimizer_ptr opt);
+
 #endif
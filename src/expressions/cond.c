@@ -24,6 +24,8 @@
 #include <string.h>
 
 
+#include "../aot/aot.h"
+#include "../optimizer/optimizer.h"
 #include "../parser/parser.h"
 #include "../scanner/scanner.h"
 #include "../types/boolean.h"
@@ -33,6 +35,7 @@
 #include "../utils/list.h"
 #include "expression.h"
 #include "expression_base.h"
+#include "data.h"
 
 #define ERR_NO_LEFT_PARENTHESIS \
   "In cond expression, there is no left parenthesis at the beginning of case"
@@ -40,9 +43,15 @@
 #define ERR_NO_RIGHT_PARENTHESIS \
   "In cond expression, there is no right parenthesis at the end of case"
 
+#define ERR_NOT_BOOLEAN \
+  "Condition in cond expression does not yield a boolean."
+
 static const expr_vtable cond_expr_vtable = {.destroy = destroy_cond_expr,
                                              .to_string = cond_expr_tostring,
-                                             .interpret = interpret_cond};
+                                             .interpret = interpret_cond,
+                                             .optimize = optimize_cond,
+                                             .inline_copy = inline_copy_cond,
+                                             .emit = emit_cond};
 
 /* ((cond) expr-if-cond) */
 typedef struct {
@@ -154,8 +163,7 @@ objectptr interpret_cond(exprptr self, stack_frame_ptr sf) {
 
     if (!is_boolean(condition_result)) {
       delete_object(condition_result);
-      return make_error(
-          "Condition in cond expression does not yield a boolean.");
+      return make_error(ERR_NOT_BOOLEAN);
     }
 
     if (boolean_value(condition_result)) {
@@ -168,3 +176,106 @@ objectptr interpret_cond(exprptr self, stack_frame_ptr sf) {
 
   return make_void();
 }
+
+static void delete_cond_case(cond_case *c) {
+  delete_expr(c->condition);
+  delete_expr(c->true_case);
+  free(c);
+}
+
+/* true if the condition is the given boolean literal */
+static bool is_constant_condition(exprptr condition, bool value) {
+  if (!is_data_expr(condition)) {
+    return false;
+  }
+
+  objectptr obj = get_data_value(condition);
+  return is_boolean(obj) && boolean_value(obj) == value;
+}
+
+exprptr optimize_cond(exprptr self, optimizer_ptr opt) {
+  cond_expr *ce = self->data;
+  listptr remaining_cases = new_list();
+
+  /* Cases that can never be selected are removed */
+  size_t i = 0;
+  for (; i < list_size(ce->cases); ++i) {
+    cond_case *c = list_get(ce->cases, i);
+    c->condition = optimize_expr(c->condition, opt);
+    if (is_constant_condition(c->condition, false)) {
+      delete_cond_case(c);
+      continue;
+    }
+
+    c->true_case = optimize_expr(c->true_case, opt);
+    list_add(remaining_cases, c);
+    if (is_constant_condition(c->condition, true)) {
+      break;
+    }
+  }
+
+  /* Cases after a case that is always selected are unreachable */
+  for (i = i + 1; i < list_size(ce->cases); ++i) {
+    delete_cond_case(list_get(ce->cases, i));
+  }
+
+  delete_list(ce->cases);
+  ce->cases = remaining_cases;
+
+  if (list_size(ce->cases) == 0) {
+    objectptr void_obj = make_void();
+    exprptr result = expr_replace_with_data(self, void_obj);
+    delete_object(void_obj);
+    return result;
+  }
+
+  cond_case *first = list_get(ce->cases, 0);
+  if (is_constant_condition(first->condition, true)) {
+    return expr_replace_with_subexpr(self, first->true_case);
+  }
+
+  return self;
+}
+
+exprptr inline_copy_cond(exprptr self, optimizer_ptr opt) {
+  cond_expr *ce = self->data;
+  exprptr copy = expr_set_position(new_cond_expr(NULL), self);
+
+  for (size_t i = 0; i < list_size(ce->cases); ++i) {
+    cond_case *c = list_get(ce->cases, i);
+    exprptr condition = optimizer_copy_inlined(opt, c->condition);
+    exprptr true_case = optimizer_copy_inlined(opt, c->true_case);
+    if (!condition || !true_case) {
+      delete_expr(condition);
+      delete_expr(true_case);
+      delete_expr(copy);
+      return NULL;
+    }
+
+    cond_expr_add_case(copy, condition, true_case);
+  }
+
+  return copy;
+}
+
+bool emit_cond(exprptr self, aot_emitter_ptr em, size_t result) {
+  cond_expr *ce = self->data;
+  size_t ncases = list_size(ce->cases);
+
+  /* Each case is tested in the else branch of the previous one */
+  for (size_t i = 0; i < ncases; ++i) {
+    cond_case *cc = list_get(ce->cases, i);
+    size_t condition = aot_temp(em);
+    aot_emit_expr(em, cc->condition, condition);
+    aot_open_condition(em, condition, result, ERR_NOT_BOOLEAN);
+    aot_emit_expr(em, cc->true_case, result);
+    aot_reopen(em, "} else {");
+  }
+
+  aot_line(em, "t%zu = make_void();", result);
+  for (size_t i = 0; i < ncases; ++i) {
+    aot_close(em, "}");
+  }
+
+  return true;
+}
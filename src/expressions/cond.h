@@ -51,4 +51,13 @@ bool is_cond_expr(exprptr e);
 /* evaluates cond expression */
 objectptr interpret_cond(exprptr self, stack_frame_ptr sf);
 
+/* removes the cases whose conditions are literals */
+exprptr optimize_cond(exprptr self, optimizer_ptr opt);
+
+/* copies cond expression into an inlined procedure body */
+exprptr inline_copy_cond(exprptr self, optimizer_ptr opt);
+
+/* translates cond expression to C */
+bool emit_cond(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
@@ -20,6 +20,8 @@
 #include "data.h"
 #include "expression.h"
 #include "expression_base.h"
+#include "../aot/aot.h"
+#include "../jit/jit.h"
 #include <string.h>
 
 
@@ -33,7 +35,10 @@ static const char data_expr_name[] = "data_expr";
 static const expr_vtable data_expr_vtable = {
   .destroy = destroy_data_expr,
   .to_string = data_expr_tostring,
-  .interpret = interpret_data
+  .interpret = interpret_data,
+  .inline_copy = inline_copy_data,
+  .compile = compile_data,
+  .emit = emit_data
 };
 
 bool is_data_expr(exprptr e) {
@@ -71,3 +76,18 @@ objectptr interpret_data(exprptr self, stack_frame_ptr sf) {
   data_expr *de = self->data;
   return clone_object(de->obj);
 }
+
+exprptr inline_copy_data(exprptr self, optimizer_ptr opt) {
+  return clone_expr(self);
+}
+
+jit_node_ptr compile_data(exprptr self, jit_compiler_ptr jc) {
+  return jit_constant(jc, get_data_value(self));
+}
+
+bool emit_data(exprptr self, aot_emitter_ptr em, size_t result) {
+  char *constant = aot_constant(em, get_data_value(self));
+  aot_line(em, "t%zu = %s;", result, constant);
+  free(constant);
+  return true;
+}
@@ -48,4 +48,13 @@ bool is_data_expr(exprptr e);
 /* evaluates data expression */
 objectptr interpret_data(exprptr self, stack_frame_ptr sf);
 
+/* copies data expression into an inlined procedure body */
+exprptr inline_copy_data(exprptr self, optimizer_ptr opt);
+
+/* compiles data expression */
+jit_node_ptr compile_data(exprptr self, jit_compiler_ptr jc);
+
+/* translates data expression to C */
+bool emit_data(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
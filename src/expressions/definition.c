@@ -23,6 +23,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include "../aot/aot.h"
+#include "../optimizer/optimizer.h"
 #include "../utils/string.h"
 #include "../scanner/scanner.h"
 #include "../parser/parser.h"
@@ -53,7 +55,9 @@ bool is_definition_expr(exprptr e) {
 static const expr_vtable definition_expr_vtable = {
   .destroy = destroy_definition_expr,
   .to_string = definition_expr_tostring,
-  .interpret = interpret_definition
+  .interpret = interpret_definition,
+  .optimize = optimize_definition,
+  .emit = emit_definition
 };
 
 exprptr new_definition_expr(const char *name, exprptr body, tokenptr tkn) {
@@ -108,3 +112,27 @@ objectptr interpret_definition(exprptr self, stack_frame_ptr sf) {
   delete_object(value);
   return make_void();
 }
+
+exprptr optimize_definition(exprptr self, optimizer_ptr opt) {
+  definition_expr *de = self->data;
+  de->value = optimize_expr(de->value, opt);
+  optimizer_note_definition(opt, self, de->name, de->value);
+  return self;
+}
+
+bool emit_definition(exprptr self, aot_emitter_ptr em, size_t result) {
+  definition_expr *de = self->data;
+  size_t value = aot_temp(em);
+  aot_emit_expr(em, de->value, value);
+  aot_open_unless_error(em, value, result);
+
+  char *name = aot_quote(de->name);
+  aot_line(em, "stack_frame_set_global_variable(%s, %s, t%zu);",
+           aot_frame(em), name, value);
+  aot_line(em, "delete_object(t%zu);", value);
+  aot_line(em, "t%zu = make_void();", result);
+  aot_close(em, "}");
+  free(name);
+
+  return true;
+}
@@ -47,4 +47,10 @@ bool is_definition_expr(exprptr e);
 /* evaluates definition expression */
 objectptr interpret_definition(exprptr self, stack_frame_ptr ptr);
 
+/* optimizes the value of definition */
+exprptr optimize_definition(exprptr self, optimizer_ptr opt);
+
+/* translates definition expression to C */
+bool emit_definition(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
@@ -19,6 +19,7 @@
 
 #include "evaluation.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -27,12 +28,19 @@
 #include "../builtin/builtin.h"
 #include "../parser/parser.h"
 #include "../scanner/scanner.h"
+#include "../aot/aot.h"
+#include "../jit/jit.h"
+#include "../optimizer/optimizer.h"
+#include "../types/boolean.h"
 #include "../types/error.h"
+#include "../types/integer.h"
 #include "../types/procedure.h"
+#include "../types/real.h"
 #include "../types/null.h"
 #include "../types/pair.h"
 #include "../utils/string.h"
 #include "../utils/list.h"
+#include "data.h"
 #include "expanded.h"
 #include "expression.h"
 #include "expression_base.h"
@@ -49,10 +57,59 @@
 #define ERR_NOT_PROCEDURE "%s is not a procedure"
 #define ERR_EXPANDED_NOT_LIST "Expanded expression does not yield a list"
 
+/* Number of calls with the same operand types after which a call to
+ * an arithmetic or comparison builtin is specialized for those types */
+#define QUICKEN_THRESHOLD 2
+
+/* Number of times a call may fall back to the generic path before it is
+ * no longer specialized */
+#define MAX_DEOPTIMIZATIONS 4
+
+/* Number of leading arguments that may be passed as borrowed references */
+#define MAX_BORROWED_ARGS 64
+
+/* Binary builtin functions that have specialized implementations */
+typedef enum {
+  QUICK_UNKNOWN,
+  QUICK_NONE,
+  QUICK_ADD,
+  QUICK_SUB,
+  QUICK_MUL,
+  QUICK_EQ,
+  QUICK_NEQ,
+  QUICK_LT,
+  QUICK_LE,
+  QUICK_GT,
+  QUICK_GE
+} quick_op_t;
+
+static const struct {
+  const char *name;
+  quick_op_t op;
+} quick_ops[] = {{"+", QUICK_ADD}, {"-", QUICK_SUB}, {"*", QUICK_MUL},
+                 {"=", QUICK_EQ},  {"!=", QUICK_NEQ}, {"<", QUICK_LT},
+                 {"<=", QUICK_LE}, {">", QUICK_GT},  {">=", QUICK_GE}};
+
 /* (proc arg1 arg2 arg3 ...) */
 typedef struct {
   exprptr procexpr;
   listptr arguments; /* list of exprptr's */
+  /// Builtin function that is called, found on the first call
+  const builtin_function *builtin;
+  /// Specializable operation, found on the first call
+  quick_op_t quick_op;
+  /// Arguments whose values are borrowed when they are variables,
+  /// found on the first call
+  uint64_t borrowed_args;
+  /// True if only the value of the last argument is used, found on the
+  /// first call
+  bool discards_values;
+  /// Number of consecutive calls with integer operands
+  unsigned char integer_calls;
+  /// Number of consecutive calls with real operands
+  unsigned char real_calls;
+  /// Number of times the specialized implementation is abandoned
+  unsigned char deoptimizations;
 } evaluation_expr;
 
 static const char evaluation_expr_name[] = "evaluation_expr";
@@ -60,7 +117,34 @@ static const char evaluation_expr_name[] = "evaluation_expr";
 static const expr_vtable evaluation_expr_vtable = {
     .destroy = destroy_evaluation_expr,
     .to_string = evaluation_expr_tostring,
-    .interpret = interpret_evaluation};
+    .interpret = interpret_evaluation,
+    .optimize = optimize_evaluation,
+    .inline_copy = inline_copy_evaluation,
+    .compile = compile_evaluation,
+    .emit = emit_evaluation};
+
+static objectptr interpret_integer_evaluation(exprptr self,
+                                             stack_frame_ptr sf);
+static objectptr interpret_real_evaluation(exprptr self, stack_frame_ptr sf);
+
+/* Once a call is specialized, only its interpret operation changes */
+static const expr_vtable integer_evaluation_expr_vtable = {
+    .destroy = destroy_evaluation_expr,
+    .to_string = evaluation_expr_tostring,
+    .interpret = interpret_integer_evaluation,
+    .optimize = optimize_evaluation,
+    .inline_copy = inline_copy_evaluation,
+    .compile = compile_evaluation,
+    .emit = emit_evaluation};
+
+static const expr_vtable real_evaluation_expr_vtable = {
+    .destroy = destroy_evaluation_expr,
+    .to_string = evaluation_expr_tostring,
+    .interpret = interpret_real_evaluation,
+    .optimize = optimize_evaluation,
+    .inline_copy = inline_copy_evaluation,
+    .compile = compile_evaluation,
+    .emit = emit_evaluation};
 
 bool is_evaluation_expr(exprptr e) {
   if (e == NULL) {
@@ -74,6 +158,13 @@ exprptr new_evaluation_expr(exprptr proc, tokenptr tkn) {
   evaluation_expr *ee = malloc(sizeof *ee);
   ee->procexpr = proc;
   ee->arguments = new_list();
+  ee->builtin = NULL;
+  ee->quick_op = QUICK_UNKNOWN;
+  ee->borrowed_args = 0;
+  ee->discards_values = false;
+  ee->integer_calls = 0;
+  ee->real_calls = 0;
+  ee->deoptimizations = 0;
   
   return expr_base_new(ee, &evaluation_expr_vtable, evaluation_expr_name, tkn);
 }
@@ -139,8 +230,49 @@ exprptr evaluation_expr_parse(tokenstreamptr tkns, stack_frame_ptr sf) {
   return eval_expr;
 }
 
-static objectptr interpret_args(listptr arglist, size_t *argsize,
+/* Returns true if the argument at index i is passed as a borrowed
+ * reference. Only variables are borrowed. */
+static bool is_borrowed_arg(evaluation_expr *ee, size_t i, exprptr arg) {
+  return i < MAX_BORROWED_ARGS && (ee->borrowed_args >> i & 1) &&
+         arg->vtable->interpret == interpret_identifier;
+}
+
+/* Evaluates an argument. The value of a variable that can be borrowed is
+ * returned without cloning it. */
+static objectptr interpret_arg(evaluation_expr *ee, size_t i, exprptr arg,
+                               stack_frame_ptr sf) {
+  if (is_borrowed_arg(ee, i, arg)) {
+    /* Errors are returned as owned references by the interpreter */
+    objectptr value = stack_frame_peek_variable(sf, identifier_expr_get_name(arg));
+    if (value && !is_error(value)) {
+      return value;
+    }
+  }
+
+  return interpret_expr(arg, sf);
+}
+
+/* Deletes the arguments that are owned by the call */
+static void release_args(evaluation_expr *ee, size_t argsize, objectptr *args) {
+  if (ee->borrowed_args == 0) {
+    for (size_t i = 0; i < argsize; ++i) {
+      if (args[i]) {
+        delete_object(args[i]);
+      }
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < argsize; ++i) {
+    if (args[i] && !is_borrowed_arg(ee, i, list_get(ee->arguments, i))) {
+      delete_object(args[i]);
+    }
+  }
+}
+
+static objectptr interpret_args(evaluation_expr *ee, size_t *argsize,
                                stack_frame_ptr sf, objectptr **args) {
+  listptr arglist = ee->arguments;
   objectptr error = NULL;
 
   listptr evaluated_arglist = new_list();
@@ -162,19 +294,33 @@ static objectptr interpret_args(listptr arglist, size_t *argsize,
 
       delete_object(list_object);
     } else {
-      objectptr value = interpret_expr(expr, sf);
+      objectptr value = interpret_arg(ee, i, expr, sf);
       if (is_error(value)) {
         error = value;
         break;
       }
 
+      /* Values that are not used are deleted right away, so that they do
+       * not keep variables from being updated in place (see
+       * interpret_update) while the remaining arguments are evaluated */
+      if (ee->discards_values && i + 1 < list_size(arglist)) {
+        if (!is_borrowed_arg(ee, i, expr)) {
+          delete_object(value);
+        }
+        value = NULL;
+      }
+
       list_add(evaluated_arglist, value);
     }
   }
 
   if (error) {
     for (size_t i = 0; i < list_size(evaluated_arglist); i++) {
-      delete_object(list_get(evaluated_arglist, i));
+      objectptr value = list_get(evaluated_arglist, i);
+      if (value && (ee->borrowed_args == 0 ||
+                    !is_borrowed_arg(ee, i, list_get(arglist, i)))) {
+        delete_object(value);
+      }
     }
 
     delete_list(evaluated_arglist);
@@ -192,30 +338,77 @@ static objectptr interpret_args(listptr arglist, size_t *argsize,
   return NULL;
 }
 
-static bool interpret_builtin_call(exprptr procexpr, stack_frame_ptr sf,
-                                   size_t argsize, objectptr *evaluated_args,
-                                   objectptr *result) {
-  bool is_builtin_call = false;
-
-  if (is_identifier_expr(procexpr)) {
-    const char *name = identifier_expr_get_name(procexpr);
-    const builtin_function *func = find_builtin_function(name);
-    if (func) {
-      is_builtin_call = true;
-
-      if (func->variadic && func->arity > argsize) {
-        objectptr error = make_error(ERR_ARITY_AT_LEAST, name, func->arity, argsize);
-        *result = error;
-      } else if (!func->variadic && func->arity != argsize) {
-        objectptr error = make_error(ERR_ARITY, name, func->arity, argsize);
-        *result = error;
-      } else {
-        *result = func->func(argsize, evaluated_args, sf);
+/* A variable argument is passed as a borrowed reference when nothing that
+ * is evaluated after it can assign variables: the remaining arguments are
+ * variables or constants, and the procedure is a builtin function or a
+ * variable. Builtin functions do not use their arguments after running
+ * Theory Lisp code, and procedures clone their arguments into their stack
+ * frames before their bodies run. */
+static void find_borrowed_args(evaluation_expr *ee) {
+  ee->borrowed_args = 0;
+  ee->discards_values = false;
+  if (!ee->builtin && !is_identifier_expr(ee->procexpr)) {
+    return;
+  }
+
+  /* Expanded arguments change the positions of the remaining arguments */
+  for (size_t i = 0; i < list_size(ee->arguments); ++i) {
+    if (is_expanded_expression(list_get(ee->arguments, i))) {
+      return;
+    }
+  }
+
+  ee->discards_values = ee->builtin && ee->builtin->func == builtin_begin;
+
+  for (size_t i = list_size(ee->arguments); i > 0; --i) {
+    exprptr arg = list_get(ee->arguments, i - 1);
+    if (is_identifier_expr(arg)) {
+      if (i - 1 < MAX_BORROWED_ARGS) {
+        ee->borrowed_args |= (uint64_t)1 << (i - 1);
       }
+    } else if (!is_data_expr(arg)) {
+      break;
+    }
+  }
+}
+
+/* Builtin functions cannot be shadowed, so the builtin function that is
+ * called by an expression can be found once and remembered */
+static void resolve_builtin(evaluation_expr *ee) {
+  ee->quick_op = QUICK_NONE;
+  if (!is_identifier_expr(ee->procexpr)) {
+    find_borrowed_args(ee);
+    return;
+  }
+
+  const char *name = identifier_expr_get_name(ee->procexpr);
+  ee->builtin = find_builtin_function(name);
+  find_borrowed_args(ee);
+  if (!ee->builtin || list_size(ee->arguments) != 2 ||
+      is_expanded_expression(list_get(ee->arguments, 0)) ||
+      is_expanded_expression(list_get(ee->arguments, 1))) {
+    return;
+  }
+
+  for (size_t i = 0; i < sizeof quick_ops / sizeof *quick_ops; ++i) {
+    if (strcmp(name, quick_ops[i].name) == 0) {
+      ee->quick_op = quick_ops[i].op;
     }
   }
+}
+
+objectptr interpret_builtin_call(const builtin_function *func,
+                                 stack_frame_ptr sf, size_t argsize,
+                                 objectptr *evaluated_args) {
+  if (func->variadic && func->arity > argsize) {
+    return make_error(ERR_ARITY_AT_LEAST, func->name, func->arity, argsize);
+  }
+
+  if (!func->variadic && func->arity != argsize) {
+    return make_error(ERR_ARITY, func->name, func->arity, argsize);
+  }
 
-  return is_builtin_call;
+  return func->func(argsize, evaluated_args, sf);
 }
 
 static objectptr interpret_proc_call(exprptr procexpr, stack_frame_ptr sf,
@@ -230,40 +423,415 @@ static objectptr interpret_proc_call(exprptr procexpr, stack_frame_ptr sf,
   return result;
 }
 
+/* Calls the function with evaluated arguments */
+static objectptr interpret_call(evaluation_expr *ee, stack_frame_ptr sf,
+                                size_t argsize, objectptr *args) {
+  /* If the first argument is a name (identifier) of a builtin function,
+   * the builtin function is called. */
+  if (ee->builtin) {
+    return interpret_builtin_call(ee->builtin, sf, argsize, args);
+  }
+
+  /* If a builtin function is not found, the expression is
+   * recognized as a call to a user-defined function. */
+  return interpret_proc_call(ee->procexpr, sf, argsize, args);
+}
+
+/* Records the types of the operands of an arithmetic or comparison call,
+ * and specializes the call once the same types are seen repeatedly */
+static void record_operand_types(exprptr self, objectptr *args) {
+  evaluation_expr *ee = self->data;
+  bool integers = is_integer(args[0]) && is_integer(args[1]);
+  bool reals = !integers && is_real(args[0]) && is_real(args[1]);
+
+  ee->integer_calls = integers ? ee->integer_calls + 1 : 0;
+  ee->real_calls = reals ? ee->real_calls + 1 : 0;
+
+  if (ee->integer_calls >= QUICKEN_THRESHOLD) {
+    self->vtable = &integer_evaluation_expr_vtable;
+  } else if (ee->real_calls >= QUICKEN_THRESHOLD) {
+    self->vtable = &real_evaluation_expr_vtable;
+  }
+}
+
 objectptr interpret_evaluation(exprptr self, stack_frame_ptr sf) {
   objectptr result = NULL;
 
   evaluation_expr *evaluation_expr = self->data;
-  exprptr proc = evaluation_expr->procexpr;
-  listptr arglist = evaluation_expr->arguments;
   size_t argsize = 0;
 
   objectptr *args = NULL;
 
+  if (evaluation_expr->quick_op == QUICK_UNKNOWN) {
+    resolve_builtin(evaluation_expr);
+  }
+
   /* Evaluate arguments before calling the function.
    * All arguments must be fully evaluated before the function is called.
    * If an error occurs while evaluating arguments, the error is returned. */
   objectptr error = NULL;
-  if ((error = interpret_args(arglist, &argsize, sf, &args)) != NULL) {
-    result = error;
-    goto leave;
+  if ((error = interpret_args(evaluation_expr, &argsize, sf, &args)) != NULL) {
+    return error;
   }
 
-  /* If the first argument is a name (identifier), try to find a builtin function with
-   * that name. */
-  if (interpret_builtin_call(proc, sf, argsize, args, &result)) {
-    goto leave;
+  if (evaluation_expr->quick_op != QUICK_NONE) {
+    record_operand_types(self, args);
   }
 
-  /* If a builtin function is not found, the expression is
-   * recognized as a call to a user-defined function. */
-  result = interpret_proc_call(proc, sf, argsize, args);
+  result = interpret_call(evaluation_expr, sf, argsize, args);
+
+  /* Delete the owned arguments from the memory. */
+  release_args(evaluation_expr, argsize, args);
+  free(args);
+  return result;
+}
+
+/* Builtin functions that take over a temporary first argument and store
+ * their result in it */
+static bool updates_first_arg(const builtin_function *func) {
+  return func->func == builtin_add || func->func == builtin_mul ||
+         func->func == builtin_sub || func->func == builtin_strcat;
+}
+
+/* Returns true if the value of the variable at the first argument can be
+ * given to the builtin function. Arithmetic functions are given only
+ * numbers, so that they cannot fail after changing the value. */
+static bool can_update(evaluation_expr *ee, const char *name,
+                       size_t argsize, objectptr *args) {
+  if (!is_unique(args[0]) || is_temporary(args[0])) {
+    return false;
+  }
+
+  for (size_t i = 1; i < argsize; ++i) {
+    exprptr arg = list_get(ee->arguments, i);
+    if (is_identifier_expr(arg) &&
+        strcmp(identifier_expr_get_name(arg), name) == 0) {
+      return false;
+    }
+  }
+
+  if (ee->builtin->func == builtin_strcat) {
+    return true;
+  }
 
-  /* Delete arguments from the memory. */
-leave:
   for (size_t i = 0; i < argsize; ++i) {
-    delete_object(args[i]);
+    if (!is_number(args[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+objectptr interpret_update(exprptr self, const char *name,
+                           stack_frame_ptr sf) {
+  if (!is_evaluation_expr(self)) {
+    return NULL;
+  }
+
+  evaluation_expr *ee = self->data;
+  if (ee->quick_op == QUICK_UNKNOWN) {
+    resolve_builtin(ee);
+  }
+
+  if (!ee->builtin || !updates_first_arg(ee->builtin) ||
+      list_size(ee->arguments) < 2 ||
+      !is_borrowed_arg(ee, 0, list_get(ee->arguments, 0)) ||
+      strcmp(identifier_expr_get_name(list_get(ee->arguments, 0)), name) != 0) {
+    return NULL;
+  }
+
+  size_t argsize = 0;
+  objectptr *args = NULL;
+  objectptr error = NULL;
+  if ((error = interpret_args(ee, &argsize, sf, &args)) != NULL) {
+    return error;
+  }
+
+  /* The variable is set to the result by the set expression */
+  if (can_update(ee, name, argsize, args)) {
+    move(stack_frame_take_variable(sf, name));
   }
+
+  objectptr result = interpret_call(ee, sf, argsize, args);
+  release_args(ee, argsize, args);
   free(args);
   return result;
 }
+
+/* Evaluates both operands of a specialized call */
+static objectptr interpret_operands(evaluation_expr *ee, stack_frame_ptr sf,
+                                    objectptr *args) {
+  exprptr first = list_get(ee->arguments, 0);
+  args[0] = interpret_arg(ee, 0, first, sf);
+  if (is_error(args[0])) {
+    return args[0];
+  }
+
+  args[1] = interpret_arg(ee, 1, list_get(ee->arguments, 1), sf);
+  if (is_error(args[1])) {
+    if (!is_borrowed_arg(ee, 0, first)) {
+      delete_object(args[0]);
+    }
+    return args[1];
+  }
+
+  return NULL;
+}
+
+/* Returns to the generic implementation when the operands of a
+ * specialized call do not have the expected types */
+static objectptr deoptimize(exprptr self, stack_frame_ptr sf,
+                            objectptr *args) {
+  evaluation_expr *ee = self->data;
+  self->vtable = &evaluation_expr_vtable;
+  ee->integer_calls = 0;
+  ee->real_calls = 0;
+  if (++ee->deoptimizations >= MAX_DEOPTIMIZATIONS) {
+    ee->quick_op = QUICK_NONE;
+  }
+
+  objectptr result = interpret_call(ee, sf, 2, args);
+  release_args(ee, 2, args);
+  return result;
+}
+
+static objectptr interpret_integer_evaluation(exprptr self,
+                                             stack_frame_ptr sf) {
+  evaluation_expr *ee = self->data;
+  objectptr args[2];
+  objectptr error = interpret_operands(ee, sf, args);
+  if (error) {
+    return error;
+  }
+
+  if (!is_integer(args[0]) || !is_integer(args[1])) {
+    return deoptimize(self, sf, args);
+  }
+
+  integer_t x = int_value(args[0]);
+  integer_t y = int_value(args[1]);
+  release_args(ee, 2, args);
+
+  switch (ee->quick_op) {
+  case QUICK_ADD:
+    return make_integer(x + y);
+  case QUICK_SUB:
+    return make_integer(x - y);
+  case QUICK_MUL:
+    return make_integer(x * y);
+  case QUICK_EQ:
+    return make_boolean(x == y);
+  case QUICK_NEQ:
+    return make_boolean(x != y);
+  case QUICK_LT:
+    return make_boolean(x < y);
+  case QUICK_LE:
+    return make_boolean(x <= y);
+  case QUICK_GT:
+    return make_boolean(x > y);
+  case QUICK_GE:
+    return make_boolean(x >= y);
+  default:
+    abort();
+  }
+}
+
+/* The results are computed in the same way as the generic builtin
+ * functions compute them, so that NaNs and signed zeros give the
+ * same results. */
+static objectptr interpret_real_evaluation(exprptr self, stack_frame_ptr sf) {
+  evaluation_expr *ee = self->data;
+  objectptr args[2];
+  objectptr error = interpret_operands(ee, sf, args);
+  if (error) {
+    return error;
+  }
+
+  if (!is_real(args[0]) || !is_real(args[1])) {
+    return deoptimize(self, sf, args);
+  }
+
+  real_t x = real_value(args[0]);
+  real_t y = real_value(args[1]);
+  release_args(ee, 2, args);
+
+  switch (ee->quick_op) {
+  case QUICK_ADD:
+    return make_real((0 + x) + y);
+  case QUICK_SUB:
+    return make_real(x - y);
+  case QUICK_MUL:
+    return make_real((1 * x) * y);
+  case QUICK_EQ:
+    return make_boolean(x == y);
+  case QUICK_NEQ:
+    return make_boolean(!(x == y));
+  case QUICK_LT:
+    return make_boolean(x < y);
+  case QUICK_LE:
+    return make_boolean(x < y || x == y);
+  case QUICK_GT:
+    return make_boolean(!(x < y || x == y));
+  case QUICK_GE:
+    return make_boolean(!(x < y));
+  default:
+    abort();
+  }
+}
+
+exprptr optimize_evaluation(exprptr self, optimizer_ptr opt) {
+  evaluation_expr *ee = self->data;
+
+  /* A name in the call position is left as it is, since builtin functions
+   * are found by their names */
+  const char *name = NULL;
+  if (is_identifier_expr(ee->procexpr)) {
+    name = identifier_expr_get_name(ee->procexpr);
+    optimizer_note_call(opt, name);
+  } else {
+    ee->procexpr = optimize_expr(ee->procexpr, opt);
+  }
+
+  bool constant_arguments = true;
+  for (size_t i = 0; i < list_size(ee->arguments); ++i) {
+    exprptr arg = optimize_expr(list_get(ee->arguments, i), opt);
+    list_set(ee->arguments, i, arg);
+    constant_arguments = constant_arguments && is_data_expr(arg);
+  }
+
+  /* A call to a small procedure is replaced with its body */
+  if (name) {
+    exprptr inlined = optimizer_inline_call(opt, self, name, ee->arguments);
+    if (inlined) {
+      delete_expr(self);
+      return inlined;
+    }
+  }
+
+  /* A pure builtin call with literal arguments is replaced with its
+   * result. Errors are left to be reported at runtime. */
+  if (name && constant_arguments && optimizer_is_foldable_builtin(name)) {
+    objectptr value = interpret_expr(self, optimizer_stack_frame(opt));
+    if (!is_error(value)) {
+      exprptr result = expr_replace_with_data(self, value);
+      delete_object(value);
+      return result;
+    }
+    delete_object(value);
+  }
+
+  return self;
+}
+
+exprptr inline_copy_evaluation(exprptr self, optimizer_ptr opt) {
+  evaluation_expr *ee = self->data;
+  if (!is_identifier_expr(ee->procexpr)) {
+    return NULL;
+  }
+
+  const char *name = identifier_expr_get_name(ee->procexpr);
+  if (!optimizer_is_inlinable_call(opt, name)) {
+    return NULL;
+  }
+
+  exprptr procexpr =
+      expr_set_position(new_identifier_expr(name, NULL), ee->procexpr);
+  exprptr copy = expr_set_position(new_evaluation_expr(procexpr, NULL), self);
+  for (size_t i = 0; i < list_size(ee->arguments); ++i) {
+    exprptr arg = optimizer_copy_inlined(opt, list_get(ee->arguments, i));
+    if (!arg) {
+      delete_expr(copy);
+      return NULL;
+    }
+
+    evaluation_expr_add_arg(copy, arg);
+  }
+
+  return copy;
+}
+
+jit_node_ptr compile_evaluation(exprptr self, jit_compiler_ptr jc) {
+  evaluation_expr *ee = self->data;
+  if (!is_identifier_expr(ee->procexpr)) {
+    return NULL;
+  }
+
+  size_t nargs = list_size(ee->arguments);
+  for (size_t i = 0; i < nargs; ++i) {
+    if (is_expanded_expression(list_get(ee->arguments, i))) {
+      return NULL;
+    }
+  }
+
+  /* Arity errors are reported by the interpreter */
+  if (ee->quick_op == QUICK_UNKNOWN) {
+    resolve_builtin(ee);
+  }
+  const builtin_function *func = ee->builtin;
+  if (func && (func->variadic ? func->arity > nargs : func->arity != nargs)) {
+    return NULL;
+  }
+
+  jit_node_ptr *args = malloc(nargs * sizeof *args);
+  for (size_t i = 0; i < nargs; ++i) {
+    args[i] = jit_compile_expr(jc, list_get(ee->arguments, i));
+  }
+
+  return jit_call(jc, self, identifier_expr_get_name(ee->procexpr), func,
+                  nargs, args);
+}
+
+bool emit_evaluation(exprptr self, aot_emitter_ptr em, size_t result) {
+  evaluation_expr *ee = self->data;
+  size_t nargs = list_size(ee->arguments);
+  for (size_t i = 0; i < nargs; ++i) {
+    if (is_expanded_expression(list_get(ee->arguments, i))) {
+      return false;
+    }
+  }
+
+  if (ee->quick_op == QUICK_UNKNOWN) {
+    resolve_builtin(ee);
+  }
+
+  /* The arguments are evaluated from left to right until one of them
+   * yields an error */
+  size_t args = aot_unique(em);
+  aot_line(em, "t%zu = NULL;", result);
+  aot_line(em, "objectptr a%zu[%zu];", args, nargs > 0 ? nargs : 1);
+  for (size_t i = 0; i < nargs; ++i) {
+    if (i > 0) {
+      aot_open(em, "if (!t%zu) {", result);
+    }
+
+    size_t arg = aot_temp(em);
+    aot_emit_expr(em, list_get(ee->arguments, i), arg);
+    aot_open(em, "if (is_error(t%zu)) {", arg);
+    if (i > 0) {
+      aot_line(em, "aot_release(%zu, a%zu);", i, args);
+    }
+    aot_line(em, "t%zu = t%zu;", result, arg);
+    aot_reopen(em, "} else {");
+    aot_line(em, "a%zu[%zu] = t%zu;", args, i, arg);
+    aot_close(em, "}");
+
+    if (i > 0) {
+      aot_close(em, "}");
+    }
+  }
+
+  aot_open(em, "if (!t%zu) {", result);
+  if (ee->builtin) {
+    aot_line(em, "t%zu = aot_call_builtin(builtins[%zu], %zu, a%zu, %s);",
+             result, aot_builtin(em, ee->builtin), nargs, args, aot_frame(em));
+  } else {
+    size_t proc = aot_temp(em);
+    aot_emit_expr(em, ee->procexpr, proc);
+    aot_line(em, "t%zu = aot_call(t%zu, %zu, a%zu, %s);", result, proc, nargs,
+             args, aot_frame(em));
+  }
+  aot_close(em, "}");
+
+  return true;
+}
@@ -26,6 +26,7 @@
 #include "../utils/list.h"
 #include "../interpreter/interpreter.h"
 #include "../scanner/scanner.h"
+#include "../builtin/builtin.h"
 
 #include <stdbool.h>
 
@@ -51,4 +52,30 @@ bool is_evaluation_expr(exprptr e);
 /* evaluates evaluation expression */
 objectptr interpret_evaluation(exprptr self, stack_frame_ptr sf);
 
+/* evaluates the value of (set! name self) if self is a call to +, -, *
+ * or strcat whose first argument is the variable name. If nothing else
+ * refers to the value of the variable, the value is removed from the
+ * variable and the builtin function stores its result in it. Returns NULL
+ * if self is not such a call. */
+objectptr interpret_update(exprptr self, const char *name, stack_frame_ptr sf);
+
+/* calls a builtin function with evaluated arguments, or returns an error
+ * if the number of arguments does not match its arity */
+objectptr interpret_builtin_call(const builtin_function *func,
+                                 stack_frame_ptr sf, size_t argsize,
+                                 objectptr *evaluated_args);
+
+/* folds calls to pure builtin functions with literal arguments */
+exprptr optimize_evaluation(exprptr self, optimizer_ptr opt);
+
+/* copies the call into an inlined procedure body if the called
+ * function can be inlined as well */
+exprptr inline_copy_evaluation(exprptr self, optimizer_ptr opt);
+
+/* compiles a call */
+jit_node_ptr compile_evaluation(exprptr self, jit_compiler_ptr jc);
+
+/* translates a call to C */
+bool emit_evaluation(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
@@ -32,7 +32,8 @@ static const char expanded_expr_name[] = "expanded_expr";
 static const expr_vtable expanded_expr_vtable = {
   .destroy = destroy_expanded_expr,
   .to_string = expanded_expr_tostring,
-  .interpret = interpret_expanded_expr
+  .interpret = interpret_expanded_expr,
+  .optimize = optimize_expanded_expr
 };
 
 bool is_expanded_expression(exprptr e) {
@@ -62,4 +63,7 @@ objectptr interpret_expanded_expr(exprptr self, stack_frame_ptr sf) {
                     "as an argument in a function evaluation expression");
 }
 
-
+exprptr optimize_expanded_expr(exprptr self, optimizer_ptr opt) {
+  self->data = optimize_expr(self->data, opt);
+  return self;
+}
@@ -45,4 +45,7 @@ bool is_expanded_expression(exprptr e);
 /* expanded expression interpreter */
 objectptr interpret_expanded_expr(exprptr self, stack_frame_ptr sf);
 
+/* expanded expression optimizer */
+exprptr optimize_expanded_expr(exprptr self, optimizer_ptr opt);
+
 #endif
@@ -35,6 +35,7 @@
 #include "../types/void.h"
 #include "../types/internal.h"
 #include "../utils/list.h"
+#include "../utils/slab.h"
 #include "automaton.h"
 #include "data.h"
 #include "definition.h"
@@ -54,10 +55,15 @@
 #define ERR_INVALID_TOKEN "Invalid token"
 #define ERR_UNMATCHED_PARENTHESIS "Unmatched parenthesis"
 
+/* Number of expressions that are created and deleted */
+static size_t allocated_exprs = 0;
+static size_t freed_exprs = 0;
+
 /* base constructor */
 exprptr expr_base_new(void *data, const expr_vtable *vtable,
                       const char *expr_name, tokenptr tkn) {
-  exprptr e = malloc(sizeof *e);
+  exprptr e = slab_alloc(sizeof *e);
+  ++allocated_exprs;
   e->data = data;
   e->vtable = vtable;
   e->expr_name = expr_name;
@@ -69,12 +75,36 @@ exprptr expr_base_new(void *data, const expr_vtable *vtable,
 
 /* base clone */
 exprptr expr_base_clone(exprptr other, void *new_data) {
-  exprptr e = malloc(sizeof *e);
+  exprptr e = slab_alloc(sizeof *e);
+  ++allocated_exprs;
   *e = *other;
   e->data = new_data;
   return e;
 }
 
+/* replaces an expression with its constant value */
+exprptr expr_replace_with_data(exprptr self, objectptr value) {
+  exprptr result = new_data_expr(value, NULL);
+  result->line_number = self->line_number;
+  result->column_number = self->column_number;
+  delete_expr(self);
+  return result;
+}
+
+/* replaces an expression with one of its parts */
+exprptr expr_replace_with_subexpr(exprptr self, exprptr subexpr) {
+  exprptr result = clone_expr(subexpr);
+  delete_expr(self);
+  return result;
+}
+
+/* moves an expression to the position of another one */
+exprptr expr_set_position(exprptr self, exprptr origin) {
+  self->line_number = origin->line_number;
+  self->column_number = origin->column_number;
+  return self;
+}
+
 /* destroys and deallocates an expression */
 void delete_expr(exprptr self) {
   if (self != NULL) {
@@ -84,12 +114,19 @@ void delete_expr(exprptr self) {
       assert(self->vtable->destroy);
       if (--self->ref_count == 0) {
         self->vtable->destroy(self);
-        free(self);
+        slab_free(self, sizeof *self);
+        ++freed_exprs;
       }
     }
   }
 }
 
+/* prints the number of expressions that are created and deleted */
+void print_expr_stats(FILE *file) {
+  fprintf(file, "  expressions: %zu allocated, %zu freed\n", allocated_exprs,
+          freed_exprs);
+}
+
 /* clones an expression */
 exprptr clone_expr(exprptr self) {
   if (self != NULL) {
@@ -413,6 +450,42 @@ objectptr interpret_expr(exprptr self, stack_frame_ptr sf) {
   return self->vtable->interpret(self, sf);
 }
 
+/* optimizes an arbitrary expression */
+exprptr optimize_expr(exprptr self, optimizer_ptr opt) {
+  if (self->vtable->optimize) {
+    return self->vtable->optimize(self, opt);
+  }
+
+  return self;
+}
+
+/* copies an expression into the body of an inlined procedure */
+exprptr inline_copy_expr(exprptr self, optimizer_ptr opt) {
+  if (self->vtable->inline_copy) {
+    return self->vtable->inline_copy(self, opt);
+  }
+
+  return NULL;
+}
+
+/* compiles an expression */
+jit_node_ptr compile_expr(exprptr self, jit_compiler_ptr jc) {
+  if (self->vtable->compile) {
+    return self->vtable->compile(self, jc);
+  }
+
+  return NULL;
+}
+
+/* translates an expression to C */
+bool emit_expr(exprptr self, aot_emitter_ptr em, size_t result) {
+  if (self->vtable->emit) {
+    return self->vtable->emit(self, em, result);
+  }
+
+  return false;
+}
+
 /* calls an expression with given closure, arguments and stack frame */
 objectptr expr_call(exprptr self, size_t nargs, objectptr *args,
                     stack_frame_ptr sf) {
@@ -30,12 +30,27 @@
 struct expr;
 typedef struct expr *exprptr;
 
+struct optimizer;
+typedef struct optimizer *optimizer_ptr;
+
+struct jit_compiler;
+typedef struct jit_compiler *jit_compiler_ptr;
+
+struct jit_node;
+typedef struct jit_node *jit_node_ptr;
+
+struct aot_emitter;
+typedef struct aot_emitter *aot_emitter_ptr;
+
 /* Expression clone */
 exprptr clone_expr(exprptr self);
 
 /* Expression "delete" operation */
 void delete_expr(exprptr self);
 
+/* Prints the number of expressions that are created and deleted */
+void print_expr_stats(FILE *file);
+
 /* Expression tostring */
 char *expr_tostring(exprptr self);
 
@@ -45,6 +60,26 @@ exprptr expr_parse(tokenstreamptr tkns, stack_frame_ptr sf);
 /* Expression interpreter */
 objectptr interpret_expr(exprptr self, stack_frame_ptr sf);
 
+/* Expression optimizer. Takes ownership of self and returns either self
+ * or an equivalent expression that replaces it. */
+exprptr optimize_expr(exprptr self, optimizer_ptr opt);
+
+/* Gives self the position of origin in the source code */
+exprptr expr_set_position(exprptr self, exprptr origin);
+
+/* Copies self into the body of an inlined procedure, renaming its
+ * parameters. Returns NULL if self cannot be inlined. */
+exprptr inline_copy_expr(exprptr self, optimizer_ptr opt);
+
+/* Compiles self into a node of compiled code. Returns NULL if self
+ * has no compiled form. */
+jit_node_ptr compile_expr(exprptr self, jit_compiler_ptr jc);
+
+/* Writes C code that stores the value of self in the temporary variable
+ * result of the generated program. Returns false without writing
+ * anything if self has no translation to C. */
+bool emit_expr(exprptr self, aot_emitter_ptr em, size_t result);
+
 /* Expression function call operator */
 objectptr expr_call(exprptr e, size_t nargs,
                    objectptr *args, stack_frame_ptr sf);
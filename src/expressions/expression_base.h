@@ -43,6 +43,10 @@ typedef struct {
   objectptr (*call_internal)(exprptr e, void *args, stack_frame_ptr sf);
   size_t (*get_arity)(exprptr e);
   size_t (*get_pn_arity)(exprptr e);
+  exprptr (*optimize)(exprptr e, optimizer_ptr opt);
+  exprptr (*inline_copy)(exprptr e, optimizer_ptr opt);
+  jit_node_ptr (*compile)(exprptr e, jit_compiler_ptr jc);
+  bool (*emit)(exprptr e, aot_emitter_ptr em, size_t result);
 } expr_vtable;
 
 /* Expression */
@@ -62,4 +66,11 @@ exprptr expr_base_new(void *data, const expr_vtable *vtable, const char *expr_na
 /* Expression base copy constructor */
 exprptr expr_base_clone(exprptr other, void *new_data);
 
+/* Replaces self with a data expression at the same position
+ * in the source code */
+exprptr expr_replace_with_data(exprptr self, objectptr value);
+
+/* Replaces self with one of its subexpressions */
+exprptr expr_replace_with_subexpr(exprptr self, exprptr subexpr);
+
 #endif
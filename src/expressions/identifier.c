@@ -25,6 +25,10 @@
 
 #include "expression.h"
 #include "expression_base.h"
+#include "data.h"
+#include "../aot/aot.h"
+#include "../jit/jit.h"
+#include "../optimizer/optimizer.h"
 
 /* identifier */
 typedef struct {
@@ -36,7 +40,11 @@ static const char identifier_expr_name[] = "identifier_expr";
 static const expr_vtable identifier_expr_vtable = {
   .destroy = destroy_identifier_expr,
   .to_string = identifier_expr_tostring,
-  .interpret = interpret_identifier
+  .interpret = interpret_identifier,
+  .optimize = optimize_identifier,
+  .inline_copy = inline_copy_identifier,
+  .compile = compile_identifier,
+  .emit = emit_identifier
 };
 
 bool is_identifier_expr(exprptr e) {
@@ -75,3 +83,52 @@ objectptr interpret_identifier(exprptr self, stack_frame_ptr sf) {
   objectptr result = stack_frame_get_variable(sf, ie->name);
   return result;
 }
+
+exprptr optimize_identifier(exprptr self, optimizer_ptr opt) {
+  identifier_expr *ie = self->data;
+  optimizer_note_reference(opt, ie->name);
+  objectptr value = optimizer_get_constant(opt, ie->name);
+  if (value) {
+    return expr_replace_with_data(self, value);
+  }
+
+  return self;
+}
+
+exprptr inline_copy_identifier(exprptr self, optimizer_ptr opt) {
+  identifier_expr *ie = self->data;
+  exprptr replacement = optimizer_get_replacement(opt, ie->name);
+  if (replacement) {
+    return clone_expr(replacement);
+  }
+
+  /* Since variables are dynamically scoped, any other variable may be
+   * bound by the caller or by a procedure that calls it, under a name
+   * that is renamed in the inlined body. Only the constants and the
+   * variables of the bodies that are already inlined, whose names
+   * contain '%', can be read. */
+  objectptr value = optimizer_get_constant(opt, ie->name);
+  if (value) {
+    return expr_set_position(new_data_expr(value, NULL), self);
+  }
+
+  if (strchr(ie->name, '%')) {
+    return expr_set_position(new_identifier_expr(ie->name, NULL), self);
+  }
+
+  return NULL;
+}
+
+jit_node_ptr compile_identifier(exprptr self, jit_compiler_ptr jc) {
+  identifier_expr *ie = self->data;
+  return jit_variable(jc, ie->name);
+}
+
+bool emit_identifier(exprptr self, aot_emitter_ptr em, size_t result) {
+  identifier_expr *ie = self->data;
+  char *name = aot_quote(ie->name);
+  aot_line(em, "t%zu = stack_frame_get_variable(%s, %s);", result,
+           aot_frame(em), name);
+  free(name);
+  return true;
+}
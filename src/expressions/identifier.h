@@ -46,4 +46,17 @@ bool is_identifier_expr(exprptr e);
 /* evaluates identifier expression */
 objectptr interpret_identifier(exprptr self, stack_frame_ptr sf);
 
+/* replaces the identifier with its value if it is a constant */
+exprptr optimize_identifier(exprptr self, optimizer_ptr opt);
+
+/* copies the identifier into an inlined procedure body,
+ * replacing it if it is a parameter */
+exprptr inline_copy_identifier(exprptr self, optimizer_ptr opt);
+
+/* compiles identifier expression */
+jit_node_ptr compile_identifier(exprptr self, jit_compiler_ptr jc);
+
+/* translates identifier expression to C */
+bool emit_identifier(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
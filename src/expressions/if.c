@@ -23,6 +23,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../aot/aot.h"
+#include "../jit/jit.h"
+#include "../optimizer/optimizer.h"
 #include "../parser/parser.h"
 #include "../scanner/scanner.h"
 #include "../types/boolean.h"
@@ -30,6 +33,9 @@
 #include "../utils/string.h"
 #include "expression.h"
 #include "expression_base.h"
+#include "data.h"
+
+#define ERR_NOT_BOOLEAN "Condition in if expression does not yield a boolean."
 
 /* (if (cond) true-case false-case) */
 typedef struct {
@@ -42,7 +48,11 @@ static const char if_expr_name[] = "if_expr";
 
 static const expr_vtable if_expr_vtable = {.destroy = destroy_if_expr,
                                            .to_string = if_expr_tostring,
-                                           .interpret = interpret_if};
+                                           .interpret = interpret_if,
+                                           .optimize = optimize_if,
+                                           .inline_copy = inline_copy_if,
+                                           .compile = compile_if,
+                                           .emit = emit_if};
 
 bool is_if_expr(exprptr e) {
   if (e == NULL) {
@@ -111,7 +121,7 @@ objectptr interpret_if(exprptr self, stack_frame_ptr sf) {
 
   if (!is_boolean(condition_result)) {
     delete_object(condition_result);
-    return make_error("Condition in if expression does not yield a boolean.");
+    return make_error(ERR_NOT_BOOLEAN);
   }
 
   exprptr case_expr = NULL;
@@ -125,3 +135,55 @@ objectptr interpret_if(exprptr self, stack_frame_ptr sf) {
   delete_object(condition_result);
   return result;
 }
+
+exprptr optimize_if(exprptr self, optimizer_ptr opt) {
+  if_expr *ie = self->data;
+  ie->condition = optimize_expr(ie->condition, opt);
+  ie->true_case = optimize_expr(ie->true_case, opt);
+  ie->false_case = optimize_expr(ie->false_case, opt);
+
+  if (is_data_expr(ie->condition) &&
+      is_boolean(get_data_value(ie->condition))) {
+    bool condition = boolean_value(get_data_value(ie->condition));
+    return expr_replace_with_subexpr(
+        self, condition ? ie->true_case : ie->false_case);
+  }
+
+  return self;
+}
+
+exprptr inline_copy_if(exprptr self, optimizer_ptr opt) {
+  if_expr *ie = self->data;
+  exprptr condition = optimizer_copy_inlined(opt, ie->condition);
+  exprptr true_case = optimizer_copy_inlined(opt, ie->true_case);
+  exprptr false_case = optimizer_copy_inlined(opt, ie->false_case);
+
+  if (!condition || !true_case || !false_case) {
+    delete_expr(condition);
+    delete_expr(true_case);
+    delete_expr(false_case);
+    return NULL;
+  }
+
+  exprptr copy = new_if_expr(condition, true_case, false_case, NULL);
+  return expr_set_position(copy, self);
+}
+
+jit_node_ptr compile_if(exprptr self, jit_compiler_ptr jc) {
+  if_expr *ie = self->data;
+  return jit_if(jc, jit_compile_expr(jc, ie->condition),
+                jit_compile_expr(jc, ie->true_case),
+                jit_compile_expr(jc, ie->false_case));
+}
+
+bool emit_if(exprptr self, aot_emitter_ptr em, size_t result) {
+  if_expr *ie = self->data;
+  size_t condition = aot_temp(em);
+  aot_emit_expr(em, ie->condition, condition);
+  aot_open_condition(em, condition, result, ERR_NOT_BOOLEAN);
+  aot_emit_expr(em, ie->true_case, result);
+  aot_reopen(em, "} else {");
+  aot_emit_expr(em, ie->false_case, result);
+  aot_close(em, "}");
+  return true;
+}
@@ -48,4 +48,16 @@ bool is_if_expr(exprptr e);
 /* evaluates if expression */
 objectptr interpret_if(exprptr self, stack_frame_ptr sf);
 
+/* selects the case if the condition is a literal */
+exprptr optimize_if(exprptr self, optimizer_ptr opt);
+
+/* copies if expression into an inlined procedure body */
+exprptr inline_copy_if(exprptr self, optimizer_ptr opt);
+
+/* compiles if expression */
+jit_node_ptr compile_if(exprptr self, jit_compiler_ptr jc);
+
+/* translates if expression to C */
+bool emit_if(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
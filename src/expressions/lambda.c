@@ -28,6 +28,9 @@
 #include "../scanner/scanner.h"
 #include "../types/error.h"
 #include "../types/procedure.h"
+#include "../aot/aot.h"
+#include "../jit/jit.h"
+#include "../optimizer/optimizer.h"
 #include "../utils/string.h"
 #include "../utils/list.h"
 #include "../builtin/list.h"
@@ -65,6 +68,10 @@ typedef struct {
   listptr captured_vars; /* list of char*'s */
   listptr params; /* list of char*'s */
   exprptr body;
+  /// Number of calls before the lambda is compiled
+  size_t calls;
+  /// Compiled body, or NULL if the body is interpreted
+  jit_code_ptr code;
 } lambda_expr;
 
 static const expr_vtable lambda_expr_vtable = {
@@ -73,7 +80,9 @@ static const expr_vtable lambda_expr_vtable = {
     .interpret = lambda_interpret,
     .call = lambda_call,
     .get_arity = lambda_expr_get_arity,
-    .get_pn_arity = lambda_expr_get_pn_arity
+    .get_pn_arity = lambda_expr_get_pn_arity,
+    .optimize = optimize_lambda,
+    .emit = emit_lambda
 };
 
 bool is_lambda_expr(exprptr e) {
@@ -91,6 +100,8 @@ exprptr new_lambda_expr(exprptr body, bool variadic, tokenptr tkn) {
   le->body = body;
   le->variadic = variadic;
   le->pn_arity = 0;
+  le->calls = 0;
+  le->code = NULL;
 
   return expr_base_new(le, &lambda_expr_vtable, lambda_expr_name, tkn);
 }
@@ -98,6 +109,9 @@ exprptr new_lambda_expr(exprptr body, bool variadic, tokenptr tkn) {
 void destroy_lambda_expr(exprptr self) {
   lambda_expr *expr = self->data;
   delete_expr(expr->body);
+  if (expr->code) {
+    delete_jit_code(expr->code);
+  }
 
   for (size_t i = 0; i < list_size(expr->params); ++i) {
     char *param = list_get(expr->params, i);
@@ -144,6 +158,27 @@ bool lambda_expr_is_variadic(exprptr self) {
   return le->variadic;
 }
 
+const char *lambda_expr_get_param(exprptr self, size_t index) {
+  lambda_expr *le = self->data;
+  return list_get(le->params, index);
+}
+
+bool lambda_expr_has_captures(exprptr self) {
+  lambda_expr *le = self->data;
+  return list_size(le->captured_vars) > 0;
+}
+
+exprptr lambda_expr_get_body(exprptr self) {
+  lambda_expr *le = self->data;
+  return le->body;
+}
+
+void lambda_expr_set_body(exprptr self, exprptr body) {
+  lambda_expr *le = self->data;
+  delete_expr(le->body);
+  le->body = body;
+}
+
 /**
  * Helper function of lambda_expr_tostring to print a list of strings
  * with spaces between them.
@@ -370,6 +405,50 @@ objectptr lambda_call(exprptr self, size_t nargs, objectptr *args,
     delete_object(args_object); 
   }
 
+  /* A lambda that is called frequently is compiled once */
+  if (le->calls <= JIT_THRESHOLD && jit_get_mode() != JIT_OFF &&
+      ++le->calls == JIT_THRESHOLD) {
+    le->code = jit_compile(le->body, le->params);
+  }
+
   /* Compute the result */
+  if (le->code) {
+    return jit_run(le->code, nargs, args, local_frame);
+  }
+
   return interpret_expr(le->body, local_frame);
 }
+
+/*
+ * Optimizes the body of lambda.
+ */
+exprptr optimize_lambda(exprptr self, optimizer_ptr opt) {
+  lambda_expr *le = self->data;
+  for (size_t i = 0; i < list_size(le->params); ++i) {
+    optimizer_note_binding(opt, list_get(le->params, i));
+  }
+
+  for (size_t i = 0; i < list_size(le->captured_vars); ++i) {
+    optimizer_note_binding(opt, list_get(le->captured_vars, i));
+  }
+
+  if (le->variadic) {
+    optimizer_note_binding(opt, "va_args");
+  }
+
+  le->body = optimize_expr(le->body, opt);
+  return self;
+}
+
+/*
+ * Translates the body of lambda into a C function. The procedure object
+ * is still created by the lambda expression, which is parsed when the
+ * generated program starts.
+ */
+bool emit_lambda(exprptr self, aot_emitter_ptr em, size_t result) {
+  lambda_expr *le = self->data;
+  size_t index = aot_lambda(em, self, le->body);
+  aot_line(em, "t%zu = interpret_expr(lambdas[%zu], %s);", result, index,
+           aot_frame(em));
+  return true;
+}
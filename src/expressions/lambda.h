@@ -55,6 +55,18 @@ size_t lambda_expr_get_arity(exprptr self);
 /* Returns whether lambda is variadic */
 bool lambda_expr_is_variadic(exprptr self);
 
+/* Returns the name of the formal parameter at the given index */
+const char *lambda_expr_get_param(exprptr self, size_t index);
+
+/* Returns whether lambda captures variables from its environment */
+bool lambda_expr_has_captures(exprptr self);
+
+/* Returns the body of the lambda function */
+exprptr lambda_expr_get_body(exprptr self);
+
+/* Replaces the body of the lambda function and deletes the previous body */
+void lambda_expr_set_body(exprptr self, exprptr body);
+
 /* Lambda expression tostring implementation */
 char *lambda_expr_tostring(exprptr self);
 
@@ -71,4 +83,10 @@ objectptr lambda_interpret(exprptr self, stack_frame_ptr sf);
 objectptr lambda_call(exprptr lambda, size_t nargs,
                      objectptr *args, stack_frame_ptr sf);
 
+/* optimizes the body of lambda */
+exprptr optimize_lambda(exprptr self, optimizer_ptr opt);
+
+/* translates the body of lambda to C */
+bool emit_lambda(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
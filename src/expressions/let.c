@@ -23,6 +23,8 @@
 #include <string.h>
 
 #include "../scanner/scanner.h"
+#include "../aot/aot.h"
+#include "../optimizer/optimizer.h"
 #include "../utils/string.h"
 #include "../utils/list.h"
 #include "expression.h"
@@ -61,7 +63,10 @@ typedef struct {
 
 static const expr_vtable let_expr_vtable = {.destroy = destroy_let_expr,
                                             .to_string = let_expr_tostring,
-					                                  .interpret = interpret_let};
+					                                  .interpret = interpret_let,
+                                            .optimize = optimize_let,
+                                            .inline_copy = inline_copy_let,
+                                            .emit = emit_let};
 
 static const char let_expr_name[] = "let_expr";
 
@@ -215,3 +220,75 @@ objectptr interpret_let(exprptr self, stack_frame_ptr sf) {
   delete_stack_frame(new_frame);
   return result;
 }
+
+exprptr optimize_let(exprptr self, optimizer_ptr opt) {
+  let_expr *le = self->data;
+  for (size_t i = 0; i < list_size(le->declarations); ++i) {
+    var_declaration *decl = list_get(le->declarations, i);
+    optimizer_note_binding(opt, decl->name);
+    decl->value = optimize_expr(decl->value, opt);
+  }
+
+  le->body = optimize_expr(le->body, opt);
+  return self;
+}
+
+exprptr inline_copy_let(exprptr self, optimizer_ptr opt) {
+  let_expr *le = self->data;
+
+  /* Only the let expressions that bind renamed parameters of inlined
+   * procedures are copied. Their names contain '%', so they cannot be
+   * seen by any other expression and do not need to be renamed again. */
+  for (size_t i = 0; i < list_size(le->declarations); ++i) {
+    var_declaration *decl = list_get(le->declarations, i);
+    if (!strchr(decl->name, '%')) {
+      return NULL;
+    }
+  }
+
+  exprptr body = optimizer_copy_inlined(opt, le->body);
+  if (!body) {
+    return NULL;
+  }
+
+  exprptr copy = expr_set_position(new_let_expr(body, NULL), self);
+  for (size_t i = 0; i < list_size(le->declarations); ++i) {
+    var_declaration *decl = list_get(le->declarations, i);
+    exprptr value = optimizer_copy_inlined(opt, decl->value);
+    if (!value) {
+      delete_expr(copy);
+      return NULL;
+    }
+
+    let_expr_add_declaration(copy, decl->name, value);
+  }
+
+  return copy;
+}
+
+bool emit_let(exprptr self, aot_emitter_ptr em, size_t result) {
+  let_expr *le = self->data;
+  size_t ndeclarations = list_size(le->declarations);
+
+  aot_enter_frame(em);
+  for (size_t i = 0; i < ndeclarations; ++i) {
+    var_declaration *decl = list_get(le->declarations, i);
+    size_t value = aot_temp(em);
+    aot_emit_expr(em, decl->value, value);
+    aot_open_unless_error(em, value, result);
+
+    char *name = aot_quote(decl->name);
+    aot_line(em, "stack_frame_set_local_variable(%s, %s, t%zu);",
+             aot_frame(em), name, value);
+    aot_line(em, "delete_object(t%zu);", value);
+    free(name);
+  }
+
+  aot_emit_expr(em, le->body, result);
+  for (size_t i = 0; i < ndeclarations; ++i) {
+    aot_close(em, "}");
+  }
+  aot_leave_frame(em);
+
+  return true;
+}
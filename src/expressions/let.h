@@ -50,4 +50,14 @@ bool is_let_expr(exprptr e);
 /* evaluates let expression */
 objectptr interpret_let(exprptr self, stack_frame_ptr sf);
 
+/* optimizes the declared values and the body */
+exprptr optimize_let(exprptr self, optimizer_ptr opt);
+
+/* copies a let expression that was created by the inliner into
+ * another inlined procedure body */
+exprptr inline_copy_let(exprptr self, optimizer_ptr opt);
+
+/* translates let expression to C */
+bool emit_let(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
@@ -0,0 +1,71 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "native.h"
+
+#include <string.h>
+
+#include "expression.h"
+#include "expression_base.h"
+
+/* native */
+typedef struct {
+  native_function function;
+  char *source;
+} native_expr;
+
+static const char native_expr_name[] = "native_expr";
+
+static const expr_vtable native_expr_vtable = {
+  .destroy = destroy_native_expr,
+  .to_string = native_expr_tostring,
+  .interpret = interpret_native
+};
+
+bool is_native_expr(exprptr e) {
+  if (e == NULL) {
+    return false;
+  }
+
+  return strcmp(e->expr_name, native_expr_name) == 0;
+}
+
+exprptr new_native_expr(native_function function, const char *source) {
+  native_expr *ne = malloc(sizeof *ne);
+  ne->function = function;
+  ne->source = strdup(source);
+
+  return expr_base_new(ne, &native_expr_vtable, native_expr_name, NULL);
+}
+
+void destroy_native_expr(exprptr self) {
+  native_expr *ne = self->data;
+  free(ne->source);
+  free(ne);
+}
+
+char *native_expr_tostring(exprptr self) {
+  native_expr *ne = self->data;
+  return strdup(ne->source);
+}
+
+objectptr interpret_native(exprptr self, stack_frame_ptr sf) {
+  native_expr *ne = self->data;
+  return ne->function(sf);
+}
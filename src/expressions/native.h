@@ -0,0 +1,51 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file native.h
+
+#ifndef THEORYLISP_EXPRESSIONS_NATIVE_H
+#define THEORYLISP_EXPRESSIONS_NATIVE_H
+
+#include "expression.h"
+
+#include <stdbool.h>
+
+#include "../interpreter/stack_frame.h"
+
+/* A native expression is evaluated by a C function. It is used for the
+ * bodies of lambdas in programs that are translated to C. */
+typedef objectptr (*native_function)(stack_frame_ptr sf);
+
+/* native_expr "new" operation. source is the expression that the
+ * function computes, and it is used as the string representation. */
+exprptr new_native_expr(native_function function, const char *source);
+
+/* native_expr "delete" operation */
+void destroy_native_expr(exprptr self);
+
+/* native_expr tostring implementation */
+char *native_expr_tostring(exprptr self);
+
+/* true if e is native expression */
+bool is_native_expr(exprptr e);
+
+/* evaluates native expression */
+objectptr interpret_native(exprptr self, stack_frame_ptr sf);
+
+#endif
@@ -26,6 +26,7 @@
 #include "../interpreter/variable.h"
 #include "../scanner/scanner.h"
 #include "../parser/parser.h"
+#include "../optimizer/optimizer.h"
 #include "../utils/string.h"
 #include "../utils/stack.h"
 #include "../types/error.h"
@@ -53,6 +54,7 @@ static const expr_vtable pn_expr_vtable = {
   .call = pn_expr_call,
   .get_arity = pn_expr_get_arity,
   .get_pn_arity = pn_expr_get_pn_arity,
+  .optimize = optimize_pn_expr,
 };
 
 bool is_pn_expr(exprptr e) {
@@ -156,6 +158,13 @@ void pn_expr_add_captured_var(exprptr self, char *name) {
   list_add(pe->captured, strdup(name));
 }
 
+/**
+ * Returns the expressions in the PN expression body
+ */
+listptr pn_expr_get_body(exprptr self) {
+  return ((pn_expr *)self->data)->body;
+}
+
 /**
  * Parses PN expression
  * A PN expression can be one of the following
@@ -387,3 +396,20 @@ size_t pn_expr_get_arity(exprptr self) {
 size_t pn_expr_get_pn_arity(exprptr self) {
   return ((pn_expr *)self->data)->pn_arity;
 }
+
+/**
+ * Optimizes each expression in the body
+ */
+exprptr optimize_pn_expr(exprptr self, optimizer_ptr opt) {
+  pn_expr *pe = self->data;
+  for (size_t i = 0; i < list_size(pe->captured); ++i) {
+    optimizer_note_binding(opt, list_get(pe->captured, i));
+  }
+  optimizer_note_binding(opt, "nargs");
+
+  for (size_t i = 0; i < list_size(pe->body); ++i) {
+    list_set(pe->body, i, optimize_expr(list_get(pe->body, i), opt));
+  }
+
+  return self;
+}
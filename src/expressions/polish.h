@@ -38,6 +38,9 @@ char *pn_expr_tostring(exprptr self);
 /* Adds argument to a PN expression */
 void pn_expr_add_body_expr(exprptr self, exprptr body_expr);
 
+/* Returns the list of body expressions */
+listptr pn_expr_get_body(exprptr self);
+
 /* PN expression parser */
 exprptr pn_expr_parse(tokenstreamptr tkns, stack_frame_ptr sf);
 
@@ -57,4 +60,7 @@ size_t pn_expr_get_arity(exprptr self);
 /* Returns PN arity of the PN expression */
 size_t pn_expr_get_pn_arity(exprptr self);
 
+/* Optimizes the body of the PN expression */
+exprptr optimize_pn_expr(exprptr self, optimizer_ptr opt);
+
 #endif
@@ -20,9 +20,12 @@
 #include "set.h"
 #include "expression.h"
 #include "expression_base.h"
+#include "evaluation.h"
 #include <string.h>
 #include <assert.h>
 
+#include "../aot/aot.h"
+#include "../optimizer/optimizer.h"
 #include "../utils/string.h"
 #include "../scanner/scanner.h"
 #include "../parser/parser.h"
@@ -53,7 +56,9 @@ bool is_set_expr(exprptr e) {
 static const expr_vtable set_expr_vtable = {
   .destroy = destroy_set_expr,
   .to_string = set_expr_tostring,
-  .interpret = interpret_set
+  .interpret = interpret_set,
+  .optimize = optimize_set,
+  .emit = emit_set
 };
 
 exprptr new_set_expr(const char *name, exprptr body, tokenptr tkn) {
@@ -99,7 +104,11 @@ exprptr set_expr_parse(tokenstreamptr tkns, stack_frame_ptr sf) {
 
 objectptr interpret_set(exprptr self, stack_frame_ptr sf) {
   set_expr *se = self->data;
-  objectptr value = interpret_expr(se->value, sf);
+  objectptr value = interpret_update(se->value, se->name, sf);
+  if (value == NULL) {
+    value = interpret_expr(se->value, sf);
+  }
+
   if (is_error(value)) {
     return value;
   }
@@ -107,3 +116,26 @@ objectptr interpret_set(exprptr self, stack_frame_ptr sf) {
   stack_frame_set_variable(sf, se->name, value);
   return value;
 }
+
+exprptr optimize_set(exprptr self, optimizer_ptr opt) {
+  set_expr *se = self->data;
+  optimizer_note_assignment(opt, se->name);
+  se->value = optimize_expr(se->value, opt);
+  return self;
+}
+
+bool emit_set(exprptr self, aot_emitter_ptr em, size_t result) {
+  set_expr *se = self->data;
+  size_t value = aot_temp(em);
+  aot_emit_expr(em, se->value, value);
+  aot_open_unless_error(em, value, result);
+
+  char *name = aot_quote(se->name);
+  aot_line(em, "stack_frame_set_variable(%s, %s, t%zu);", aot_frame(em), name,
+           value);
+  aot_line(em, "t%zu = t%zu;", result, value);
+  aot_close(em, "}");
+  free(name);
+
+  return true;
+}
@@ -47,4 +47,10 @@ bool is_set_expr(exprptr e);
 /* evaluates set expression */
 objectptr interpret_set(exprptr self, stack_frame_ptr ptr);
 
+/* optimizes the assigned value */
+exprptr optimize_set(exprptr self, optimizer_ptr opt);
+
+/* translates set expression to C */
+bool emit_set(exprptr self, aot_emitter_ptr em, size_t result);
+
 #endif
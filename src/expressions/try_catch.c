@@ -23,6 +23,7 @@
 #include <string.h>
 #include <assert.h>
 
+#include "../optimizer/optimizer.h"
 #include "../utils/string.h"
 #include "../scanner/scanner.h"
 #include "../parser/parser.h"
@@ -58,7 +59,8 @@ bool is_try_catch_expr(exprptr e) {
 static const expr_vtable try_catch_expr_vtable = {
   .destroy = destroy_try_catch_expr,
   .to_string = try_catch_expr_tostring,
-  .interpret = interpret_try_catch_expr
+  .interpret = interpret_try_catch_expr,
+  .optimize = optimize_try_catch_expr
 };
 
 exprptr new_try_catch_expr(exprptr body, const char *name, exprptr handler, 
@@ -165,3 +167,11 @@ objectptr interpret_try_catch_expr(exprptr self, stack_frame_ptr sf) {
   delete_stack_frame(local_sf);
   return handler_value;
 }
+
+exprptr optimize_try_catch_expr(exprptr self, optimizer_ptr opt) {
+  try_catch_expr *tce = self->data;
+  optimizer_note_binding(opt, tce->exception_name);
+  tce->body = optimize_expr(tce->body, opt);
+  tce->handler = optimize_expr(tce->handler, opt);
+  return self;
+}
@@ -48,4 +48,7 @@ bool is_try_catch_expr(exprptr e);
 /* evaluates try-catch expression */
 objectptr interpret_try_catch_expr(exprptr self, stack_frame_ptr ptr);
 
+/* optimizes the body and the handler */
+exprptr optimize_try_catch_expr(exprptr self, optimizer_ptr opt);
+
 #endif
@@ -22,13 +22,17 @@
 #include <stdio.h>
 #include <limits.h>
 #include <string.h>
+#include <sys/types.h>
 
 #include "stack_frame.h"
 #include "variable.h"
 #include "../scanner/scanner.h"
+#include "../optimizer/optimizer.h"
 #include "../parser/parser.h"
+#include "../types/collector.h"
 #include "../types/error.h"
 #include "../types/void.h"
+#include "../utils/port.h"
 
 #ifndef LINE_MAX
 #define LINE_MAX 2048
@@ -38,7 +42,7 @@ static exprptr get_expression(listptr parse_tree, size_t i, bool verbose) {
   exprptr expr = list_get(parse_tree, i);
   if (verbose) {
     char *expr_str = expr_tostring(expr);
-    printf("Expression: %s\n", expr_str);
+    port_printf(standard_output(), "Expression: %s\n", expr_str);
     free(expr_str);
   }
 
@@ -47,18 +51,18 @@ static exprptr get_expression(listptr parse_tree, size_t i, bool verbose) {
 
 static objectptr evaluate(exprptr e, stack_frame_ptr sf, bool verbose, bool quiet) {
   objectptr result = interpret_expr(e, sf);
-  char *result_str = object_tostring(result);
+  output_port_ptr port = standard_output();
 
   if (verbose) {
-    printf("Result: ");
+    port_puts(port, "Result: ");
   }
 
   bool show_result = !quiet && !is_void(result);
   if (!is_exit(result) && (is_error(result) || show_result || verbose)) {
-    printf("%s\n", result_str);
+    object_print(result, port);
+    port_putc(port, '\n');
   }
 
-  free(result_str);
   return result;
 }
 
@@ -68,27 +72,178 @@ objectptr interpreter(listptr parse_tree, bool verbose, bool quiet, stack_frame_
   for (size_t i = 0; !is_error(result) && i < list_size(parse_tree); ++i) {
     exprptr e = get_expression(parse_tree, i, verbose);
     assign_object(&result, evaluate(e, sf, verbose, quiet));
+    collector_safe_point();
   }
 
   return result;
 }
 
-void repl(stack_frame_ptr sf) {
-  char line[LINE_MAX];
-
-  while (!feof(stdin)) {
-    if (!fgets(line, LINE_MAX, stdin)) {
-      if (!feof(stdin)) {
-        fprintf(stderr, 
-            "Cannot read the next line from stdin."
-            "The length of a line must not exceed %d characters",
-            LINE_MAX);
+/* Source code that is read line by line from a file and handed out
+ * one top-level expression at a time */
+typedef struct {
+  FILE *file;
+  /// Characters that are read but not yet handed out begin at start
+  char *buffer;
+  size_t start;
+  size_t length;
+  size_t capacity;
+  /// How far the expression at start is scanned
+  form_state_t form;
+  /// Position of the character at start in the source code
+  size_t line;
+  size_t column;
+  char *input_line;
+  size_t input_line_capacity;
+} source_reader;
+
+static void init_source_reader(source_reader *r, FILE *file) {
+  r->file = file;
+  r->capacity = LINE_MAX;
+  r->buffer = malloc(r->capacity);
+  r->start = 0;
+  r->length = 0;
+  init_form_state(&r->form);
+  r->line = 1;
+  r->column = 1;
+  r->input_line = NULL;
+  r->input_line_capacity = 0;
+}
+
+static void destroy_source_reader(source_reader *r) {
+  free(r->buffer);
+  free(r->input_line);
+}
+
+/* makes room for n more characters at the end of the buffer */
+static void reserve(source_reader *r, size_t n) {
+  if (r->length + n <= r->capacity) {
+    return;
+  }
+
+  /* The characters that are handed out are dropped. The buffer is at
+   * most half full afterwards, so that the remaining characters are
+   * moved again only after as many new ones are read. */
+  memmove(r->buffer, r->buffer + r->start, r->length - r->start);
+  r->length -= r->start;
+  r->start = 0;
+
+  if (2 * (r->length + n) > r->capacity) {
+    while (2 * (r->length + n) > r->capacity) {
+      r->capacity *= 2;
+    }
+    r->buffer = realloc(r->buffer, r->capacity);
+  }
+}
+
+/* appends the next line of the file to the buffer */
+static bool read_line(source_reader *r) {
+  if (r->file == stdin) {
+    flush_standard_output();
+  }
+
+  ssize_t n = getline(&r->input_line, &r->input_line_capacity, r->file);
+  if (n <= 0) {
+    return false;
+  }
+
+  reserve(r, n);
+  memcpy(r->buffer + r->length, r->input_line, n);
+  r->length += n;
+  return true;
+}
+
+/* hands out the first n characters after start */
+static void consume(source_reader *r, size_t n) {
+  for (size_t i = r->start; i < r->start + n; ++i) {
+    if (r->buffer[i] == '\n') {
+      r->line++;
+      r->column = 1;
+    } else {
+      r->column++;
+    }
+  }
+
+  r->start += n;
+}
+
+/* Returns the tokens of the next top-level expression. At the end of the
+ * file, the tokens of an incomplete expression are returned so that the
+ * parser can report it. Returns NULL when no expression is left.
+ * Each line is scanned once while the expression is looked for, even if
+ * the expression spans many lines. */
+static tokenstreamptr read_form(source_reader *r) {
+  for (;;) {
+    size_t end = 0;
+    form_status_t status = find_top_level_form_from(
+        r->buffer + r->start, r->length - r->start, &r->form, &end);
+
+    if (status == FORM_COMPLETE) {
+      tokenstreamptr tkns =
+          scanner_at(r->buffer + r->start, end, r->line, r->column);
+      consume(r, end);
+      init_form_state(&r->form);
+      return tkns;
+    }
+
+    if (status == FORM_EMPTY) {
+      /* only whitespace and comments, which do not need to be kept */
+      consume(r, r->form.position);
+      r->form.position = 0;
+    }
+
+    if (!read_line(r)) {
+      if (status == FORM_EMPTY) {
+        return NULL;
       }
 
-      return;
+      tokenstreamptr tkns = scanner_at(r->buffer + r->start,
+                                       r->length - r->start, r->line,
+                                       r->column);
+      consume(r, r->length - r->start);
+      init_form_state(&r->form);
+      return tkns;
+    }
+  }
+}
+
+objectptr stream_interpreter(FILE *file, bool verbose, bool quiet,
+                             bool optimize, stack_frame_ptr sf) {
+  source_reader reader;
+  init_source_reader(&reader, file);
+
+  objectptr result = make_void();
+  tokenstreamptr tkns = NULL;
+
+  while (!is_error(result) && !is_exit(result) &&
+         (tkns = read_form(&reader))) {
+    listptr parse_tree = parser(tkns, sf);
+    delete_tokenstream(tkns);
+    if (!parse_tree) {
+      delete_object(result);
+      result = NULL;
+      break;
+    }
+
+    /* Later expressions are not known yet, so global variables
+     * cannot be treated as constants */
+    if (optimize) {
+      optimize_parse_tree(parse_tree, false, sf);
     }
 
-    tokenstreamptr tkns = scanner(line);
+    assign_object(&result, interpreter(parse_tree, verbose, quiet, sf));
+    delete_parse_tree(parse_tree);
+  }
+
+  destroy_source_reader(&reader);
+  return result;
+}
+
+void repl(stack_frame_ptr sf) {
+  source_reader reader;
+  init_source_reader(&reader, stdin);
+
+  tokenstreamptr tkns = NULL;
+  while ((tkns = read_form(&reader))) {
     listptr parse_tree = parser(tkns, sf);
     delete_tokenstream(tkns);
     
@@ -99,8 +254,10 @@ void repl(stack_frame_ptr sf) {
       bool exit = is_exit(result);
       delete_object(result);
       if (exit) {
-        return;
+        break;
       }
     }
   }
+
+  destroy_source_reader(&reader);
 }
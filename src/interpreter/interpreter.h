@@ -22,6 +22,8 @@
 #ifndef THEORYLISP_INTERPRETER_INTERPRETER_H
 #define THEORYLISP_INTERPRETER_INTERPRETER_H
 
+#include <stdio.h>
+
 #include "../utils/list.h"
 #include "../expressions/expression.h"
 #include "../types/object.h"
@@ -38,8 +40,25 @@
  */
 objectptr interpreter(listptr parse_tree, bool verbose, bool show, stack_frame_ptr sf);
 
+/**
+ * Reads the given file one top-level expression at a time, and parses
+ * and interprets each expression before reading the next one, so that
+ * the memory used does not grow with the size of the file.
+ *
+ * Stops at the first expression that returns an error or exit object and
+ * returns that object. If a parser error occurs, NULL is returned.
+ *
+ * @param optimize if optimize is set to true, each expression is
+ * optimized with optimize_parse_tree before it is interpreted.
+ */
+objectptr stream_interpreter(FILE *file, bool verbose, bool quiet,
+                             bool optimize, stack_frame_ptr sf);
+
 /**
  * Read-Evaluate-Print-Loop
+ *
+ * An expression may span multiple lines. It is evaluated as soon as
+ * it is complete.
  */
 void repl(stack_frame_ptr sf);
 
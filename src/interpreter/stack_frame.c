@@ -31,12 +31,14 @@
 struct stack_frame {
   hashtableptr local_variables;
   struct stack_frame *saved_frame_pointer;
+  stack_frame_miss_handler miss_handler;
 };
 
 stack_frame_ptr new_stack_frame(stack_frame_ptr previous) {
   stack_frame_ptr sf = malloc(sizeof *sf);
   sf->local_variables = new_hash_table(1);
   sf->saved_frame_pointer = previous;
+  sf->miss_handler = NULL;
   return sf;
 }
 
@@ -54,16 +56,42 @@ static variableptr find_variable_locally(stack_frame_ptr sf, const char *name) {
   return hash_table_get(sf->local_variables, name);
 }
 
+void stack_frame_set_miss_handler(stack_frame_ptr sf, stack_frame_miss_handler handler) {
+  sf->miss_handler = handler;
+}
+
+static variableptr find_missing_variable(stack_frame_ptr sf, const char *name) {
+  if (!sf->miss_handler) {
+    return NULL;
+  }
+
+  objectptr value = sf->miss_handler(sf, name);
+  if (!value) {
+    return NULL;
+  }
+
+  variableptr var = new_variable(name, value);
+  hash_table_put(sf->local_variables, name, var);
+  delete_object(value);
+  return var;
+}
+
 static variableptr find_variable(stack_frame_ptr sf, const char *name) {
+  stack_frame_ptr bottom = NULL;
   while (sf) {
     variableptr var = find_variable_locally(sf, name);
     if (var) {
       return var;
     }
 
+    bottom = sf;
     sf = sf->saved_frame_pointer;
   }
 
+  if (bottom) {
+    return find_missing_variable(bottom, name);
+  }
+
   return NULL;
 }
 
@@ -103,9 +131,35 @@ objectptr stack_frame_get_variable(stack_frame_ptr sf, const char *name) {
   return make_error("Variable %s does not exist", name);
 }
 
+objectptr stack_frame_peek_variable(stack_frame_ptr sf, const char *name) {
+  variableptr var = find_variable(sf, name);
+  return var ? variable_peek_value(var) : NULL;
+}
+
+objectptr stack_frame_take_variable(stack_frame_ptr sf, const char *name) {
+  variableptr var = find_variable(sf, name);
+  if (!var || !is_unique(variable_peek_value(var))) {
+    return NULL;
+  }
+  return variable_take_value(var);
+}
+
 bool stack_frame_defined(stack_frame_ptr sf, const char *name) {
-  objectptr value = stack_frame_get_variable(sf, name);
-  bool defined = !is_error(value);
-  delete_object(value);
-  return defined;
+  return stack_frame_peek_variable(sf, name) != NULL;
+}
+
+typedef struct {
+  stack_frame_visitor visit;
+  void *context;
+} stack_frame_visit;
+
+static void visit_variable(const char *name, void *variable, void *context) {
+  stack_frame_visit *v = context;
+  v->visit(name, variable_peek_value(variable), v->context);
+}
+
+void stack_frame_foreach_local(stack_frame_ptr sf, stack_frame_visitor visit,
+                               void *context) {
+  stack_frame_visit v = {visit, context};
+  hash_table_foreach(sf->local_variables, visit_variable, &v);
 }
@@ -34,6 +34,13 @@
 struct stack_frame;
 typedef struct stack_frame *stack_frame_ptr;
 
+/**
+ * A function that is called when a variable cannot be found in any of the
+ * stack frames. It either returns the value that the missing variable should
+ * be created with, or NULL if the variable does not exist.
+ */
+typedef objectptr (*stack_frame_miss_handler)(stack_frame_ptr sf, const char *name);
+
 /**
  * Allocates a stack frame.
  * The member saved_frame_pointer is set to the given previous frame.
@@ -48,6 +55,16 @@ stack_frame_ptr new_stack_frame(stack_frame_ptr previous);
  */
 void delete_stack_frame(stack_frame_ptr sf);
 
+/**
+ * Installs a miss handler to the given stack frame.
+ *
+ * When a variable lookup reaches the bottom stack frame without finding the
+ * variable, the miss handler of the bottom frame is consulted. If the handler
+ * yields a value, the variable is created in the bottom frame with that value,
+ * so that the handler is called at most once for each name.
+ */
+void stack_frame_set_miss_handler(stack_frame_ptr sf, stack_frame_miss_handler handler);
+
 /**
  * Sets the value of a local variable in the given stack frame.
  *
@@ -86,14 +103,52 @@ void stack_frame_set_variable(stack_frame_ptr sf, const char *name,
  * found, increasingly outer stack frames are searched for the variable.
  *
  * When it is found, the value is returned. If it does not exist,
- * the function returns an error object.
+ * the function returns an error object. The caller owns the returned
+ * reference and must delete it.
  *
  */
 objectptr stack_frame_get_variable(stack_frame_ptr sf, const char *name);
 
+/**
+ * Returns the value of the variable with the given name like
+ * stack_frame_get_variable, but without cloning it, or NULL if the
+ * variable does not exist.
+ *
+ * The returned reference is borrowed. The caller must not delete it,
+ * and must not use it after the variable may have been set or its stack
+ * frame deleted, which can happen whenever a Theory Lisp expression is
+ * interpreted. Borrowed references are used on the evaluation paths that
+ * only read a value before anything else can run, so that reading a
+ * variable does not change reference counts.
+ */
+objectptr stack_frame_peek_variable(stack_frame_ptr sf, const char *name);
+
+/**
+ * Removes the value of the variable with the given name and returns it,
+ * if the variable holds the only reference to the value. Returns NULL
+ * otherwise, or if the variable does not exist.
+ *
+ * The returned reference is owned by the caller. The variable must be set
+ * with stack_frame_set_variable before anything else reads it.
+ */
+objectptr stack_frame_take_variable(stack_frame_ptr sf, const char *name);
+
 /**
  * Returns true if the given variable was previously defined
  */
 bool stack_frame_defined(stack_frame_ptr sf, const char *name);
 
+/**
+ * A function that is called for each local variable of a stack frame.
+ */
+typedef void (*stack_frame_visitor)(const char *name, objectptr value, void *context);
+
+/**
+ * Calls visit for each variable in the local stack frame sf.
+ * The values are borrowed, so the visitor must clone the values it keeps
+ * and must not change the variables of sf.
+ */
+void stack_frame_foreach_local(stack_frame_ptr sf, stack_frame_visitor visit,
+                               void *context);
+
 #endif
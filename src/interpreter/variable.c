@@ -47,7 +47,20 @@ void delete_variable(variableptr var) {
 
 objectptr variable_get_value(variableptr var) { return clone_object(var->value); }
 
+objectptr variable_peek_value(variableptr var) { return var->value; }
+
+objectptr variable_take_value(variableptr var) {
+  objectptr value = var->value;
+  var->value = NULL;
+  return value;
+}
+
 void variable_set_value(variableptr var, objectptr value) { 
+  if (var->value == NULL) {
+    var->value = clone_object(value);
+    return;
+  }
+
   assign_object(&var->value, clone_object(value));
 }
 
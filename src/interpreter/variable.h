@@ -42,9 +42,26 @@ void delete_variable(variableptr var);
 /** Clones variable */
 variableptr clone_variable(variableptr var);
 
-/** Returns the value stored in the given variable */
+/**
+ * Returns the value stored in the given variable.
+ * The caller owns the returned reference and must delete it.
+ */
 objectptr variable_get_value(variableptr var);
 
+/**
+ * Returns the value stored in the given variable without cloning it.
+ * The returned reference is borrowed: the caller must not delete it,
+ * and it is valid only until the variable is set or deleted.
+ */
+objectptr variable_peek_value(variableptr var);
+
+/**
+ * Removes the value from the given variable and returns it. The returned
+ * reference is owned by the caller. The variable must be set again before
+ * its value is read.
+ */
+objectptr variable_take_value(variableptr var);
+
 /**
  * Sets the value of an existing variable.
  * A clone of the given parameter value is stored internally.
@@ -0,0 +1,879 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "jit.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../expressions/lambda.h"
+#include "../types/boolean.h"
+#include "../types/error.h"
+#include "../types/integer.h"
+#include "../types/procedure.h"
+#include "../types/real.h"
+#include "native.h"
+
+#define ERR_IF_CONDITION "Condition in if expression does not yield a boolean."
+
+/* Marks a variable that is not a parameter */
+#define NO_SLOT SIZE_MAX
+
+/* Value passed between compiled nodes. Numbers and booleans are not
+ * allocated as objects. */
+typedef enum {
+  VALUE_INTEGER,
+  VALUE_REAL,
+  VALUE_BOOLEAN,
+  VALUE_OBJECT
+} value_kind_t;
+
+typedef struct {
+  value_kind_t kind;
+  union {
+    integer_t integer;
+    real_t real;
+    bool boolean;
+    objectptr object;
+  } as;
+} jit_value;
+
+/* Binary builtin functions that are computed directly */
+typedef enum {
+  OP_NONE,
+  OP_ADD,
+  OP_SUB,
+  OP_MUL,
+  OP_EQ,
+  OP_NEQ,
+  OP_LT,
+  OP_LE,
+  OP_GT,
+  OP_GE
+} jit_op_t;
+
+static const struct {
+  const char *name;
+  jit_op_t op;
+} binary_ops[] = {{"+", OP_ADD}, {"-", OP_SUB},  {"*", OP_MUL},
+                  {"=", OP_EQ},  {"!=", OP_NEQ}, {"<", OP_LT},
+                  {"<=", OP_LE}, {">", OP_GT},   {">=", OP_GE}};
+
+/* Builtin functions that can assign the variables of the caller */
+static const char *dynamic_builtins[] = {"eval", "load"};
+
+/* State of a running compiled lambda */
+typedef struct {
+  stack_frame_ptr sf;
+  objectptr *args;
+  /// True if parameters are read from the argument array
+  bool use_slots;
+} jit_frame;
+
+typedef jit_value (*jit_run_fn)(jit_node_ptr node, jit_frame *frame);
+
+struct jit_node {
+  jit_run_fn run;
+  /// The compiled expression
+  exprptr expr;
+  /// Value of a constant node
+  jit_value value;
+  /// Name of a variable or a called function
+  char *name;
+  /// Index of a parameter in the argument array
+  size_t slot;
+  const builtin_function *builtin;
+  jit_op_t op;
+  size_t nchildren;
+  jit_node_ptr *children;
+};
+
+struct jit_compiler {
+  listptr params;
+  /// True if the compiled code can assign a parameter through a call
+  bool dynamic;
+};
+
+struct jit_code {
+  jit_node_ptr root;
+  bool use_slots;
+  /// The compiled body, which belongs to the lambda
+  exprptr body;
+  size_t nparams;
+  /// True once the body has been tried to be compiled to machine code
+  bool native_tried;
+  native_code_ptr native;
+  /// Kinds of the arguments that the machine code is specialized for
+  value_kind_t *native_params;
+  value_kind_t native_result;
+  /// Name through which the machine code calls itself, or NULL
+  char *self;
+};
+
+/* Machine code of the binary builtin functions */
+static const native_stencil_t integer_stencils[] = {
+    [OP_ADD] = STENCIL_INTEGER_ADD, [OP_SUB] = STENCIL_INTEGER_SUB,
+    [OP_MUL] = STENCIL_INTEGER_MUL, [OP_EQ] = STENCIL_INTEGER_EQ,
+    [OP_NEQ] = STENCIL_INTEGER_NEQ, [OP_LT] = STENCIL_INTEGER_LT,
+    [OP_LE] = STENCIL_INTEGER_LE,   [OP_GT] = STENCIL_INTEGER_GT,
+    [OP_GE] = STENCIL_INTEGER_GE};
+
+static const native_stencil_t real_stencils[] = {
+    [OP_ADD] = STENCIL_REAL_ADD, [OP_SUB] = STENCIL_REAL_SUB,
+    [OP_MUL] = STENCIL_REAL_MUL, [OP_EQ] = STENCIL_REAL_EQ,
+    [OP_NEQ] = STENCIL_REAL_NEQ, [OP_LT] = STENCIL_REAL_LT,
+    [OP_LE] = STENCIL_REAL_LE,   [OP_GT] = STENCIL_REAL_GT,
+    [OP_GE] = STENCIL_REAL_GE};
+
+/* State of the translation of nodes to machine code */
+typedef struct {
+  const value_kind_t *params;
+  size_t nparams;
+  /// Kind of the values that calls of the body to itself return
+  value_kind_t result;
+  /// Name of the procedure that the body calls
+  const char *self;
+  /// Position of the body in the machine code
+  size_t start;
+} native_context;
+
+static jit_mode_t jit_mode = JIT_OFF;
+static size_t failures = 0;
+
+void jit_set_mode(jit_mode_t mode) { jit_mode = mode; }
+
+jit_mode_t jit_get_mode(void) { return jit_mode; }
+
+size_t jit_check_failures(void) { return failures; }
+
+/* Converts an object to a value. Takes ownership of obj. */
+static jit_value unbox(objectptr obj) {
+  jit_value v;
+  if (is_integer(obj)) {
+    v.kind = VALUE_INTEGER;
+    v.as.integer = int_value(obj);
+  } else if (is_real(obj)) {
+    v.kind = VALUE_REAL;
+    v.as.real = real_value(obj);
+  } else if (is_boolean(obj)) {
+    v.kind = VALUE_BOOLEAN;
+    v.as.boolean = boolean_value(obj);
+  } else {
+    v.kind = VALUE_OBJECT;
+    v.as.object = obj;
+    return v;
+  }
+
+  delete_object(obj);
+  return v;
+}
+
+/* Converts an object to a value without taking ownership of obj.
+ * Only objects that are not numbers or booleans are cloned. */
+static jit_value unbox_borrowed(objectptr obj) {
+  jit_value v;
+  if (is_integer(obj)) {
+    v.kind = VALUE_INTEGER;
+    v.as.integer = int_value(obj);
+  } else if (is_real(obj)) {
+    v.kind = VALUE_REAL;
+    v.as.real = real_value(obj);
+  } else if (is_boolean(obj)) {
+    v.kind = VALUE_BOOLEAN;
+    v.as.boolean = boolean_value(obj);
+  } else {
+    v.kind = VALUE_OBJECT;
+    v.as.object = clone_object(obj);
+  }
+
+  return v;
+}
+
+/* Converts a value to an object. Takes ownership of v. */
+static objectptr box(jit_value v) {
+  switch (v.kind) {
+  case VALUE_INTEGER:
+    return make_integer(v.as.integer);
+  case VALUE_REAL:
+    return make_real(v.as.real);
+  case VALUE_BOOLEAN:
+    return make_boolean(v.as.boolean);
+  case VALUE_OBJECT:
+    return v.as.object;
+  }
+
+  abort();
+}
+
+/* Converts a value to an object without taking ownership of it */
+static objectptr box_copy(jit_value v) {
+  if (v.kind == VALUE_OBJECT) {
+    return clone_object(v.as.object);
+  }
+
+  return box(v);
+}
+
+static void release(jit_value v) {
+  if (v.kind == VALUE_OBJECT && v.as.object) {
+    delete_object(v.as.object);
+  }
+}
+
+static bool is_error_value(jit_value v) {
+  return v.kind == VALUE_OBJECT && is_error(v.as.object);
+}
+
+static jit_value integer_value(integer_t x) {
+  jit_value v = {.kind = VALUE_INTEGER, .as.integer = x};
+  return v;
+}
+
+static jit_value real_value_of(real_t x) {
+  jit_value v = {.kind = VALUE_REAL, .as.real = x};
+  return v;
+}
+
+static jit_value boolean_value_of(bool x) {
+  jit_value v = {.kind = VALUE_BOOLEAN, .as.boolean = x};
+  return v;
+}
+
+static jit_value run_node(jit_node_ptr node, jit_frame *frame) {
+  return node->run(node, frame);
+}
+
+/* Compares the result of a compiled node with the result of the
+ * interpreter in JIT_CHECK mode. Takes ownership of expected. */
+static void check_result(jit_node_ptr node, jit_value actual,
+                         objectptr expected) {
+  objectptr boxed = box_copy(actual);
+  char *actual_str = object_tostring(boxed);
+  char *expected_str = object_tostring(expected);
+
+  if (strcmp(actual_str, expected_str) != 0) {
+    char *expr_str = expr_tostring(node->expr);
+    fprintf(stderr, "JIT check failed: %s gives %s, interpreter gives %s\n",
+            expr_str, actual_str, expected_str);
+    free(expr_str);
+    failures++;
+  }
+
+  free(actual_str);
+  free(expected_str);
+  delete_object(boxed);
+  delete_object(expected);
+}
+
+static jit_value run_constant(jit_node_ptr node, jit_frame *frame) {
+  if (node->value.kind == VALUE_OBJECT) {
+    jit_value v = {.kind = VALUE_OBJECT,
+                   .as.object = clone_object(node->value.as.object)};
+    return v;
+  }
+
+  return node->value;
+}
+
+static jit_value run_variable(jit_node_ptr node, jit_frame *frame) {
+  if (frame->use_slots && node->slot != NO_SLOT) {
+    jit_value v = unbox_borrowed(frame->args[node->slot]);
+    if (jit_mode == JIT_CHECK) {
+      check_result(node, v, stack_frame_get_variable(frame->sf, node->name));
+    }
+    return v;
+  }
+
+  objectptr value = stack_frame_peek_variable(frame->sf, node->name);
+  if (value && !is_error(value)) {
+    return unbox_borrowed(value);
+  }
+
+  return unbox(stack_frame_get_variable(frame->sf, node->name));
+}
+
+static jit_value run_fallback(jit_node_ptr node, jit_frame *frame) {
+  return unbox(interpret_expr(node->expr, frame->sf));
+}
+
+static jit_value run_if(jit_node_ptr node, jit_frame *frame) {
+  jit_value condition = run_node(node->children[0], frame);
+  if (is_error_value(condition)) {
+    return condition;
+  }
+
+  if (condition.kind != VALUE_BOOLEAN) {
+    release(condition);
+    return unbox(make_error(ERR_IF_CONDITION));
+  }
+
+  return run_node(node->children[condition.as.boolean ? 1 : 2], frame);
+}
+
+/* Evaluates the arguments of a call from left to right. Returns an
+ * error, or NULL if all arguments are evaluated. */
+static objectptr run_arguments(jit_node_ptr node, jit_frame *frame,
+                               objectptr *args) {
+  for (size_t i = 0; i < node->nchildren; ++i) {
+    jit_value v = run_node(node->children[i], frame);
+    if (is_error_value(v)) {
+      for (size_t j = 0; j < i; ++j) {
+        delete_object(args[j]);
+      }
+      return v.as.object;
+    }
+    args[i] = box(v);
+  }
+
+  return NULL;
+}
+
+static void delete_arguments(size_t nargs, objectptr *args) {
+  for (size_t i = 0; i < nargs; ++i) {
+    delete_object(args[i]);
+  }
+}
+
+static jit_value run_builtin_call(jit_node_ptr node, jit_frame *frame) {
+  objectptr args[node->nchildren + 1];
+  objectptr error = run_arguments(node, frame, args);
+  if (error) {
+    return unbox(error);
+  }
+
+  objectptr result = node->builtin->func(node->nchildren, args, frame->sf);
+  delete_arguments(node->nchildren, args);
+  return unbox(result);
+}
+
+static jit_value run_procedure_call(jit_node_ptr node, jit_frame *frame) {
+  objectptr args[node->nchildren + 1];
+  objectptr error = run_arguments(node, frame, args);
+  if (error) {
+    return unbox(error);
+  }
+
+  objectptr proc = stack_frame_get_variable(frame->sf, node->name);
+  objectptr result = proc;
+  if (!is_error(proc)) {
+    result = object_op_call(proc, node->nchildren, args, frame->sf);
+    delete_object(proc);
+  }
+
+  delete_arguments(node->nchildren, args);
+  return unbox(result);
+}
+
+static jit_value integer_op(jit_op_t op, integer_t x, integer_t y) {
+  switch (op) {
+  case OP_ADD:
+    return integer_value(x + y);
+  case OP_SUB:
+    return integer_value(x - y);
+  case OP_MUL:
+    return integer_value(x * y);
+  case OP_EQ:
+    return boolean_value_of(x == y);
+  case OP_NEQ:
+    return boolean_value_of(x != y);
+  case OP_LT:
+    return boolean_value_of(x < y);
+  case OP_LE:
+    return boolean_value_of(x <= y);
+  case OP_GT:
+    return boolean_value_of(x > y);
+  case OP_GE:
+    return boolean_value_of(x >= y);
+  case OP_NONE:
+    break;
+  }
+
+  abort();
+}
+
+/* Reals are computed in the same way as the builtin functions compute
+ * them, so that NaNs and signed zeros give the same results */
+static jit_value real_op(jit_op_t op, real_t x, real_t y) {
+  switch (op) {
+  case OP_ADD:
+    return real_value_of((0 + x) + y);
+  case OP_SUB:
+    return real_value_of(x - y);
+  case OP_MUL:
+    return real_value_of((1 * x) * y);
+  case OP_EQ:
+    return boolean_value_of(x == y);
+  case OP_NEQ:
+    return boolean_value_of(!(x == y));
+  case OP_LT:
+    return boolean_value_of(x < y);
+  case OP_LE:
+    return boolean_value_of(x < y || x == y);
+  case OP_GT:
+    return boolean_value_of(!(x < y || x == y));
+  case OP_GE:
+    return boolean_value_of(!(x < y));
+  case OP_NONE:
+    break;
+  }
+
+  abort();
+}
+
+static jit_value run_binary(jit_node_ptr node, jit_frame *frame) {
+  jit_value lhs = run_node(node->children[0], frame);
+  if (is_error_value(lhs)) {
+    return lhs;
+  }
+
+  jit_value rhs = run_node(node->children[1], frame);
+  if (is_error_value(rhs)) {
+    release(lhs);
+    return rhs;
+  }
+
+  jit_value result;
+  if (lhs.kind == VALUE_INTEGER && rhs.kind == VALUE_INTEGER) {
+    result = integer_op(node->op, lhs.as.integer, rhs.as.integer);
+  } else if (lhs.kind == VALUE_REAL && rhs.kind == VALUE_REAL) {
+    result = real_op(node->op, lhs.as.real, rhs.as.real);
+  } else {
+    /* Other types are handled by the builtin function */
+    objectptr args[2] = {box(lhs), box(rhs)};
+    objectptr value = node->builtin->func(2, args, frame->sf);
+    delete_arguments(2, args);
+    return unbox(value);
+  }
+
+  if (jit_mode == JIT_CHECK) {
+    objectptr args[2] = {box(lhs), box(rhs)};
+    check_result(node, result, node->builtin->func(2, args, frame->sf));
+    delete_arguments(2, args);
+  }
+
+  return result;
+}
+
+static jit_node_ptr new_node(jit_run_fn run, exprptr expr, size_t nchildren) {
+  jit_node_ptr node = malloc(sizeof *node);
+  node->run = run;
+  node->expr = expr ? clone_expr(expr) : NULL;
+  node->value.kind = VALUE_OBJECT;
+  node->value.as.object = NULL;
+  node->name = NULL;
+  node->slot = NO_SLOT;
+  node->builtin = NULL;
+  node->op = OP_NONE;
+  node->nchildren = nchildren;
+  node->children = nchildren ? malloc(nchildren * sizeof(jit_node_ptr)) : NULL;
+  return node;
+}
+
+static void delete_node(jit_node_ptr node) {
+  for (size_t i = 0; i < node->nchildren; ++i) {
+    delete_node(node->children[i]);
+  }
+  free(node->children);
+  release(node->value);
+  free(node->name);
+  if (node->expr) {
+    delete_expr(node->expr);
+  }
+  free(node);
+}
+
+jit_node_ptr jit_compile_expr(jit_compiler_ptr jc, exprptr e) {
+  jit_node_ptr node = compile_expr(e, jc);
+  if (node) {
+    node->expr = node->expr ? node->expr : clone_expr(e);
+    return node;
+  }
+
+  /* The interpreter may run any code, including code that assigns
+   * the parameters */
+  jc->dynamic = true;
+  return new_node(run_fallback, e, 0);
+}
+
+jit_node_ptr jit_constant(jit_compiler_ptr jc, objectptr value) {
+  jit_node_ptr node = new_node(run_constant, NULL, 0);
+  node->value = unbox(clone_object(value));
+  return node;
+}
+
+jit_node_ptr jit_variable(jit_compiler_ptr jc, const char *name) {
+  jit_node_ptr node = new_node(run_variable, NULL, 0);
+  node->name = strdup(name);
+
+  /* If a name is repeated in the parameter list, the last one is used */
+  for (size_t i = list_size(jc->params); i > 0; --i) {
+    if (strcmp(list_get(jc->params, i - 1), name) == 0) {
+      node->slot = i - 1;
+      break;
+    }
+  }
+
+  return node;
+}
+
+jit_node_ptr jit_if(jit_compiler_ptr jc, jit_node_ptr condition,
+                    jit_node_ptr true_case, jit_node_ptr false_case) {
+  jit_node_ptr node = new_node(run_if, NULL, 3);
+  node->children[0] = condition;
+  node->children[1] = true_case;
+  node->children[2] = false_case;
+  return node;
+}
+
+static bool in_name_list(const char *name, const char **names, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (strcmp(name, names[i]) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+jit_node_ptr jit_call(jit_compiler_ptr jc, exprptr call, const char *name,
+                      const builtin_function *builtin, size_t nargs,
+                      jit_node_ptr *args) {
+  jit_run_fn run = run_procedure_call;
+  jit_op_t op = OP_NONE;
+
+  if (builtin) {
+    run = run_builtin_call;
+    for (size_t i = 0; nargs == 2 && i < sizeof binary_ops / sizeof *binary_ops;
+         ++i) {
+      if (strcmp(name, binary_ops[i].name) == 0) {
+        run = run_binary;
+        op = binary_ops[i].op;
+      }
+    }
+  }
+
+  /* A procedure that is called may assign the parameters of its caller,
+   * since variables are dynamically scoped */
+  if (!builtin || in_name_list(name, dynamic_builtins,
+                               sizeof dynamic_builtins /
+                                   sizeof *dynamic_builtins)) {
+    jc->dynamic = true;
+  }
+
+  jit_node_ptr node = new_node(run, call, nargs);
+  node->name = strdup(name);
+  node->builtin = builtin;
+  node->op = op;
+  for (size_t i = 0; i < nargs; ++i) {
+    node->children[i] = args[i];
+  }
+  free(args);
+  return node;
+}
+
+/* Returns the kind of the values that a node computes in machine code,
+ * or VALUE_OBJECT if the node has no machine code. Only numbers,
+ * booleans, parameters, binary builtin functions, if expressions and
+ * calls of the body to itself are translated. */
+static value_kind_t native_kind(jit_node_ptr node, native_context *ctx) {
+  if (node->run == run_constant) {
+    return node->value.kind;
+  }
+
+  if (node->run == run_variable) {
+    return node->slot == NO_SLOT ? VALUE_OBJECT : ctx->params[node->slot];
+  }
+
+  if (node->run == run_if) {
+    value_kind_t true_kind = native_kind(node->children[1], ctx);
+    if (native_kind(node->children[0], ctx) != VALUE_BOOLEAN ||
+        native_kind(node->children[2], ctx) != true_kind) {
+      return VALUE_OBJECT;
+    }
+    return true_kind;
+  }
+
+  if (node->run == run_binary) {
+    /* Mixed integers and reals are left to the builtin functions */
+    value_kind_t kind = native_kind(node->children[0], ctx);
+    if ((kind != VALUE_INTEGER && kind != VALUE_REAL) ||
+        native_kind(node->children[1], ctx) != kind) {
+      return VALUE_OBJECT;
+    }
+    bool arithmetic =
+        node->op == OP_ADD || node->op == OP_SUB || node->op == OP_MUL;
+    return arithmetic ? kind : VALUE_BOOLEAN;
+  }
+
+  if (node->run == run_procedure_call) {
+    if ((ctx->self && strcmp(ctx->self, node->name) != 0) ||
+        node->nchildren != ctx->nparams) {
+      return VALUE_OBJECT;
+    }
+    ctx->self = node->name;
+    for (size_t i = 0; i < node->nchildren; ++i) {
+      if (native_kind(node->children[i], ctx) != ctx->params[i]) {
+        return VALUE_OBJECT;
+      }
+    }
+    return ctx->result;
+  }
+
+  return VALUE_OBJECT;
+}
+
+static uint64_t native_bits(jit_value v) {
+  uint64_t bits = 0;
+  switch (v.kind) {
+  case VALUE_INTEGER:
+    bits = (uint64_t)v.as.integer;
+    break;
+  case VALUE_REAL:
+    memcpy(&bits, &v.as.real, sizeof bits);
+    break;
+  case VALUE_BOOLEAN:
+    bits = v.as.boolean;
+    break;
+  case VALUE_OBJECT:
+    abort();
+  }
+  return bits;
+}
+
+/* Copies the stencils of a node whose kind is not VALUE_OBJECT.
+ * A call in tail position jumps back to the start of the body instead
+ * of calling it. */
+static void emit_native(native_emitter_ptr e, jit_node_ptr node,
+                        native_context *ctx, bool tail) {
+  if (node->run == run_constant) {
+    native_emit(e, STENCIL_CONSTANT, native_bits(node->value));
+  } else if (node->run == run_variable) {
+    native_emit(e, STENCIL_LOAD, node->slot * sizeof(uint64_t));
+  } else if (node->run == run_if) {
+    emit_native(e, node->children[0], ctx, false);
+    size_t false_jump = native_emit(e, STENCIL_BRANCH_FALSE, 0);
+    emit_native(e, node->children[1], ctx, tail);
+    size_t end_jump = native_emit(e, STENCIL_JUMP, 0);
+    native_patch_jump(e, false_jump, native_position(e));
+    emit_native(e, node->children[2], ctx, tail);
+    native_patch_jump(e, end_jump, native_position(e));
+  } else if (node->run == run_binary) {
+    value_kind_t kind = native_kind(node->children[0], ctx);
+    emit_native(e, node->children[0], ctx, false);
+    native_emit(e, STENCIL_PUSH, 0);
+    emit_native(e, node->children[1], ctx, false);
+    native_emit(e, kind == VALUE_INTEGER ? integer_stencils[node->op]
+                                         : real_stencils[node->op],
+                0);
+  } else {
+    /* Arguments are pushed from right to left, so that the first one
+     * is at the lowest address. They have no side effects, so the
+     * order of evaluation is not visible. */
+    for (size_t i = node->nchildren; i > 0; --i) {
+      emit_native(e, node->children[i - 1], ctx, false);
+      native_emit(e, STENCIL_PUSH, 0);
+    }
+
+    if (tail) {
+      for (size_t i = 0; i < node->nchildren; ++i) {
+        native_emit(e, STENCIL_STORE, i * sizeof(uint64_t));
+      }
+      native_emit(e, STENCIL_JUMP, ctx->start);
+    } else {
+      native_emit(e, STENCIL_CALL, 0);
+      native_emit(e, STENCIL_DROP, node->nchildren * sizeof(uint64_t));
+    }
+  }
+}
+
+static value_kind_t argument_kind(objectptr arg) {
+  if (is_integer(arg)) {
+    return VALUE_INTEGER;
+  } else if (is_real(arg)) {
+    return VALUE_REAL;
+  } else if (is_boolean(arg)) {
+    return VALUE_BOOLEAN;
+  }
+  return VALUE_OBJECT;
+}
+
+/* Compiles the body to machine code specialized for the kinds of the
+ * given arguments, if it can be translated completely */
+static void compile_native(jit_code_ptr code, size_t nargs,
+                           objectptr *args) {
+  code->native_tried = true;
+  if (nargs != code->nparams) {
+    return;
+  }
+
+  value_kind_t *params = malloc((nargs + 1) * sizeof(value_kind_t));
+  for (size_t i = 0; i < nargs; ++i) {
+    params[i] = argument_kind(args[i]);
+  }
+
+  /* The kind of the result of the body may depend on the kind of
+   * the results of its calls to itself */
+  native_context ctx = {.params = params, .nparams = nargs};
+  value_kind_t results[] = {VALUE_INTEGER, VALUE_REAL, VALUE_BOOLEAN};
+  value_kind_t result = VALUE_OBJECT;
+  for (size_t i = 0; i < 3 && result == VALUE_OBJECT; ++i) {
+    ctx.result = results[i];
+    ctx.self = NULL;
+    if (native_kind(code->root, &ctx) == results[i]) {
+      result = results[i];
+    }
+  }
+
+  native_emitter_ptr e = new_native_emitter();
+  if (result == VALUE_OBJECT || !e) {
+    free(params);
+    if (e) {
+      delete_native_emitter(e);
+    }
+    return;
+  }
+
+  native_emit(e, STENCIL_ENTRY, 0);
+  ctx.start = native_position(e);
+  emit_native(e, code->root, &ctx, true);
+  native_emit(e, STENCIL_RETURN, 0);
+  code->native = native_finish(e);
+  delete_native_emitter(e);
+
+  if (!code->native) {
+    free(params);
+    return;
+  }
+
+  code->native_params = params;
+  code->native_result = result;
+  code->self = ctx.self ? strdup(ctx.self) : NULL;
+}
+
+/* Fills the slots of the machine code if it can run with the given
+ * arguments. The arguments must have the kinds that the code is
+ * specialized for, and the name through which the body calls itself
+ * must refer to a procedure of this lambda. The frames of these calls
+ * would only contain the parameters, which do not have that name if
+ * it refers to a procedure, so the name refers to the same procedure
+ * in all of them. */
+static bool native_applies(jit_code_ptr code, size_t nargs,
+                           objectptr *args, stack_frame_ptr sf,
+                           uint64_t *slots) {
+  if (nargs != code->nparams) {
+    return false;
+  }
+
+  for (size_t i = 0; i < nargs; ++i) {
+    if (argument_kind(args[i]) != code->native_params[i]) {
+      return false;
+    }
+    slots[i] = native_bits(unbox_borrowed(args[i]));
+  }
+
+  if (code->self) {
+    objectptr proc = stack_frame_peek_variable(sf, code->self);
+    if (!proc || !is_procedure(proc)) {
+      return false;
+    }
+
+    exprptr lambda = procedure_get_lambda(proc);
+    if (!is_lambda_expr(lambda) || lambda_expr_get_body(lambda) != code->body ||
+        lambda_expr_has_captures(lambda) || lambda_expr_is_variadic(lambda)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static objectptr run_native(jit_code_ptr code, uint64_t *slots,
+                            stack_frame_ptr sf) {
+  uint64_t bits = native_run(code->native, slots);
+  jit_value v = {.kind = code->native_result};
+  switch (code->native_result) {
+  case VALUE_INTEGER:
+    v.as.integer = (integer_t)bits;
+    break;
+  case VALUE_REAL:
+    memcpy(&v.as.real, &bits, sizeof bits);
+    break;
+  default:
+    v.as.boolean = bits != 0;
+    break;
+  }
+
+  if (jit_mode == JIT_CHECK) {
+    check_result(code->root, v, interpret_expr(code->body, sf));
+  }
+
+  return box(v);
+}
+
+jit_code_ptr jit_compile(exprptr body, listptr params) {
+  struct jit_compiler jc = {.params = params, .dynamic = false};
+  jit_node_ptr root = jit_compile_expr(&jc, body);
+
+  /* Nothing is gained if the whole body is interpreted */
+  if (root->run == run_fallback) {
+    delete_node(root);
+    return NULL;
+  }
+
+  jit_code_ptr code = malloc(sizeof *code);
+  code->root = root;
+  code->use_slots = !jc.dynamic;
+  code->body = body;
+  code->nparams = list_size(params);
+  code->native_tried = false;
+  code->native = NULL;
+  code->native_params = NULL;
+  code->native_result = VALUE_OBJECT;
+  code->self = NULL;
+  return code;
+}
+
+objectptr jit_run(jit_code_ptr code, size_t nargs, objectptr *args,
+                  stack_frame_ptr sf) {
+  /* Machine code is specialized for the arguments of the first run */
+  if (!code->native_tried) {
+    compile_native(code, nargs, args);
+  }
+
+  if (code->native) {
+    uint64_t slots[nargs + 1];
+    if (native_applies(code, nargs, args, sf, slots)) {
+      return run_native(code, slots, sf);
+    }
+  }
+
+  jit_frame frame = {.sf = sf, .args = args, .use_slots = code->use_slots};
+  return box(run_node(code->root, &frame));
+}
+
+void delete_jit_code(jit_code_ptr code) {
+  if (code->native) {
+    delete_native_code(code->native);
+  }
+  free(code->native_params);
+  free(code->self);
+  delete_node(code->root);
+  free(code);
+}
@@ -0,0 +1,138 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file jit.h
+
+#ifndef THEORYLISP_JIT_JIT_H
+#define THEORYLISP_JIT_JIT_H
+
+#include <stdbool.h>
+
+#include "../builtin/builtin.h"
+#include "../expressions/expression.h"
+#include "../interpreter/stack_frame.h"
+#include "../types/object.h"
+#include "../utils/list.h"
+
+/**
+ * Tier-up compiler for frequently called lambdas.
+ *
+ * When enabled, a lambda that is called JIT_THRESHOLD times is compiled
+ * into a tree of specialized nodes. Each node is a C function that
+ * evaluates one expression without going through the expression vtable.
+ * Integers, reals and booleans are passed between nodes without being
+ * allocated as objects, and arithmetic and comparisons on them are
+ * computed directly. Expressions that have no compiled form are
+ * evaluated by the interpreter.
+ *
+ * On x86-64 Linux, a body that only computes with numbers, booleans and
+ * its parameters, and calls nothing but builtin arithmetic and
+ * comparisons and itself, is also compiled to machine code from
+ * stencils (see native.h) when it first runs. The machine code is
+ * specialized for the kinds of the arguments of that run, and calls in
+ * tail position become jumps. Runs with arguments of other kinds, or in
+ * which the name of the body no longer refers to its own procedure, use
+ * the tree of nodes instead.
+ */
+
+/* Number of calls after which a lambda is compiled */
+#define JIT_THRESHOLD 64
+
+typedef enum {
+  /// Lambdas are only interpreted
+  JIT_OFF,
+  /// Frequently called lambdas are compiled
+  JIT_ON,
+  /// Compiled code is checked against the interpreter
+  JIT_CHECK
+} jit_mode_t;
+
+struct jit_code;
+typedef struct jit_code *jit_code_ptr;
+
+/**
+ * Enables or disables the compiler for the lambdas called afterwards.
+ */
+void jit_set_mode(jit_mode_t mode);
+
+/**
+ * Returns the current mode of the compiler.
+ */
+jit_mode_t jit_get_mode(void);
+
+/**
+ * Returns the number of compiled operations whose results differed from
+ * the results of the interpreter in JIT_CHECK mode.
+ */
+size_t jit_check_failures(void);
+
+/**
+ * Compiles the body of a lambda with the given list of parameter names.
+ * Returns NULL if there is nothing to gain from compiling it. The body
+ * must not be deleted before the compiled code.
+ */
+jit_code_ptr jit_compile(exprptr body, listptr params);
+
+/**
+ * Runs compiled code. The parameters must already be defined
+ * in the local stack frame sf.
+ */
+objectptr jit_run(jit_code_ptr code, size_t nargs, objectptr *args,
+                  stack_frame_ptr sf);
+
+/**
+ * Deletes compiled code.
+ */
+void delete_jit_code(jit_code_ptr code);
+
+/* The following functions are used by the expressions while they
+ * compile themselves. */
+
+/**
+ * Compiles an expression. Expressions that cannot be compiled are
+ * evaluated by the interpreter when the compiled code runs.
+ */
+jit_node_ptr jit_compile_expr(jit_compiler_ptr jc, exprptr e);
+
+/**
+ * A node that evaluates to the given object.
+ */
+jit_node_ptr jit_constant(jit_compiler_ptr jc, objectptr value);
+
+/**
+ * A node that evaluates to the value of a variable.
+ */
+jit_node_ptr jit_variable(jit_compiler_ptr jc, const char *name);
+
+/**
+ * A node that selects true_case or false_case depending on condition.
+ */
+jit_node_ptr jit_if(jit_compiler_ptr jc, jit_node_ptr condition,
+                    jit_node_ptr true_case, jit_node_ptr false_case);
+
+/**
+ * A node that calls the builtin function or the procedure with the given
+ * name. call is the expression that is compiled, and args are the
+ * compiled arguments. Takes ownership of args.
+ */
+jit_node_ptr jit_call(jit_compiler_ptr jc, exprptr call, const char *name,
+                      const builtin_function *builtin, size_t nargs,
+                      jit_node_ptr *args);
+
+#endif
@@ -0,0 +1,272 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "native.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__linux__)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+typedef enum {
+  HOLE_NONE,
+  /// 64-bit immediate
+  HOLE_IMM64,
+  /// 32-bit immediate
+  HOLE_IMM32,
+  /// 32-bit displacement relative to the end of the stencil
+  HOLE_REL32
+} hole_kind_t;
+
+typedef struct {
+  unsigned char bytes[32];
+  size_t size;
+  hole_kind_t hole;
+  /// Offset of the hole in the bytes
+  size_t offset;
+} stencil_t;
+
+/* Loads rhs from rax into xmm1 and lhs from the stack into xmm0 */
+#define REAL_OPERANDS 0x66, 0x48, 0x0f, 0x6e, 0xc8, 0x58, 0x66, 0x48, 0x0f, \
+                      0x6e, 0xc0
+/* Moves rhs from rax to rcx and pops lhs into rax, then compares them */
+#define INTEGER_COMPARE 0x48, 0x89, 0xc1, 0x58, 0x48, 0x39, 0xc8
+/* movzx eax, al */
+#define ZERO_EXTEND 0x0f, 0xb6, 0xc0
+/* xor eax, 1 */
+#define NEGATE 0x83, 0xf0, 0x01
+/* movq rax, xmm0 */
+#define REAL_RESULT 0x66, 0x48, 0x0f, 0x7e, 0xc0
+
+/* Reals are computed in the same way as the builtin functions compute
+ * them: addition starts from a positive zero, and comparisons with NaN
+ * are false before they are negated */
+static const stencil_t stencils[] = {
+    /* push rbx; mov rbx, rdi */
+    [STENCIL_ENTRY] = {{0x53, 0x48, 0x89, 0xfb}, 4, HOLE_NONE, 0},
+    /* pop rbx; ret */
+    [STENCIL_RETURN] = {{0x5b, 0xc3}, 2, HOLE_NONE, 0},
+    /* mov rax, imm64 */
+    [STENCIL_CONSTANT] = {{0x48, 0xb8}, 10, HOLE_IMM64, 2},
+    /* mov rax, [rbx + disp32] */
+    [STENCIL_LOAD] = {{0x48, 0x8b, 0x83}, 7, HOLE_IMM32, 3},
+    /* pop rax; mov [rbx + disp32], rax */
+    [STENCIL_STORE] = {{0x58, 0x48, 0x89, 0x83}, 8, HOLE_IMM32, 4},
+    /* push rax */
+    [STENCIL_PUSH] = {{0x50}, 1, HOLE_NONE, 0},
+    /* pop rcx; add rax, rcx */
+    [STENCIL_INTEGER_ADD] = {{0x59, 0x48, 0x01, 0xc8}, 4, HOLE_NONE, 0},
+    /* mov rcx, rax; pop rax; sub rax, rcx */
+    [STENCIL_INTEGER_SUB] = {{0x48, 0x89, 0xc1, 0x58, 0x48, 0x29, 0xc8}, 7,
+                             HOLE_NONE, 0},
+    /* pop rcx; imul rax, rcx */
+    [STENCIL_INTEGER_MUL] = {{0x59, 0x48, 0x0f, 0xaf, 0xc1}, 5, HOLE_NONE, 0},
+    /* sete al */
+    [STENCIL_INTEGER_EQ] = {{INTEGER_COMPARE, 0x0f, 0x94, 0xc0, ZERO_EXTEND},
+                            13, HOLE_NONE, 0},
+    /* setne al */
+    [STENCIL_INTEGER_NEQ] = {{INTEGER_COMPARE, 0x0f, 0x95, 0xc0, ZERO_EXTEND},
+                             13, HOLE_NONE, 0},
+    /* setl al */
+    [STENCIL_INTEGER_LT] = {{INTEGER_COMPARE, 0x0f, 0x9c, 0xc0, ZERO_EXTEND},
+                            13, HOLE_NONE, 0},
+    /* setle al */
+    [STENCIL_INTEGER_LE] = {{INTEGER_COMPARE, 0x0f, 0x9e, 0xc0, ZERO_EXTEND},
+                            13, HOLE_NONE, 0},
+    /* setg al */
+    [STENCIL_INTEGER_GT] = {{INTEGER_COMPARE, 0x0f, 0x9f, 0xc0, ZERO_EXTEND},
+                            13, HOLE_NONE, 0},
+    /* setge al */
+    [STENCIL_INTEGER_GE] = {{INTEGER_COMPARE, 0x0f, 0x9d, 0xc0, ZERO_EXTEND},
+                            13, HOLE_NONE, 0},
+    /* xorpd xmm2, xmm2; addsd xmm2, xmm0; addsd xmm2, xmm1;
+     * movq rax, xmm2 */
+    [STENCIL_REAL_ADD] = {{REAL_OPERANDS, 0x66, 0x0f, 0x57, 0xd2, 0xf2, 0x0f,
+                           0x58, 0xd0, 0xf2, 0x0f, 0x58, 0xd1, 0x66, 0x48,
+                           0x0f, 0x7e, 0xd0},
+                          28, HOLE_NONE, 0},
+    /* subsd xmm0, xmm1 */
+    [STENCIL_REAL_SUB] = {{REAL_OPERANDS, 0xf2, 0x0f, 0x5c, 0xc1, REAL_RESULT},
+                          20, HOLE_NONE, 0},
+    /* mulsd xmm0, xmm1 */
+    [STENCIL_REAL_MUL] = {{REAL_OPERANDS, 0xf2, 0x0f, 0x59, 0xc1, REAL_RESULT},
+                          20, HOLE_NONE, 0},
+    /* ucomisd xmm0, xmm1; sete al; setnp cl; and al, cl */
+    [STENCIL_REAL_EQ] = {{REAL_OPERANDS, 0x66, 0x0f, 0x2e, 0xc1, 0x0f, 0x94,
+                          0xc0, 0x0f, 0x9b, 0xc1, 0x20, 0xc8, ZERO_EXTEND},
+                         26, HOLE_NONE, 0},
+    [STENCIL_REAL_NEQ] = {{REAL_OPERANDS, 0x66, 0x0f, 0x2e, 0xc1, 0x0f, 0x94,
+                           0xc0, 0x0f, 0x9b, 0xc1, 0x20, 0xc8, ZERO_EXTEND,
+                           NEGATE},
+                          29, HOLE_NONE, 0},
+    /* ucomisd xmm1, xmm0; seta al */
+    [STENCIL_REAL_LT] = {{REAL_OPERANDS, 0x66, 0x0f, 0x2e, 0xc8, 0x0f, 0x97,
+                          0xc0, ZERO_EXTEND},
+                         21, HOLE_NONE, 0},
+    /* ucomisd xmm1, xmm0; setae al */
+    [STENCIL_REAL_LE] = {{REAL_OPERANDS, 0x66, 0x0f, 0x2e, 0xc8, 0x0f, 0x93,
+                          0xc0, ZERO_EXTEND},
+                         21, HOLE_NONE, 0},
+    [STENCIL_REAL_GT] = {{REAL_OPERANDS, 0x66, 0x0f, 0x2e, 0xc8, 0x0f, 0x93,
+                          0xc0, ZERO_EXTEND, NEGATE},
+                         24, HOLE_NONE, 0},
+    [STENCIL_REAL_GE] = {{REAL_OPERANDS, 0x66, 0x0f, 0x2e, 0xc8, 0x0f, 0x97,
+                          0xc0, ZERO_EXTEND, NEGATE},
+                         24, HOLE_NONE, 0},
+    /* test rax, rax; jz rel32 */
+    [STENCIL_BRANCH_FALSE] = {{0x48, 0x85, 0xc0, 0x0f, 0x84}, 9, HOLE_REL32,
+                              5},
+    /* jmp rel32 */
+    [STENCIL_JUMP] = {{0xe9}, 5, HOLE_REL32, 1},
+    /* mov rdi, rsp; call rel32 */
+    [STENCIL_CALL] = {{0x48, 0x89, 0xe7, 0xe8}, 8, HOLE_REL32, 4},
+    /* add rsp, imm32 */
+    [STENCIL_DROP] = {{0x48, 0x81, 0xc4}, 7, HOLE_IMM32, 3}};
+
+struct native_emitter {
+  unsigned char *bytes;
+  size_t size;
+  size_t capacity;
+};
+
+struct native_code {
+  void *memory;
+  size_t size;
+};
+
+native_emitter_ptr new_native_emitter(void) {
+  native_emitter_ptr e = malloc(sizeof *e);
+  e->capacity = 256;
+  e->size = 0;
+  e->bytes = malloc(e->capacity);
+  return e;
+}
+
+size_t native_position(native_emitter_ptr e) { return e->size; }
+
+static void write_le(unsigned char *dest, uint64_t value, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    dest[i] = (value >> (8 * i)) & 0xff;
+  }
+}
+
+size_t native_emit(native_emitter_ptr e, native_stencil_t stencil,
+                   uint64_t value) {
+  const stencil_t *s = &stencils[stencil];
+  if (e->size + s->size > e->capacity) {
+    e->capacity = 2 * (e->size + s->size);
+    e->bytes = realloc(e->bytes, e->capacity);
+  }
+
+  unsigned char *dest = e->bytes + e->size;
+  memcpy(dest, s->bytes, s->size);
+  size_t hole = e->size + s->offset;
+  e->size += s->size;
+
+  switch (s->hole) {
+  case HOLE_NONE:
+    break;
+  case HOLE_IMM64:
+    write_le(dest + s->offset, value, 8);
+    break;
+  case HOLE_IMM32:
+    write_le(dest + s->offset, value, 4);
+    break;
+  case HOLE_REL32:
+    native_patch_jump(e, hole, value);
+    break;
+  }
+
+  return hole;
+}
+
+void native_patch_jump(native_emitter_ptr e, size_t hole, size_t target) {
+  /* The displacement is relative to the end of the instruction, which
+   * is the end of the hole */
+  int32_t displacement = (int32_t)target - (int32_t)(hole + 4);
+  write_le(e->bytes + hole, (uint32_t)displacement, 4);
+}
+
+native_code_ptr native_finish(native_emitter_ptr e) {
+  size_t page = sysconf(_SC_PAGESIZE);
+  size_t size = (e->size + page - 1) / page * page;
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    return NULL;
+  }
+
+  /* The memory is never writable and executable at the same time */
+  memcpy(memory, e->bytes, e->size);
+  if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+    munmap(memory, size);
+    return NULL;
+  }
+
+  native_code_ptr code = malloc(sizeof *code);
+  code->memory = memory;
+  code->size = size;
+  return code;
+}
+
+void delete_native_emitter(native_emitter_ptr e) {
+  free(e->bytes);
+  free(e);
+}
+
+uint64_t native_run(native_code_ptr code, uint64_t *slots) {
+  uint64_t (*entry)(uint64_t *);
+  /* Object pointers cannot be converted to function pointers directly
+   * in ISO C */
+  memcpy(&entry, &code->memory, sizeof entry);
+  return entry(slots);
+}
+
+void delete_native_code(native_code_ptr code) {
+  munmap(code->memory, code->size);
+  free(code);
+}
+
+#else
+
+native_emitter_ptr new_native_emitter(void) { return NULL; }
+
+size_t native_position(native_emitter_ptr e) { abort(); }
+
+size_t native_emit(native_emitter_ptr e, native_stencil_t stencil,
+                   uint64_t value) {
+  abort();
+}
+
+void native_patch_jump(native_emitter_ptr e, size_t hole, size_t target) {
+  abort();
+}
+
+native_code_ptr native_finish(native_emitter_ptr e) { abort(); }
+
+void delete_native_emitter(native_emitter_ptr e) { abort(); }
+
+uint64_t native_run(native_code_ptr code, uint64_t *slots) { abort(); }
+
+void delete_native_code(native_code_ptr code) { abort(); }
+
+#endif
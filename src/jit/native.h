@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "jit.h"
+/// @file native.h
+
+#ifndef THEORYLISP_JIT_NATIVE_H
+#define THEORYLISP_JIT_NATIVE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Machine code emitter for the native tier of the compiler.
+ *
+ * Code is built by copying precompiled stencils, which are short
+ * sequences of x86-64 instructions, one after another and patching the
+ * holes in them with constants, slot offsets and jump targets. The
+ * finished code is copied to memory that is mapped as executable once it
+ * is no longer writable.
+ *
+ * Compiled code is a function that takes an array of 64-bit slots
+ * holding its parameters and returns a 64-bit value. Values are kept in
+ * rax, and the left operands of binary operations are pushed on the
+ * machine stack. Integers and booleans are stored as integers, and reals
+ * as the bits of a double.
+ *
+ * The native tier is only available on x86-64 Linux. Elsewhere
+ * new_native_emitter returns NULL.
+ */
+
+typedef enum {
+  /// Saves rbx and sets it to the slot array
+  STENCIL_ENTRY,
+  /// Restores rbx and returns rax
+  STENCIL_RETURN,
+  /// Loads a 64-bit constant into rax
+  STENCIL_CONSTANT,
+  /// Loads the slot at the given byte offset into rax
+  STENCIL_LOAD,
+  /// Pops a value into the slot at the given byte offset
+  STENCIL_STORE,
+  /// Pushes rax
+  STENCIL_PUSH,
+  STENCIL_INTEGER_ADD,
+  STENCIL_INTEGER_SUB,
+  STENCIL_INTEGER_MUL,
+  STENCIL_INTEGER_EQ,
+  STENCIL_INTEGER_NEQ,
+  STENCIL_INTEGER_LT,
+  STENCIL_INTEGER_LE,
+  STENCIL_INTEGER_GT,
+  STENCIL_INTEGER_GE,
+  STENCIL_REAL_ADD,
+  STENCIL_REAL_SUB,
+  STENCIL_REAL_MUL,
+  STENCIL_REAL_EQ,
+  STENCIL_REAL_NEQ,
+  STENCIL_REAL_LT,
+  STENCIL_REAL_LE,
+  STENCIL_REAL_GT,
+  STENCIL_REAL_GE,
+  /// Jumps to the given position if rax is zero
+  STENCIL_BRANCH_FALSE,
+  /// Jumps to the given position
+  STENCIL_JUMP,
+  /// Calls the code at the given position with the pushed slots
+  STENCIL_CALL,
+  /// Pops the given number of bytes
+  STENCIL_DROP
+} native_stencil_t;
+
+struct native_emitter;
+typedef struct native_emitter *native_emitter_ptr;
+
+struct native_code;
+typedef struct native_code *native_code_ptr;
+
+/**
+ * Returns a new empty emitter, or NULL if the native tier is not
+ * available.
+ */
+native_emitter_ptr new_native_emitter(void);
+
+/**
+ * Returns the position at which the next stencil is copied.
+ */
+size_t native_position(native_emitter_ptr e);
+
+/**
+ * Copies a stencil and patches its hole with the given value. The value
+ * of a jump or a call is the position of its target. Returns the
+ * position of the hole.
+ */
+size_t native_emit(native_emitter_ptr e, native_stencil_t stencil,
+                   uint64_t value);
+
+/**
+ * Sets the target of the jump whose hole is at the given position.
+ */
+void native_patch_jump(native_emitter_ptr e, size_t hole, size_t target);
+
+/**
+ * Copies the code to executable memory. Returns NULL if the memory
+ * cannot be mapped.
+ */
+native_code_ptr native_finish(native_emitter_ptr e);
+
+void delete_native_emitter(native_emitter_ptr e);
+
+/**
+ * Runs native code from position 0 with the given slots.
+ */
+uint64_t native_run(native_code_ptr code, uint64_t *slots);
+
+void delete_native_code(native_code_ptr code);
+
+#endif
@@ -21,17 +21,34 @@
 #include <stdio.h>
 #include <locale.h>
 #include <time.h>
+#include <unistd.h>
 
+#include "aot/aot.h"
 #include "builtin/builtin.h"
 #include "expressions/expression.h"
 #include "interpreter/interpreter.h"
 #include "interpreter/stack_frame.h"
+#include "jit/jit.h"
+#include "optimizer/optimizer.h"
 #include "parser/parser.h"
 #include "scanner/scanner.h"
+#include "types/collector.h"
 #include "types/error.h"
 #include "types/void.h"
 #include "utils/file.h"
 #include "utils/init.h"
+#include "utils/port.h"
+#include "utils/slab.h"
+
+static void print_stats(void) {
+  fprintf(stderr, "Allocations:\n");
+  print_object_stats(stderr);
+  print_expr_stats(stderr);
+  fprintf(stderr, "Cycle collector:\n");
+  print_collector_stats(stderr);
+  fprintf(stderr, "Slabs:\n");
+  print_slab_stats(stderr);
+}
 
 int main(int argc, char **argv) {
   setlocale(LC_ALL, "");
@@ -40,34 +57,91 @@ int main(int argc, char **argv) {
   program_arguments args;
   parse_args(argc, argv, &args);
 
+  if (args.stats) {
+    atexit(print_stats);
+  }
+
+  if (args.deferred_free) {
+    set_deferred_free(true);
+  }
+
+  if (args.jit_check) {
+    jit_set_mode(JIT_CHECK);
+  } else if (args.jit) {
+    jit_set_mode(JIT_ON);
+  }
+
   stack_frame_ptr global_frame = new_stack_frame(NULL);
   define_builtin_function_wrappers(global_frame);
 
   objectptr result = make_void();
-  if (args.filename) {
-    char *code = read_file(args.filename);
+  if (args.filename && args.stream && !args.emit_c) {
+    FILE *file = fopen(args.filename, "r");
+    if (!file) {
+      delete_stack_frame(global_frame);
+      delete_object(result);
+      print_error_and_exit(2, "Cannot read file %s\n", args.filename);
+    }
+
+    delete_object(result);
+    result = stream_interpreter(file, args.verbose, args.quiet, args.optimize,
+                                global_frame);
+    fclose(file);
+    if (!result) {
+      delete_stack_frame(global_frame);
+      print_error_and_exit(4, "A parser error has occured.\n");
+    }
+  } else if (args.filename) {
+    mapped_file_ptr code = map_file(args.filename);
     if (!code) {
       delete_stack_frame(global_frame);
       delete_object(result);
       print_error_and_exit(2, "Cannot read file %s\n", args.filename);
     }
 
-    tokenstreamptr tokens = scanner(code);
-    free(code);
+    tokenstreamptr tokens = scanner_n(code->data, code->length);
+    unmap_file(code);
     if (!tokens) {
       delete_stack_frame(global_frame);
       delete_object(result);
       print_error_and_exit(3, "A scanner error has occured.\n");
     }
 
+    /* Output of the code that runs while the program is parsed is not
+     * mixed with the generated C code */
+    int output = -1;
+    if (args.emit_c) {
+      flush_standard_output();
+      output = dup(STDOUT_FILENO);
+      dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+
     listptr parse_tree = parser(tokens, global_frame);
     delete_tokenstream(tokens);
+
+    if (args.emit_c) {
+      flush_standard_output();
+      dup2(output, STDOUT_FILENO);
+      close(output);
+    }
     if (!parse_tree) {
       delete_stack_frame(global_frame);
       delete_object(result);
       print_error_and_exit(4, "A parser error has occured.\n");
     }
 
+    if (args.optimize) {
+      optimize_parse_tree(parse_tree, true, global_frame);
+    }
+
+    if (args.emit_c) {
+      aot_emit_program(stdout, parse_tree, global_frame);
+      delete_parse_tree(parse_tree);
+      delete_stack_frame(global_frame);
+      delete_object(result);
+      return EXIT_SUCCESS;
+    }
+
     assign_object(&result, interpreter(parse_tree, args.verbose, args.quiet,
                                        global_frame));
     delete_parse_tree(parse_tree);
@@ -79,6 +153,17 @@ int main(int argc, char **argv) {
 
   delete_object(result);
   delete_stack_frame(global_frame);
+  set_deferred_free(false);
+
+  /* Cycles that were unreachable from the global variables are freed,
+   * along with the objects they kept alive */
+  while (collect_cycles() > 0) {
+  }
+
+  if (jit_check_failures() > 0) {
+    print_error_and_exit(5, "%zu compiled operations gave different results.\n",
+                         jit_check_failures());
+  }
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,502 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "optimizer.h"
+
+#include <string.h>
+
+#include "../builtin/builtin.h"
+#include "../expressions/data.h"
+#include "../expressions/expanded.h"
+#include "../expressions/identifier.h"
+#include "../expressions/lambda.h"
+#include "../expressions/let.h"
+#include "../types/procedure.h"
+#include "../utils/hashtable.h"
+#include "../utils/string.h"
+
+/* Largest number of expressions in the body of an inlined procedure */
+#define MAX_INLINE_SIZE 24
+
+/* Largest number of inlined calls nested inside each other */
+#define MAX_INLINE_DEPTH 8
+
+/* Builtin functions that can be evaluated before the program runs */
+static const char *foldable_builtins[] = {
+    "=", "!=", "<", "<=", ">", ">=",
+    "null?", "void?", "boolean?", "integer?", "real?", "rational?",
+    "number?", "string?", "pair?", "procedure?",
+    "+", "*", "-", "/", "&", "|", "xor", "not",
+    "strlen", "strcat", "charat", "strcar", "strcdr",
+    "string-index", "string-contains", "string-replace",
+    "newline", "tab", "backspace", "quotation-mark", "i2s", "s2i",
+    "cos", "sin", "tan", "acos", "asin", "atan", "atan2",
+    "cosh", "sinh", "tanh", "acosh", "asinh", "atanh",
+    "exp", "log", "log10", "pow", "sqrt", "cbrt", "hypot",
+    "erf", "erfc", "tgamma", "lgamma",
+    "ceil", "floor", "trunc", "round", "modulo",
+    "isfinite", "isinf", "isnan", "isnormal"};
+
+/* Builtin functions that run code which is not part of the parse tree */
+static const char *dynamic_code_builtins[] = {"eval", "load"};
+
+/* Builtin functions other than the foldable ones that may be called
+ * from an inlined procedure body. None of them calls a procedure or
+ * looks up a variable by its name, so they cannot observe the renamed
+ * parameters. */
+static const char *inlinable_builtins[] = {
+    "begin", "begin0", "void", "display", "putchar",
+    "cons", "car", "cdr", "list", "substr", "error", "random",
+    "dict-ref", "dict-contains?", "dict-size", "dict-set", "dict-remove",
+    "dict-merge"};
+
+/* Whether a procedure can be inlined */
+typedef enum {
+  INLINE_UNKNOWN,
+  INLINE_IN_PROGRESS,
+  INLINE_YES,
+  INLINE_NO
+} inline_state_t;
+
+/* What is known about a global name */
+typedef struct {
+  /// Number of define expressions with this name
+  size_t definitions;
+  /// True if the name is assigned with set! or bound locally
+  bool assigned;
+  /// Value of the top-level definition if it is a literal
+  objectptr value;
+  /// True after the definition is passed in the program order
+  bool active;
+  /// Lambda expression of the top-level definition
+  exprptr lambda;
+  /// Whether calls to the procedure can be replaced with its body
+  inline_state_t inline_state;
+  /// True if the name is used by the program or a procedure it uses
+  bool referenced;
+} name_info;
+
+struct optimizer {
+  stack_frame_ptr sf;
+  bool whole_program;
+  /// True while the program is searched for constants
+  bool analyzing;
+  /// True if the program calls eval or load
+  bool dynamic_code;
+  /// The top-level expression that is being optimized
+  exprptr current_form;
+  hashtableptr names;
+  /// Names in the order they are first referenced while analyzing
+  listptr referenced;
+  /// Replacements of the parameters of the procedure being inlined
+  hashtableptr params;
+  /// Number of expressions that can still be copied into an inlined body
+  size_t inline_budget;
+  /// Number of inlined calls that are being optimized
+  size_t inline_depth;
+  /// Used to generate unique parameter names
+  size_t inline_counter;
+};
+
+static void name_info_destructor(void *value) {
+  name_info *info = value;
+  if (info->value) {
+    delete_object(info->value);
+  }
+  if (info->lambda) {
+    delete_expr(info->lambda);
+  }
+  free(info);
+}
+
+static name_info *get_name_info(optimizer_ptr opt, const char *name) {
+  name_info *info = hash_table_get(opt->names, name);
+  if (!info) {
+    info = malloc(sizeof *info);
+    info->definitions = 0;
+    info->assigned = false;
+    info->value = NULL;
+    info->active = false;
+    info->lambda = NULL;
+    info->inline_state = INLINE_UNKNOWN;
+    info->referenced = false;
+    hash_table_put(opt->names, name, info);
+  }
+
+  return info;
+}
+
+static bool is_constant(optimizer_ptr opt, name_info *info) {
+  return !opt->dynamic_code && info->definitions == 1 && !info->assigned &&
+         info->value;
+}
+
+void optimizer_note_binding(optimizer_ptr opt, const char *name) {
+  get_name_info(opt, name)->assigned = true;
+}
+
+void optimizer_note_assignment(optimizer_ptr opt, const char *name) {
+  get_name_info(opt, name)->assigned = true;
+}
+
+void optimizer_note_definition(optimizer_ptr opt, exprptr definition,
+                               const char *name, exprptr value) {
+  name_info *info = get_name_info(opt, name);
+  bool top_level = definition == opt->current_form;
+
+  if (opt->analyzing) {
+    info->definitions++;
+    if (top_level && is_data_expr(value) && !info->value) {
+      info->value = clone_object(get_data_value(value));
+    }
+    if (top_level && is_lambda_expr(value) && !info->lambda) {
+      info->lambda = clone_expr(value);
+    }
+  } else if (top_level) {
+    info->active = true;
+  }
+}
+
+void optimizer_note_reference(optimizer_ptr opt, const char *name) {
+  if (!opt->analyzing) {
+    return;
+  }
+
+  name_info *info = get_name_info(opt, name);
+  if (!info->referenced) {
+    info->referenced = true;
+    list_add(opt->referenced, strdup(name));
+  }
+}
+
+void optimizer_note_call(optimizer_ptr opt, const char *name) {
+  optimizer_note_reference(opt, name);
+  for (size_t i = 0;
+       i < sizeof dynamic_code_builtins / sizeof *dynamic_code_builtins; ++i) {
+    if (strcmp(name, dynamic_code_builtins[i]) == 0) {
+      opt->dynamic_code = true;
+    }
+  }
+}
+
+objectptr optimizer_get_constant(optimizer_ptr opt, const char *name) {
+  if (opt->analyzing || !opt->whole_program) {
+    return NULL;
+  }
+
+  /* $1, $2, ... are implicitly bound in PN expressions */
+  if (name[0] == '$') {
+    return NULL;
+  }
+
+  name_info *info = hash_table_get(opt->names, name);
+  if (!info || !info->active || !is_constant(opt, info)) {
+    return NULL;
+  }
+
+  return info->value;
+}
+
+bool optimizer_is_foldable_builtin(const char *name) {
+  for (size_t i = 0; i < sizeof foldable_builtins / sizeof *foldable_builtins;
+       ++i) {
+    if (strcmp(name, foldable_builtins[i]) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+stack_frame_ptr optimizer_stack_frame(optimizer_ptr opt) { return opt->sf; }
+
+static bool in_name_list(const char *name, const char **names, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (strcmp(name, names[i]) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/* Finds the lambda expression of a global procedure that is never
+ * redefined or assigned. Procedures defined at the top level of the
+ * program and procedures that were created before the program is
+ * optimized, such as library functions, are considered. */
+static exprptr find_global_lambda(optimizer_ptr opt, name_info *info,
+                                  const char *name) {
+  if (opt->dynamic_code || info->assigned) {
+    return NULL;
+  }
+
+  if (info->definitions == 1) {
+    return info->active ? info->lambda : NULL;
+  }
+
+  if (info->definitions > 0 || !stack_frame_defined(opt->sf, name)) {
+    return NULL;
+  }
+
+  objectptr value = stack_frame_get_variable(opt->sf, name);
+  if (is_procedure(value) && is_lambda_expr(procedure_get_lambda(value))) {
+    info->lambda = clone_expr(procedure_get_lambda(value));
+  }
+  delete_object(value);
+  return info->lambda;
+}
+
+/* The replacements of the parameters are not owned by the table */
+static void keep_replacement(void *replacement) {}
+
+/* Copies the body of lambda, replacing its parameters with the given
+ * expressions. Returns NULL if the body is too large or contains
+ * expressions that cannot be inlined. */
+static exprptr copy_lambda_body(optimizer_ptr opt, exprptr lambda,
+                                exprptr *replacements) {
+  hashtableptr saved_params = opt->params;
+  size_t saved_budget = opt->inline_budget;
+
+  opt->params = new_hash_table(8);
+  opt->inline_budget = MAX_INLINE_SIZE;
+  for (size_t i = 0; i < lambda_expr_get_arity(lambda); ++i) {
+    hash_table_put(opt->params, lambda_expr_get_param(lambda, i),
+                   replacements[i]);
+  }
+
+  exprptr body = optimizer_copy_inlined(opt, lambda_expr_get_body(lambda));
+
+  delete_hash_table(opt->params, keep_replacement);
+  opt->params = saved_params;
+  opt->inline_budget = saved_budget;
+  return body;
+}
+
+/* Copies the body of lambda to find out whether it is small enough and
+ * calls only the functions that can be inlined */
+static bool is_inlinable_body(optimizer_ptr opt, exprptr lambda) {
+  size_t nparams = lambda_expr_get_arity(lambda);
+  exprptr *params = malloc(nparams * sizeof *params);
+  for (size_t i = 0; i < nparams; ++i) {
+    params[i] = new_identifier_expr(lambda_expr_get_param(lambda, i), NULL);
+  }
+
+  exprptr body = copy_lambda_body(opt, lambda, params);
+  delete_expr(body);
+
+  for (size_t i = 0; i < nparams; ++i) {
+    delete_expr(params[i]);
+  }
+  free(params);
+  return body != NULL;
+}
+
+/* Returns the lambda expression of the procedure with the given name
+ * if calls to it can be replaced with its body, otherwise NULL. */
+static exprptr get_inlinable_lambda(optimizer_ptr opt, const char *name) {
+  if (opt->analyzing || !opt->whole_program || find_builtin_function(name)) {
+    return NULL;
+  }
+
+  name_info *info = get_name_info(opt, name);
+  switch (info->inline_state) {
+  case INLINE_YES:
+    return info->lambda;
+  case INLINE_NO:
+  case INLINE_IN_PROGRESS:
+    /* A recursive procedure is never inlined */
+    return NULL;
+  case INLINE_UNKNOWN:
+    break;
+  }
+
+  /* Calls before the definition are left as they are */
+  if (info->definitions == 1 && !info->active) {
+    return NULL;
+  }
+
+  info->inline_state = INLINE_IN_PROGRESS;
+  exprptr lambda = find_global_lambda(opt, info, name);
+  bool inlinable = lambda && !lambda_expr_is_variadic(lambda) &&
+                   !lambda_expr_has_captures(lambda);
+
+  if (inlinable) {
+    inlinable = is_inlinable_body(opt, lambda);
+  }
+
+  info->inline_state = inlinable ? INLINE_YES : INLINE_NO;
+  return inlinable ? lambda : NULL;
+}
+
+exprptr optimizer_copy_inlined(optimizer_ptr opt, exprptr e) {
+  if (opt->inline_budget == 0) {
+    return NULL;
+  }
+
+  opt->inline_budget--;
+  return inline_copy_expr(e, opt);
+}
+
+exprptr optimizer_get_replacement(optimizer_ptr opt, const char *name) {
+  return hash_table_get(opt->params, name);
+}
+
+bool optimizer_is_inlinable_call(optimizer_ptr opt, const char *name) {
+  /* A parameter may name any procedure */
+  if (hash_table_get(opt->params, name)) {
+    return false;
+  }
+
+  if (find_builtin_function(name)) {
+    return optimizer_is_foldable_builtin(name) ||
+           in_name_list(name, inlinable_builtins,
+                        sizeof inlinable_builtins / sizeof *inlinable_builtins);
+  }
+
+  return get_inlinable_lambda(opt, name) != NULL;
+}
+
+exprptr optimizer_inline_call(optimizer_ptr opt, exprptr call,
+                              const char *name, listptr args) {
+  exprptr lambda = get_inlinable_lambda(opt, name);
+  if (!lambda || opt->inline_depth >= MAX_INLINE_DEPTH) {
+    return NULL;
+  }
+
+  /* Arity errors are left to be reported at runtime */
+  size_t nargs = list_size(args);
+  if (nargs != lambda_expr_get_arity(lambda)) {
+    return NULL;
+  }
+
+  for (size_t i = 0; i < nargs; ++i) {
+    if (is_expanded_expression(list_get(args, i))) {
+      return NULL;
+    }
+  }
+
+  /* Literal arguments replace the parameters. Other parameters are given
+   * new names that cannot be written in the source code, so that they
+   * cannot be confused with the variables of the caller. */
+  exprptr *replacements = malloc(nargs * sizeof *replacements);
+  for (size_t i = 0; i < nargs; ++i) {
+    exprptr arg = list_get(args, i);
+    if (is_data_expr(arg)) {
+      replacements[i] = clone_expr(arg);
+    } else {
+      char *new_name = format("%s%%%zu", lambda_expr_get_param(lambda, i),
+                              ++opt->inline_counter);
+      replacements[i] = new_identifier_expr(new_name, NULL);
+      free(new_name);
+    }
+  }
+
+  exprptr body = copy_lambda_body(opt, lambda, replacements);
+  exprptr result = body;
+
+  /* The other arguments are bound in a let expression. Like a procedure
+   * call, it evaluates the arguments from left to right before the body,
+   * and its stack frame is a child of the caller's stack frame. */
+  for (size_t i = 0; body && i < nargs; ++i) {
+    exprptr arg = list_get(args, i);
+    if (is_data_expr(arg)) {
+      continue;
+    }
+
+    if (result == body) {
+      result = expr_set_position(new_let_expr(body, NULL), call);
+    }
+    let_expr_add_declaration(result,
+                             identifier_expr_get_name(replacements[i]),
+                             clone_expr(arg));
+  }
+
+  for (size_t i = 0; i < nargs; ++i) {
+    delete_expr(replacements[i]);
+  }
+  free(replacements);
+
+  if (!result) {
+    return NULL;
+  }
+
+  opt->inline_depth++;
+  result = optimize_expr(result, opt);
+  opt->inline_depth--;
+  return result;
+}
+
+static void optimize_top_level(optimizer_ptr opt, listptr parse_tree) {
+  for (size_t i = 0; i < list_size(parse_tree); ++i) {
+    opt->current_form = list_get(parse_tree, i);
+    list_set(parse_tree, i, optimize_expr(opt->current_form, opt));
+  }
+}
+
+/* Procedures that were created before the program is optimized, such as
+ * library functions, bind and assign variables when they are called, and
+ * since variables are dynamically scoped, they can see the variables of
+ * the program. The procedures that the program can reach by name are
+ * analyzed like the program, so that their parameters, local variables
+ * and assignments are not treated as constants. */
+static void analyze_existing_procedures(optimizer_ptr opt) {
+  opt->current_form = NULL;
+  for (size_t i = 0; i < list_size(opt->referenced); ++i) {
+    objectptr value =
+        stack_frame_peek_variable(opt->sf, list_get(opt->referenced, i));
+    if (!value || !is_procedure(value) ||
+        !is_lambda_expr(procedure_get_lambda(value))) {
+      continue;
+    }
+
+    exprptr lambda = clone_expr(procedure_get_lambda(value));
+    delete_expr(optimize_expr(lambda, opt));
+  }
+}
+
+void optimize_parse_tree(listptr parse_tree, bool whole_program,
+                         stack_frame_ptr sf) {
+  struct optimizer opt = {.sf = sf,
+                          .whole_program = whole_program,
+                          .analyzing = false,
+                          .dynamic_code = false,
+                          .current_form = NULL,
+                          .names = new_hash_table(64),
+                          .referenced = new_list(),
+                          .params = NULL,
+                          .inline_budget = 0,
+                          .inline_depth = 0,
+                          .inline_counter = 0};
+
+  /* The first pass finds the constants, and the second pass
+   * substitutes them. Both passes fold constant expressions. */
+  if (whole_program) {
+    opt.analyzing = true;
+    optimize_top_level(&opt, parse_tree);
+    analyze_existing_procedures(&opt);
+    opt.analyzing = false;
+  }
+
+  optimize_top_level(&opt, parse_tree);
+  delete_hash_table(opt.names, name_info_destructor);
+  for (size_t i = 0; i < list_size(opt.referenced); ++i) {
+    free(list_get(opt.referenced, i));
+  }
+  delete_list(opt.referenced);
+}
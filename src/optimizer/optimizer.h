@@ -0,0 +1,136 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file optimizer.h
+
+#ifndef THEORYLISP_OPTIMIZER_OPTIMIZER_H
+#define THEORYLISP_OPTIMIZER_OPTIMIZER_H
+
+#include <stdbool.h>
+
+#include "../expressions/expression.h"
+#include "../interpreter/stack_frame.h"
+#include "../types/object.h"
+#include "../utils/list.h"
+
+/**
+ * Optimizes a parse tree in place before it is interpreted.
+ *
+ * Calls to pure builtin functions whose arguments are literals are
+ * replaced with their results, and if and cond expressions whose
+ * conditions are literals are replaced with the selected case.
+ *
+ * If whole_program is true, the parse tree is assumed to contain the
+ * entire program. Global variables that are defined once at the top level
+ * with a literal value, and are never assigned with set!, defined again,
+ * or bound as a parameter or local variable anywhere in the program or in
+ * the existing procedures that it uses, such as library functions, are
+ * then replaced with their values in the expressions that follow their
+ * definitions. Programs that call eval or load are not analyzed this way,
+ * since the code that they run cannot be seen in advance.
+ *
+ * In the same way, calls to small global procedures that are never
+ * redefined or assigned are replaced with their bodies. Parameters whose
+ * arguments are literals are replaced with the literals. The others are
+ * renamed and bound to the arguments in a let expression, so the arguments
+ * are still evaluated once, from left to right, before the body. Recursive procedures, procedures with
+ * captured variables and variadic procedures are not inlined. Neither
+ * are procedures that read variables other than their parameters and
+ * global constants, directly or through the procedures they call, since
+ * the caller could bind those variables under the renamed names.
+ */
+void optimize_parse_tree(listptr parse_tree, bool whole_program,
+                         stack_frame_ptr sf);
+
+/* The following functions are used by the expressions while they
+ * optimize themselves. */
+
+/**
+ * Records that name is a parameter or a local variable.
+ */
+void optimizer_note_binding(optimizer_ptr opt, const char *name);
+
+/**
+ * Records that name is assigned a new value with set!.
+ */
+void optimizer_note_assignment(optimizer_ptr opt, const char *name);
+
+/**
+ * Records that the given define expression defines name with the given
+ * (already optimized) value.
+ */
+void optimizer_note_definition(optimizer_ptr opt, exprptr definition,
+                               const char *name, exprptr value);
+
+/**
+ * Records that the value of the variable with the given name is used.
+ */
+void optimizer_note_reference(optimizer_ptr opt, const char *name);
+
+/**
+ * Records a call to the procedure with the given name.
+ */
+void optimizer_note_call(optimizer_ptr opt, const char *name);
+
+/**
+ * Returns the value of the global constant with the given name,
+ * or NULL if name is not a constant at this point of the program.
+ * The returned object must not be deleted.
+ */
+objectptr optimizer_get_constant(optimizer_ptr opt, const char *name);
+
+/**
+ * True if the builtin function with the given name always returns
+ * the same value for the same arguments and has no side effects.
+ */
+bool optimizer_is_foldable_builtin(const char *name);
+
+/**
+ * Returns the stack frame that is used to evaluate constant expressions.
+ */
+stack_frame_ptr optimizer_stack_frame(optimizer_ptr opt);
+
+/**
+ * Copies a part of the body of a procedure that is being inlined.
+ * Returns NULL if the body is too large or e cannot be inlined.
+ */
+exprptr optimizer_copy_inlined(optimizer_ptr opt, exprptr e);
+
+/**
+ * Returns the expression that replaces a parameter of the procedure that
+ * is being inlined, or NULL if name is not a parameter.
+ * The returned expression must not be deleted.
+ */
+exprptr optimizer_get_replacement(optimizer_ptr opt, const char *name);
+
+/**
+ * True if a call to the function with the given name can be a part
+ * of an inlined procedure body.
+ */
+bool optimizer_is_inlinable_call(optimizer_ptr opt, const char *name);
+
+/**
+ * Replaces call, a call to the procedure with the given name and
+ * arguments, with the body of the procedure. Returns NULL if the
+ * procedure cannot be inlined. call and args are not modified.
+ */
+exprptr optimizer_inline_call(optimizer_ptr opt, exprptr call,
+                              const char *name, listptr args);
+
+#endif
@@ -24,10 +24,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../utils/arena.h"
 #include "../utils/list.h"
 #include "../utils/string.h"
 
-#define INITIAL_TOKEN_SIZE 128
 #define INITIAL_WORD_SIZE 128
 
 static const struct {
@@ -56,50 +56,43 @@ static const struct {
                           {'\\', TOKEN_BACKSLASH},
                           {':', TOKEN_COLON}};
 
-typedef enum {
-  ST_WHITESPACE,
-  ST_TOKEN,
-  ST_SINGLE_LINE_COMMENT,
-  ST_STRING
-} scanner_state;
-
+/* State of the scanner while it walks over the input */
 typedef struct {
+  const char *input;
+  size_t length;
+  size_t position;
+  size_t line;
+  /// Position of the first character of the current line
+  size_t line_start;
+  /// Column number of the character at line_start
+  size_t first_column;
+  /// Null terminated copy of the word being classified
   char *word;
   size_t word_capacity;
-  size_t line;
-  size_t column;
-  size_t first_column_of_word;
-  size_t position_in_input;
-  size_t position_in_current_word;
-} scanner_position_data;
-
-static inline bool is_semicolon(char c) { return c == L';'; }
-
-static inline bool is_newline(char c) { return c == L'\n'; }
-
-static inline bool is_quote(char c) { return c == L'\"'; }
-
-static inline bool is_space(char c) { return isspace(c); }
-
-static inline void chrcat(char **str, size_t *capacity, char chr) {
-  if (strlen(*str) == *capacity - 1) {
-    *str = realloc(*str, (*capacity *= 2));
+  arenaptr arena;
+  listptr tokens;
+} scanner_data;
+
+static inline bool is_special_character(char c) {
+  switch (c) {
+    case '(': case ')': case '[': case ']': case '{': case '}':
+    case '%': case '\\': case ':':
+      return true;
+    default:
+      return false;
   }
-
-  size_t len = strlen(*str);
-  (*str)[len] = chr;
-  (*str)[len + 1] = '\0';
 }
 
-static bool token_special_character(token_type_t *type, token_value_t *value,
-                                    const char *word) {
-  if (strlen(word) != 1) {
-    return false;
-  }
+/* Characters that end a sequence of tokens that are not separated
+ * by whitespace */
+static inline bool is_word_delimiter(char c) {
+  return c == ';' || c == '"' || isspace((unsigned char)c);
+}
 
+static bool token_special_character(token_type_t *type, char c) {
   for (size_t i = 0; i < sizeof special_characters / sizeof *special_characters;
        ++i) {
-    if (word[0] == special_characters[i].c) {
+    if (c == special_characters[i].c) {
       *type = special_characters[i].type;
       return true;
     }
@@ -181,26 +174,6 @@ static bool token_number(token_type_t *type, token_value_t *value,
   return false;
 }
 
-static bool token_identifier(token_type_t *type, token_value_t *value,
-                             const char *word) {
-  for (size_t i = 0; i < sizeof special_characters / sizeof *special_characters;
-       ++i) {
-    if (strchr(word, special_characters[i].c)) {
-      return false;
-    }
-  }
-
-  if (isdigit(word[0])) {
-    return false;
-  }
-
-  *type = TOKEN_IDENTIFIER;
-  value->character_sequence = malloc(strlen(word) + 1);
-  strcpy(value->character_sequence, word);
-
-  return true;
-}
-
 char *token_tostring(tokenptr token) {
   switch (token->type) {
     case TOKEN_END_OF_FILE:
@@ -234,211 +207,269 @@ char *token_tostring(tokenptr token) {
   }
 }
 
-static bool get_tokens(listptr token_list, const char *str, size_t line_number,
-                       size_t column_number) {
-  size_t offset = 0;
-
-  while (offset < strlen(str)) {
-    size_t current_token_capacity = INITIAL_TOKEN_SIZE;
-    char *current_token = calloc(current_token_capacity, 1);
-
-    token_type_t tkn_type = TOKEN_END_OF_FILE;
-    token_value_t tkn_value;
-
-    size_t previous_offset = offset;
-    for (size_t i = offset; i < strlen(str); ++i) {
-      chrcat(&current_token, &current_token_capacity, str[i]);
-
-      token_type_t new_tkn_type = TOKEN_END_OF_FILE;
-      token_value_t new_tkn_value;
+static inline size_t current_column(scanner_data *s) {
+  return s->position - s->line_start + s->first_column;
+}
 
-      if (token_special_character(&new_tkn_type, &new_tkn_value,
-                                  current_token) ||
-          token_keyword(&new_tkn_type, &new_tkn_value, current_token) ||
-          token_number(&new_tkn_type, &new_tkn_value, current_token) ||
-          token_boolean(&new_tkn_type, &new_tkn_value, current_token) ||
-          token_identifier(&new_tkn_type, &new_tkn_value, current_token)) {
-        if (tkn_type == TOKEN_IDENTIFIER) {
-          free(tkn_value.character_sequence);
-        }
+static void add_token(scanner_data *s, token_type_t type, token_value_t value,
+                      size_t column) {
+  tokenptr tkn = arena_alloc(s->arena, sizeof *tkn);
+  tkn->type = type;
+  tkn->value = value;
+  tkn->line = s->line;
+  tkn->column = column;
+  list_add(s->tokens, tkn);
+}
 
-        tkn_type = new_tkn_type;
-        tkn_value = new_tkn_value;
-        (offset = i + 1);
-      }
+/* copies the next length characters of the input into the word buffer
+ * so that the classifiers can work on a null terminated string */
+static void set_word(scanner_data *s, size_t length) {
+  if (length >= s->word_capacity) {
+    while (length >= s->word_capacity) {
+      s->word_capacity *= 2;
     }
-
-    if (tkn_type == TOKEN_END_OF_FILE) {
-      free(current_token);
-      return false;
-    }
-
-    token_t *token = malloc(sizeof *token);
-    token->type = tkn_type;
-    token->value = tkn_value;
-    token->line = line_number;
-    token->column = column_number + previous_offset;
-    list_add(token_list, token);
-
-    free(current_token);
+    s->word = realloc(s->word, s->word_capacity);
   }
 
-  return true;
+  memcpy(s->word, s->input + s->position, length);
+  s->word[length] = '\0';
 }
 
-static scanner_state scanner_state_whitespace(char c, scanner_position_data *p,
-                                              listptr tokens) {
-  if (is_semicolon(c)) {
-    return ST_SINGLE_LINE_COMMENT;
-  }
+/* Splits the characters up to end into tokens. Special characters are
+ * tokens by themselves. Any other run of characters becomes a single
+ * token, except that a run beginning with a digit is cut after its
+ * longest prefix that is a number. */
+static void scan_word(scanner_data *s, size_t end) {
+  while (s->position < end) {
+    size_t column = current_column(s);
+    token_type_t type = TOKEN_END_OF_FILE;
+    token_value_t value = {.integer = 0};
+
+    if (token_special_character(&type, s->input[s->position])) {
+      add_token(s, type, value, column);
+      s->position++;
+      continue;
+    }
 
-  if (is_quote(c)) {
-    p->first_column_of_word = p->column;
-    return ST_STRING;
-  }
+    size_t run_length = 0;
+    while (s->position + run_length < end &&
+           !is_special_character(s->input[s->position + run_length])) {
+      ++run_length;
+    }
 
-  if (!is_space(c)) {
-    if (p->position_in_current_word == p->word_capacity - 1) {
-      p->word = realloc(p->word, (p->word_capacity *= 2));
+    set_word(s, run_length);
+    if (isdigit((unsigned char)s->word[0])) {
+      /* a single digit is always a number, so this terminates */
+      while (!token_number(&type, &value, s->word)) {
+        s->word[--run_length] = '\0';
+      }
+    } else if (!token_keyword(&type, &value, s->word) &&
+               !token_number(&type, &value, s->word) &&
+               !token_boolean(&type, &value, s->word)) {
+      type = TOKEN_IDENTIFIER;
+      value.character_sequence =
+          arena_strndup(s->arena, s->word, run_length);
     }
 
-    p->word[p->position_in_current_word++] = c;
-    p->first_column_of_word = p->column;
-    return ST_TOKEN;
+    add_token(s, type, value, column);
+    s->position += run_length;
   }
-
-  return ST_WHITESPACE;
 }
 
-static scanner_state scanner_state_string(char c, scanner_position_data *p,
-                                          listptr tokens) {
-  if (is_quote(c)) {
-    p->word[p->position_in_current_word] = '\0';
-
-    token_t *tkn = malloc(sizeof *tkn);
-    tkn->line = p->line;
-    tkn->column = p->first_column_of_word;
-    tkn->type = TOKEN_STRING;
-    tkn->value.character_sequence = malloc(strlen(p->word) + 1);
-    strcpy(tkn->value.character_sequence, p->word);
-    list_add(tokens, tkn);
-
-    memset(p->word, 0, p->word_capacity);
-    p->position_in_current_word = 0;
-    return ST_WHITESPACE;
-  }
-
-  if (p->position_in_current_word == p->word_capacity - 1) {
-    p->word = realloc(p->word, (p->word_capacity *= 2));
+/* Scans a string literal starting at the opening quote. A string that
+ * is not terminated extends to the end of the input. */
+static void scan_string(scanner_data *s) {
+  size_t column = current_column(s);
+  size_t start = s->position + 1;
+  const char *quote = memchr(s->input + start, '"', s->length - start);
+  size_t end = quote ? (size_t)(quote - s->input) : s->length;
+
+  token_value_t value;
+  value.character_sequence =
+      arena_strndup(s->arena, s->input + start, end - start);
+  add_token(s, TOKEN_STRING, value, column);
+
+  /* strings may span multiple lines */
+  const char *newline = s->input + start;
+  while ((newline = memchr(newline, '\n', s->input + end - newline))) {
+    s->line++;
+    s->line_start = ++newline - s->input;
+    s->first_column = 1;
   }
 
-  p->word[p->position_in_current_word++] = c;
-  return ST_STRING;
+  s->position = quote ? end + 1 : end;
 }
 
-static scanner_state scanner_state_token(char c, scanner_position_data *p,
-                                         listptr tokens) {
-  if (is_semicolon(c) || is_space(c) || is_quote(c)) {
-    p->word[p->position_in_current_word] = '\0';
-    get_tokens(tokens, p->word, p->line, p->first_column_of_word);
-    memset(p->word, 0, p->word_capacity);
-    p->position_in_current_word = 0;
+tokenstreamptr scanner_at(const char *input, size_t length, size_t line,
+                          size_t column) {
+  scanner_data s = {.input = input,
+                    .length = length,
+                    .position = 0,
+                    .line = line,
+                    .line_start = 0,
+                    .first_column = column,
+                    .word = malloc(INITIAL_WORD_SIZE),
+                    .word_capacity = INITIAL_WORD_SIZE,
+                    .arena = new_arena(),
+                    .tokens = new_list()};
+
+  while (s.position < length) {
+    char c = input[s.position];
+
+    if (c == '\n') {
+      s.line++;
+      s.line_start = ++s.position;
+      s.first_column = 1;
+    } else if (c == ';') {
+      /* skip to the end of the comment */
+      const char *newline = memchr(input + s.position, '\n',
+                                   length - s.position);
+      s.position = newline ? (size_t)(newline - input) : length;
+    } else if (c == '"') {
+      scan_string(&s);
+    } else if (isspace((unsigned char)c)) {
+      s.position++;
+    } else {
+      size_t end = s.position;
+      while (end < length && !is_word_delimiter(input[end])) {
+        ++end;
+      }
+      scan_word(&s, end);
+    }
   }
 
-  if (is_semicolon(c)) {
-    return ST_SINGLE_LINE_COMMENT;
-  }
+  free(s.word);
 
-  if (is_quote(c)) {
-    p->first_column_of_word = p->column;
-    return ST_STRING;
-  }
+  /* add a final token that denotes the end of the file */
+  token_value_t no_value = {.integer = 0};
+  add_token(&s, TOKEN_END_OF_FILE, no_value, current_column(&s));
 
-  if (is_space(c)) {
-    return ST_WHITESPACE;
-  }
+  /* return a "token stream" object that stores the current token position
+   * and the list of tokens */
+  tokenstreamptr tkns = malloc(sizeof *tkns);
+  tkns->tokens = s.tokens;
+  tkns->arena = s.arena;
+  tkns->index = 0;
+  return tkns;
+}
 
-  p->word[p->position_in_current_word++] = c;
-  return ST_TOKEN;
+tokenstreamptr scanner_n(const char *input, size_t length) {
+  return scanner_at(input, length, 1, 1);
 }
 
-static scanner_state scanner_state_comment(char c, scanner_position_data *p,
-                                           listptr tokens) {
-  if (is_newline(c)) {
-    return ST_WHITESPACE;
-  }
+tokenstreamptr scanner(const char *input) {
+  return scanner_n(input, strlen(input));
+}
 
-  return ST_SINGLE_LINE_COMMENT;
+void init_form_state(form_state_t *state) {
+  state->position = 0;
+  state->depth = 0;
+  state->started = false;
+  state->in_string = false;
 }
 
-tokenstreamptr scanner(const char *input) {
-  listptr token_list = new_list();
+form_status_t find_top_level_form(const char *input, size_t length,
+                                  size_t *end) {
+  form_state_t state;
+  init_form_state(&state);
+  return find_top_level_form_from(input, length, &state, end);
+}
 
-  scanner_state state = ST_WHITESPACE;
-  scanner_position_data position = {.position_in_input = 0,
-                                    .position_in_current_word = 0,
-                                    .column = 1,
-                                    .line = 1,
-                                    .first_column_of_word = 1,
-                                    .word_capacity = INITIAL_WORD_SIZE,
-                                    .word = calloc(INITIAL_WORD_SIZE, 1)};
+/* Follows the same rules as the scanner to skip comments, strings and
+ * words, and counts brackets to find where the first expression ends.
+ * A comment or a word that reaches the end of the input is scanned again
+ * in the next call, since it ends on the same line. */
+form_status_t find_top_level_form_from(const char *input, size_t length,
+                                       form_state_t *state, size_t *end) {
+  size_t position = state->position;
+
+  for (;;) {
+    if (state->in_string) {
+      const char *quote = memchr(input + position, '"', length - position);
+      if (!quote) {
+        state->position = length;
+        return FORM_INCOMPLETE;
+      }
 
-  size_t length = strlen(input);
+      position = quote - input + 1;
+      state->in_string = false;
+      if (state->depth == 0) {
+        state->position = position;
+        *end = position;
+        return FORM_COMPLETE;
+      }
+    }
 
-  for (; position.position_in_input < length; ++position.position_in_input) {
-    char c = input[position.position_in_input];
+    if (position == length) {
+      break;
+    }
 
-    switch (state) {
-      case ST_WHITESPACE:
-        state = scanner_state_whitespace(c, &position, token_list);
-        break;
-      case ST_STRING:
-        state = scanner_state_string(c, &position, token_list);
-        break;
-      case ST_TOKEN:
-        state = scanner_state_token(c, &position, token_list);
-        break;
-      case ST_SINGLE_LINE_COMMENT:
-        state = scanner_state_comment(c, &position, token_list);
+    char c = input[position];
+
+    if (c == ';') {
+      const char *newline = memchr(input + position, '\n', length - position);
+      if (!newline) {
         break;
+      }
+      position = newline - input;
+      continue;
     }
 
-    if (is_newline(c)) {
-      position.column = 1;
-      position.line++;
-    } else {
-      position.column++;
+    if (isspace((unsigned char)c)) {
+      ++position;
+      continue;
     }
-  }
 
-  /* add the last token that was being processed when end of file was reached */
-  get_tokens(token_list, position.word, position.line, position.column);
-  free(position.word);
+    state->started = true;
+
+    if (c == '"') {
+      state->in_string = true;
+      ++position;
+      continue;
+    } else if (c == '(' || c == '[' || c == '{') {
+      ++state->depth;
+      ++position;
+      continue;
+    } else if (c == ')' || c == ']' || c == '}') {
+      /* an unmatched closing bracket is left to the parser to report */
+      if (state->depth > 0) {
+        --state->depth;
+      }
+      ++position;
+    } else if (c == '%') {
+      /* expansion applies to the expression that follows it */
+      ++position;
+      continue;
+    } else if (is_special_character(c)) {
+      ++position;
+    } else {
+      size_t word = position;
+      while (position < length && !is_word_delimiter(input[position]) &&
+             !is_special_character(input[position])) {
+        ++position;
+      }
 
-  /* add a final token that denotes the end of the file */
-  tokenptr token_eof = malloc(sizeof *token_eof);
-  token_eof->type = TOKEN_END_OF_FILE;
-  token_eof->line = position.line;
-  token_eof->column = position.column;
-  list_add(token_list, token_eof);
+      /* the word may continue in the input that is not yet available */
+      if (position == length) {
+        state->position = word;
+        return FORM_INCOMPLETE;
+      }
+    }
 
-  /* return a "token stream" object that stores the current token position
-   * and the list of tokens */
-  tokenstreamptr tkns = malloc(sizeof *tkns);
-  tkns->tokens = token_list;
-  tkns->index = 0;
-  return tkns;
+    if (state->depth == 0) {
+      state->position = position;
+      *end = position;
+      return FORM_COMPLETE;
+    }
+  }
+
+  state->position = position;
+  return state->started ? FORM_INCOMPLETE : FORM_EMPTY;
 }
 
 void delete_tokenstream(tokenstreamptr tkns) {
-  for (size_t i = 0; i < list_size(tkns->tokens); ++i) {
-    tokenptr tkn = list_get(tkns->tokens, i);
-    if (tkn->type == TOKEN_IDENTIFIER || tkn->type == TOKEN_STRING) {
-      free(tkn->value.character_sequence);
-    }
-    free(tkn);
-  }
   delete_list(tkns->tokens);
+  delete_arena(tkns->arena);
   free(tkns);
 }
 
@@ -25,6 +25,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#include "../utils/arena.h"
 #include "../utils/list.h"
 #include "../utils/string.h"
 
@@ -117,19 +118,80 @@ typedef token_t *tokenptr;
 
 typedef struct tokenstream{
   listptr tokens;
+  /// Memory that holds the tokens and their character sequences
+  arenaptr arena;
   size_t index;
 } tokenstream_t;
 
 typedef tokenstream_t *tokenstreamptr;
 
 /**
- * Takes a char array and returns a list of tokens
- *
- * If an error occurs during scanning, the constructed portion of the list is
- * deallocated and NULL is returned.
+ * Takes a null terminated char array and returns a list of tokens
  */
 tokenstreamptr scanner(const char *input);
 
+/**
+ * Takes the first length characters of input and returns a list of tokens.
+ * The input does not need to be null terminated, and it is not referenced
+ * by the returned tokens, so it can be released right after scanning.
+ */
+tokenstreamptr scanner_n(const char *input, size_t length);
+
+/**
+ * Same as scanner_n, but the first character of input is assumed to be
+ * at the given line and column of the source code.
+ */
+tokenstreamptr scanner_at(const char *input, size_t length, size_t line,
+                          size_t column);
+
+typedef enum {
+  /// The input contains a whole top-level expression
+  FORM_COMPLETE,
+  /// An expression begins in the input, but it does not end there
+  FORM_INCOMPLETE,
+  /// The input consists of whitespace and comments only
+  FORM_EMPTY
+} form_status_t;
+
+/**
+ * Progress of find_top_level_form_from through an input that grows
+ */
+typedef struct {
+  /// Number of characters that do not need to be scanned again
+  size_t position;
+  /// Number of brackets that are not yet closed
+  size_t depth;
+  /// True if the expression has begun
+  bool started;
+  /// True if the scanned characters end inside a string
+  bool in_string;
+} form_state_t;
+
+/**
+ * Initializes state to scan an input from its beginning.
+ */
+void init_form_state(form_state_t *state);
+
+/**
+ * Finds the end of the first top-level expression in the first length
+ * characters of input without scanning it into tokens. If the expression
+ * is complete, the number of characters up to and including it is stored
+ * in end. Unbalanced closing brackets form expressions on their own, so
+ * that they can be reported by the parser.
+ */
+form_status_t find_top_level_form(const char *input, size_t length,
+                                  size_t *end);
+
+/**
+ * Same as find_top_level_form, but continues from the given state. If
+ * the expression is not complete, the state is updated, so that more
+ * characters can be appended to input and only the new ones are scanned
+ * in the next call. If the input is empty, state->position is the number
+ * of characters that can be removed from its beginning.
+ */
+form_status_t find_top_level_form_from(const char *input, size_t length,
+                                       form_state_t *state, size_t *end);
+
 /**
  * Returns the string representation of a token.
  * Substituting the result into the scanner must give the same token
@@ -27,14 +27,17 @@
 
 #define ERR_OPERAND_NOT_BOOL "Boolean AND operands must be booleans"
 
+static object_stats_t boolean_stats;
+
 static const object_type_t boolean_type_id = {{.destroy = destroy_boolean,
                                                .tostring = boolean_tostring,
                                                .equals = boolean_equals,
                                                .op_and = boolean_op_and,
                                                .op_or = boolean_op_or,
                                                .op_xor = boolean_op_xor,
-                                               .op_not = boolean_op_not},
-                                              "boolean"};
+                                               .op_not = boolean_op_not,
+                                               .hash = boolean_hash},
+                                              "boolean", sizeof(boolean_t), &boolean_stats};
 
 inline boolean_t boolean_value(objectptr obj) {
   assert(is_boolean(obj));
@@ -46,15 +49,13 @@ bool is_boolean(objectptr obj) {
 }
 
 objectptr make_boolean(boolean_t value) {
-  boolean_t *bool_value = malloc(sizeof *bool_value);
-  *bool_value = value;
-
-  return object_base_new(bool_value, &boolean_type_id);
+  objectptr obj = object_base_new_inline(&boolean_type_id);
+  *(boolean_t *)obj->value = value;
+  return obj;
 }
 
 void destroy_boolean(objectptr obj) {
   assert(is_boolean(obj));
-  free(obj->value);
 }
 
 char *boolean_tostring(objectptr obj) {
@@ -71,6 +72,12 @@ bool boolean_equals(objectptr obj, objectptr other) {
   return boolean_value(obj) == boolean_value(other);
 }
 
+bool boolean_hash(objectptr obj, size_t *hash) {
+  assert(is_boolean(obj));
+  *hash = boolean_value(obj) ? 1231 : 1237;
+  return true;
+}
+
 objectptr boolean_op_and(objectptr obj, objectptr other) {
   assert(is_boolean(obj));
   if (!is_boolean(other)) {
@@ -43,6 +43,9 @@ char *boolean_tostring(objectptr val);
 /** Tests equality of two boolean values. */
 bool boolean_equals(objectptr val, objectptr other);
 
+/** Hashes a boolean value */
+bool boolean_hash(objectptr val, size_t *hash);
+
 /** True if and only if given object is a boolean. */
 bool is_boolean(objectptr obj);
 
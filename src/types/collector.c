@@ -0,0 +1,260 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "collector.h"
+
+#include <assert.h>
+
+#include "object-base.h"
+#include "../utils/list.h"
+#include "../utils/stack.h"
+
+/* Possible roots of garbage cycles, created when the first one is found */
+static listptr roots = NULL;
+
+static size_t threshold = DEFAULT_COLLECTOR_THRESHOLD;
+
+/* Statistics */
+static size_t collections = 0;
+static size_t buffered_roots = 0;
+static size_t collected_objects = 0;
+
+static void traverse(objectptr obj, object_visitor visit, void *context) {
+  obj->type_id->vtable.traverse(obj, visit, context);
+}
+
+static void check_acyclic(objectptr child, void *context) {
+  bool *acyclic = context;
+  if (!is_acyclic(child)) {
+    *acyclic = false;
+  }
+}
+
+void collector_init_object(objectptr obj) {
+  bool acyclic = true;
+  traverse(obj, check_acyclic, &acyclic);
+  if (acyclic) {
+    obj->color = COLOR_GREEN;
+  }
+}
+
+bool is_acyclic(objectptr obj) {
+  return !obj->type_id->vtable.traverse || obj->color == COLOR_GREEN;
+}
+
+void collector_possible_root(objectptr obj) {
+  if (obj->color == COLOR_GREEN) {
+    return;
+  }
+
+  obj->color = COLOR_PURPLE;
+  if (!obj->buffered) {
+    obj->buffered = true;
+    if (!roots) {
+      roots = new_list();
+    }
+    list_add(roots, obj);
+    ++buffered_roots;
+  }
+}
+
+/* Acyclic children are never part of a cycle, so they are skipped by
+ * every phase, and their reference counts are not changed */
+
+static void mark_gray_child(objectptr child, void *stack) {
+  if (!is_acyclic(child)) {
+    --child->ref_count;
+    stack_push(stack, child);
+  }
+}
+
+/* Subtracts the references between the objects that are reachable
+ * from obj */
+static void mark_gray(objectptr obj, stackptr stack) {
+  stack_push(stack, obj);
+  while (!stack_is_empty(stack)) {
+    objectptr next = stack_pop(stack);
+    if (next->color != COLOR_GRAY) {
+      next->color = COLOR_GRAY;
+      traverse(next, mark_gray_child, stack);
+    }
+  }
+}
+
+static void scan_black_child(objectptr child, void *stack) {
+  if (!is_acyclic(child)) {
+    ++child->ref_count;
+    if (child->color != COLOR_BLACK) {
+      child->color = COLOR_BLACK;
+      stack_push(stack, child);
+    }
+  }
+}
+
+/* Restores the references of the objects that are reachable from an
+ * object that is referenced from outside */
+static void scan_black(objectptr obj, stackptr stack) {
+  obj->color = COLOR_BLACK;
+  stack_push(stack, obj);
+  while (!stack_is_empty(stack)) {
+    traverse(stack_pop(stack), scan_black_child, stack);
+  }
+}
+
+static void push_child(objectptr child, void *stack) {
+  if (!is_acyclic(child)) {
+    stack_push(stack, child);
+  }
+}
+
+/* Colors the objects that are reachable from obj and have no references
+ * from outside white */
+static void scan(objectptr obj, stackptr stack, stackptr black_stack) {
+  stack_push(stack, obj);
+  while (!stack_is_empty(stack)) {
+    objectptr next = stack_pop(stack);
+    if (next->color != COLOR_GRAY) {
+      continue;
+    }
+
+    if (next->ref_count > 0) {
+      scan_black(next, black_stack);
+    } else {
+      next->color = COLOR_WHITE;
+      traverse(next, push_child, stack);
+    }
+  }
+}
+
+/* Adds the white objects that are reachable from obj to garbage. They
+ * are marked as buffered, so that they are not remembered as possible
+ * roots while they are deleted. */
+static void collect_white(objectptr obj, stackptr stack, listptr garbage) {
+  stack_push(stack, obj);
+  while (!stack_is_empty(stack)) {
+    objectptr next = stack_pop(stack);
+    if (next->color == COLOR_WHITE && !next->buffered) {
+      next->color = COLOR_BLACK;
+      next->buffered = true;
+      list_add(garbage, next);
+      traverse(next, push_child, stack);
+    }
+  }
+}
+
+static void restore_child(objectptr child, void *context) {
+  if (!is_acyclic(child)) {
+    ++child->ref_count;
+  }
+}
+
+/* Deletes the objects of garbage cycles. The references between them are
+ * restored first, so that destroying the objects releases them in the
+ * usual way. Each object is kept alive by an extra reference until all
+ * of them are destroyed. */
+static void delete_garbage(listptr garbage) {
+  size_t n = list_size(garbage);
+  for (size_t i = 0; i < n; ++i) {
+    traverse(list_get(garbage, i), restore_child, NULL);
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    objectptr obj = list_get(garbage, i);
+    ++obj->ref_count;
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    objectptr obj = list_get(garbage, i);
+    obj->type_id->vtable.destroy(obj);
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    objectptr obj = list_get(garbage, i);
+    assert(obj->ref_count == 1);
+    object_base_free(obj);
+  }
+}
+
+size_t collect_cycles(void) {
+  if (!roots) {
+    return 0;
+  }
+
+  listptr candidates = roots;
+  roots = NULL;
+  stackptr stack = new_stack();
+  stackptr black_stack = new_stack();
+
+  /* Objects that are deleted while they are possible roots are freed
+   * here, and the other roots are marked */
+  listptr marked = new_list();
+  for (size_t i = 0; i < list_size(candidates); ++i) {
+    objectptr obj = list_get(candidates, i);
+    if (obj->color == COLOR_PURPLE && obj->ref_count > 0) {
+      mark_gray(obj, stack);
+      list_add(marked, obj);
+    } else {
+      obj->buffered = false;
+      if (obj->color == COLOR_BLACK && obj->ref_count == 0) {
+        object_base_free(obj);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < list_size(marked); ++i) {
+    scan(list_get(marked, i), stack, black_stack);
+  }
+
+  listptr garbage = new_list();
+  for (size_t i = 0; i < list_size(marked); ++i) {
+    objectptr obj = list_get(marked, i);
+    obj->buffered = false;
+    collect_white(obj, stack, garbage);
+  }
+
+  delete_garbage(garbage);
+
+  size_t collected = list_size(garbage);
+  ++collections;
+  collected_objects += collected;
+
+  delete_list(garbage);
+  delete_list(marked);
+  delete_list(candidates);
+  delete_stack(stack);
+  delete_stack(black_stack);
+  return collected;
+}
+
+void collector_safe_point(void) {
+  if (threshold > 0 && roots && list_size(roots) >= threshold) {
+    collect_cycles();
+  }
+}
+
+size_t collector_set_threshold(size_t new_threshold) {
+  size_t previous = threshold;
+  threshold = new_threshold;
+  return previous;
+}
+
+void print_collector_stats(FILE *file) {
+  fprintf(file, "  %zu collections, %zu possible roots, %zu objects in "
+          "cycles\n", collections, buffered_roots, collected_objects);
+}
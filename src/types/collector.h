@@ -0,0 +1,105 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file collector.h
+
+#ifndef THEORYLISP_TYPES_COLLECTOR_H
+#define THEORYLISP_TYPES_COLLECTOR_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "object.h"
+
+/**
+ * \brief Collector of reference cycles.
+ *
+ * An object is deleted when its reference count drops to zero, which does
+ * not happen to objects that refer to each other in a cycle. The collector
+ * finds such objects with trial deletion (Bacon and Rajan, "Concurrent
+ * Cycle Collection in Reference Counted Systems", 2001).
+ *
+ * Only objects of types that implement the traverse operation can be part
+ * of a cycle. When the reference count of such an object is decreased but
+ * does not reach zero, the object is remembered as a possible root of a
+ * garbage cycle. Once the number of possible roots reaches a threshold,
+ * the next call to collector_safe_point subtracts the references between
+ * the objects that are reachable from the roots, and deletes the objects
+ * that are left with no references from outside.
+ *
+ * An object whose children cannot be part of a cycle, and which cannot be
+ * changed to refer to other objects, is acyclic and is never remembered.
+ */
+
+#define DEFAULT_COLLECTOR_THRESHOLD 10000
+
+/** Colors of objects during collection */
+enum {
+  /// In use or free
+  COLOR_BLACK = 0,
+  /// Possible member of a cycle
+  COLOR_GRAY,
+  /// Member of a garbage cycle
+  COLOR_WHITE,
+  /// Possible root of a cycle
+  COLOR_PURPLE,
+  /// Acyclic
+  COLOR_GREEN
+};
+
+/**
+ * Marks a new object of an immutable type that implements traverse as
+ * acyclic if none of the objects it refers to can be part of a cycle.
+ * Called by the constructors of such types.
+ */
+void collector_init_object(objectptr obj);
+
+/** Returns true if the object cannot be part of a reference cycle */
+bool is_acyclic(objectptr obj);
+
+/**
+ * Remembers an object whose reference count is decreased to a nonzero
+ * value as a possible root of a garbage cycle.
+ */
+void collector_possible_root(objectptr obj);
+
+/**
+ * Deletes the garbage cycles that are reachable from the possible roots.
+ * Returns the number of deleted objects.
+ */
+size_t collect_cycles(void);
+
+/**
+ * Collects cycles if the number of possible roots has reached the
+ * threshold. Called where no object is referenced without being counted
+ * except by its owners, such as between top-level expressions and after
+ * procedure calls.
+ */
+void collector_safe_point(void);
+
+/**
+ * Sets the number of possible roots that starts a collection, and returns
+ * the previous threshold. Zero disables automatic collection.
+ */
+size_t collector_set_threshold(size_t threshold);
+
+/** Prints the number of collections and the objects they deleted */
+void print_collector_stats(FILE *file);
+
+#endif
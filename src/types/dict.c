@@ -0,0 +1,843 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dict.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../types/error.h"
+#include "../types/null.h"
+#include "../types/pair.h"
+#include "../types/void.h"
+#include "collector.h"
+#include "object-base.h"
+
+#define ERR_UNHASHABLE "Dictionary key cannot be hashed"
+#define ERR_NOT_ALIST "Given object is not an association list"
+
+/* Number of hash bits that select a slot at each level of a trie */
+#define HAMT_BITS 5
+#define HAMT_MASK ((1u << HAMT_BITS) - 1)
+
+#define MIN_TABLE_CAPACITY 8
+
+typedef struct hamt_node hamt_node_t;
+
+/* A slot holds either a key and its value, or a child node if key is
+ * NULL. The hash of the key is stored with it so that it is computed
+ * only once. */
+typedef struct {
+  size_t hash;
+  objectptr key;
+  union {
+    objectptr value;
+    hamt_node_t *child;
+  };
+} hamt_slot_t;
+
+/* A node has a slot for each bit that is set in its bitmap, in the order
+ * of the bits. The keys of a collision node have equal hashes, and its
+ * bitmap is not used. Nodes are shared between dicts and counted by
+ * refs. Only nodes that are not shared are changed. */
+struct hamt_node {
+  size_t refs;
+  uint32_t bitmap;
+  uint32_t count;
+  bool collision;
+  hamt_slot_t slots[];
+};
+
+typedef struct {
+  hamt_node_t *root;
+  size_t size;
+} dict_t;
+
+typedef struct {
+  size_t hash;
+  objectptr key;
+  objectptr value;
+} table_entry_t;
+
+/* Mutable dicts are hash tables with linear probing. Empty entries have
+ * NULL keys. */
+typedef struct {
+  table_entry_t *entries;
+  size_t capacity;
+  size_t size;
+} mutable_dict_t;
+
+static object_stats_t dict_stats;
+static object_stats_t mutable_dict_stats;
+
+static const object_type_t dict_type_id = {{
+    .destroy = destroy_dict,
+    .equals = dict_equals,
+    .tostring = dict_tostring,
+    .print = dict_print,
+    .traverse = dict_traverse},
+    "dict", sizeof(dict_t), &dict_stats};
+
+/* Mutable dicts implement traverse but are never marked acyclic, since
+ * their values can be changed to refer back to them */
+static const object_type_t mutable_dict_type_id = {{
+    .destroy = destroy_mutable_dict,
+    .equals = dict_equals,
+    .tostring = dict_tostring,
+    .print = dict_print,
+    .traverse = dict_traverse},
+    "mutable-dict", sizeof(mutable_dict_t), &mutable_dict_stats};
+
+bool is_dict(objectptr obj) {
+  return obj->type_id == &dict_type_id ||
+         strcmp(dict_type_id.type_name, obj->type_id->type_name) == 0;
+}
+
+bool is_mutable_dict(objectptr obj) {
+  return obj->type_id == &mutable_dict_type_id ||
+         strcmp(mutable_dict_type_id.type_name, obj->type_id->type_name) ==
+             0;
+}
+
+/* Computes the hash of a key. The hash of the object is mixed, since the
+ * trie and the table use its lowest bits first. */
+static bool key_hash(objectptr key, size_t *hash) {
+  size_t value;
+  if (!object_hash(key, &value)) {
+    return false;
+  }
+
+  uint64_t bits = value;
+  bits ^= bits >> 33;
+  bits *= 0xff51afd7ed558ccdULL;
+  bits ^= bits >> 33;
+  bits *= 0xc4ceb9fe1a85ec53ULL;
+  bits ^= bits >> 33;
+  *hash = (size_t)bits;
+  return true;
+}
+
+/* Hash array mapped trie */
+
+static size_t node_size(uint32_t count) {
+  return sizeof(hamt_node_t) + count * sizeof(hamt_slot_t);
+}
+
+static hamt_node_t *new_node(uint32_t count) {
+  hamt_node_t *node = malloc(node_size(count));
+  node->refs = 1;
+  node->bitmap = 0;
+  node->count = count;
+  node->collision = false;
+  return node;
+}
+
+static void release_node(hamt_node_t *node);
+
+static void retain_slot(hamt_slot_t *slot) {
+  if (slot->key) {
+    clone_object(slot->key);
+    clone_object(slot->value);
+  } else {
+    ++slot->child->refs;
+  }
+}
+
+static void release_slot(hamt_slot_t *slot) {
+  if (slot->key) {
+    delete_object(slot->key);
+    delete_object(slot->value);
+  } else {
+    release_node(slot->child);
+  }
+}
+
+static void release_node(hamt_node_t *node) {
+  if (--node->refs == 0) {
+    for (uint32_t i = 0; i < node->count; ++i) {
+      release_slot(&node->slots[i]);
+    }
+    free(node);
+  }
+}
+
+static hamt_slot_t make_leaf(size_t hash, objectptr key, objectptr value) {
+  hamt_slot_t slot = {.hash = hash, .key = clone_object(key)};
+  slot.value = clone_object(value);
+  return slot;
+}
+
+static void replace_value(hamt_slot_t *slot, objectptr value) {
+  /* The new value is stored before the old one is deleted, since
+   * deleting it may delete the value */
+  objectptr old = slot->value;
+  slot->value = clone_object(value);
+  delete_object(old);
+}
+
+/* Takes over a reference to node, and returns node itself if it is not
+ * shared, or a copy of it otherwise. The result has room for count
+ * slots. */
+static hamt_node_t *writable_node(hamt_node_t *node, uint32_t count) {
+  if (node->refs == 1) {
+    return count > node->count ? realloc(node, node_size(count)) : node;
+  }
+
+  hamt_node_t *copy = malloc(node_size(count > node->count ? count
+                                                           : node->count));
+  copy->refs = 1;
+  copy->bitmap = node->bitmap;
+  copy->count = node->count;
+  copy->collision = node->collision;
+  memcpy(copy->slots, node->slots, node->count * sizeof(hamt_slot_t));
+  for (uint32_t i = 0; i < copy->count; ++i) {
+    retain_slot(&copy->slots[i]);
+  }
+
+  /* The node is shared, so it is not freed */
+  --node->refs;
+  return copy;
+}
+
+/* Returns a copy of node and its descendants that does not share any
+ * nodes with it */
+static hamt_node_t *copy_tree(hamt_node_t *node) {
+  hamt_node_t *copy = malloc(node_size(node->count));
+  copy->refs = 1;
+  copy->bitmap = node->bitmap;
+  copy->count = node->count;
+  copy->collision = node->collision;
+  memcpy(copy->slots, node->slots, node->count * sizeof(hamt_slot_t));
+  for (uint32_t i = 0; i < copy->count; ++i) {
+    if (copy->slots[i].key) {
+      retain_slot(&copy->slots[i]);
+    } else {
+      copy->slots[i].child = copy_tree(copy->slots[i].child);
+    }
+  }
+  return copy;
+}
+
+static uint32_t slot_position(uint32_t bitmap, uint32_t bit) {
+  return (uint32_t)__builtin_popcount(bitmap & (bit - 1));
+}
+
+/* Returns a node for the level at the given shift that contains two
+ * slots. The slots are put in a collision node if their hashes are
+ * equal, and into deeper nodes until their hashes differ otherwise. */
+static hamt_node_t *pair_node(hamt_slot_t first, hamt_slot_t second,
+                              unsigned shift) {
+  if (first.hash == second.hash) {
+    assert(first.key && second.key);
+    hamt_node_t *node = new_node(2);
+    node->collision = true;
+    node->slots[0] = first;
+    node->slots[1] = second;
+    return node;
+  }
+
+  uint32_t first_index = (first.hash >> shift) & HAMT_MASK;
+  uint32_t second_index = (second.hash >> shift) & HAMT_MASK;
+  if (first_index == second_index) {
+    hamt_node_t *node = new_node(1);
+    node->bitmap = 1u << first_index;
+    node->slots[0].hash = first.hash;
+    node->slots[0].key = NULL;
+    node->slots[0].child = pair_node(first, second, shift + HAMT_BITS);
+    return node;
+  }
+
+  hamt_node_t *node = new_node(2);
+  node->bitmap = (1u << first_index) | (1u << second_index);
+  node->slots[first_index < second_index ? 0 : 1] = first;
+  node->slots[first_index < second_index ? 1 : 0] = second;
+  return node;
+}
+
+static hamt_slot_t *node_find(hamt_node_t *node, size_t hash,
+                              objectptr key) {
+  for (unsigned shift = 0;; shift += HAMT_BITS) {
+    if (node->collision) {
+      for (uint32_t i = 0; i < node->count; ++i) {
+        hamt_slot_t *slot = &node->slots[i];
+        if (slot->hash == hash && object_equals(slot->key, key)) {
+          return slot;
+        }
+      }
+      return NULL;
+    }
+
+    uint32_t bit = 1u << ((hash >> shift) & HAMT_MASK);
+    if (!(node->bitmap & bit)) {
+      return NULL;
+    }
+
+    hamt_slot_t *slot = &node->slots[slot_position(node->bitmap, bit)];
+    if (slot->key) {
+      return slot->hash == hash && object_equals(slot->key, key) ? slot
+                                                                 : NULL;
+    }
+    node = slot->child;
+  }
+}
+
+/* Takes over a reference to node, and returns a reference to a node that
+ * maps key to value. Sets *added if key was not in the node. */
+static hamt_node_t *node_insert(hamt_node_t *node, unsigned shift,
+                                size_t hash, objectptr key, objectptr value,
+                                bool *added) {
+  if (node->collision) {
+    if (hash != node->slots[0].hash) {
+      hamt_slot_t existing = {.hash = node->slots[0].hash, .key = NULL};
+      existing.child = node;
+      *added = true;
+      return pair_node(existing, make_leaf(hash, key, value), shift);
+    }
+
+    for (uint32_t i = 0; i < node->count; ++i) {
+      if (object_equals(node->slots[i].key, key)) {
+        node = writable_node(node, node->count);
+        replace_value(&node->slots[i], value);
+        return node;
+      }
+    }
+
+    node = writable_node(node, node->count + 1);
+    node->slots[node->count++] = make_leaf(hash, key, value);
+    *added = true;
+    return node;
+  }
+
+  uint32_t bit = 1u << ((hash >> shift) & HAMT_MASK);
+  uint32_t position = slot_position(node->bitmap, bit);
+  if (!(node->bitmap & bit)) {
+    node = writable_node(node, node->count + 1);
+    memmove(&node->slots[position + 1], &node->slots[position],
+            (node->count - position) * sizeof(hamt_slot_t));
+    node->slots[position] = make_leaf(hash, key, value);
+    node->bitmap |= bit;
+    ++node->count;
+    *added = true;
+    return node;
+  }
+
+  node = writable_node(node, node->count);
+  hamt_slot_t *slot = &node->slots[position];
+  if (!slot->key) {
+    slot->child =
+        node_insert(slot->child, shift + HAMT_BITS, hash, key, value, added);
+  } else if (slot->hash == hash && object_equals(slot->key, key)) {
+    replace_value(slot, value);
+  } else {
+    hamt_node_t *child = pair_node(*slot, make_leaf(hash, key, value),
+                                   shift + HAMT_BITS);
+    slot->key = NULL;
+    slot->child = child;
+    *added = true;
+  }
+  return node;
+}
+
+/* Takes over a reference to node, which contains key, and returns a
+ * reference to a node without it, or NULL if no keys are left */
+static hamt_node_t *node_remove(hamt_node_t *node, unsigned shift,
+                                size_t hash, objectptr key) {
+  uint32_t bit = 0;
+  uint32_t position = 0;
+  if (node->collision) {
+    while (!object_equals(node->slots[position].key, key)) {
+      ++position;
+    }
+  } else {
+    bit = 1u << ((hash >> shift) & HAMT_MASK);
+    position = slot_position(node->bitmap, bit);
+  }
+
+  node = writable_node(node, node->count);
+  hamt_slot_t *slot = &node->slots[position];
+  if (slot->key) {
+    release_slot(slot);
+  } else {
+    hamt_node_t *child =
+        node_remove(slot->child, shift + HAMT_BITS, hash, key);
+    if (child && child->count == 1 && child->slots[0].key) {
+      /* A child with a single key is replaced with the key. The child is
+       * not shared, since it has just been changed. */
+      *slot = child->slots[0];
+      free(child);
+      return node;
+    }
+    if (child) {
+      slot->child = child;
+      return node;
+    }
+  }
+
+  memmove(slot, slot + 1,
+          (node->count - position - 1) * sizeof(hamt_slot_t));
+  --node->count;
+  node->bitmap &= ~bit;
+  if (node->count == 0) {
+    free(node);
+    return NULL;
+  }
+  return node;
+}
+
+typedef void (*entry_visitor)(size_t hash, objectptr key, objectptr value,
+                              void *context);
+
+static void node_foreach(hamt_node_t *node, entry_visitor visit,
+                         void *context) {
+  for (uint32_t i = 0; i < node->count; ++i) {
+    hamt_slot_t *slot = &node->slots[i];
+    if (slot->key) {
+      visit(slot->hash, slot->key, slot->value, context);
+    } else {
+      node_foreach(slot->child, visit, context);
+    }
+  }
+}
+
+/* Dict objects */
+
+static objectptr new_dict(hamt_node_t *root, size_t size) {
+  objectptr obj = object_base_new_inline(&dict_type_id);
+  dict_t *dict = obj->value;
+  dict->root = root;
+  dict->size = size;
+  return obj;
+}
+
+objectptr make_dict(void) {
+  objectptr obj = new_dict(NULL, 0);
+  collector_init_object(obj);
+  return obj;
+}
+
+void destroy_dict(objectptr obj) {
+  assert(is_dict(obj));
+  dict_t *dict = obj->value;
+  if (dict->root) {
+    release_node(dict->root);
+  }
+}
+
+/* Returns a dict with the keys of obj whose nodes can be changed. obj is
+ * returned if it is a temporary that is not used anywhere else.
+ *
+ * The collector follows the references from each dict to its keys and
+ * values, but the references are counted once for each node. So nodes
+ * are shared only if the dict is acyclic, since the collector skips
+ * acyclic keys and values. The color is kept up to date here and in
+ * dict_insert instead of calling collector_init_object, which would
+ * visit every key. */
+static objectptr modifiable_dict(objectptr obj) {
+  if (is_reusable(obj)) {
+    return reuse_object(obj);
+  }
+
+  dict_t *dict = obj->value;
+  hamt_node_t *root = dict->root;
+  if (root && obj->color == COLOR_GREEN) {
+    ++root->refs;
+  } else if (root) {
+    root = copy_tree(root);
+  }
+
+  objectptr result = new_dict(root, dict->size);
+  if (obj->color == COLOR_GREEN) {
+    result->color = COLOR_GREEN;
+  }
+  return result;
+}
+
+/* Maps key to value in a dict returned by modifiable_dict */
+static void dict_insert(objectptr obj, size_t hash, objectptr key,
+                        objectptr value) {
+  dict_t *dict = obj->value;
+  if (!dict->root) {
+    dict->root = new_node(0);
+  }
+
+  bool added = false;
+  dict->root = node_insert(dict->root, 0, hash, key, value, &added);
+  if (added) {
+    ++dict->size;
+  }
+
+  if (obj->color == COLOR_GREEN && !(is_acyclic(key) && is_acyclic(value))) {
+    obj->color = COLOR_BLACK;
+  }
+}
+
+size_t dict_size(objectptr obj) {
+  if (is_dict(obj)) {
+    return ((dict_t *)obj->value)->size;
+  }
+
+  assert(is_mutable_dict(obj));
+  return ((mutable_dict_t *)obj->value)->size;
+}
+
+/* Mutable dict objects */
+
+static objectptr new_mutable_dict(size_t capacity) {
+  objectptr obj = object_base_new_inline(&mutable_dict_type_id);
+  mutable_dict_t *table = obj->value;
+  table->entries = calloc(capacity, sizeof(table_entry_t));
+  table->capacity = capacity;
+  table->size = 0;
+  return obj;
+}
+
+objectptr make_mutable_dict(void) {
+  return new_mutable_dict(MIN_TABLE_CAPACITY);
+}
+
+void destroy_mutable_dict(objectptr obj) {
+  assert(is_mutable_dict(obj));
+  mutable_dict_t *table = obj->value;
+  for (size_t i = 0; i < table->capacity; ++i) {
+    if (table->entries[i].key) {
+      delete_object(table->entries[i].key);
+      delete_object(table->entries[i].value);
+    }
+  }
+  free(table->entries);
+}
+
+/* Returns the entry of key, or the empty entry where it would be
+ * added */
+static table_entry_t *table_find(mutable_dict_t *table, size_t hash,
+                                 objectptr key) {
+  size_t mask = table->capacity - 1;
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    table_entry_t *entry = &table->entries[i];
+    if (!entry->key ||
+        (entry->hash == hash && object_equals(entry->key, key))) {
+      return entry;
+    }
+  }
+}
+
+/* Doubles the capacity of the table */
+static void table_grow(mutable_dict_t *table) {
+  table_entry_t *old_entries = table->entries;
+  size_t old_capacity = table->capacity;
+  table->capacity *= 2;
+  table->entries = calloc(table->capacity, sizeof(table_entry_t));
+
+  size_t mask = table->capacity - 1;
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (old_entries[i].key) {
+      size_t j = old_entries[i].hash & mask;
+      while (table->entries[j].key) {
+        j = (j + 1) & mask;
+      }
+      table->entries[j] = old_entries[i];
+    }
+  }
+  free(old_entries);
+}
+
+static void table_insert(mutable_dict_t *table, size_t hash, objectptr key,
+                         objectptr value) {
+  /* The table is kept at most three quarters full */
+  if ((table->size + 1) * 4 > table->capacity * 3) {
+    table_grow(table);
+  }
+
+  table_entry_t *entry = table_find(table, hash, key);
+  if (entry->key) {
+    objectptr old = entry->value;
+    entry->value = clone_object(value);
+    delete_object(old);
+  } else {
+    entry->hash = hash;
+    entry->key = clone_object(key);
+    entry->value = clone_object(value);
+    ++table->size;
+  }
+}
+
+objectptr mutable_dict_set(objectptr obj, objectptr key, objectptr value) {
+  assert(is_mutable_dict(obj));
+  size_t hash;
+  if (!key_hash(key, &hash)) {
+    return make_error(ERR_UNHASHABLE);
+  }
+
+  table_insert(obj->value, hash, key, value);
+  return make_void();
+}
+
+void mutable_dict_remove(objectptr obj, objectptr key) {
+  assert(is_mutable_dict(obj));
+  mutable_dict_t *table = obj->value;
+  size_t hash;
+  if (!key_hash(key, &hash)) {
+    return;
+  }
+
+  table_entry_t *entry = table_find(table, hash, key);
+  if (!entry->key) {
+    return;
+  }
+
+  objectptr old_key = entry->key;
+  objectptr old_value = entry->value;
+
+  /* The following entries of the same run are moved back into the hole,
+   * unless the hole is before the position that their hash selects, so
+   * that lookups do not stop at the hole */
+  size_t mask = table->capacity - 1;
+  size_t hole = (size_t)(entry - table->entries);
+  for (size_t i = (hole + 1) & mask; table->entries[i].key;
+       i = (i + 1) & mask) {
+    size_t home = table->entries[i].hash & mask;
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      table->entries[hole] = table->entries[i];
+      hole = i;
+    }
+  }
+  table->entries[hole].key = NULL;
+  --table->size;
+
+  delete_object(old_key);
+  delete_object(old_value);
+}
+
+/* Operations on both kinds */
+
+static void foreach_entry(objectptr obj, entry_visitor visit,
+                          void *context) {
+  if (is_dict(obj)) {
+    dict_t *dict = obj->value;
+    if (dict->root) {
+      node_foreach(dict->root, visit, context);
+    }
+    return;
+  }
+
+  mutable_dict_t *table = obj->value;
+  for (size_t i = 0; i < table->capacity; ++i) {
+    table_entry_t *entry = &table->entries[i];
+    if (entry->key) {
+      visit(entry->hash, entry->key, entry->value, context);
+    }
+  }
+}
+
+static objectptr lookup(objectptr obj, size_t hash, objectptr key) {
+  if (is_dict(obj)) {
+    dict_t *dict = obj->value;
+    hamt_slot_t *slot = dict->root ? node_find(dict->root, hash, key) : NULL;
+    return slot ? slot->value : NULL;
+  }
+
+  table_entry_t *entry = table_find(obj->value, hash, key);
+  return entry->key ? entry->value : NULL;
+}
+
+objectptr dict_get(objectptr obj, objectptr key) {
+  assert(is_dict(obj) || is_mutable_dict(obj));
+
+  /* Keys that cannot be hashed are never added */
+  size_t hash;
+  if (!key_hash(key, &hash)) {
+    return NULL;
+  }
+
+  return lookup(obj, hash, key);
+}
+
+objectptr dict_set(objectptr obj, objectptr key, objectptr value) {
+  assert(is_dict(obj));
+  size_t hash;
+  if (!key_hash(key, &hash)) {
+    return make_error(ERR_UNHASHABLE);
+  }
+
+  objectptr result = modifiable_dict(obj);
+  dict_insert(result, hash, key, value);
+  return result;
+}
+
+objectptr dict_remove(objectptr obj, objectptr key) {
+  assert(is_dict(obj));
+  size_t hash;
+  if (!key_hash(key, &hash) || !lookup(obj, hash, key)) {
+    return reuse_object(obj);
+  }
+
+  objectptr result = modifiable_dict(obj);
+  dict_t *dict = result->value;
+  dict->root = node_remove(dict->root, 0, hash, key);
+  --dict->size;
+  return result;
+}
+
+static void merge_entry(size_t hash, objectptr key, objectptr value,
+                        void *result) {
+  if (!lookup(result, hash, key)) {
+    dict_insert(result, hash, key, value);
+  }
+}
+
+objectptr dict_merge(objectptr first, objectptr second) {
+  assert(is_dict(first));
+  assert(is_dict(second) || is_mutable_dict(second));
+  objectptr result = modifiable_dict(first);
+  foreach_entry(second, merge_entry, result);
+  return result;
+}
+
+static void add_pair(size_t hash, objectptr key, objectptr value,
+                     void *list) {
+  objectptr pair = make_pair(key, value);
+  assign_object(list, make_pair(pair, *(objectptr *)list));
+  delete_object(pair);
+}
+
+objectptr dict_to_list(objectptr obj) {
+  objectptr list = make_null();
+  foreach_entry(obj, add_pair, &list);
+  return list;
+}
+
+/* Adds the pairs of an association list to an empty dictionary */
+static objectptr add_list(objectptr obj, objectptr list) {
+  for (objectptr next = list; !is_null(next); next = pair_second(next)) {
+    if (!is_pair(next) || !is_pair(pair_first(next))) {
+      delete_object(obj);
+      return make_error(ERR_NOT_ALIST);
+    }
+
+    objectptr key = pair_first(pair_first(next));
+    objectptr value = pair_second(pair_first(next));
+    size_t hash;
+    if (!key_hash(key, &hash)) {
+      delete_object(obj);
+      return make_error(ERR_UNHASHABLE);
+    }
+
+    /* Only the first value of a key is used, as in an association
+     * list */
+    if (lookup(obj, hash, key)) {
+      continue;
+    }
+
+    if (is_dict(obj)) {
+      dict_insert(obj, hash, key, value);
+    } else {
+      table_insert(obj->value, hash, key, value);
+    }
+  }
+  return obj;
+}
+
+objectptr list_to_dict(objectptr list) {
+  return add_list(make_dict(), list);
+}
+
+objectptr list_to_mutable_dict(objectptr list) {
+  return add_list(make_mutable_dict(), list);
+}
+
+typedef struct {
+  objectptr other;
+  bool equal;
+} equals_context_t;
+
+static void compare_entry(size_t hash, objectptr key, objectptr value,
+                          void *context) {
+  equals_context_t *comparison = context;
+  if (comparison->equal) {
+    objectptr other_value = lookup(comparison->other, hash, key);
+    comparison->equal = other_value && object_equals(value, other_value);
+  }
+}
+
+bool dict_equals(objectptr obj, objectptr other) {
+  if (obj == other) {
+    return true;
+  }
+  if (obj->type_id != other->type_id &&
+      strcmp(obj->type_id->type_name, other->type_id->type_name) != 0) {
+    return false;
+  }
+  if (dict_size(obj) != dict_size(other)) {
+    return false;
+  }
+
+  /* A mutable dict can contain itself */
+  if (!begin_equals(obj, other)) {
+    return true;
+  }
+
+  equals_context_t comparison = {other, true};
+  foreach_entry(obj, compare_entry, &comparison);
+  end_equals(obj, other);
+  return comparison.equal;
+}
+
+static void print_entry(size_t hash, objectptr key, objectptr value,
+                        void *port) {
+  port_puts(port, " (cons ");
+  object_print(key, port);
+  port_putc(port, ' ');
+  object_print(value, port);
+  port_putc(port, ')');
+}
+
+char *dict_tostring(objectptr obj) {
+  return print_to_string(obj);
+}
+
+void dict_print(objectptr obj, output_port_ptr port) {
+  if (!begin_print(obj)) {
+    port_puts(port, "...");
+    return;
+  }
+
+  port_puts(port, is_dict(obj) ? "(make-dict" : "(make-mutable-dict");
+  foreach_entry(obj, print_entry, port);
+  port_putc(port, ')');
+  end_print(obj);
+}
+
+typedef struct {
+  object_visitor visit;
+  void *context;
+} traverse_context_t;
+
+static void traverse_entry(size_t hash, objectptr key, objectptr value,
+                           void *context) {
+  traverse_context_t *traversal = context;
+  traversal->visit(key, traversal->context);
+  traversal->visit(value, traversal->context);
+}
+
+void dict_traverse(objectptr obj, object_visitor visit, void *context) {
+  traverse_context_t traversal = {visit, context};
+  foreach_entry(obj, traverse_entry, &traversal);
+}
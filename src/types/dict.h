@@ -0,0 +1,121 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file dict.h
+
+/**
+ * Dictionaries map keys to values. Keys are compared with object_equals
+ * and found by their hashes, so only objects that can be hashed (see
+ * object_hash) can be keys.
+ *
+ * A dict is persistent: adding or removing a key creates a new dict
+ * that shares most of its structure with the old one, which is not
+ * changed. It is stored as a hash array mapped trie (Bagwell, "Ideal
+ * Hash Trees", 2001). A mutable dict is a hash table that is changed in
+ * place, and like a vector, it is shared rather than copied.
+ */
+
+#ifndef THEORYLISP_TYPES_DICT_H
+#define THEORYLISP_TYPES_DICT_H
+
+#include "object.h"
+
+/** Creates an empty dict */
+objectptr make_dict(void);
+
+/** Creates an empty mutable dict */
+objectptr make_mutable_dict(void);
+
+void destroy_dict(objectptr obj);
+
+void destroy_mutable_dict(objectptr obj);
+
+/**
+ * Returns the string representation of the form
+ * (make-dict [(cons key value)]) or (make-mutable-dict [(cons key value)])
+ */
+char *dict_tostring(objectptr obj);
+
+void dict_print(objectptr obj, output_port_ptr port);
+
+/**
+ * Returns true if and only if other is a dictionary of the same kind
+ * with the same keys, whose values are equal to the values in obj.
+ */
+bool dict_equals(objectptr obj, objectptr other);
+
+/** Calls visit for each key and value */
+void dict_traverse(objectptr obj, object_visitor visit, void *context);
+
+bool is_dict(objectptr obj);
+
+bool is_mutable_dict(objectptr obj);
+
+/** Returns the number of keys in a dict or a mutable dict */
+size_t dict_size(objectptr obj);
+
+/**
+ * Returns the value of key in a dict or a mutable dict, or NULL if
+ * there is no such key. The returned reference is borrowed.
+ */
+objectptr dict_get(objectptr obj, objectptr key);
+
+/**
+ * Returns a dict that maps key to value and contains the other keys of
+ * obj, or an error object if key cannot be hashed. If obj is a temporary
+ * that is not used anywhere else, it is changed and returned.
+ */
+objectptr dict_set(objectptr obj, objectptr key, objectptr value);
+
+/** Returns a dict that contains the keys of obj except key */
+objectptr dict_remove(objectptr obj, objectptr key);
+
+/**
+ * Returns a dict that contains the keys of first, and the keys of second
+ * that are not in first. second may be a dict or a mutable dict.
+ */
+objectptr dict_merge(objectptr first, objectptr second);
+
+/**
+ * Maps key to value in a mutable dict. Returns an error object if key
+ * cannot be hashed, or void otherwise.
+ */
+objectptr mutable_dict_set(objectptr obj, objectptr key, objectptr value);
+
+/** Removes key from a mutable dict if it is there */
+void mutable_dict_remove(objectptr obj, objectptr key);
+
+/**
+ * Returns the keys and values of a dict or a mutable dict as a list of
+ * pairs
+ */
+objectptr dict_to_list(objectptr obj);
+
+/**
+ * Returns a dict that contains the pairs in the given association list.
+ * If a key appears more than once, its first value is used. Returns an
+ * error object if list is not a proper list of pairs or a key cannot be
+ * hashed.
+ */
+objectptr list_to_dict(objectptr list);
+
+/** Same as list_to_dict, but returns a mutable dict */
+objectptr list_to_mutable_dict(objectptr list);
+
+#endif
@@ -26,10 +26,12 @@
 #include "../utils/string.h"
 #include "object-base.h"
 
+static object_stats_t error_stats;
+
 static const object_type_t error_type_id = {{.destroy = destroy_error,
                                              .equals = error_equals,
                                              .tostring = error_tostring},
-                                            "error"};
+                                            "error", 0, &error_stats};
 
 static const char normal_exit_message[] = "NORMAL_EXIT";
 
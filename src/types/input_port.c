@@ -0,0 +1,280 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "input_port.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../types/error.h"
+#include "../types/integer.h"
+#include "../types/pair.h"
+#include "../types/string.h"
+#include "../types/void.h"
+#include "../utils/list.h"
+#include "object-base.h"
+
+#define INPUT_PORT_BLOCK_SIZE 65536
+
+/* Integers have at most this many characters including the sign */
+#define MAX_INTEGER_LENGTH 20
+
+typedef struct {
+  /// -1 after the port is closed
+  int fd;
+  char *buffer;
+  /// Characters in [start, end) of the buffer are read but not consumed
+  size_t start;
+  size_t end;
+  size_t capacity;
+  bool eof;
+} input_port_t;
+
+static object_stats_t input_port_stats;
+
+static const object_type_t input_port_type_id = {{
+    .destroy = destroy_input_port,
+    .equals = input_port_equals,
+    .tostring = input_port_tostring},
+    "input-port", sizeof(input_port_t), &input_port_stats};
+
+bool is_input_port(objectptr obj) {
+  return obj->type_id == &input_port_type_id ||
+         strcmp(input_port_type_id.type_name, obj->type_id->type_name) == 0;
+}
+
+objectptr make_input_port(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return make_error("Cannot open %s: %s", path, strerror(errno));
+  }
+
+  objectptr obj = object_base_new_inline(&input_port_type_id);
+  input_port_t *port = obj->value;
+  port->fd = fd;
+  port->capacity = INPUT_PORT_BLOCK_SIZE;
+  port->buffer = malloc(port->capacity);
+  port->start = 0;
+  port->end = 0;
+  port->eof = false;
+  return obj;
+}
+
+void destroy_input_port(objectptr obj) {
+  assert(is_input_port(obj));
+  input_port_close(obj);
+}
+
+char *input_port_tostring(objectptr obj) {
+  assert(is_input_port(obj));
+  return strdup("input-port");
+}
+
+bool input_port_equals(objectptr obj, objectptr other) {
+  assert(is_input_port(obj));
+  return obj == other;
+}
+
+void input_port_close(objectptr obj) {
+  assert(is_input_port(obj));
+  input_port_t *port = obj->value;
+  if (port->fd >= 0) {
+    close(port->fd);
+    free(port->buffer);
+    port->fd = -1;
+    port->buffer = NULL;
+  }
+}
+
+/* Number of characters that are read but not consumed */
+static size_t available(input_port_t *port) {
+  return port->end - port->start;
+}
+
+/* Reads the next block of the file after the unconsumed characters,
+ * moving them to the beginning of the buffer and growing the buffer if
+ * they fill it. Returns false at the end of the file or on error. */
+static bool fill(input_port_t *port) {
+  if (port->eof) {
+    return false;
+  }
+
+  if (port->start > 0) {
+    memmove(port->buffer, port->buffer + port->start, available(port));
+    port->end -= port->start;
+    port->start = 0;
+  }
+
+  if (port->capacity - port->end < INPUT_PORT_BLOCK_SIZE) {
+    port->capacity *= 2;
+    port->buffer = realloc(port->buffer, port->capacity);
+  }
+
+  ssize_t n;
+  do {
+    n = read(port->fd, port->buffer + port->end, port->capacity - port->end);
+  } while (n < 0 && errno == EINTR);
+
+  if (n <= 0) {
+    port->eof = true;
+    return false;
+  }
+
+  port->end += n;
+  return true;
+}
+
+/* Returns the given number of unconsumed characters as a string and
+ * consumes them */
+static objectptr take(input_port_t *port, size_t length) {
+  objectptr result = make_string_n(port->buffer + port->start, length);
+  port->start += length;
+  return result;
+}
+
+/* Returns the port, or NULL if it is closed */
+static input_port_t *open_port(objectptr obj) {
+  assert(is_input_port(obj));
+  input_port_t *port = obj->value;
+  return port->fd >= 0 ? port : NULL;
+}
+
+objectptr input_port_read_line(objectptr obj) {
+  input_port_t *port = open_port(obj);
+  if (!port) {
+    return make_error("Input port is closed");
+  }
+
+  /* Only the newly read characters are searched after each fill */
+  size_t searched = 0;
+  for (;;) {
+    char *newline = memchr(port->buffer + port->start + searched, '\n',
+                           available(port) - searched);
+    if (newline) {
+      size_t length = newline - (port->buffer + port->start);
+      objectptr line = take(port, length);
+      port->start++;
+      return line;
+    }
+
+    searched = available(port);
+    if (!fill(port)) {
+      break;
+    }
+  }
+
+  /* The last line of the file does not end with a newline */
+  if (available(port) == 0) {
+    return make_void();
+  }
+  return take(port, available(port));
+}
+
+objectptr input_port_read_bytes(objectptr obj, size_t n) {
+  input_port_t *port = open_port(obj);
+  if (!port) {
+    return make_error("Input port is closed");
+  }
+
+  while (available(port) < n && fill(port)) {
+  }
+
+  if (available(port) == 0 && n > 0) {
+    return make_void();
+  }
+  return take(port, available(port) < n ? available(port) : n);
+}
+
+objectptr input_port_read_all(objectptr obj) {
+  input_port_t *port = open_port(obj);
+  if (!port) {
+    return make_error("Input port is closed");
+  }
+
+  while (fill(port)) {
+  }
+
+  return take(port, available(port));
+}
+
+objectptr parse_symbol(const char *chars, size_t length) {
+  size_t digits = (chars[0] == '-' || chars[0] == '+') ? 1 : 0;
+  bool integer = length > digits && length <= MAX_INTEGER_LENGTH;
+  for (size_t i = digits; integer && i < length; ++i) {
+    integer = isdigit((unsigned char)chars[i]);
+  }
+
+  if (integer) {
+    char number[MAX_INTEGER_LENGTH + 1];
+    memcpy(number, chars, length);
+    number[length] = '\0';
+    errno = 0;
+    long value = strtol(number, NULL, 10);
+    if (errno == 0) {
+      return make_integer(value);
+    }
+  }
+
+  return make_string_n(chars, length);
+}
+
+objectptr input_port_read_symbols(objectptr obj, size_t n) {
+  input_port_t *port = open_port(obj);
+  if (!port) {
+    return make_error("Input port is closed");
+  }
+
+  listptr symbols = new_list();
+  while (list_size(symbols) < n) {
+    /* Skip whitespace before the symbol */
+    while (available(port) > 0 &&
+           isspace((unsigned char)port->buffer[port->start])) {
+      port->start++;
+    }
+    if (available(port) == 0) {
+      if (!fill(port)) {
+        break;
+      }
+      continue;
+    }
+
+    /* Find the end of the symbol, which may be in a later block */
+    size_t length = 0;
+    for (;;) {
+      while (length < available(port) &&
+             !isspace((unsigned char)port->buffer[port->start + length])) {
+        length++;
+      }
+      if (length < available(port) || !fill(port)) {
+        break;
+      }
+    }
+
+    list_add(symbols, move(parse_symbol(port->buffer + port->start, length)));
+    port->start += length;
+  }
+
+  objectptr result = internal_list_to_cons_list(symbols);
+  delete_list(symbols);
+  return result;
+}
@@ -0,0 +1,80 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file input_port.h
+
+/**
+ * Input ports read files in large blocks, so that reading a large file
+ * line by line or symbol by symbol does not make a system call for each
+ * of them.
+ */
+
+#ifndef THEORYLISP_TYPES_INPUT_PORT_H
+#define THEORYLISP_TYPES_INPUT_PORT_H
+
+#include "object.h"
+
+/**
+ * Opens the file at the given path for reading.
+ * Returns an error object if the file cannot be opened.
+ */
+objectptr make_input_port(const char *path);
+
+/** Closes the file of the port if it is not closed explicitly */
+void destroy_input_port(objectptr obj);
+
+char *input_port_tostring(objectptr obj);
+
+/** Ports are only equal to themselves */
+bool input_port_equals(objectptr obj, objectptr other);
+
+bool is_input_port(objectptr obj);
+
+/**
+ * Returns the next line without its newline character,
+ * or void at the end of the file.
+ */
+objectptr input_port_read_line(objectptr obj);
+
+/**
+ * Returns a string of at most n bytes,
+ * or void at the end of the file.
+ */
+objectptr input_port_read_bytes(objectptr obj, size_t n);
+
+/** Returns the rest of the file as a string */
+objectptr input_port_read_all(objectptr obj);
+
+/**
+ * Returns a list of at most n whitespace-separated symbols. Symbols that
+ * are integers become integer objects, and the others become strings.
+ * The list is empty at the end of the file.
+ */
+objectptr input_port_read_symbols(objectptr obj, size_t n);
+
+/** Closes the file. Reading from a closed port gives an error. */
+void input_port_close(objectptr obj);
+
+/**
+ * Returns an integer if the given characters form an integer,
+ * or a string otherwise. Used for the symbols that are read from files.
+ */
+objectptr parse_symbol(const char *chars, size_t length);
+
+#endif
@@ -29,18 +29,23 @@
 #include "real.h"
 #include "rational.h"
 
+static object_stats_t integer_stats;
+
 static const object_type_t integer_type_id = {{.destroy = destroy_integer,
                                                .equals = integer_equals,
                                                .tostring = integer_tostring,
+                                               .print = integer_print,
                                                .op_add = integer_op_add,
                                                .op_mul = integer_op_mul,
                                                .op_sub = integer_op_sub,
                                                .op_div = integer_op_div,
-                                               .less = integer_less},
-                                               "integer"};
+                                               .less = integer_less,
+                                               .hash = integer_hash},
+                                               "integer", sizeof(integer_t), &integer_stats};
 
 bool is_integer(objectptr obj) {
-  return strcmp(integer_type_id.type_name, obj->type_id->type_name) == 0;
+  return obj->type_id == &integer_type_id ||
+         strcmp(integer_type_id.type_name, obj->type_id->type_name) == 0;
 }
 
 inline integer_t int_value(objectptr obj) {
@@ -49,20 +54,22 @@ inline integer_t int_value(objectptr obj) {
 }
 
 objectptr make_integer(integer_t value) {
-  integer_t *int_value = malloc(sizeof *int_value);
-  *int_value = value;
-
-  return object_base_new(int_value, &integer_type_id);
+  objectptr obj = object_base_new_inline(&integer_type_id);
+  *(integer_t *)obj->value = value;
+  return obj;
 }
 
 void destroy_integer(objectptr self) {
   assert(is_integer(self));
-  free(self->value);
 }
 
 char *integer_tostring(objectptr self) {
+  return print_to_string(self);
+}
+
+void integer_print(objectptr self, output_port_ptr port) {
   assert(is_integer(self));
-  return format("%ld", int_value(self));
+  port_printf(port, "%ld", int_value(self));
 }
 
 bool integer_equals(objectptr self, objectptr other) {
@@ -85,12 +92,28 @@ bool integer_equals(objectptr self, objectptr other) {
   return false;
 }
 
+bool integer_hash(objectptr self, size_t *hash) {
+  assert(is_integer(self));
+  *hash = hash_number((real_t)int_value(self));
+  return true;
+}
+
+/* Stores the result of an operation in self if self can be reused */
+static objectptr integer_result(objectptr self, integer_t value) {
+  if (is_reusable(self)) {
+    *(integer_t *)self->value = value;
+    return reuse_object(self);
+  }
+
+  return make_integer(value);
+}
+
 objectptr integer_op_add(objectptr self, objectptr other) {
   assert(is_integer(self));
   integer_t self_value = int_value(self);
 
   if (is_integer(other)) {
-    return make_integer(self_value + int_value(other));
+    return integer_result(self, self_value + int_value(other));
   }
 
   if (is_real(other)) {
@@ -110,7 +133,7 @@ objectptr integer_op_mul(objectptr self, objectptr other) {
   integer_t self_value = int_value(self);
 
   if (is_integer(other)) {
-    return make_integer(self_value * int_value(other));
+    return integer_result(self, self_value * int_value(other));
   }
 
   if (is_real(other)) {
@@ -130,7 +153,7 @@ objectptr integer_op_sub(objectptr self, objectptr other) {
   integer_t self_value = int_value(self);
 
   if (is_integer(other)) {
-    return make_integer(self_value - int_value(other));
+    return integer_result(self, self_value - int_value(other));
   }
 
   if (is_real(other)) {
@@ -51,6 +51,8 @@ void destroy_integer(objectptr val);
  */
 char *integer_tostring(objectptr val);
 
+void integer_print(objectptr val, output_port_ptr port);
+
 /**
  * Compares two integers for equality.
  *
@@ -59,6 +61,9 @@ char *integer_tostring(objectptr val);
  */
 bool integer_equals(objectptr self, objectptr other);
 
+/** Hashes an integer by its real value (see real_hash) */
+bool integer_hash(objectptr self, size_t *hash);
+
 /**
  * Less than operator (self < other).
  * The second operand can have a type different from integer
@@ -25,12 +25,14 @@
 
 #include "object-base.h"
 
+static object_stats_t internal_stats;
+
 static const object_type_t internal_type_id = {{
     .destroy = destroy_internal,
     .tostring = internal_tostring,
     .equals = internal_equals,
     .get_raw_data = internal_get_raw_data},
-    "internal"};
+    "internal", 0, &internal_stats};
 
 bool is_internal(objectptr obj) {
   return strcmp(internal_type_id.type_name, obj->type_id->type_name) == 0;
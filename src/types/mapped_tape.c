@@ -0,0 +1,183 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mapped_tape.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <string.h>
+
+#include "../types/error.h"
+#include "../types/input_port.h"
+#include "../types/integer.h"
+#include "../types/null.h"
+#include "../types/pair.h"
+#include "../types/void.h"
+#include "../utils/file.h"
+#include "object-base.h"
+
+/* File that is shared by the mapped tapes made from it */
+typedef struct {
+  mapped_file_ptr file;
+  tape_format_t format;
+  size_t references;
+} tape_source_t;
+
+typedef struct {
+  tape_source_t *source;
+  /// Visited cells, starting with the left end symbol and a blank
+  listptr cells;
+  /// Offset of the first symbol in the file that is not visited
+  size_t position;
+} mapped_tape_t;
+
+static object_stats_t mapped_tape_stats;
+
+static const object_type_t mapped_tape_type_id = {{
+    .destroy = destroy_mapped_tape,
+    .equals = mapped_tape_equals,
+    .tostring = mapped_tape_tostring},
+    "mapped-tape", sizeof(mapped_tape_t), &mapped_tape_stats};
+
+bool is_mapped_tape(objectptr obj) {
+  return obj->type_id == &mapped_tape_type_id ||
+         strcmp(mapped_tape_type_id.type_name, obj->type_id->type_name) == 0;
+}
+
+static objectptr new_mapped_tape(tape_source_t *source, listptr cells,
+                                 size_t position) {
+  objectptr obj = object_base_new_inline(&mapped_tape_type_id);
+  mapped_tape_t *tape = obj->value;
+  tape->source = source;
+  tape->cells = cells;
+  tape->position = position;
+  source->references++;
+  return obj;
+}
+
+objectptr make_mapped_tape(const char *path, tape_format_t format) {
+  mapped_file_ptr file = map_file(path);
+  if (!file) {
+    return make_error("%s is not accessible.", path);
+  }
+
+  tape_source_t *source = malloc(sizeof *source);
+  source->file = file;
+  source->format = format;
+  source->references = 0;
+
+  listptr cells = new_list();
+  list_add(cells, make_void());
+  list_add(cells, make_null());
+  return new_mapped_tape(source, cells, 0);
+}
+
+void destroy_mapped_tape(objectptr obj) {
+  assert(is_mapped_tape(obj));
+  mapped_tape_t *tape = obj->value;
+  for (size_t i = 0; i < list_size(tape->cells); ++i) {
+    delete_object(list_get(tape->cells, i));
+  }
+  delete_list(tape->cells);
+
+  if (--tape->source->references == 0) {
+    unmap_file(tape->source->file);
+    free(tape->source);
+  }
+}
+
+char *mapped_tape_tostring(objectptr obj) {
+  assert(is_mapped_tape(obj));
+  return strdup("mapped-tape");
+}
+
+bool mapped_tape_equals(objectptr obj, objectptr other) {
+  assert(is_mapped_tape(obj));
+  return obj == other;
+}
+
+void mapped_tape_get_cells(objectptr obj, listptr output) {
+  assert(is_mapped_tape(obj));
+  mapped_tape_t *tape = obj->value;
+  for (size_t i = 0; i < list_size(tape->cells); ++i) {
+    list_add(output, clone_object(list_get(tape->cells, i)));
+  }
+}
+
+size_t mapped_tape_position(objectptr obj) {
+  assert(is_mapped_tape(obj));
+  return ((mapped_tape_t *)obj->value)->position;
+}
+
+objectptr mapped_tape_next_symbol(objectptr obj, size_t *position) {
+  assert(is_mapped_tape(obj));
+  tape_source_t *source = ((mapped_tape_t *)obj->value)->source;
+  const char *data = source->file->data;
+  size_t length = source->file->length;
+
+  if (source->format == TAPE_BYTES) {
+    if (*position >= length) {
+      return make_null();
+    }
+    return make_integer((unsigned char)data[(*position)++]);
+  }
+
+  while (*position < length && isspace((unsigned char)data[*position])) {
+    (*position)++;
+  }
+  if (*position >= length) {
+    return make_null();
+  }
+
+  size_t begin = *position;
+  while (*position < length && !isspace((unsigned char)data[*position])) {
+    (*position)++;
+  }
+  return parse_symbol(data + begin, *position - begin);
+}
+
+objectptr mapped_tape_with_cells(objectptr obj, listptr cells,
+                                 size_t position) {
+  assert(is_mapped_tape(obj));
+  return new_mapped_tape(((mapped_tape_t *)obj->value)->source, cells,
+                         position);
+}
+
+objectptr mapped_tape_to_list(objectptr obj) {
+  assert(is_mapped_tape(obj));
+  listptr cells = new_list();
+  mapped_tape_get_cells(obj, cells);
+  size_t position = mapped_tape_position(obj);
+  for (;;) {
+    /* Symbols in the file are never blank */
+    objectptr symbol = mapped_tape_next_symbol(obj, &position);
+    if (is_null(symbol)) {
+      delete_object(symbol);
+      break;
+    }
+    list_add(cells, symbol);
+  }
+
+  objectptr result = internal_list_to_cons_list(cells);
+  for (size_t i = 0; i < list_size(cells); ++i) {
+    delete_object(list_get(cells, i));
+  }
+  delete_list(cells);
+  return result;
+}
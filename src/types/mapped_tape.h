@@ -0,0 +1,88 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file mapped_tape.h
+
+/**
+ * A mapped tape holds the contents of a tape whose symbols are read
+ * from a memory-mapped file. Like the tapes made by make-tape, it starts
+ * with the left end symbol and a blank. The symbols of the file are only
+ * created when a tape head visits them, and writes change the visited
+ * cells instead of the file, so that running a machine on a large file
+ * takes time and memory in proportion to the cells it visits.
+ *
+ * Mapped tapes are immutable. A machine that runs on a mapped tape works
+ * on a copy of its visited cells, and returns a new mapped tape that
+ * shares the file.
+ */
+
+#ifndef THEORYLISP_TYPES_MAPPED_TAPE_H
+#define THEORYLISP_TYPES_MAPPED_TAPE_H
+
+#include "object.h"
+#include "../utils/list.h"
+
+/** How the bytes of a file are divided into symbols */
+typedef enum {
+  /// Each byte is an integer symbol
+  TAPE_BYTES,
+  /// Whitespace-separated symbols as returned by read-symbols
+  TAPE_SYMBOLS
+} tape_format_t;
+
+/**
+ * Maps the file at the given path.
+ * Returns an error object if the file cannot be read.
+ */
+objectptr make_mapped_tape(const char *path, tape_format_t format);
+
+void destroy_mapped_tape(objectptr obj);
+
+char *mapped_tape_tostring(objectptr obj);
+
+/** Mapped tapes are only equal to themselves */
+bool mapped_tape_equals(objectptr obj, objectptr other);
+
+bool is_mapped_tape(objectptr obj);
+
+/** Appends new references to the visited cells to the given list */
+void mapped_tape_get_cells(objectptr obj, listptr output);
+
+/** Returns the position of the first symbol of the file that is not
+ * visited */
+size_t mapped_tape_position(objectptr obj);
+
+/**
+ * Returns the symbol of the file at the given position and advances the
+ * position past it. Blanks are returned after the end of the file.
+ */
+objectptr mapped_tape_next_symbol(objectptr obj, size_t *position);
+
+/**
+ * Returns a mapped tape that shares the file of obj, whose visited cells
+ * are the given ones, and whose next symbol is at the given position.
+ * Takes ownership of the list and the objects in it.
+ */
+objectptr mapped_tape_with_cells(objectptr obj, listptr cells,
+                                 size_t position);
+
+/** Returns all cells of the tape as a list */
+objectptr mapped_tape_to_list(objectptr obj);
+
+#endif
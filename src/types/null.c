@@ -26,11 +26,14 @@
 #include "error.h"
 #include "object-base.h"
 
+static object_stats_t null_stats;
+
 static const object_type_t null_type_id = {
     {.destroy = destroy_null, 
      .tostring = null_tostring,
-     .equals = null_equals},
-    "null"};
+     .equals = null_equals,
+     .hash = null_hash},
+    "null", 0, &null_stats};
 
 bool is_null(objectptr obj) {
   return strcmp(null_type_id.type_name, obj->type_id->type_name) == 0;
@@ -52,3 +55,9 @@ bool null_equals(objectptr self, objectptr other) {
   }
   return true;
 }
+
+bool null_hash(objectptr self, size_t *hash) {
+  assert(is_null(self));
+  *hash = 0;
+  return true;
+}
@@ -48,6 +48,11 @@ char *null_tostring(objectptr obj);
  */
 bool null_equals(objectptr obj, objectptr other);
 
+/**
+ * Hashes null (all null values have the same hash)
+ */
+bool null_hash(objectptr obj, size_t *hash);
+
 /**
  * Checks whether the given object is null
  */
@@ -0,0 +1,421 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "numeric_vector.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../types/error.h"
+#include "../types/null.h"
+#include "../types/pair.h"
+#include "../types/void.h"
+#include "object-base.h"
+
+typedef struct {
+  void *data;
+  size_t length;
+} numeric_vector_t;
+
+static object_stats_t f64vector_stats;
+static object_stats_t i64vector_stats;
+
+/* Numeric vectors do not refer to other objects, so they do not need
+ * traverse */
+static const object_type_t f64vector_type_id = {{
+    .destroy = destroy_numeric_vector,
+    .equals = numeric_vector_equals,
+    .tostring = numeric_vector_tostring,
+    .print = numeric_vector_print},
+    "f64vector", sizeof(numeric_vector_t), &f64vector_stats};
+
+static const object_type_t i64vector_type_id = {{
+    .destroy = destroy_numeric_vector,
+    .equals = numeric_vector_equals,
+    .tostring = numeric_vector_tostring,
+    .print = numeric_vector_print},
+    "i64vector", sizeof(numeric_vector_t), &i64vector_stats};
+
+bool is_f64vector(objectptr obj) {
+  return obj->type_id == &f64vector_type_id ||
+         strcmp(f64vector_type_id.type_name, obj->type_id->type_name) == 0;
+}
+
+bool is_i64vector(objectptr obj) {
+  return obj->type_id == &i64vector_type_id ||
+         strcmp(i64vector_type_id.type_name, obj->type_id->type_name) == 0;
+}
+
+bool is_numeric_vector(objectptr obj) {
+  return is_f64vector(obj) || is_i64vector(obj);
+}
+
+/* Elements of both kinds have the same size */
+static objectptr new_numeric_vector(const object_type_t *type,
+                                    size_t length) {
+  objectptr obj = object_base_new_inline(type);
+  numeric_vector_t *vec = obj->value;
+  vec->data = malloc(length == 0 ? 1 : length * sizeof(real_t));
+  vec->length = length;
+  return obj;
+}
+
+objectptr make_f64vector(size_t length, real_t fill) {
+  objectptr obj = new_numeric_vector(&f64vector_type_id, length);
+  real_t *data = f64vector_data(obj);
+  for (size_t i = 0; i < length; ++i) {
+    data[i] = fill;
+  }
+  return obj;
+}
+
+objectptr make_i64vector(size_t length, integer_t fill) {
+  objectptr obj = new_numeric_vector(&i64vector_type_id, length);
+  integer_t *data = i64vector_data(obj);
+  for (size_t i = 0; i < length; ++i) {
+    data[i] = fill;
+  }
+  return obj;
+}
+
+void destroy_numeric_vector(objectptr obj) {
+  assert(is_numeric_vector(obj));
+  free(((numeric_vector_t *)obj->value)->data);
+}
+
+char *numeric_vector_tostring(objectptr obj) {
+  return print_to_string(obj);
+}
+
+void numeric_vector_print(objectptr obj, output_port_ptr port) {
+  assert(is_numeric_vector(obj));
+  size_t length = numeric_vector_length(obj);
+  if (is_f64vector(obj)) {
+    real_t *data = f64vector_data(obj);
+    port_puts(port, "(f64vector");
+    for (size_t i = 0; i < length; ++i) {
+      port_printf(port, " %f", data[i]);
+    }
+  } else {
+    integer_t *data = i64vector_data(obj);
+    port_puts(port, "(i64vector");
+    for (size_t i = 0; i < length; ++i) {
+      port_printf(port, " %ld", data[i]);
+    }
+  }
+  port_putc(port, ')');
+}
+
+bool numeric_vector_equals(objectptr obj, objectptr other) {
+  assert(is_numeric_vector(obj));
+  if (obj == other) {
+    return true;
+  }
+  if (!is_numeric_vector(other) || is_f64vector(obj) != is_f64vector(other)) {
+    return false;
+  }
+
+  size_t length = numeric_vector_length(obj);
+  if (length != numeric_vector_length(other)) {
+    return false;
+  }
+
+  /* Doubles are compared with == rather than memcmp, since zero is equal
+   * to negative zero and NaN is not equal to itself */
+  if (is_f64vector(obj)) {
+    real_t *data = f64vector_data(obj);
+    real_t *other_data = f64vector_data(other);
+    for (size_t i = 0; i < length; ++i) {
+      if (data[i] != other_data[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  return memcmp(i64vector_data(obj), i64vector_data(other),
+                length * sizeof(integer_t)) == 0;
+}
+
+size_t numeric_vector_length(objectptr obj) {
+  assert(is_numeric_vector(obj));
+  return ((numeric_vector_t *)obj->value)->length;
+}
+
+real_t *f64vector_data(objectptr obj) {
+  assert(is_f64vector(obj));
+  return ((numeric_vector_t *)obj->value)->data;
+}
+
+integer_t *i64vector_data(objectptr obj) {
+  assert(is_i64vector(obj));
+  return ((numeric_vector_t *)obj->value)->data;
+}
+
+objectptr numeric_vector_ref(objectptr obj, size_t index) {
+  assert(index < numeric_vector_length(obj));
+  if (is_f64vector(obj)) {
+    return make_real(f64vector_data(obj)[index]);
+  }
+  return make_integer(i64vector_data(obj)[index]);
+}
+
+objectptr numeric_vector_set(objectptr obj, size_t index, objectptr value) {
+  if (index >= numeric_vector_length(obj)) {
+    return make_error("Vector index %zu is out of bounds", index);
+  }
+
+  if (is_f64vector(obj)) {
+    if (!is_number(value)) {
+      return make_error("Only numbers can be stored in an f64vector");
+    }
+    f64vector_data(obj)[index] = cast_real(value);
+  } else {
+    if (!is_integer(value)) {
+      return make_error("Only integers can be stored in an i64vector");
+    }
+    i64vector_data(obj)[index] = int_value(value);
+  }
+  return make_void();
+}
+
+objectptr numeric_vector_to_list(objectptr obj) {
+  objectptr list = make_null();
+  for (size_t i = numeric_vector_length(obj); i != 0; --i) {
+    objectptr element = numeric_vector_ref(obj, i - 1);
+    assign_object(&list, make_pair(element, list));
+    delete_object(element);
+  }
+  return list;
+}
+
+/* Returns the length of the list, or SIZE_MAX if it is not a proper list
+ * whose elements satisfy accepts */
+static size_t checked_length(objectptr list, bool (*accepts)(objectptr)) {
+  size_t length = 0;
+  for (objectptr next = list; !is_null(next); next = pair_second(next)) {
+    if (!is_pair(next) || !accepts(pair_first(next))) {
+      return SIZE_MAX;
+    }
+    ++length;
+  }
+  return length;
+}
+
+objectptr list_to_f64vector(objectptr list) {
+  size_t length = checked_length(list, is_number);
+  if (length == SIZE_MAX) {
+    return make_error("Given object is not a proper list of numbers");
+  }
+
+  objectptr obj = new_numeric_vector(&f64vector_type_id, length);
+  real_t *data = f64vector_data(obj);
+  for (objectptr next = list; !is_null(next); next = pair_second(next)) {
+    *data++ = cast_real(pair_first(next));
+  }
+  return obj;
+}
+
+objectptr list_to_i64vector(objectptr list) {
+  size_t length = checked_length(list, is_integer);
+  if (length == SIZE_MAX) {
+    return make_error("Given object is not a proper list of integers");
+  }
+
+  objectptr obj = new_numeric_vector(&i64vector_type_id, length);
+  integer_t *data = i64vector_data(obj);
+  for (objectptr next = list; !is_null(next); next = pair_second(next)) {
+    *data++ = int_value(pair_first(next));
+  }
+  return obj;
+}
+
+/* Returns a vector for the result of an operation on first and second,
+ * which is one of them if it is a temporary vector of the given type that
+ * is not used anywhere else. second may be NULL. */
+static objectptr result_vector(const object_type_t *type, objectptr first,
+                               objectptr second, size_t length) {
+  if (first->type_id == type && is_reusable(first)) {
+    return reuse_object(first);
+  }
+  if (second && second->type_id == type && is_reusable(second)) {
+    return reuse_object(second);
+  }
+  return new_numeric_vector(type, length);
+}
+
+/* Returns the elements of a numeric vector as doubles. If it is an
+ * i64vector, they are converted to a new array that is also stored in
+ * converted, which must be freed by the caller. */
+static const real_t *f64_elements(objectptr obj, real_t **converted) {
+  if (is_f64vector(obj)) {
+    return f64vector_data(obj);
+  }
+
+  size_t length = numeric_vector_length(obj);
+  *converted = malloc(length == 0 ? 1 : length * sizeof(real_t));
+  i64_to_f64(*converted, i64vector_data(obj), length);
+  return *converted;
+}
+
+static objectptr elementwise_op(kernel_op_t op, objectptr first,
+                                objectptr second) {
+  size_t length = numeric_vector_length(first);
+  if (length != numeric_vector_length(second)) {
+    return make_error("Vector lengths %zu and %zu are not equal", length,
+                      numeric_vector_length(second));
+  }
+
+  if (op != KERNEL_DIV && is_i64vector(first) && is_i64vector(second)) {
+    objectptr result =
+        result_vector(&i64vector_type_id, first, second, length);
+    i64_elementwise(op, i64vector_data(result), i64vector_data(first),
+                    i64vector_data(second), length);
+    return result;
+  }
+
+  real_t *first_converted = NULL;
+  real_t *second_converted = NULL;
+  const real_t *first_data = f64_elements(first, &first_converted);
+  const real_t *second_data = f64_elements(second, &second_converted);
+
+  objectptr result = result_vector(&f64vector_type_id, first, second, length);
+  f64_elementwise(op, f64vector_data(result), first_data, second_data,
+                  length);
+
+  free(first_converted);
+  free(second_converted);
+  return result;
+}
+
+static objectptr broadcast_op(kernel_op_t op, objectptr vec,
+                              objectptr scalar, bool reversed) {
+  size_t length = numeric_vector_length(vec);
+  if (op != KERNEL_DIV && is_i64vector(vec) && is_integer(scalar)) {
+    objectptr result = result_vector(&i64vector_type_id, vec, NULL, length);
+    i64_broadcast(op, i64vector_data(result), i64vector_data(vec),
+                  int_value(scalar), reversed, length);
+    return result;
+  }
+
+  real_t *converted = NULL;
+  const real_t *data = f64_elements(vec, &converted);
+  objectptr result = result_vector(&f64vector_type_id, vec, NULL, length);
+  f64_broadcast(op, f64vector_data(result), data, cast_real(scalar),
+                reversed, length);
+  free(converted);
+  return result;
+}
+
+objectptr numeric_vector_op(kernel_op_t op, objectptr first,
+                            objectptr second) {
+  if (!is_numeric_vector(first)) {
+    assert(is_number(first));
+    return broadcast_op(op, second, first, true);
+  }
+  if (!is_numeric_vector(second)) {
+    assert(is_number(second));
+    return broadcast_op(op, first, second, false);
+  }
+  return elementwise_op(op, first, second);
+}
+
+objectptr numeric_vector_sqrt(objectptr obj) {
+  size_t length = numeric_vector_length(obj);
+  real_t *converted = NULL;
+  const real_t *data = f64_elements(obj, &converted);
+  objectptr result = result_vector(&f64vector_type_id, obj, NULL, length);
+  f64_sqrt(f64vector_data(result), data, length);
+  free(converted);
+  return result;
+}
+
+objectptr numeric_vector_map(objectptr obj, real_t (*function)(real_t)) {
+  size_t length = numeric_vector_length(obj);
+  real_t *converted = NULL;
+  const real_t *data = f64_elements(obj, &converted);
+  objectptr result = result_vector(&f64vector_type_id, obj, NULL, length);
+  f64_map(function, f64vector_data(result), data, length);
+  free(converted);
+  return result;
+}
+
+objectptr numeric_vector_sum(objectptr obj) {
+  size_t length = numeric_vector_length(obj);
+  if (is_f64vector(obj)) {
+    return make_real(f64_sum(f64vector_data(obj), length));
+  }
+  return make_integer(i64_sum(i64vector_data(obj), length));
+}
+
+objectptr numeric_vector_dot(objectptr first, objectptr second) {
+  size_t length = numeric_vector_length(first);
+  if (length != numeric_vector_length(second)) {
+    return make_error("Vector lengths %zu and %zu are not equal", length,
+                      numeric_vector_length(second));
+  }
+
+  if (is_i64vector(first) && is_i64vector(second)) {
+    return make_integer(
+        i64_dot(i64vector_data(first), i64vector_data(second), length));
+  }
+
+  real_t *first_converted = NULL;
+  real_t *second_converted = NULL;
+  real_t result = f64_dot(f64_elements(first, &first_converted),
+                          f64_elements(second, &second_converted), length);
+  free(first_converted);
+  free(second_converted);
+  return make_real(result);
+}
+
+objectptr numeric_vector_min(objectptr obj) {
+  size_t length = numeric_vector_length(obj);
+  if (length == 0) {
+    return make_error("Minimum of an empty vector is not defined");
+  }
+  if (is_f64vector(obj)) {
+    return make_real(f64_min(f64vector_data(obj), length));
+  }
+  return make_integer(i64_min(i64vector_data(obj), length));
+}
+
+objectptr numeric_vector_max(objectptr obj) {
+  size_t length = numeric_vector_length(obj);
+  if (length == 0) {
+    return make_error("Maximum of an empty vector is not defined");
+  }
+  if (is_f64vector(obj)) {
+    return make_real(f64_max(f64vector_data(obj), length));
+  }
+  return make_integer(i64_max(i64vector_data(obj), length));
+}
+
+objectptr numeric_vector_prefix_sum(objectptr obj) {
+  size_t length = numeric_vector_length(obj);
+  objectptr result = result_vector(obj->type_id, obj, NULL, length);
+  if (is_f64vector(obj)) {
+    f64_prefix_sum(f64vector_data(result), f64vector_data(obj), length);
+  } else {
+    i64_prefix_sum(i64vector_data(result), i64vector_data(obj), length);
+  }
+  return result;
+}
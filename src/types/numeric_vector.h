@@ -0,0 +1,140 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file numeric_vector.h
+
+/**
+ * Numeric vectors are arrays of unboxed numbers. An f64vector stores
+ * reals as doubles, and an i64vector stores integers as longs. Their
+ * elementwise operations and reductions run in loops over the raw
+ * numbers instead of creating an object for each element.
+ */
+
+#ifndef THEORYLISP_TYPES_NUMERIC_VECTOR_H
+#define THEORYLISP_TYPES_NUMERIC_VECTOR_H
+
+#include "object.h"
+#include "integer.h"
+#include "real.h"
+#include "../utils/kernels.h"
+
+/**
+ * f64vector constructor.
+ * Creates an f64vector of the given length whose elements are fill.
+ */
+objectptr make_f64vector(size_t length, real_t fill);
+
+/**
+ * i64vector constructor.
+ * Creates an i64vector of the given length whose elements are fill.
+ */
+objectptr make_i64vector(size_t length, integer_t fill);
+
+void destroy_numeric_vector(objectptr obj);
+
+/**
+ * Returns the string representation of the form (f64vector [elements])
+ * or (i64vector [elements])
+ */
+char *numeric_vector_tostring(objectptr obj);
+
+void numeric_vector_print(objectptr obj, output_port_ptr port);
+
+/**
+ * Returns true if and only if other is a numeric vector of the same kind
+ * and length whose elements are equal to the elements of obj.
+ */
+bool numeric_vector_equals(objectptr obj, objectptr other);
+
+bool is_f64vector(objectptr obj);
+
+bool is_i64vector(objectptr obj);
+
+/** Returns true if obj is an f64vector or an i64vector */
+bool is_numeric_vector(objectptr obj);
+
+size_t numeric_vector_length(objectptr obj);
+
+real_t *f64vector_data(objectptr obj);
+
+integer_t *i64vector_data(objectptr obj);
+
+/** Returns the element at the given index as a real or an integer */
+objectptr numeric_vector_ref(objectptr obj, size_t index);
+
+/**
+ * Replaces the element at the given index with value. Returns an error
+ * object if the index is out of bounds or the value cannot be stored in
+ * the vector, or void otherwise.
+ */
+objectptr numeric_vector_set(objectptr obj, size_t index, objectptr value);
+
+/** Returns a list that contains the elements of the vector */
+objectptr numeric_vector_to_list(objectptr obj);
+
+/**
+ * Returns an f64vector that contains the numbers in the given list, or an
+ * error object if it is not a proper list of numbers.
+ */
+objectptr list_to_f64vector(objectptr list);
+
+/**
+ * Returns an i64vector that contains the integers in the given list, or
+ * an error object if it is not a proper list of integers.
+ */
+objectptr list_to_i64vector(objectptr list);
+
+/**
+ * Applies op to the corresponding elements of two numeric vectors of the
+ * same length, or to each element of a numeric vector and a number. The
+ * result is an i64vector if there are no reals and op is not division,
+ * and an f64vector otherwise. A temporary operand of the same kind as
+ * the result is reused for the result.
+ */
+objectptr numeric_vector_op(kernel_op_t op, objectptr first,
+                            objectptr second);
+
+/** Returns an f64vector of the square roots of the elements */
+objectptr numeric_vector_sqrt(objectptr obj);
+
+/** Returns an f64vector of the results of function for each element */
+objectptr numeric_vector_map(objectptr obj, real_t (*function)(real_t));
+
+/** Returns the sum of the elements as an integer or a real */
+objectptr numeric_vector_sum(objectptr obj);
+
+/**
+ * Returns the dot product of two numeric vectors, or an error object if
+ * their lengths are different.
+ */
+objectptr numeric_vector_dot(objectptr first, objectptr second);
+
+/** Returns the smallest element, or an error object if obj is empty */
+objectptr numeric_vector_min(objectptr obj);
+
+/** Returns the largest element, or an error object if obj is empty */
+objectptr numeric_vector_max(objectptr obj);
+
+/**
+ * Returns a vector of the same kind whose ith element is the sum of
+ * the first i + 1 elements of obj.
+ */
+objectptr numeric_vector_prefix_sum(objectptr obj);
+
+#endif
@@ -23,6 +23,7 @@
 #define THEORYLISP_TYPES_OBJECT_BASE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "object.h"
@@ -30,15 +31,22 @@
 /**
  * object_vtable_t contains operations that are supported by an object.
  * All objects must implement destroy, tostring and equals functions.
- * The remaining are optional. If an operation is not implemented, the
+ * The remaining are optional. Types that implement print, which writes
+ * the string representation to an output port, can implement tostring
+ * with print_to_string. If an operation is not implemented, the
  * member corresponding to it must be set to NULL. If an unsupported operation
  * is called, it will return an error object containing "unsupported operation"
- * message.
+ * message. Types that implement hash must give equal hashes for equal
+ * objects, including objects of other types that they are equal to.
+ * Types whose objects refer to other objects implement traverse,
+ * which calls the visitor once for every such reference, so that reference
+ * cycles between them can be collected (see collector.h).
  */
 typedef struct object_vtable {
   void (*destroy)(objectptr);
   objectptr (*clone)(objectptr);
   char *(*tostring)(objectptr);
+  void (*print)(objectptr, output_port_ptr);
   bool (*equals)(objectptr, objectptr);
   objectptr (*less)(objectptr, objectptr);
   void (*delete_obj)(objectptr);
@@ -57,14 +65,33 @@ typedef struct object_vtable {
   objectptr (*op_call_internal)(objectptr, void *, void *);
 
   void *(*get_raw_data)(objectptr);
+
+  bool (*hash)(objectptr, size_t *);
+
+  void (*traverse)(objectptr, object_visitor, void *);
 } object_vtable_t;
 
+/**
+ * Number of objects of a type that are created and deleted.
+ */
+typedef struct object_stats {
+  size_t allocated;
+  size_t freed;
+  /// Next type whose objects have been counted
+  const struct tltype *next;
+} object_stats_t;
+
 /**
  * Contains type information of a Theory Lisp object.
+ * If value_size is not zero, values of the type are stored in the same
+ * allocation as their objects (see object_base_new_inline), and destroy
+ * must not free them.
  */
 typedef struct tltype {
   const object_vtable_t vtable;
   const char *type_name;
+  size_t value_size;
+  object_stats_t *stats;
 } object_type_t;
 
 /**
@@ -74,6 +101,11 @@ typedef struct object {
   void *value;
   const object_type_t *type_id;
   bool temporary;
+  /// Color and possible root flag used by the cycle collector
+  unsigned char color;
+  bool buffered;
+  /// Cached hash of an immutable container, zero if not computed
+  uint32_t hash;
   size_t ref_count;
 } object_t;
 
@@ -81,4 +113,29 @@ typedef struct object {
 /* Base constructor */
 objectptr object_base_new(void *value, const object_type_t *type_id);
 
+/* Base constructor for types with a nonzero value_size. The value is
+ * stored right after the object and is left uninitialized. */
+objectptr object_base_new_inline(const object_type_t *type_id);
+
+/* Returns the memory of a destroyed object to the allocator */
+void object_base_free(objectptr obj);
+
+/* Returns the string representation written by the print operation */
+char *print_to_string(objectptr obj);
+
+/* Mutable containers can contain themselves, so their print operations
+ * call begin_print before printing the contents and end_print after it.
+ * begin_print returns false if obj is already being printed, in which
+ * case the contents must not be printed and end_print is not called. */
+bool begin_print(objectptr obj);
+void end_print(objectptr obj);
+
+/* In the same way, their equals operations call begin_equals before
+ * comparing the contents of two objects, and end_equals after it.
+ * begin_equals returns false if the same objects are already being
+ * compared, in which case they are equal as far as the comparison on
+ * the way to them can tell. */
+bool begin_equals(objectptr obj, objectptr other);
+void end_equals(objectptr obj, objectptr other);
+
 #endif
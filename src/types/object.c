@@ -20,27 +20,143 @@
 #include "object.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
 
 #include "object-base.h"
+#include "../utils/slab.h"
 #include "../utils/string.h"
 #include "boolean.h"
+#include "collector.h"
 #include "error.h"
 #include "object.h"
 
 #define ERR_UNSUPPORTED_OPERATION "Unsupported operation"
 
+/* Number of deferred objects that are destroyed by each allocation */
+#define DEFERRED_PER_ALLOCATION 2
+
+/* First type whose objects have been counted */
+static const object_type_t *counted_types = NULL;
+
+/* Containers that are no longer referenced, and are destroyed a few at
+ * a time by later allocations if deferred freeing is enabled. Destroying
+ * one of them may add the containers it refers to. */
+static bool deferred_free = false;
+static objectptr *deferred = NULL;
+static size_t deferred_count = 0;
+static size_t deferred_capacity = 0;
+static size_t max_deferred_count = 0;
+static bool releasing = false;
+
+static inline size_t object_size(const object_type_t *type_id) {
+  return sizeof(object_t) + type_id->value_size;
+}
+
+static void count_allocation(const object_type_t *type_id) {
+  object_stats_t *stats = type_id->stats;
+  if (stats->allocated++ == 0 && stats->freed == 0) {
+    stats->next = counted_types;
+    counted_types = type_id;
+  }
+}
+
 objectptr object_base_new(void *value, const object_type_t *type_id) {
-  objectptr obj = malloc(sizeof *obj);
+  if (deferred_count > 0) {
+    release_deferred_objects(DEFERRED_PER_ALLOCATION);
+  }
+
+  objectptr obj = slab_alloc(object_size(type_id));
   obj->value = value;
   obj->type_id = type_id;
   obj->temporary = false;
+  obj->color = COLOR_BLACK;
+  obj->buffered = false;
+  obj->hash = 0;
   obj->ref_count = 1;
+  count_allocation(type_id);
   return obj;
 }
 
+objectptr object_base_new_inline(const object_type_t *type_id) {
+  assert(type_id->value_size > 0);
+  objectptr obj = object_base_new(NULL, type_id);
+  obj->value = obj + 1;
+  return obj;
+}
+
+void object_base_free(objectptr obj) {
+  ++obj->type_id->stats->freed;
+  slab_free(obj, object_size(obj->type_id));
+}
+
+void print_object_stats(FILE *file) {
+  for (const object_type_t *t = counted_types; t; t = t->stats->next) {
+    fprintf(file, "  %s: %zu allocated, %zu freed\n", t->type_name,
+            t->stats->allocated, t->stats->freed);
+  }
+
+  if (max_deferred_count > 0) {
+    fprintf(file, "  at most %zu objects waiting to be freed\n",
+            max_deferred_count);
+  }
+}
+
+/* Destroys an object whose reference count has reached zero */
+static void destroy_object(objectptr obj) {
+  obj->type_id->vtable.destroy(obj);
+  /* The collector still refers to an object that is a possible
+   * root, so it is freed at the next collection */
+  if (obj->buffered) {
+    obj->color = COLOR_BLACK;
+  } else {
+    object_base_free(obj);
+  }
+}
+
+static void defer_object(objectptr obj) {
+  if (deferred_count == deferred_capacity) {
+    deferred_capacity = deferred_capacity ? 2 * deferred_capacity : 64;
+    deferred = realloc(deferred, deferred_capacity * sizeof *deferred);
+  }
+
+  deferred[deferred_count++] = obj;
+  if (deferred_count > max_deferred_count) {
+    max_deferred_count = deferred_count;
+  }
+}
+
+void release_deferred_objects(size_t n) {
+  /* Destructors may allocate objects */
+  if (releasing) {
+    return;
+  }
+
+  releasing = true;
+  for (size_t i = 0; i < n && deferred_count > 0; ++i) {
+    destroy_object(deferred[--deferred_count]);
+  }
+  releasing = false;
+}
+
+size_t deferred_object_count(void) { return deferred_count; }
+
+bool deferred_free_enabled(void) { return deferred_free; }
+
+void set_deferred_free(bool enabled) {
+  if (!enabled) {
+    deferred_free = false;
+    release_deferred_objects(SIZE_MAX);
+    free(deferred);
+    deferred = NULL;
+    deferred_capacity = 0;
+  }
+
+  deferred_free = enabled;
+}
+
 objectptr clone_object(objectptr other) {
   if (other->temporary) {
     other->temporary = false;
@@ -73,8 +189,15 @@ void delete_object(objectptr obj) {
     assert(obj->type_id->vtable.destroy);
     if (--obj->ref_count == 0)
     {
-      obj->type_id->vtable.destroy(obj);
-      free(obj);
+      /* Objects that do not refer to other objects are destroyed in
+       * constant time, so only containers are deferred */
+      if (deferred_free && obj->type_id->vtable.traverse) {
+        defer_object(obj);
+      } else {
+        destroy_object(obj);
+      }
+    } else if (obj->type_id->vtable.traverse) {
+      collector_possible_root(obj);
     }
   }
 }
@@ -89,6 +212,28 @@ objectptr move(objectptr obj) {
   return obj;
 }
 
+objectptr settle(objectptr obj) {
+  obj->temporary = false;
+  return obj;
+}
+
+bool is_temporary(objectptr obj) {
+  return obj->temporary;
+}
+
+bool is_unique(objectptr obj) {
+  return obj->ref_count == 1;
+}
+
+bool is_reusable(objectptr obj) {
+  return obj->temporary && obj->ref_count == 1;
+}
+
+objectptr reuse_object(objectptr obj) {
+  ++obj->ref_count;
+  return obj;
+}
+
 char *object_tostring(objectptr obj) {
   if (obj->type_id->vtable.tostring) {
     return obj->type_id->vtable.tostring(obj);
@@ -96,6 +241,80 @@ char *object_tostring(objectptr obj) {
   return NULL;
 }
 
+void object_print(objectptr obj, output_port_ptr port) {
+  if (obj->type_id->vtable.print) {
+    obj->type_id->vtable.print(obj, port);
+    return;
+  }
+
+  char *str = object_tostring(obj);
+  port_puts(port, str);
+  free(str);
+}
+
+char *print_to_string(objectptr obj) {
+  assert(obj->type_id->vtable.print);
+  output_port_ptr port = new_string_port();
+  obj->type_id->vtable.print(obj, port);
+  return port_take_string(port);
+}
+
+/* Objects that are being printed, and pairs of objects that are being
+ * compared, in the order they are entered. There are only as many as
+ * containers nested in each other. */
+typedef struct {
+  objectptr *objects;
+  size_t length;
+  size_t capacity;
+} visit_stack_t;
+
+static visit_stack_t printing;
+static visit_stack_t comparing;
+
+static void push_visit(visit_stack_t *stack, objectptr obj) {
+  if (stack->length == stack->capacity) {
+    stack->capacity = stack->capacity ? 2 * stack->capacity : 16;
+    stack->objects =
+        realloc(stack->objects, stack->capacity * sizeof *stack->objects);
+  }
+  stack->objects[stack->length++] = obj;
+}
+
+bool begin_print(objectptr obj) {
+  for (size_t i = 0; i < printing.length; ++i) {
+    if (printing.objects[i] == obj) {
+      return false;
+    }
+  }
+
+  push_visit(&printing, obj);
+  return true;
+}
+
+void end_print(objectptr obj) {
+  assert(printing.length > 0 && printing.objects[printing.length - 1] == obj);
+  --printing.length;
+}
+
+bool begin_equals(objectptr obj, objectptr other) {
+  for (size_t i = 0; i < comparing.length; i += 2) {
+    if (comparing.objects[i] == obj && comparing.objects[i + 1] == other) {
+      return false;
+    }
+  }
+
+  push_visit(&comparing, obj);
+  push_visit(&comparing, other);
+  return true;
+}
+
+void end_equals(objectptr obj, objectptr other) {
+  assert(comparing.length > 1 &&
+         comparing.objects[comparing.length - 2] == obj &&
+         comparing.objects[comparing.length - 1] == other);
+  comparing.length -= 2;
+}
+
 bool object_equals(objectptr obj, objectptr other) {
   assert(obj->type_id->vtable.equals);
 
@@ -106,6 +325,14 @@ bool object_equals(objectptr obj, objectptr other) {
   return false;
 }
 
+bool object_hash(objectptr obj, size_t *hash) {
+  if (obj->type_id->vtable.hash) {
+    return obj->type_id->vtable.hash(obj, hash);
+  }
+
+  return false;
+}
+
 objectptr object_less(objectptr obj, objectptr other) {
   if (obj->type_id->vtable.less) {
     return obj->type_id->vtable.less(obj, other);
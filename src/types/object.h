@@ -23,13 +23,33 @@
 #define THEORYLISP_TYPES_OBJECT_H
 
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 
+#include "../utils/port.h"
 #include "../utils/string.h"
 
+/*
+ * Ownership of object references:
+ *
+ * Functions that return objectptr return owned references unless their
+ * documentation says otherwise. The caller must delete an owned reference
+ * once, or pass it to a function that takes ownership of it.
+ *
+ * A borrowed reference, such as the result of stack_frame_peek_variable,
+ * belongs to a variable or a container. It must not be deleted, and must
+ * be cloned if it is kept after the owner may change. Builtin functions
+ * receive their arguments as borrowed references.
+ */
 struct object;
 typedef struct object *objectptr;
 
+/**
+ * Function that is called for each object that is directly referenced
+ * by another object (see traverse in object_vtable_t).
+ */
+typedef void (*object_visitor)(objectptr child, void *context);
+
 /** Object destructor (Must be implemented) */
 void delete_object(objectptr obj);
 
@@ -49,13 +69,49 @@ void assign_object(objectptr *dest, objectptr src);
  */
 objectptr move(objectptr obj);
 
+/** Clears the temporary mark of an object */
+objectptr settle(objectptr obj);
+
+/** Returns true if the object is marked as temporary */
+bool is_temporary(objectptr obj);
+
+/** Returns true if there are no other references to the object */
+bool is_unique(objectptr obj);
+
+/**
+ * Returns true if the object is temporary and there are no other
+ * references to it. An operation that receives such an object as its
+ * first operand may store its result in the object instead of allocating
+ * a new one.
+ */
+bool is_reusable(objectptr obj);
+
+/**
+ * Returns a new reference to an object that an operation has updated in
+ * place. The object stays temporary, so that it can be reused again.
+ */
+objectptr reuse_object(objectptr obj);
+
 /** Returns string representation of object (Must be implemented) */
 char *object_tostring(objectptr obj);
 
+/**
+ * Writes the string representation of an object to a port. Types that do
+ * not implement print are converted with tostring first.
+ */
+void object_print(objectptr obj, output_port_ptr port);
+
 /** Returns true if and only if given objects are equal to each other (Must be
  * implemented) */
 bool object_equals(objectptr obj, objectptr other);
 
+/**
+ * Stores the hash of obj in *hash and returns true, or returns false if the
+ * object cannot be hashed (Optional operation). Equal objects have equal
+ * hashes, so objects with different hashes are not equal.
+ */
+bool object_hash(objectptr obj, size_t *hash);
+
 /** Returns true if obj is less than other (Optional operation) */
 objectptr object_less(objectptr obj, objectptr other);
 
@@ -91,4 +147,26 @@ objectptr object_op_call_internal(objectptr obj, void *args, void *sf);
 
 void *object_get_raw_data(objectptr obj);
 
+/** Prints the number of objects of each type that are created and deleted */
+void print_object_stats(FILE *file);
+
+/**
+ * Enables or disables deferred freeing. While it is enabled, a container
+ * such as a pair whose reference count reaches zero is added to a queue
+ * instead of being destroyed, and each allocation destroys up to two
+ * queued objects, so that dropping a large structure does not stop the
+ * program until all of it is freed. Disabling it destroys the remaining
+ * queued objects.
+ */
+void set_deferred_free(bool enabled);
+
+/** Returns true if deferred freeing is enabled */
+bool deferred_free_enabled(void);
+
+/** Destroys up to n objects that are waiting to be freed */
+void release_deferred_objects(size_t n);
+
+/** Returns the number of objects that are waiting to be freed */
+size_t deferred_object_count(void);
+
 #endif
@@ -23,25 +23,39 @@
 #include <string.h>
 
 #include "object-base.h"
+#include "../types/collector.h"
 #include "../types/null.h"
 #include "../utils/string.h"
 #include "../utils/list.h"
+#include "../utils/stack.h"
 #include "object.h"
 
+/* Values of the hash of a pair that is not computed yet, and of a pair
+ * that has an element that cannot be hashed. Other hashes are mapped
+ * above them. */
+#define HASH_UNKNOWN 0
+#define HASH_NONE 1
+
 /** Cons pair type */
 typedef struct pair {
   objectptr first;
   objectptr second;
 } pair_t;
 
+static object_stats_t pair_stats;
+
 static const object_type_t pair_type_id = {{
     .destroy = destroy_pair,
     .equals = pair_equals,
     .tostring = pair_tostring,
-}, "pair"};
+    .print = pair_print,
+    .traverse = pair_traverse,
+    .hash = pair_hash,
+}, "pair", sizeof(pair_t), &pair_stats};
 
 bool is_pair(objectptr obj) {
-  return strcmp(pair_type_id.type_name, obj->type_id->type_name) == 0;
+  return obj->type_id == &pair_type_id ||
+         strcmp(pair_type_id.type_name, obj->type_id->type_name) == 0;
 }
 
 objectptr pair_first(objectptr obj) {
@@ -55,42 +69,154 @@ objectptr pair_second(objectptr obj) {
 }
 
 objectptr make_pair(objectptr first, objectptr second) {
-  pair_t *pair_value = malloc(sizeof *pair_value);
+  objectptr obj = object_base_new_inline(&pair_type_id);
+  pair_t *pair_value = obj->value;
   pair_value->first = clone_object(first);
   pair_value->second = clone_object(second);
-
-  return object_base_new(pair_value, &pair_type_id);
+  collector_init_object(obj);
+  return obj;
 }
 
 void destroy_pair(objectptr self) {
   assert(is_pair(self));
   pair_t *pair_value = self->value;
   delete_object(pair_value->first);
-  delete_object(pair_value->second);
-  free(pair_value);
+
+  /* The rest of a list that is not referenced from elsewhere is freed
+   * here one pair at a time, since deleting it recursively could overflow
+   * the stack for long lists. Deferred freeing does not recurse. */
+  objectptr next = pair_value->second;
+  while (!deferred_free_enabled() && next->type_id == &pair_type_id &&
+         next->ref_count == 1 && !next->buffered) {
+    pair_value = next->value;
+    delete_object(pair_value->first);
+    objectptr rest = pair_value->second;
+    object_base_free(next);
+    next = rest;
+  }
+
+  delete_object(next);
 }
 
-char *pair_tostring(objectptr self) {
+void pair_traverse(objectptr self, object_visitor visit, void *context) {
   assert(is_pair(self));
   pair_t *pair_value = self->value;
-  char *first_string = object_tostring(pair_value->first);
-  char *second_string = object_tostring(pair_value->second);
-  char *result = format("(cons %s %s)", first_string, second_string);
-  free(first_string);
-  free(second_string);
-  return result;
+  visit(pair_value->first, context);
+  visit(pair_value->second, context);
+}
+
+char *pair_tostring(objectptr self) {
+  return print_to_string(self);
+}
+
+/* Markers for the text that follows the elements of a pair */
+static char separator_marker;
+static char closing_marker;
+
+void pair_print(objectptr self, output_port_ptr port) {
+  assert(is_pair(self));
+
+  /* Objects that are left to be printed and the markers between them are
+   * kept on a stack, so that nested pairs and long lists do not need
+   * recursion */
+  stackptr pending = new_stack();
+  stack_push(pending, self);
+  while (stack_size(pending) > 0) {
+    void *next = stack_pop(pending);
+    if (next == &separator_marker) {
+      port_putc(port, ' ');
+    } else if (next == &closing_marker) {
+      port_putc(port, ')');
+    } else if (is_pair(next)) {
+      pair_t *pair_value = ((objectptr)next)->value;
+      port_write(port, "(cons ", 6);
+      stack_push(pending, &closing_marker);
+      stack_push(pending, pair_value->second);
+      stack_push(pending, &separator_marker);
+      stack_push(pending, pair_value->first);
+    } else {
+      object_print(next, port);
+    }
+  }
+
+  delete_stack(pending);
+}
+
+/* Returns the hash of an element of a pair, or HASH_NONE */
+static uint32_t element_hash(objectptr obj) {
+  size_t hash;
+  if (!object_hash(obj, &hash)) {
+    return HASH_NONE;
+  }
+
+  return obj->type_id == &pair_type_id ? (uint32_t)hash
+                                       : (uint32_t)(hash % (UINT32_MAX - 1)) + 2;
+}
+
+static uint32_t combine_hashes(uint32_t first, uint32_t second) {
+  if (first == HASH_NONE || second == HASH_NONE) {
+    return HASH_NONE;
+  }
+
+  uint32_t hash = first * 31 + (second ^ (second >> 15)) * 0x9e3779b1u;
+  return hash > HASH_NONE ? hash : hash + 2;
+}
+
+bool pair_hash(objectptr self, size_t *hash) {
+  assert(is_pair(self));
+
+  if (self->hash == HASH_UNKNOWN) {
+    /* The hashes of the pairs in the rest of the list are computed
+     * from the end of the list */
+    stackptr unknown = new_stack();
+    objectptr next = self;
+    while (next->type_id == &pair_type_id && next->hash == HASH_UNKNOWN) {
+      stack_push(unknown, next);
+      next = ((pair_t *)next->value)->second;
+    }
+
+    uint32_t rest = element_hash(next);
+    while (!stack_is_empty(unknown)) {
+      objectptr pair = stack_pop(unknown);
+      pair_t *pair_value = pair->value;
+      rest = combine_hashes(element_hash(pair_value->first), rest);
+      pair->hash = rest;
+    }
+    delete_stack(unknown);
+  }
+
+  *hash = self->hash;
+  return self->hash != HASH_NONE;
 }
 
 bool pair_equals(objectptr self, objectptr other) {
   assert(is_pair(self));
-  if (!is_pair(other)) {
-    return false;
+
+  size_t self_hash, other_hash;
+  while (other->type_id == &pair_type_id) {
+    if (self == other) {
+      return true;
+    }
+
+    if (pair_hash(self, &self_hash) && pair_hash(other, &other_hash) &&
+        self_hash != other_hash) {
+      return false;
+    }
+
+    pair_t *self_value = self->value;
+    pair_t *other_value = other->value;
+    if (!object_equals(self_value->first, other_value->first)) {
+      return false;
+    }
+
+    self = self_value->second;
+    other = other_value->second;
+    if (self->type_id != &pair_type_id) {
+      return object_equals(self, other);
+    }
   }
 
-  pair_t *self_value = self->value;
-  pair_t *other_value = other->value;
-  return object_equals(self_value->first, other_value->first) &&
-         object_equals(self_value->second, other_value->second);
+  return false;
 }
 
 bool cons_list_to_internal_list(objectptr list_object, listptr output_list) {
@@ -128,11 +254,9 @@ objectptr internal_list_to_cons_list(listptr input_list) {
   }
 
   objectptr pair = make_null();
-  if (len >= 2) {
-    for (size_t i = len; i != 0; --i) {
-      objectptr arg = list_get(input_list, i - 1);
-      assign_object(&pair, make_pair(arg, pair));
-    }
+  for (size_t i = len; i != 0; --i) {
+    objectptr arg = list_get(input_list, i - 1);
+    assign_object(&pair, make_pair(arg, pair));
   }
 
   return pair;
@@ -47,13 +47,30 @@ void destroy_pair(objectptr obj);
  */
 char *pair_tostring(objectptr val);
 
+/** Writes the string representation of the pair to a port */
+void pair_print(objectptr val, output_port_ptr port);
+
 /**
  * Returns true if and only if the first element of obj equals
  * the first element of other and the second element of obj equals
- * the second element of other.
+ * the second element of other. Lists are compared in a loop rather than
+ * recursively, and lists whose hashes are known to differ are rejected
+ * without comparing their elements.
  */
 bool pair_equals(objectptr obj, objectptr other);
 
+/**
+ * Hashes the elements of the pair. The hash is computed when it is first
+ * needed and is stored in the pair, along with the hashes of the pairs in
+ * the rest of the list. Returns false if an element cannot be hashed.
+ */
+bool pair_hash(objectptr obj, size_t *hash);
+
+/**
+ * Calls visit for the first and the second element of the pair.
+ */
+void pair_traverse(objectptr obj, object_visitor visit, void *context);
+
 /**
  * Returns true if and only if the given object is a cons pair.
  */
@@ -30,6 +30,7 @@
 #include "../expressions/let.h"
 #include "../interpreter/stack_frame.h"
 #include "../interpreter/variable.h"
+#include "../types/collector.h"
 #include "../types/error.h"
 #include "../utils/string.h"
 
@@ -40,13 +41,16 @@ typedef struct {
   listptr closure;
 } proc_t;
 
+static object_stats_t procedure_stats;
+
 static const object_type_t procedure_type_id = {{
     .destroy = destroy_procedure,
     .tostring = procedure_tostring,
     .equals = procedure_equals,
     .op_call = procedure_op_call,
-    .op_call_internal = procedure_op_call_internal},
-    "procedure"};
+    .op_call_internal = procedure_op_call_internal,
+    .traverse = procedure_traverse},
+    "procedure", sizeof(proc_t), &procedure_stats};
 
 bool is_procedure(objectptr obj) {
   return strcmp(procedure_type_id.type_name, obj->type_id->type_name) == 0;
@@ -65,7 +69,8 @@ objectptr make_procedure(lambda_t proc, listptr captures, stack_frame_ptr sf) {
   }
 
   /* Create the procedure object */
-  proc_t *p = malloc(sizeof *p);
+  objectptr obj = object_base_new_inline(&procedure_type_id);
+  proc_t *p = obj->value;
   p->lambda = clone_expr(proc);
   p->closure = new_list();
 
@@ -79,7 +84,8 @@ objectptr make_procedure(lambda_t proc, listptr captures, stack_frame_ptr sf) {
     }
   }
 
-  return object_base_new(p, &procedure_type_id);
+  collector_init_object(obj);
+  return obj;
 }
 
 void destroy_procedure(objectptr self) {
@@ -94,7 +100,17 @@ void destroy_procedure(objectptr self) {
 
   /* Delete lambda */
   delete_expr(p->lambda);
-  free(p);
+}
+
+void procedure_traverse(objectptr self, object_visitor visit, void *context) {
+  assert(is_procedure(self));
+  proc_t *p = self->value;
+  for (size_t i = 0; i < list_size(p->closure); ++i) {
+    objectptr value = variable_peek_value(list_get(p->closure, i));
+    if (value) {
+      visit(value, context);
+    }
+  }
 }
 
 char *procedure_tostring(objectptr self) {
@@ -142,6 +158,11 @@ size_t procedure_get_arity(objectptr self) {
   return expr_get_arity(p->lambda);
 }
 
+lambda_t procedure_get_lambda(objectptr self) {
+  proc_t *p = self->value;
+  return p->lambda;
+}
+
 static stack_frame_ptr construct_stack_frame(listptr closure, stack_frame_ptr sf) {
   stack_frame_ptr local_frame = new_stack_frame(sf);
 
@@ -156,12 +177,18 @@ static stack_frame_ptr construct_stack_frame(listptr closure, stack_frame_ptr sf
   return local_frame;
 }
 
+stack_frame_ptr procedure_new_frame(objectptr self, stack_frame_ptr sf) {
+  proc_t *p = self->value;
+  return construct_stack_frame(p->closure, sf);
+}
+
 objectptr procedure_op_call(objectptr self, size_t nargs, objectptr *args,
                            void *sf) {
   proc_t *p = self->value;
   stack_frame_ptr local_frame = construct_stack_frame(p->closure, sf); 
   objectptr result = expr_call(p->lambda, nargs, args, local_frame);
   delete_stack_frame(local_frame);
+  collector_safe_point();
   return result;
 }
 
@@ -170,5 +197,6 @@ objectptr procedure_op_call_internal(objectptr self, void *args, void *sf) {
   stack_frame_ptr local_frame = construct_stack_frame(p->closure, sf);
   objectptr result = expr_call_internal(p->lambda, args, local_frame);
   delete_stack_frame(local_frame);
+  collector_safe_point();
   return result;
 }
@@ -44,6 +44,11 @@ objectptr make_procedure(lambda_t proc, listptr captures, stack_frame_ptr sf);
  */
 void destroy_procedure(objectptr procedure);
 
+/**
+ * Calls visit for the values of the captured variables.
+ */
+void procedure_traverse(objectptr obj, object_visitor visit, void *context);
+
 /**
  * Returns the string representation of the procedure.
  * If the returned string is substituted as input to scanner, and then
@@ -90,6 +95,18 @@ bool procedure_is_pn_arity_given(objectptr self);
  */
 bool procedure_is_variadic(objectptr self);
 
+/**
+ * Returns the lambda expression of the procedure
+ */
+lambda_t procedure_get_lambda(objectptr self);
+
+/**
+ * Returns a new stack frame on top of sf that contains the captured
+ * variables of the procedure, as the frame that a call would use.
+ * The frame must be deleted by the caller.
+ */
+stack_frame_ptr procedure_new_frame(objectptr self, stack_frame_ptr sf);
+
 /**
  * Calls the procedure
  */
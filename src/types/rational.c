@@ -28,15 +28,19 @@
 #include "object-base.h"
 #include "real.h"
 
+static object_stats_t rational_stats;
+
 static const object_type_t rational_type_id = {{.destroy = destroy_rational,
                                                 .equals = rational_equals,
                                                 .tostring = rational_tostring,
+                                                .print = rational_print,
                                                 .op_add = rational_op_add,
                                                 .op_mul = rational_op_mul,
                                                 .op_sub = rational_op_sub,
                                                 .op_div = rational_op_div,
-                                                .less = rational_less},
-                                               "rational"};
+                                                .less = rational_less,
+                                                .hash = rational_hash},
+                                               "rational", sizeof(rational_t), &rational_stats};
 
 bool is_rational(objectptr obj) {
   return strcmp(rational_type_id.type_name, obj->type_id->type_name) == 0;
@@ -67,26 +71,29 @@ static integer_t gcd(integer_t x, integer_t y) {
 }
 
 objectptr make_rational(integer_t x, integer_t y) {
-  rational_t *rational_value = malloc(sizeof *rational_value);
+  objectptr obj = object_base_new_inline(&rational_type_id);
+  rational_t *rational_value = obj->value;
   integer_t gcd_of_x_y = gcd(x, y);
   rational_value->x = x / gcd_of_x_y;
   rational_value->y = y / gcd_of_x_y;
-
-  return object_base_new(rational_value, &rational_type_id);
+  return obj;
 }
 
 void destroy_rational(objectptr self) {
   assert(is_rational(self));
-  free(self->value);
 }
 
 char *rational_tostring(objectptr self) {
+  return print_to_string(self);
+}
+
+void rational_print(objectptr self, output_port_ptr port) {
   assert(is_rational(self));
   rational_t r = rational_value(self);
   if (r.y == 1) {
-    return format("%ld", r.x);
+    port_printf(port, "%ld", r.x);
   } else {
-    return format("%ld/%ld", r.x, r.y);
+    port_printf(port, "%ld/%ld", r.x, r.y);
   }
 }
 
@@ -110,6 +117,13 @@ bool rational_equals(objectptr self, objectptr other) {
   return false;
 }
 
+bool rational_hash(objectptr self, size_t *hash) {
+  assert(is_rational(self));
+  rational_t value = rational_value(self);
+  *hash = hash_number((real_t)value.x / (real_t)value.y);
+  return true;
+}
+
 objectptr rational_op_add(objectptr self, objectptr other) {
   assert(is_rational(self));
   rational_t self_value = rational_value(self);
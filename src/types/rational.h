@@ -39,8 +39,12 @@ void destroy_rational(objectptr val);
 
 char *rational_tostring(objectptr val);
 
+void rational_print(objectptr val, output_port_ptr port);
+
 bool rational_equals(objectptr self, objectptr other);
 
+bool rational_hash(objectptr self, size_t *hash);
+
 objectptr rational_less(objectptr self, objectptr other);
 
 objectptr rational_op_add(objectptr self, objectptr other);
@@ -20,6 +20,7 @@
 #include "real.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -32,18 +33,23 @@
 #include "integer.h"
 #include "rational.h"
 
+static object_stats_t real_stats;
+
 static const object_type_t real_type_id = {{.destroy = destroy_real,
                                             .equals = real_equals,
                                             .tostring = real_tostring,
+                                            .print = real_print,
                                             .op_add = real_op_add,
                                             .op_mul = real_op_mul,
                                             .op_sub = real_op_sub,
                                             .op_div = real_op_div,
-                                            .less = real_less},
-                                            "real"};
+                                            .less = real_less,
+                                            .hash = real_hash},
+                                            "real", sizeof(real_t), &real_stats};
 
 bool is_real(objectptr obj) {
-  return strcmp(real_type_id.type_name, obj->type_id->type_name) == 0;
+  return obj->type_id == &real_type_id ||
+         strcmp(real_type_id.type_name, obj->type_id->type_name) == 0;
 }
 
 bool is_number(objectptr obj) {
@@ -84,15 +90,13 @@ real_t cast_real(objectptr obj) {
 }
 
 objectptr make_real(real_t value) {
-  real_t *real_value = malloc(sizeof *real_value);
-  *real_value = value;
-
-  return object_base_new(real_value, &real_type_id);
+  objectptr obj = object_base_new_inline(&real_type_id);
+  *(real_t *)obj->value = value;
+  return obj;
 }
 
 void destroy_real(objectptr self) {
   assert(is_real(self));
-  free(self->value);
 }
 
 bool real_equals(objectptr self, objectptr other) {
@@ -114,6 +118,26 @@ bool real_equals(objectptr self, objectptr other) {
   return false;
 }
 
+size_t hash_number(real_t value) {
+  /* Negative zero is equal to zero */
+  if (value == 0) {
+    value = 0;
+  }
+
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof bits);
+  bits ^= bits >> 33;
+  bits *= 0xff51afd7ed558ccdULL;
+  bits ^= bits >> 33;
+  return (size_t)bits;
+}
+
+bool real_hash(objectptr self, size_t *hash) {
+  assert(is_real(self));
+  *hash = hash_number(real_value(self));
+  return true;
+}
+
 objectptr real_less(objectptr self, objectptr other) {
   assert(is_real(self));
   real_t self_value = real_value(self);
@@ -134,7 +158,21 @@ objectptr real_less(objectptr self, objectptr other) {
 }
 
 char *real_tostring(objectptr obj) {
-  return format("%f", real_value(obj));
+  return print_to_string(obj);
+}
+
+void real_print(objectptr obj, output_port_ptr port) {
+  port_printf(port, "%f", real_value(obj));
+}
+
+/* Stores the result of an operation in self if self can be reused */
+static objectptr real_result(objectptr self, real_t value) {
+  if (is_reusable(self)) {
+    *(real_t *)self->value = value;
+    return reuse_object(self);
+  }
+
+  return make_real(value);
 }
 
 objectptr real_op_add(objectptr self, objectptr other) {
@@ -142,15 +180,15 @@ objectptr real_op_add(objectptr self, objectptr other) {
   real_t self_value = real_value(self);
 
   if (is_integer(other)) {
-    return make_real(self_value + real_value_of_integer(other));
+    return real_result(self, self_value + real_value_of_integer(other));
   }
 
   if (is_real(other)) {
-    return make_real(self_value + real_value(other));
+    return real_result(self, self_value + real_value(other));
   }
 
   if (is_rational(other)) {
-    return make_real(self_value + real_value_of_rational(other));
+    return real_result(self, self_value + real_value_of_rational(other));
   }
 
   return make_error("+ operand is not a number.");
@@ -161,15 +199,15 @@ objectptr real_op_mul(objectptr self, objectptr other) {
   real_t self_value = real_value(self);
 
   if (is_integer(other)) {
-    return make_real(self_value * real_value_of_integer(other));
+    return real_result(self, self_value * real_value_of_integer(other));
   }
 
   if (is_real(other)) {
-    return make_real(self_value * real_value(other));
+    return real_result(self, self_value * real_value(other));
   }
 
   if (is_rational(other)) {
-    return make_real(self_value * real_value_of_rational(other));
+    return real_result(self, self_value * real_value_of_rational(other));
   }
 
   return make_error("+ operand is not a number.");
@@ -180,15 +218,15 @@ objectptr real_op_sub(objectptr self, objectptr other) {
   real_t self_value = real_value(self);
 
   if (is_integer(other)) {
-    return make_real(self_value - real_value_of_integer(other));
+    return real_result(self, self_value - real_value_of_integer(other));
   }
 
   if (is_real(other)) {
-    return make_real(self_value - real_value(other));
+    return real_result(self, self_value - real_value(other));
   }
 
   if (is_rational(other)) {
-    return make_real(self_value - real_value_of_rational(other));
+    return real_result(self, self_value - real_value_of_rational(other));
   }
 
   return make_error("+ operand is not a number.");
@@ -199,15 +237,15 @@ objectptr real_op_div(objectptr self, objectptr other) {
   real_t self_value = real_value(self);
 
   if (is_integer(other)) {
-    return make_real(self_value / real_value_of_integer(other));
+    return real_result(self, self_value / real_value_of_integer(other));
   }
 
   if (is_real(other)) {
-    return make_real(self_value / real_value(other));
+    return real_result(self, self_value / real_value(other));
   }
 
   if (is_rational(other)) {
-    return make_real(self_value / real_value_of_rational(other));
+    return real_result(self, self_value / real_value_of_rational(other));
   }
 
   return make_error("+ operand is not a number.");
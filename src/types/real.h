@@ -52,6 +52,8 @@ void destroy_real(objectptr val);
  */
 char *real_tostring(objectptr val);
 
+void real_print(objectptr val, output_port_ptr port);
+
 /**
  * Compares two real numbers for equality.
  * Warning: Real numbers are currently implemented using double
@@ -66,6 +68,15 @@ char *real_tostring(objectptr val);
  */
 bool real_equals(objectptr val, objectptr other);
 
+/**
+ * Hashes a real number. Integers and rational numbers are hashed by
+ * their real values, so that numbers that are equal have equal hashes.
+ */
+bool real_hash(objectptr val, size_t *hash);
+
+/** Returns the hash of a number with the given real value */
+size_t hash_number(real_t value);
+
 /**
  * Less than operator for real numbers (self < other).
  * The second operand can have a type different from real
@@ -22,39 +22,209 @@
 #include <assert.h>
 #include <string.h>
 
+#include "../types/boolean.h"
 #include "../types/error.h"
 #include "../types/integer.h"
+#include "../types/pair.h"
+#include "../utils/stack.h"
 #include "../utils/string.h"
 #include "object-base.h"
 #include "object.h"
 
+/* Concatenations shorter than this are copied instead of being
+ * represented by rope nodes */
+#define MIN_ROPE_LENGTH 64
+
+/**
+ * A string is either flat, with its characters stored in a buffer, a
+ * slice of the buffer of a flat string, or a rope node that represents the
+ * concatenation of two other strings. The characters of a rope node are
+ * copied into a buffer when they are first needed, and the concatenated
+ * strings are released. The characters of a slice are not followed by a
+ * NUL character, so they are copied into a buffer of the slice when
+ * string_value is called.
+ */
+typedef struct {
+  /// Characters of a flat string or a slice, NULL for a rope node
+  char *chars;
+  size_t length;
+  /// Size of the buffer that chars points to, zero for a slice
+  size_t capacity;
+  /// Concatenated strings of a rope node, or the string of a slice
+  objectptr left;
+  objectptr right;
+} string_data_t;
+
+static object_stats_t string_stats;
+
 static const object_type_t string_type_id = {{
     .destroy = destroy_string,
     .equals = string_equals,
-    .tostring = string_tostring},
-    "string"};
+    .tostring = string_tostring,
+    .print = string_print,
+    .hash = string_hash},
+    "string", sizeof(string_data_t), &string_stats};
 
 bool is_string(objectptr obj) {
-  return strcmp(string_type_id.type_name, obj->type_id->type_name) == 0;
+  return obj->type_id == &string_type_id ||
+         strcmp(string_type_id.type_name, obj->type_id->type_name) == 0;
+}
+
+/* Creates a flat string that owns the given buffer */
+static objectptr new_flat_string(char *chars, size_t length,
+                                 size_t capacity) {
+  objectptr obj = object_base_new_inline(&string_type_id);
+  string_data_t *data = obj->value;
+  data->chars = chars;
+  data->length = length;
+  data->capacity = capacity;
+  data->left = NULL;
+  data->right = NULL;
+  return obj;
+}
+
+static objectptr new_rope_node(objectptr left, objectptr right) {
+  objectptr obj = object_base_new_inline(&string_type_id);
+  string_data_t *data = obj->value;
+  data->chars = NULL;
+  data->length = ((string_data_t *)left->value)->length +
+                 ((string_data_t *)right->value)->length;
+  data->capacity = 0;
+  data->left = left;
+  data->right = right;
+  return obj;
+}
+
+/* Returns a new reference to a string that becomes part of a rope node
+ * or a slice */
+static objectptr share(objectptr obj) {
+  ++obj->ref_count;
+  return settle(obj);
+}
+
+/* Deletes the concatenated strings of a rope node. Rope nodes that are
+ * not referenced from elsewhere are freed here one at a time, since
+ * deleting them recursively could overflow the stack for long ropes. */
+static void release_parts(string_data_t *data) {
+  stackptr parts = new_stack();
+  stack_push(parts, data->left);
+  stack_push(parts, data->right);
+  data->left = NULL;
+  data->right = NULL;
+
+  while (!stack_is_empty(parts)) {
+    objectptr part = stack_pop(parts);
+    string_data_t *part_data = part->value;
+    if (part->ref_count == 1 && !part_data->chars) {
+      stack_push(parts, part_data->left);
+      stack_push(parts, part_data->right);
+      object_base_free(part);
+    } else {
+      delete_object(part);
+    }
+  }
+
+  delete_stack(parts);
+}
+
+/* Copies the characters of a rope node into a buffer */
+static void flatten(objectptr obj) {
+  string_data_t *data = obj->value;
+  if (data->chars) {
+    return;
+  }
+
+  char *chars = malloc(data->length + 1);
+  size_t position = 0;
+  stackptr parts = new_stack();
+  stack_push(parts, obj);
+  while (!stack_is_empty(parts)) {
+    string_data_t *part_data = ((objectptr)stack_pop(parts))->value;
+    if (part_data->chars) {
+      memcpy(chars + position, part_data->chars, part_data->length);
+      position += part_data->length;
+    } else {
+      stack_push(parts, part_data->right);
+      stack_push(parts, part_data->left);
+    }
+  }
+  delete_stack(parts);
+
+  assert(position == data->length);
+  chars[position] = '\0';
+  release_parts(data);
+  data->chars = chars;
+  data->capacity = data->length + 1;
+}
+
+static inline bool is_slice(string_data_t *data) {
+  return data->chars && data->left;
+}
+
+const char *string_chars(objectptr obj) {
+  assert(is_string(obj));
+  flatten(obj);
+  return ((string_data_t *)obj->value)->chars;
 }
 
 string_t string_value(objectptr obj) {
   assert(is_string(obj));
-  return obj->value;
+  flatten(obj);
+
+  string_data_t *data = obj->value;
+  if (is_slice(data)) {
+    char *chars = malloc(data->length + 1);
+    memcpy(chars, data->chars, data->length);
+    chars[data->length] = '\0';
+    delete_object(data->left);
+    data->left = NULL;
+    data->chars = chars;
+    data->capacity = data->length + 1;
+  }
+
+  return data->chars;
+}
+
+size_t string_size(objectptr obj) {
+  assert(is_string(obj));
+  return ((string_data_t *)obj->value)->length;
 }
 
 objectptr make_string(const string_t value) {
-  return object_base_new(strdup(value), &string_type_id);
+  size_t length = strlen(value);
+  char *chars = malloc(length + 1);
+  memcpy(chars, value, length + 1);
+  return new_flat_string(chars, length, length + 1);
+}
+
+objectptr make_string_n(const char *chars, size_t length) {
+  char *copy = malloc(length + 1);
+  memcpy(copy, chars, length);
+  copy[length] = '\0';
+  return new_flat_string(copy, length, length + 1);
 }
 
 void destroy_string(objectptr self) {
   assert(is_string(self));
-  free(self->value);
+  string_data_t *data = self->value;
+  if (!data->chars) {
+    release_parts(data);
+  } else if (is_slice(data)) {
+    delete_object(data->left);
+  } else {
+    free(data->chars);
+  }
 }
 
 char *string_tostring(objectptr self) {
+  return print_to_string(self);
+}
+
+void string_print(objectptr self, output_port_ptr port) {
   assert(is_string(self));
-  return format("\"%s\"", self->value);
+  port_putc(port, '"');
+  port_write(port, string_chars(self), string_size(self));
+  port_putc(port, '"');
 }
 
 bool string_equals(objectptr self, objectptr other) {
@@ -63,40 +233,105 @@ bool string_equals(objectptr self, objectptr other) {
     return false;
   }
 
-  return strcmp(self->value, other->value) == 0;
+  if (self == other) {
+    return true;
+  }
+
+  if (string_size(self) != string_size(other)) {
+    return false;
+  }
+
+  return memcmp(string_chars(self), string_chars(other),
+                string_size(self)) == 0;
+}
+
+bool string_hash(objectptr self, size_t *hash) {
+  assert(is_string(self));
+  /* FNV-1a */
+  size_t result = 14695981039346656037ULL;
+  const char *chars = string_chars(self);
+  for (size_t i = 0; i < string_size(self); ++i) {
+    result = (result ^ (unsigned char)chars[i]) * 1099511628211ULL;
+  }
+
+  *hash = result;
+  return true;
 }
 
 objectptr string_length(objectptr obj) {
   assert(is_string(obj));
-  return make_integer((long)strlen(string_value(obj)));
+  return make_integer((integer_t)string_size(obj));
 }
 
-objectptr string_concat(objectptr first, objectptr second) {
-  objectptr first_str = NULL;
-  if (is_string(first)) {
-    first_str = clone_object(first);
-  } else {
-    char *str = object_tostring(first);
-    first_str = make_string(str);
-    free(str);
+/* Returns the operand as a string. Other objects are converted to their
+ * string representations, which are stored in *converted and must be
+ * deleted by the caller. */
+static objectptr string_operand(objectptr obj, objectptr *converted) {
+  if (is_string(obj)) {
+    *converted = NULL;
+    return obj;
   }
 
-  objectptr second_str = NULL;
-  if (is_string(second)) {
-    second_str = clone_object(second);
-  } else {
-    char *str = object_tostring(second);
-    second_str = make_string(str);
-    free(str);
+  char *representation = object_tostring(obj);
+  size_t length = strlen(representation);
+  *converted = new_flat_string(representation, length, length + 1);
+  return *converted;
+}
+
+/* Appends characters to a flat string, doubling its buffer when it is
+ * full, so that repeated appends take amortized constant time per
+ * character */
+static void append_in_place(string_data_t *data, const char *chars,
+                            size_t length) {
+  size_t required = data->length + length + 1;
+  if (required > data->capacity) {
+    size_t capacity = 2 * data->capacity;
+    data->capacity = capacity > required ? capacity : required;
+    data->chars = realloc(data->chars, data->capacity);
   }
 
-  char *concat = append(string_value(first_str), string_value(second_str));
-  objectptr result = make_string(concat);
-  free(concat);
+  memcpy(data->chars + data->length, chars, length);
+  data->length += length;
+  data->chars[data->length] = '\0';
+}
 
-  delete_object(first_str);
-  delete_object(second_str);
+objectptr string_concat(objectptr first, objectptr second) {
+  objectptr first_converted = NULL;
+  objectptr second_converted = NULL;
+  objectptr left = string_operand(first, &first_converted);
+  objectptr right = string_operand(second, &second_converted);
+  string_data_t *left_data = left->value;
+  string_data_t *right_data = right->value;
+  size_t length = left_data->length + right_data->length;
 
+  objectptr result = NULL;
+  if (right_data->length == 0) {
+    result = left == first ? reuse_object(first) : share(left);
+  } else if (left_data->length == 0) {
+    result = share(right);
+  } else if (right_data->length < MIN_ROPE_LENGTH && left == first &&
+             left_data->chars && !is_slice(left_data) && first != second &&
+             is_reusable(first)) {
+    /* Short strings are appended to a reusable string in place */
+    append_in_place(left_data, string_chars(right), right_data->length);
+    result = reuse_object(first);
+  } else if (length < MIN_ROPE_LENGTH) {
+    char *chars = malloc(length + 1);
+    memcpy(chars, string_chars(left), left_data->length);
+    memcpy(chars + left_data->length, string_chars(right),
+           right_data->length);
+    chars[length] = '\0';
+    result = new_flat_string(chars, length, length + 1);
+  } else {
+    result = new_rope_node(share(left), share(right));
+  }
+
+  if (first_converted) {
+    delete_object(first_converted);
+  }
+  if (second_converted) {
+    delete_object(second_converted);
+  }
   return result;
 }
 
@@ -105,20 +340,14 @@ objectptr string_charat(objectptr obj, size_t index) {
     return make_error("charat operand is not string");
   }
 
-  objectptr strlen_obj = string_length(obj);
-  if (is_error(strlen_obj)) {
-    return strlen_obj;
-  }
-
-  if (index >= int_value(strlen_obj)) {
-    delete_object(strlen_obj);
+  if (index >= string_size(obj)) {
     return make_error("Index is outside of string");
   }
 
-  delete_object(strlen_obj);
-  char result_string[] = "0";
-  result_string[0] = string_value(obj)[index];
-  return make_string(result_string);
+  char *chars = malloc(2);
+  chars[0] = string_chars(obj)[index];
+  chars[1] = '\0';
+  return new_flat_string(chars, 1, 2);
 }
 
 objectptr string_substring(objectptr obj, size_t begin, size_t end) {
@@ -126,26 +355,120 @@ objectptr string_substring(objectptr obj, size_t begin, size_t end) {
     return make_error("substring operand is not string");
   }
 
-  objectptr strlen_obj = string_length(obj);
-  if (is_error(strlen_obj)) {
-    return strlen_obj;
+  if (begin > end) {
+    return make_error("Begin index is larger than end index");
   }
 
-  if (begin >= int_value(strlen_obj)) {
-    return make_error("Begin index is outside of string");
+  if (end > string_size(obj)) {
+    return make_error("End index is outside of string");
   }
 
-  if (end >= int_value(strlen_obj)) {
-    return make_error("End index is outside of string");
+  if (begin == 0 && end == string_size(obj)) {
+    return share(obj);
   }
 
-  if (begin > end) {
-    return make_error("Begin index is larger than end index");
+  /* The slice refers to the flat string that owns the characters */
+  const char *chars = string_chars(obj);
+  string_data_t *data = obj->value;
+  objectptr owner = is_slice(data) ? data->left : obj;
+
+  objectptr slice = object_base_new_inline(&string_type_id);
+  string_data_t *slice_data = slice->value;
+  slice_data->chars = (char *)chars + begin;
+  slice_data->length = end - begin;
+  slice_data->capacity = 0;
+  slice_data->left = share(owner);
+  slice_data->right = NULL;
+  return slice;
+}
+
+/* Returns the first occurrence of pattern in obj at or after the given
+ * index, or NULL */
+static const char *find(objectptr obj, objectptr pattern, size_t start) {
+  return find_substring(string_chars(obj) + start, string_size(obj) - start,
+                        string_chars(pattern), string_size(pattern));
+}
+
+objectptr string_index(objectptr obj, objectptr pattern) {
+  if (!is_string(obj) || !is_string(pattern)) {
+    return make_error("string-index operands are not strings");
   }
 
-  char *substr = malloc(end - begin + 1);
-  strncpy(substr, &string_value(obj)[begin], end - begin);
-  objectptr result = make_string(substr);
-  free(substr);
+  const char *found = find(obj, pattern, 0);
+  if (!found) {
+    return make_integer(-1);
+  }
+
+  return make_integer((integer_t)(found - string_chars(obj)));
+}
+
+objectptr string_contains(objectptr obj, objectptr pattern) {
+  if (!is_string(obj) || !is_string(pattern)) {
+    return make_error("string-contains operands are not strings");
+  }
+
+  return make_boolean(find(obj, pattern, 0) != NULL);
+}
+
+objectptr string_split(objectptr obj, objectptr separator) {
+  if (!is_string(obj) || !is_string(separator)) {
+    return make_error("string-split operands are not strings");
+  }
+
+  if (string_size(separator) == 0) {
+    return make_error("string-split separator is empty");
+  }
+
+  /* The parts are slices of the string */
+  listptr parts = new_list();
+  const char *chars = string_chars(obj);
+  size_t begin = 0;
+  const char *found = NULL;
+  while ((found = find(obj, separator, begin))) {
+    size_t end = (size_t)(found - chars);
+    list_add(parts, string_substring(obj, begin, end));
+    begin = end + string_size(separator);
+  }
+  list_add(parts, string_substring(obj, begin, string_size(obj)));
+
+  objectptr result = internal_list_to_cons_list(parts);
+  for (size_t i = 0; i < list_size(parts); ++i) {
+    delete_object(list_get(parts, i));
+  }
+  delete_list(parts);
   return result;
 }
+
+objectptr string_replace(objectptr obj, objectptr pattern,
+                         objectptr replacement) {
+  if (!is_string(obj) || !is_string(pattern) || !is_string(replacement)) {
+    return make_error("string-replace operands are not strings");
+  }
+
+  if (string_size(pattern) == 0) {
+    return make_error("string-replace pattern is empty");
+  }
+
+  const char *chars = string_chars(obj);
+  const char *found = find(obj, pattern, 0);
+  if (!found) {
+    return share(obj);
+  }
+
+  /* The parts between the occurrences and the replacements are appended
+   * to a buffer that grows as needed */
+  string_data_t result = {malloc(string_size(obj) + 1), 0,
+                          string_size(obj) + 1, NULL, NULL};
+  const char *replacement_chars = string_chars(replacement);
+  size_t begin = 0;
+  while (found) {
+    size_t end = (size_t)(found - chars);
+    append_in_place(&result, chars + begin, end - begin);
+    append_in_place(&result, replacement_chars, string_size(replacement));
+    begin = end + string_size(pattern);
+    found = find(obj, pattern, begin);
+  }
+  append_in_place(&result, chars + begin, string_size(obj) - begin);
+
+  return new_flat_string(result.chars, result.length, result.capacity);
+}
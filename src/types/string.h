@@ -27,7 +27,12 @@
 #include "../utils/string.h"
 
 /**
- * String type is implemented as an array of characters.
+ * String values are arrays of characters with a stored length. Internally,
+ * the result of a concatenation may be a rope node that refers to the
+ * concatenated strings and is converted to an array of characters when it
+ * is first needed, so that building a long string from many parts takes
+ * linear time, and a substring may be a slice that shares the characters
+ * of the original string.
  */
 typedef char *string_t;
 
@@ -37,6 +42,12 @@ typedef char *string_t;
  */
 objectptr make_string(string_t value);
 
+/**
+ * Creates a string from the given number of characters, which do not
+ * need to be followed by a NUL character.
+ */
+objectptr make_string_n(const char *chars, size_t length);
+
 /**
  * String destructor.
  * Deallocates the internal storage allocated for the string value.
@@ -46,6 +57,9 @@ void destroy_string(objectptr val);
 /** Returns the quoted version of the stored string */
 char *string_tostring(objectptr val);
 
+/** Writes the quoted version of the stored string to a port */
+void string_print(objectptr val, output_port_ptr port);
+
 /**
  * Returns true if and only if given objects are both strings, they both
  * have the same length, and they have the same characters in the same
@@ -53,22 +67,65 @@ char *string_tostring(objectptr val);
  */
 bool string_equals(objectptr val, objectptr other);
 
+/** Hashes the characters of a string */
+bool string_hash(objectptr val, size_t *hash);
+
 /** Returns true if and only if the given object is a string */
 bool is_string(objectptr obj);
 
-/** Returns stored string (unquoted) */
+/**
+ * Returns stored string (unquoted). The characters of a concatenation or a
+ * slice are copied into a NUL terminated array by the first call.
+ */
 string_t string_value(objectptr obj);
 
+/**
+ * Returns the characters of the string without copying a slice. The
+ * characters are not necessarily followed by a NUL character, so
+ * string_size must be used to find where they end.
+ */
+const char *string_chars(objectptr obj);
+
+/** Returns the number of characters in the string */
+size_t string_size(objectptr obj);
+
 /** Returns string length */
 objectptr string_length(objectptr obj);
 
-/** Concatenates two strings */
+/**
+ * Concatenates two strings. Operands that are not strings are converted
+ * to their string representations. A short string is appended in place
+ * to a reusable first operand, other short results are copied, and long
+ * results refer to the operands without copying them.
+ */
 objectptr string_concat(objectptr first, objectptr second);
 
 /** Returns character at given index */
 objectptr string_charat(objectptr obj, size_t index);
 
-/** Returns substring */
+/**
+ * Returns the characters from begin up to but not including end. The
+ * substring shares the characters of the given string.
+ */
 objectptr string_substring(objectptr obj, size_t begin, size_t end);
 
+/**
+ * Returns the index of the first occurrence of pattern in the string,
+ * or -1 if there is none.
+ */
+objectptr string_index(objectptr obj, objectptr pattern);
+
+/** Returns true if pattern occurs in the string */
+objectptr string_contains(objectptr obj, objectptr pattern);
+
+/**
+ * Returns a list of the parts of the string that are separated by the
+ * given separator. The parts share the characters of the string.
+ */
+objectptr string_split(objectptr obj, objectptr separator);
+
+/** Replaces all occurrences of pattern in the string */
+objectptr string_replace(objectptr obj, objectptr pattern,
+                         objectptr replacement);
+
 #endif
@@ -0,0 +1,201 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "vector.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "../types/error.h"
+#include "../types/null.h"
+#include "../types/pair.h"
+#include "../types/void.h"
+#include "object-base.h"
+
+#define MIN_VECTOR_CAPACITY 4
+
+typedef struct {
+  objectptr *elements;
+  size_t length;
+  size_t capacity;
+} vector_t;
+
+static object_stats_t vector_stats;
+
+/* Vectors implement traverse but are never marked acyclic, since their
+ * elements can be changed to refer back to them */
+static const object_type_t vector_type_id = {{
+    .destroy = destroy_vector,
+    .equals = vector_equals,
+    .tostring = vector_tostring,
+    .print = vector_print,
+    .traverse = vector_traverse},
+    "vector", sizeof(vector_t), &vector_stats};
+
+bool is_vector(objectptr obj) {
+  return obj->type_id == &vector_type_id ||
+         strcmp(vector_type_id.type_name, obj->type_id->type_name) == 0;
+}
+
+static objectptr new_vector(size_t capacity) {
+  objectptr obj = object_base_new_inline(&vector_type_id);
+  vector_t *vec = obj->value;
+  vec->capacity = capacity < MIN_VECTOR_CAPACITY ? MIN_VECTOR_CAPACITY
+                                                 : capacity;
+  vec->elements = malloc(vec->capacity * sizeof(objectptr));
+  vec->length = 0;
+  return obj;
+}
+
+objectptr make_vector(size_t length, objectptr fill) {
+  objectptr obj = new_vector(length);
+  vector_t *vec = obj->value;
+  for (size_t i = 0; i < length; ++i) {
+    vec->elements[i] = clone_object(fill);
+  }
+  vec->length = length;
+  return obj;
+}
+
+void destroy_vector(objectptr obj) {
+  assert(is_vector(obj));
+  vector_t *vec = obj->value;
+  for (size_t i = 0; i < vec->length; ++i) {
+    delete_object(vec->elements[i]);
+  }
+  free(vec->elements);
+}
+
+char *vector_tostring(objectptr obj) {
+  return print_to_string(obj);
+}
+
+void vector_print(objectptr obj, output_port_ptr port) {
+  assert(is_vector(obj));
+  /* A vector inside itself is printed as ... */
+  if (!begin_print(obj)) {
+    port_puts(port, "...");
+    return;
+  }
+
+  vector_t *vec = obj->value;
+  port_puts(port, "(vector");
+  for (size_t i = 0; i < vec->length; ++i) {
+    port_putc(port, ' ');
+    object_print(vec->elements[i], port);
+  }
+  port_putc(port, ')');
+  end_print(obj);
+}
+
+bool vector_equals(objectptr obj, objectptr other) {
+  assert(is_vector(obj));
+  if (obj == other) {
+    return true;
+  }
+  if (!is_vector(other)) {
+    return false;
+  }
+
+  vector_t *vec = obj->value;
+  vector_t *other_vec = other->value;
+  if (vec->length != other_vec->length) {
+    return false;
+  }
+
+  /* Vectors that are reached again while they are compared are equal
+   * if the rest of their elements are */
+  if (!begin_equals(obj, other)) {
+    return true;
+  }
+
+  bool equal = true;
+  for (size_t i = 0; equal && i < vec->length; ++i) {
+    equal = object_equals(vec->elements[i], other_vec->elements[i]);
+  }
+  end_equals(obj, other);
+  return equal;
+}
+
+void vector_traverse(objectptr obj, object_visitor visit, void *context) {
+  assert(is_vector(obj));
+  vector_t *vec = obj->value;
+  for (size_t i = 0; i < vec->length; ++i) {
+    visit(vec->elements[i], context);
+  }
+}
+
+size_t vector_length(objectptr obj) {
+  assert(is_vector(obj));
+  return ((vector_t *)obj->value)->length;
+}
+
+objectptr vector_get(objectptr obj, size_t index) {
+  assert(is_vector(obj));
+  vector_t *vec = obj->value;
+  assert(index < vec->length);
+  return vec->elements[index];
+}
+
+objectptr vector_set(objectptr obj, size_t index, objectptr value) {
+  assert(is_vector(obj));
+  vector_t *vec = obj->value;
+  if (index >= vec->length) {
+    return make_error("Vector index %zu is out of bounds", index);
+  }
+
+  /* The new value is stored before the old one is deleted, since
+   * deleting it may delete the value */
+  objectptr old = vec->elements[index];
+  vec->elements[index] = clone_object(value);
+  delete_object(old);
+  return make_void();
+}
+
+void vector_push(objectptr obj, objectptr value) {
+  assert(is_vector(obj));
+  vector_t *vec = obj->value;
+  if (vec->length == vec->capacity) {
+    vec->capacity *= 2;
+    vec->elements = realloc(vec->elements, vec->capacity * sizeof(objectptr));
+  }
+  vec->elements[vec->length++] = clone_object(value);
+}
+
+objectptr vector_to_list(objectptr obj) {
+  assert(is_vector(obj));
+  vector_t *vec = obj->value;
+  objectptr list = make_null();
+  for (size_t i = vec->length; i != 0; --i) {
+    assign_object(&list, make_pair(vec->elements[i - 1], list));
+  }
+  return list;
+}
+
+objectptr list_to_vector(objectptr list) {
+  objectptr obj = new_vector(0);
+  for (objectptr next = list; !is_null(next); next = pair_second(next)) {
+    if (!is_pair(next)) {
+      delete_object(obj);
+      return make_error("Given object is not a proper list");
+    }
+    vector_push(obj, pair_first(next));
+  }
+  return obj;
+}
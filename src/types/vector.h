@@ -0,0 +1,85 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file vector.h
+
+/**
+ * Vectors are mutable arrays of objects that can be indexed in constant
+ * time and grow at their end. Unlike lists, they are shared rather than
+ * copied, so a change made through one reference is seen through all
+ * of them.
+ */
+
+#ifndef THEORYLISP_TYPES_VECTOR_H
+#define THEORYLISP_TYPES_VECTOR_H
+
+#include "object.h"
+
+/**
+ * Vector constructor.
+ * Creates a vector of the given length whose elements are fill.
+ */
+objectptr make_vector(size_t length, objectptr fill);
+
+/** Deletes the elements of the vector */
+void destroy_vector(objectptr obj);
+
+/** Returns the string representation of the form (vector [elements]) */
+char *vector_tostring(objectptr obj);
+
+void vector_print(objectptr obj, output_port_ptr port);
+
+/**
+ * Returns true if and only if other is a vector of the same length
+ * whose elements are equal to the elements of obj.
+ */
+bool vector_equals(objectptr obj, objectptr other);
+
+/** Calls visit for each element */
+void vector_traverse(objectptr obj, object_visitor visit, void *context);
+
+bool is_vector(objectptr obj);
+
+size_t vector_length(objectptr obj);
+
+/**
+ * Returns the element at the given index.
+ * The returned reference is borrowed from the vector.
+ */
+objectptr vector_get(objectptr obj, size_t index);
+
+/**
+ * Replaces the element at the given index with value. Returns an error
+ * object if the index is out of bounds, or void otherwise.
+ */
+objectptr vector_set(objectptr obj, size_t index, objectptr value);
+
+/** Appends value to the end of the vector in amortized constant time */
+void vector_push(objectptr obj, objectptr value);
+
+/** Returns a list that contains the elements of the vector */
+objectptr vector_to_list(objectptr obj);
+
+/**
+ * Returns a vector that contains the elements of the given list, or an
+ * error object if it is not a proper list.
+ */
+objectptr list_to_vector(objectptr list);
+
+#endif
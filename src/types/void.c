@@ -26,11 +26,14 @@
 #include "error.h"
 #include "../utils/string.h"
 
+static object_stats_t void_stats;
+
 static const object_type_t void_type_id = {{
     .destroy = destroy_void,
     .tostring = void_tostring,
-    .equals = void_equals},
-    "void"};
+    .equals = void_equals,
+    .hash = void_hash},
+    "void", 0, &void_stats};
 
 bool is_void(objectptr obj) {
   return strcmp(void_type_id.type_name, obj->type_id->type_name) == 0;
@@ -54,3 +57,9 @@ bool void_equals(objectptr self, objectptr other) {
   }
   return true;
 }
+
+bool void_hash(objectptr self, size_t *hash) {
+  assert(is_void(self));
+  *hash = 1;
+  return true;
+}
@@ -53,6 +53,11 @@ char *void_tostring(objectptr obj);
  */
 bool void_equals(objectptr obj, objectptr other);
 
+/**
+ * Hashes void (all instances of void type have the same hash)
+ */
+bool void_hash(objectptr obj, size_t *hash);
+
 /**
  * Checks whether the given object is of void type.
  */
@@ -0,0 +1,104 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "arena.h"
+
+#include <stddef.h>
+#include <string.h>
+
+typedef struct arena_block {
+  struct arena_block *next;
+  size_t capacity;
+  size_t used;
+  max_align_t data[];
+} arena_block;
+
+struct arena {
+  arena_block *blocks;
+};
+
+static const size_t default_block_size = 64 * 1024;
+
+static inline size_t align_size(size_t size) {
+  const size_t alignment = sizeof(max_align_t);
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static arena_block *new_arena_block(size_t capacity, arena_block *next) {
+  arena_block *block = malloc(sizeof *block + capacity);
+  block->next = next;
+  block->capacity = capacity;
+  block->used = 0;
+  return block;
+}
+
+/* arena "new" operator */
+arenaptr new_arena(void) {
+  arenaptr arena = malloc(sizeof *arena);
+  arena->blocks = NULL;
+  return arena;
+}
+
+/* arena "delete" operation */
+void delete_arena(arenaptr arena) {
+  arena_block *block = arena->blocks;
+  while (block) {
+    arena_block *next = block->next;
+    free(block);
+    block = next;
+  }
+  free(arena);
+}
+
+/* bumps the used part of the current block, starting a new block
+ * when the current one does not have enough room */
+void *arena_alloc(arenaptr arena, size_t size) {
+  size = align_size(size);
+
+  arena_block *block = arena->blocks;
+  if (!block || block->capacity - block->used < size) {
+    if (size > default_block_size / 4) {
+      /* Large requests get a block of their own that is placed behind
+       * the current block so that the remaining space is not wasted */
+      arena_block *large = new_arena_block(size, NULL);
+      if (block) {
+        large->next = block->next;
+        block->next = large;
+      } else {
+        arena->blocks = large;
+      }
+      large->used = size;
+      return large->data;
+    }
+
+    block = arena->blocks = new_arena_block(default_block_size, block);
+  }
+
+  void *ptr = (char *)block->data + block->used;
+  block->used += size;
+  return ptr;
+}
+
+/* copies a string of known length into the arena */
+char *arena_strndup(arenaptr arena, const char *str, size_t length) {
+  char *copy = arena_alloc(arena, length + 1);
+  memcpy(copy, str, length);
+  copy[length] = '\0';
+  return copy;
+}
@@ -0,0 +1,59 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file arena.h
+
+#ifndef THEORYLISP_UTILS_ARENA_H
+#define THEORYLISP_UTILS_ARENA_H
+
+#include <stdlib.h>
+
+/**
+ * \brief A bump allocator whose allocations are freed all at once.
+ *
+ * Memory is handed out from large blocks in the order it is requested,
+ * so objects allocated one after another are adjacent in memory.
+ * Individual allocations cannot be freed; delete_arena releases every
+ * block together. Pointers returned by arena_alloc stay valid until then.
+ */
+struct arena;
+typedef struct arena *arenaptr;
+
+/**
+ * Returns a malloc'ed and initialized arena.
+ */
+arenaptr new_arena(void);
+
+/**
+ * Frees all memory allocated from the arena together with the arena itself.
+ */
+void delete_arena(arenaptr arena);
+
+/**
+ * Returns a suitably aligned block of at least size bytes.
+ */
+void *arena_alloc(arenaptr arena, size_t size);
+
+/**
+ * Copies the first length characters of str into the arena and
+ * appends a terminating null character.
+ */
+char *arena_strndup(arenaptr arena, const char *str, size_t length);
+
+#endif
@@ -19,36 +19,83 @@
 
 #include "file.h"
 
+#include <fcntl.h>
 #include <stdio.h>
-#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-#include "init.h"
-
-#define MAX_FILENAME_SIZE 1024
 #define INITIAL_BUFFER_LENGTH 10000
 
-char *read_file(char *filename) {
-  FILE *file = fopen(filename, "r");
-  if (file == NULL) {
+/* reads everything from the given descriptor into a heap buffer,
+ * leaving space for a terminating null character */
+static char *read_descriptor(int fd, size_t *length) {
+  size_t capacity = INITIAL_BUFFER_LENGTH;
+  char *buffer = malloc(capacity);
+  *length = 0;
+
+  ssize_t count = 0;
+  while ((count = read(fd, buffer + *length, capacity - *length - 1)) != 0) {
+    if (count < 0) {
+      free(buffer);
+      return NULL;
+    }
+
+    *length += count;
+    if (*length == capacity - 1) {
+      capacity *= 2;
+      buffer = realloc(buffer, capacity);
+    }
+  }
+
+  return buffer;
+}
+
+mapped_file_ptr map_file(const char *filename) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
     return NULL;
   }
 
-  size_t capacity = INITIAL_BUFFER_LENGTH;
-  char *code = malloc(capacity);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || S_ISDIR(st.st_mode)) {
+    close(fd);
+    return NULL;
+  }
 
-  int c = 0;
-  size_t length = 0;
-  while ((c = fgetc(file)) != EOF) {
-    code[length++] = c;
+  mapped_file_ptr file = malloc(sizeof *file);
 
-    if (length == capacity) {
-      capacity *= 2;
-      code = realloc(code, capacity);
+  /* Empty files cannot be mapped, and special files may not support it */
+  if (S_ISREG(st.st_mode) && st.st_size > 0) {
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      madvise(data, st.st_size, MADV_SEQUENTIAL);
+      close(fd);
+      file->data = data;
+      file->length = st.st_size;
+      file->mapped = true;
+      return file;
     }
   }
 
-  code[length] = '\0';
+  char *data = read_descriptor(fd, &file->length);
+  close(fd);
+  if (!data) {
+    free(file);
+    return NULL;
+  }
 
-  fclose(file);
-  return code;
+  file->data = data;
+  file->mapped = false;
+  return file;
+}
+
+void unmap_file(mapped_file_ptr file) {
+  if (file->mapped) {
+    munmap((void *)file->data, file->length);
+  } else {
+    free((void *)file->data);
+  }
+  free(file);
 }
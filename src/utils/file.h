@@ -22,6 +22,35 @@
 #ifndef THEORYLISP_UTILS_FILE_H
 #define THEORYLISP_UTILS_FILE_H
 
-char *read_file(char *filename);
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * \brief Read-only contents of a file.
+ *
+ * Regular files are mapped into memory, other files (such as pipes)
+ * are read into a heap buffer. The data is not null terminated.
+ */
+typedef struct mapped_file {
+  /// Contents of the file
+  const char *data;
+  /// Number of bytes in data
+  size_t length;
+  /// Whether data is a memory mapping or a malloc'ed buffer
+  bool mapped;
+} mapped_file_t;
+
+typedef mapped_file_t *mapped_file_ptr;
+
+/**
+ * Returns the contents of the file with the given name,
+ * or NULL if the file cannot be read.
+ */
+mapped_file_ptr map_file(const char *filename);
+
+/**
+ * Releases the memory that holds the contents of the file.
+ */
+void unmap_file(mapped_file_ptr file);
 
 #endif
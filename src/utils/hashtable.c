@@ -151,3 +151,15 @@ void *hash_table_get(hashtableptr table, const char *key) {
 
   return NULL;
 }
+
+void hash_table_foreach(hashtableptr table, hash_table_visitor visit, void *context) {
+  for (size_t i = 0; i < table->capacity; ++i) {
+    listptr lst = table->data[i];
+    if (lst != NULL) {
+      for (size_t j = 0; j < list_size(lst); ++j) {
+        hashtable_pair_t *pair = list_get(lst, j);
+        visit(pair->key, pair->value, context);
+      }
+    }
+  }
+}
@@ -37,4 +37,8 @@ void *hash_table_put(hashtableptr table, const char *key, void *value);
 
 void *hash_table_get(hashtableptr table, const char *key);
 
+typedef void (*hash_table_visitor)(const char *key, void *value, void *context);
+
+void hash_table_foreach(hashtableptr table, hash_table_visitor visit, void *context);
+
 #endif
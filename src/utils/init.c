@@ -24,6 +24,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "port.h"
+
 void print_usage_and_exit(char *program_name) {
   printf("Theory Lisp\n");
   printf("Usage: %s [options] filename\n", program_name);
@@ -31,10 +33,23 @@ void print_usage_and_exit(char *program_name) {
   printf("-v verbose output\n");
   printf("-q quiet output (do not print each expression result)\n");
   printf("-x exit after executing file (no read-evaluate-print loop)\n");
+  printf("-s parse and execute the file one expression at a time\n");
+  printf("-O optimize the program before executing it\n");
+  printf("-j compile frequently called lambdas\n");
+  printf("-J compile frequently called lambdas and check the results "
+         "against the interpreter\n");
+  printf("--emit-c translate the program to C and print it instead of "
+         "executing it\n");
+  printf("--stats print allocation statistics to stderr when the program "
+         "exits\n");
+  printf("--deferred-free free unused objects a few at a time during later "
+         "allocations\n");
   exit(0);
 }
 
 void print_error_and_exit(int exit_code, char *fmt, ...) {
+  flush_standard_output();
+
   va_list args;
   va_start(args, fmt);
   vfprintf(stderr, fmt, args);
@@ -48,6 +63,21 @@ void parse_arg(char *arg, program_arguments *args, char *program_name) {
       print_usage_and_exit(program_name);
     }
 
+    if (strcmp(&arg[1], "-emit-c") == 0) {
+      args->emit_c = true;
+      return;
+    }
+
+    if (strcmp(&arg[1], "-stats") == 0) {
+      args->stats = true;
+      return;
+    }
+
+    if (strcmp(&arg[1], "-deferred-free") == 0) {
+      args->deferred_free = true;
+      return;
+    }
+
     bool known_arg = false;
     if (strchr(&arg[1], 'v')) {
       args->verbose = true;
@@ -61,6 +91,22 @@ void parse_arg(char *arg, program_arguments *args, char *program_name) {
       args->exit = true;
       known_arg = true;
     }
+    if (strchr(&arg[1], 's')) {
+      args->stream = true;
+      known_arg = true;
+    }
+    if (strchr(&arg[1], 'O')) {
+      args->optimize = true;
+      known_arg = true;
+    }
+    if (strchr(&arg[1], 'j')) {
+      args->jit = true;
+      known_arg = true;
+    }
+    if (strchr(&arg[1], 'J')) {
+      args->jit_check = true;
+      known_arg = true;
+    }
 
     if (!known_arg) {
       print_error_and_exit(1, "Unknown option: %s\n", arg);
@@ -79,6 +125,13 @@ void parse_args(int argc, char **argv, program_arguments *args) {
   args->verbose = false;
   args->quiet = false;
   args->exit = false;
+  args->stream = false;
+  args->optimize = false;
+  args->jit = false;
+  args->jit_check = false;
+  args->emit_c = false;
+  args->stats = false;
+  args->deferred_free = false;
 
   for (int i = 1; i < argc; ++i) {
     char *arg = *(++argv);
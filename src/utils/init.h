@@ -28,6 +28,13 @@ typedef struct {
   bool verbose;
   bool quiet;
   bool exit;
+  bool stream;
+  bool optimize;
+  bool jit;
+  bool jit_check;
+  bool emit_c;
+  bool stats;
+  bool deferred_free;
   char *filename;
 } program_arguments;
 
@@ -0,0 +1,466 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "kernels.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* The loops over longs use SSE2 only if long has 64 bits */
+#if defined(__SSE2__) && LONG_MAX == INT64_MAX
+#define I64_SSE2
+#endif
+
+static inline double f64_add(double x, double y) { return x + y; }
+static inline double f64_sub(double x, double y) { return x - y; }
+static inline double f64_mul(double x, double y) { return x * y; }
+static inline double f64_div(double x, double y) { return x / y; }
+
+/* Operations on longs are done on unsigned longs so that they wrap
+ * around instead of overflowing */
+static inline long i64_add(long x, long y) {
+  return (long)((unsigned long)x + (unsigned long)y);
+}
+
+static inline long i64_sub(long x, long y) {
+  return (long)((unsigned long)x - (unsigned long)y);
+}
+
+static inline long i64_mul(long x, long y) {
+  return (long)((unsigned long)x * (unsigned long)y);
+}
+
+/* Each of the following macros expands to the loop of a single operation,
+ * so that the operation is not selected again for every element. The
+ * vector forms handle two elements at once, and the scalar forms handle
+ * the remaining elements. */
+
+#ifdef __SSE2__
+#define F64_ELEMENTWISE(vector_op, scalar_op)                               \
+  do {                                                                      \
+    size_t i = 0;                                                           \
+    for (; i + 2 <= n; i += 2) {                                            \
+      _mm_storeu_pd(out + i,                                                \
+                    vector_op(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));   \
+    }                                                                       \
+    for (; i < n; ++i) {                                                    \
+      out[i] = scalar_op(a[i], b[i]);                                       \
+    }                                                                       \
+  } while (0)
+
+#define F64_BROADCAST(vector_op, scalar_op)                                 \
+  do {                                                                      \
+    const __m128d scalar = _mm_set1_pd(b);                                  \
+    size_t i = 0;                                                           \
+    if (reversed) {                                                         \
+      for (; i + 2 <= n; i += 2) {                                          \
+        _mm_storeu_pd(out + i, vector_op(scalar, _mm_loadu_pd(a + i)));     \
+      }                                                                     \
+      for (; i < n; ++i) {                                                  \
+        out[i] = scalar_op(b, a[i]);                                        \
+      }                                                                     \
+    } else {                                                                \
+      for (; i + 2 <= n; i += 2) {                                          \
+        _mm_storeu_pd(out + i, vector_op(_mm_loadu_pd(a + i), scalar));     \
+      }                                                                     \
+      for (; i < n; ++i) {                                                  \
+        out[i] = scalar_op(a[i], b);                                        \
+      }                                                                     \
+    }                                                                       \
+  } while (0)
+#else
+#define F64_ELEMENTWISE(vector_op, scalar_op)                               \
+  do {                                                                      \
+    for (size_t i = 0; i < n; ++i) {                                        \
+      out[i] = scalar_op(a[i], b[i]);                                       \
+    }                                                                       \
+  } while (0)
+
+#define F64_BROADCAST(vector_op, scalar_op)                                 \
+  do {                                                                      \
+    for (size_t i = 0; i < n; ++i) {                                        \
+      out[i] = reversed ? scalar_op(b, a[i]) : scalar_op(a[i], b);          \
+    }                                                                       \
+  } while (0)
+#endif
+
+#ifdef I64_SSE2
+#define I64_ELEMENTWISE(vector_op, scalar_op)                               \
+  do {                                                                      \
+    size_t i = 0;                                                           \
+    for (; i + 2 <= n; i += 2) {                                            \
+      __m128i x = _mm_loadu_si128((const __m128i *)(a + i));                \
+      __m128i y = _mm_loadu_si128((const __m128i *)(b + i));                \
+      _mm_storeu_si128((__m128i *)(out + i), vector_op(x, y));              \
+    }                                                                       \
+    for (; i < n; ++i) {                                                    \
+      out[i] = scalar_op(a[i], b[i]);                                       \
+    }                                                                       \
+  } while (0)
+
+#define I64_BROADCAST(vector_op, scalar_op)                                 \
+  do {                                                                      \
+    const __m128i scalar = _mm_set1_epi64x(b);                              \
+    size_t i = 0;                                                           \
+    for (; i + 2 <= n; i += 2) {                                            \
+      __m128i x = _mm_loadu_si128((const __m128i *)(a + i));                \
+      _mm_storeu_si128((__m128i *)(out + i), reversed                       \
+                                                 ? vector_op(scalar, x)     \
+                                                 : vector_op(x, scalar));   \
+    }                                                                       \
+    for (; i < n; ++i) {                                                    \
+      out[i] = reversed ? scalar_op(b, a[i]) : scalar_op(a[i], b);          \
+    }                                                                       \
+  } while (0)
+#else
+#define I64_ELEMENTWISE(vector_op, scalar_op)                               \
+  do {                                                                      \
+    for (size_t i = 0; i < n; ++i) {                                        \
+      out[i] = scalar_op(a[i], b[i]);                                       \
+    }                                                                       \
+  } while (0)
+
+#define I64_BROADCAST(vector_op, scalar_op)                                 \
+  do {                                                                      \
+    for (size_t i = 0; i < n; ++i) {                                        \
+      out[i] = reversed ? scalar_op(b, a[i]) : scalar_op(a[i], b);          \
+    }                                                                       \
+  } while (0)
+#endif
+
+void f64_elementwise(kernel_op_t op, double *out, const double *a,
+                     const double *b, size_t n) {
+  switch (op) {
+    case KERNEL_ADD:
+      F64_ELEMENTWISE(_mm_add_pd, f64_add);
+      break;
+    case KERNEL_SUB:
+      F64_ELEMENTWISE(_mm_sub_pd, f64_sub);
+      break;
+    case KERNEL_MUL:
+      F64_ELEMENTWISE(_mm_mul_pd, f64_mul);
+      break;
+    case KERNEL_DIV:
+      F64_ELEMENTWISE(_mm_div_pd, f64_div);
+      break;
+  }
+}
+
+void f64_broadcast(kernel_op_t op, double *out, const double *a, double b,
+                   bool reversed, size_t n) {
+  switch (op) {
+    case KERNEL_ADD:
+      F64_BROADCAST(_mm_add_pd, f64_add);
+      break;
+    case KERNEL_SUB:
+      F64_BROADCAST(_mm_sub_pd, f64_sub);
+      break;
+    case KERNEL_MUL:
+      F64_BROADCAST(_mm_mul_pd, f64_mul);
+      break;
+    case KERNEL_DIV:
+      F64_BROADCAST(_mm_div_pd, f64_div);
+      break;
+  }
+}
+
+void f64_sqrt(double *out, const double *a, size_t n) {
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(out + i, _mm_sqrt_pd(_mm_loadu_pd(a + i)));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = sqrt(a[i]);
+  }
+}
+
+void f64_map(double (*function)(double), double *out, const double *a,
+             size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = function(a[i]);
+  }
+}
+
+double f64_sum(const double *a, size_t n) {
+  double sum = 0;
+  size_t i = 0;
+#ifdef __SSE2__
+  /* Two accumulators are used so that an addition does not have to wait
+   * for the previous one to finish */
+  __m128d first = _mm_setzero_pd();
+  __m128d second = _mm_setzero_pd();
+  for (; i + 4 <= n; i += 4) {
+    first = _mm_add_pd(first, _mm_loadu_pd(a + i));
+    second = _mm_add_pd(second, _mm_loadu_pd(a + i + 2));
+  }
+  first = _mm_add_pd(first, second);
+  sum = _mm_cvtsd_f64(first) + _mm_cvtsd_f64(_mm_unpackhi_pd(first, first));
+#endif
+  for (; i < n; ++i) {
+    sum += a[i];
+  }
+  return sum;
+}
+
+double f64_dot(const double *a, const double *b, size_t n) {
+  double sum = 0;
+  size_t i = 0;
+#ifdef __SSE2__
+  __m128d first = _mm_setzero_pd();
+  __m128d second = _mm_setzero_pd();
+  for (; i + 4 <= n; i += 4) {
+    first = _mm_add_pd(
+        first, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    second = _mm_add_pd(
+        second, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+  }
+  first = _mm_add_pd(first, second);
+  sum = _mm_cvtsd_f64(first) + _mm_cvtsd_f64(_mm_unpackhi_pd(first, first));
+#endif
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+#ifdef __SSE2__
+/* Returns the first NaN among the first n elements, which must
+ * contain one */
+static double first_nan(const double *a, size_t n) {
+  size_t i = 0;
+  while (i + 1 < n && !isnan(a[i])) {
+    ++i;
+  }
+  return a[i];
+}
+#endif
+
+/* The minimum and the maximum are NaN if any element is NaN. The first
+ * NaN is returned, so the result does not depend on the vector loop. */
+double f64_min(const double *a, size_t n) {
+  assert(n > 0);
+  if (isnan(a[0])) {
+    return a[0];
+  }
+
+  double min = a[0];
+  size_t i = 1;
+#ifdef __SSE2__
+  if (n >= 2) {
+    __m128d lanes = _mm_loadu_pd(a);
+    __m128d unordered = _mm_cmpunord_pd(lanes, lanes);
+    for (i = 2; i + 2 <= n; i += 2) {
+      __m128d next = _mm_loadu_pd(a + i);
+      unordered = _mm_or_pd(unordered, _mm_cmpunord_pd(next, next));
+      lanes = _mm_min_pd(lanes, next);
+    }
+    if (_mm_movemask_pd(unordered)) {
+      return first_nan(a, i);
+    }
+    lanes = _mm_min_sd(lanes, _mm_unpackhi_pd(lanes, lanes));
+    min = _mm_cvtsd_f64(lanes);
+  }
+#endif
+  for (; i < n; ++i) {
+    if (isnan(a[i])) {
+      return a[i];
+    }
+    min = a[i] < min ? a[i] : min;
+  }
+  return min;
+}
+
+double f64_max(const double *a, size_t n) {
+  assert(n > 0);
+  if (isnan(a[0])) {
+    return a[0];
+  }
+
+  double max = a[0];
+  size_t i = 1;
+#ifdef __SSE2__
+  if (n >= 2) {
+    __m128d lanes = _mm_loadu_pd(a);
+    __m128d unordered = _mm_cmpunord_pd(lanes, lanes);
+    for (i = 2; i + 2 <= n; i += 2) {
+      __m128d next = _mm_loadu_pd(a + i);
+      unordered = _mm_or_pd(unordered, _mm_cmpunord_pd(next, next));
+      lanes = _mm_max_pd(lanes, next);
+    }
+    if (_mm_movemask_pd(unordered)) {
+      return first_nan(a, i);
+    }
+    lanes = _mm_max_sd(lanes, _mm_unpackhi_pd(lanes, lanes));
+    max = _mm_cvtsd_f64(lanes);
+  }
+#endif
+  for (; i < n; ++i) {
+    if (isnan(a[i])) {
+      return a[i];
+    }
+    max = a[i] > max ? a[i] : max;
+  }
+  return max;
+}
+
+void f64_prefix_sum(double *out, const double *a, size_t n) {
+  double sum = 0;
+  size_t i = 0;
+#ifdef __SSE2__
+  /* Each pair (x, y) becomes (x, x + y), and the sum of the previous
+   * elements is added to both of them */
+  __m128d carry = _mm_setzero_pd();
+  for (; i + 2 <= n; i += 2) {
+    __m128d pair = _mm_loadu_pd(a + i);
+    __m128d shifted = _mm_unpacklo_pd(_mm_setzero_pd(), pair);
+    pair = _mm_add_pd(_mm_add_pd(pair, shifted), carry);
+    _mm_storeu_pd(out + i, pair);
+    carry = _mm_unpackhi_pd(pair, pair);
+  }
+  sum = _mm_cvtsd_f64(carry);
+#endif
+  for (; i < n; ++i) {
+    sum += a[i];
+    out[i] = sum;
+  }
+}
+
+void i64_elementwise(kernel_op_t op, long *out, const long *a, const long *b,
+                     size_t n) {
+  switch (op) {
+    case KERNEL_ADD:
+      I64_ELEMENTWISE(_mm_add_epi64, i64_add);
+      break;
+    case KERNEL_SUB:
+      I64_ELEMENTWISE(_mm_sub_epi64, i64_sub);
+      break;
+    case KERNEL_MUL:
+      /* SSE2 cannot multiply 64 bit integers */
+      for (size_t i = 0; i < n; ++i) {
+        out[i] = i64_mul(a[i], b[i]);
+      }
+      break;
+    case KERNEL_DIV:
+      assert(false);
+      break;
+  }
+}
+
+void i64_broadcast(kernel_op_t op, long *out, const long *a, long b,
+                   bool reversed, size_t n) {
+  switch (op) {
+    case KERNEL_ADD:
+      I64_BROADCAST(_mm_add_epi64, i64_add);
+      break;
+    case KERNEL_SUB:
+      I64_BROADCAST(_mm_sub_epi64, i64_sub);
+      break;
+    case KERNEL_MUL:
+      for (size_t i = 0; i < n; ++i) {
+        out[i] = i64_mul(a[i], b);
+      }
+      break;
+    case KERNEL_DIV:
+      assert(false);
+      break;
+  }
+}
+
+void i64_to_f64(double *out, const long *a, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = (double)a[i];
+  }
+}
+
+long i64_sum(const long *a, size_t n) {
+  long sum = 0;
+  size_t i = 0;
+#ifdef I64_SSE2
+  __m128i lanes = _mm_setzero_si128();
+  for (; i + 2 <= n; i += 2) {
+    lanes = _mm_add_epi64(lanes, _mm_loadu_si128((const __m128i *)(a + i)));
+  }
+  long parts[2];
+  _mm_storeu_si128((__m128i *)parts, lanes);
+  sum = i64_add(parts[0], parts[1]);
+#endif
+  for (; i < n; ++i) {
+    sum = i64_add(sum, a[i]);
+  }
+  return sum;
+}
+
+long i64_dot(const long *a, const long *b, size_t n) {
+  long sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum = i64_add(sum, i64_mul(a[i], b[i]));
+  }
+  return sum;
+}
+
+/* SSE2 cannot compare 64 bit integers, so the minimum and the maximum of
+ * longs are found one element at a time */
+
+long i64_min(const long *a, size_t n) {
+  assert(n > 0);
+  long min = a[0];
+  for (size_t i = 1; i < n; ++i) {
+    min = a[i] < min ? a[i] : min;
+  }
+  return min;
+}
+
+long i64_max(const long *a, size_t n) {
+  assert(n > 0);
+  long max = a[0];
+  for (size_t i = 1; i < n; ++i) {
+    max = a[i] > max ? a[i] : max;
+  }
+  return max;
+}
+
+void i64_prefix_sum(long *out, const long *a, size_t n) {
+  long sum = 0;
+  size_t i = 0;
+#ifdef I64_SSE2
+  __m128i carry = _mm_setzero_si128();
+  for (; i + 2 <= n; i += 2) {
+    __m128i pair = _mm_loadu_si128((const __m128i *)(a + i));
+    pair = _mm_add_epi64(pair, _mm_slli_si128(pair, 8));
+    pair = _mm_add_epi64(pair, carry);
+    _mm_storeu_si128((__m128i *)(out + i), pair);
+    carry = _mm_unpackhi_epi64(pair, pair);
+  }
+  long parts[2];
+  _mm_storeu_si128((__m128i *)parts, carry);
+  sum = parts[0];
+#endif
+  for (; i < n; ++i) {
+    sum = i64_add(sum, a[i]);
+    out[i] = sum;
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file kernels.h
+
+/**
+ * Loops over arrays of doubles and longs that are used by the numeric
+ * vector types. They use SSE2 when the compiler targets it, and plain
+ * loops otherwise.
+ *
+ * Sums, dot products and prefix sums of doubles are computed in several
+ * lanes at once, so their results may differ in the last bits from adding
+ * the elements one by one. Arithmetic on longs wraps around on overflow.
+ */
+
+#ifndef THEORYLISP_UTILS_KERNELS_H
+#define THEORYLISP_UTILS_KERNELS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum { KERNEL_ADD, KERNEL_SUB, KERNEL_MUL, KERNEL_DIV } kernel_op_t;
+
+/**
+ * Computes out[i] = a[i] op b[i]. out may be the same array as a or b.
+ */
+void f64_elementwise(kernel_op_t op, double *out, const double *a,
+                     const double *b, size_t n);
+
+/**
+ * Computes out[i] = a[i] op b, or out[i] = b op a[i] if reversed is true.
+ * out may be the same array as a.
+ */
+void f64_broadcast(kernel_op_t op, double *out, const double *a, double b,
+                   bool reversed, size_t n);
+
+void f64_sqrt(double *out, const double *a, size_t n);
+
+/** Applies function to each element */
+void f64_map(double (*function)(double), double *out, const double *a,
+             size_t n);
+
+double f64_sum(const double *a, size_t n);
+
+double f64_dot(const double *a, const double *b, size_t n);
+
+/** Returns the smallest element. n must be positive. */
+double f64_min(const double *a, size_t n);
+
+/** Returns the largest element. n must be positive. */
+double f64_max(const double *a, size_t n);
+
+/** Computes out[i] = a[0] + ... + a[i]. out may be the same array as a. */
+void f64_prefix_sum(double *out, const double *a, size_t n);
+
+/** Same as f64_elementwise. Division is not supported. */
+void i64_elementwise(kernel_op_t op, long *out, const long *a, const long *b,
+                     size_t n);
+
+/** Same as f64_broadcast. Division is not supported. */
+void i64_broadcast(kernel_op_t op, long *out, const long *a, long b,
+                   bool reversed, size_t n);
+
+/** Converts each element to double */
+void i64_to_f64(double *out, const long *a, size_t n);
+
+long i64_sum(const long *a, size_t n);
+
+long i64_dot(const long *a, const long *b, size_t n);
+
+long i64_min(const long *a, size_t n);
+
+long i64_max(const long *a, size_t n);
+
+void i64_prefix_sum(long *out, const long *a, size_t n);
+
+#endif
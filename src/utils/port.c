@@ -0,0 +1,199 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "port.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_STRING_PORT_CAPACITY 64
+
+struct output_port {
+  /// NULL for string ports
+  FILE *file;
+  char *buffer;
+  size_t length;
+  size_t capacity;
+  flush_policy_t policy;
+  bool failed;
+};
+
+static output_port_ptr stdout_port = NULL;
+
+output_port_ptr new_output_port(FILE *file, size_t capacity,
+                                flush_policy_t policy) {
+  assert(capacity > 0);
+  output_port_ptr port = malloc(sizeof *port);
+  port->file = file;
+  port->buffer = malloc(capacity);
+  port->length = 0;
+  port->capacity = capacity;
+  port->policy = policy;
+  port->failed = false;
+  return port;
+}
+
+output_port_ptr new_string_port(void) {
+  return new_output_port(NULL, DEFAULT_STRING_PORT_CAPACITY, FLUSH_WHEN_FULL);
+}
+
+void delete_output_port(output_port_ptr port) {
+  port_flush(port);
+  free(port->buffer);
+  free(port);
+}
+
+char *port_take_string(output_port_ptr port) {
+  assert(!port->file);
+  port_putc(port, '\0');
+  char *result = port->buffer;
+  free(port);
+  return result;
+}
+
+bool port_failed(output_port_ptr port) {
+  return port->failed;
+}
+
+/* Writes characters to the file of the port and remembers failures */
+static bool write_to_file(output_port_ptr port, const char *chars,
+                          size_t length) {
+  if (fwrite(chars, 1, length, port->file) != length) {
+    port->failed = true;
+  }
+
+  return !port->failed;
+}
+
+bool port_flush(output_port_ptr port) {
+  if (!port->file) {
+    return !port->failed;
+  }
+
+  if (port->length > 0) {
+    write_to_file(port, port->buffer, port->length);
+    port->length = 0;
+  }
+
+  if (fflush(port->file) != 0) {
+    port->failed = true;
+  }
+
+  return !port->failed;
+}
+
+/* Makes room for the given number of characters. String ports grow,
+ * and other ports are flushed. Returns false if the characters must be
+ * written to the file directly since they do not fit into the buffer. */
+static bool reserve(output_port_ptr port, size_t length) {
+  if (port->length + length <= port->capacity) {
+    return true;
+  }
+
+  if (!port->file) {
+    while (port->length + length > port->capacity) {
+      port->capacity *= 2;
+    }
+    port->buffer = realloc(port->buffer, port->capacity);
+    return true;
+  }
+
+  port_flush(port);
+  return length <= port->capacity;
+}
+
+bool port_write(output_port_ptr port, const char *chars, size_t length) {
+  if (!reserve(port, length)) {
+    write_to_file(port, chars, length);
+    return port_flush(port);
+  }
+
+  memcpy(port->buffer + port->length, chars, length);
+  port->length += length;
+
+  if (port->policy == FLUSH_ON_NEWLINE && memchr(chars, '\n', length)) {
+    return port_flush(port);
+  }
+
+  return !port->failed;
+}
+
+bool port_puts(output_port_ptr port, const char *str) {
+  return port_write(port, str, strlen(str));
+}
+
+bool port_putc(output_port_ptr port, char c) {
+  reserve(port, 1);
+  port->buffer[port->length++] = c;
+  if (port->policy == FLUSH_ON_NEWLINE && c == '\n') {
+    return port_flush(port);
+  }
+
+  return !port->failed;
+}
+
+bool port_printf(output_port_ptr port, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  size_t available = port->capacity - port->length;
+  int length = vsnprintf(port->buffer + port->length, available, fmt, args);
+  va_end(args);
+  if (length < 0) {
+    port->failed = true;
+    return false;
+  }
+
+  if ((size_t)length < available) {
+    /* Formatted in place. The newline policy is applied afterwards. */
+    const char *chars = port->buffer + port->length;
+    port->length += length;
+    if (port->policy == FLUSH_ON_NEWLINE && memchr(chars, '\n', length)) {
+      return port_flush(port);
+    }
+    return !port->failed;
+  }
+
+  /* The output did not fit into the rest of the buffer */
+  char *str = malloc(length + 1);
+  va_start(args, fmt);
+  vsnprintf(str, length + 1, fmt, args);
+  va_end(args);
+  bool success = port_write(port, str, length);
+  free(str);
+  return success;
+}
+
+output_port_ptr standard_output(void) {
+  if (!stdout_port) {
+    flush_policy_t policy =
+        isatty(STDOUT_FILENO) ? FLUSH_ON_NEWLINE : FLUSH_WHEN_FULL;
+    stdout_port = new_output_port(stdout, DEFAULT_PORT_CAPACITY, policy);
+    atexit(flush_standard_output);
+  }
+
+  return stdout_port;
+}
+
+void flush_standard_output(void) {
+  if (stdout_port) {
+    port_flush(stdout_port);
+  }
+}
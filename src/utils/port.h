@@ -0,0 +1,82 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file port.h
+
+#ifndef THEORYLISP_UTILS_PORT_H
+#define THEORYLISP_UTILS_PORT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEFAULT_PORT_CAPACITY 65536
+
+/* When the buffered characters of an output port are written out */
+typedef enum {
+  /// when the buffer is full, when flushed explicitly and at exit
+  FLUSH_WHEN_FULL,
+  /// additionally after each newline, which is used for terminals
+  FLUSH_ON_NEWLINE
+} flush_policy_t;
+
+struct output_port;
+typedef struct output_port *output_port_ptr;
+
+output_port_ptr new_output_port(FILE *file, size_t capacity,
+                                flush_policy_t policy);
+
+/* Creates a port that collects its output in a growing buffer instead
+ * of writing it to a file */
+output_port_ptr new_string_port(void);
+
+/* Flushes the port and deletes it. The file is not closed. */
+void delete_output_port(output_port_ptr port);
+
+/* Deletes a string port and returns what has been written to it as a
+ * NUL-terminated string, which must be freed by the caller */
+char *port_take_string(output_port_ptr port);
+
+/* Returns true if any write to the file of the port has failed */
+bool port_failed(output_port_ptr port);
+
+/* Appends characters to the buffer of the port. Returns false if
+ * writing to the file failed. */
+bool port_write(output_port_ptr port, const char *chars, size_t length);
+
+bool port_puts(output_port_ptr port, const char *str);
+
+bool port_putc(output_port_ptr port, char c);
+
+/* Formats directly into the buffer of the port */
+bool port_printf(output_port_ptr port, const char *fmt, ...);
+
+/* Writes buffered characters to the file */
+bool port_flush(output_port_ptr port);
+
+/* The port that writes to stdout. It flushes on newlines if stdout is
+ * a terminal, and is flushed when the program exits. */
+output_port_ptr standard_output(void);
+
+/* Flushes the standard output port if it is created. Must be called
+ * before anything else writes to stdout, or before the program waits
+ * for input. */
+void flush_standard_output(void);
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "slab.h"
+
+#include <stddef.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define SLAB_USE_MALLOC
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SLAB_USE_MALLOC
+#endif
+#endif
+
+#define SLAB_CLASSES (SLAB_MAX_SIZE / SLAB_GRANULARITY)
+#define SLAB_SIZE (64 * 1024)
+
+typedef struct free_block {
+  struct free_block *next;
+} free_block;
+
+typedef struct slab {
+  struct slab *next;
+  max_align_t data[];
+} slab;
+
+typedef struct {
+  /// Blocks that were freed
+  free_block *free_list;
+  /// Part of the newest slab that has not been handed out yet
+  char *unused;
+  size_t unused_size;
+  size_t allocated;
+  size_t freed;
+  size_t slabs;
+} size_class;
+
+static _Thread_local size_class classes[SLAB_CLASSES];
+
+/* All slabs of the thread, so that they stay reachable */
+static _Thread_local slab *slabs;
+
+static inline size_t class_index(size_t size) {
+  return size == 0 ? 0 : (size - 1) / SLAB_GRANULARITY;
+}
+
+static inline size_t class_size(size_t index) {
+  return (index + 1) * SLAB_GRANULARITY;
+}
+
+#ifndef SLAB_USE_MALLOC
+/* Starts a new slab for the given size class */
+static void refill(size_class *c) {
+  slab *s = malloc(sizeof *s + SLAB_SIZE);
+  s->next = slabs;
+  slabs = s;
+
+  c->unused = (char *)s->data;
+  c->unused_size = SLAB_SIZE;
+  ++c->slabs;
+}
+#endif
+
+void *slab_alloc(size_t size) {
+  if (size > SLAB_MAX_SIZE) {
+    return malloc(size);
+  }
+
+  size_t index = class_index(size);
+  size_class *c = &classes[index];
+  ++c->allocated;
+
+#ifdef SLAB_USE_MALLOC
+  return malloc(class_size(index));
+#else
+  free_block *block = c->free_list;
+  if (block) {
+    c->free_list = block->next;
+    return block;
+  }
+
+  size_t block_size = class_size(index);
+  if (c->unused_size < block_size) {
+    refill(c);
+  }
+
+  void *ptr = c->unused;
+  c->unused += block_size;
+  c->unused_size -= block_size;
+  return ptr;
+#endif
+}
+
+void slab_free(void *ptr, size_t size) {
+  if (size > SLAB_MAX_SIZE) {
+    free(ptr);
+    return;
+  }
+
+  size_class *c = &classes[class_index(size)];
+  ++c->freed;
+
+#ifdef SLAB_USE_MALLOC
+  free(ptr);
+#else
+  free_block *block = ptr;
+  block->next = c->free_list;
+  c->free_list = block;
+#endif
+}
+
+void print_slab_stats(FILE *file) {
+  for (size_t i = 0; i < SLAB_CLASSES; ++i) {
+    size_class *c = &classes[i];
+    if (c->allocated == 0) {
+      continue;
+    }
+
+    fprintf(file, "  %4zu bytes: %zu allocated, %zu freed, %zu slabs\n",
+            class_size(i), c->allocated, c->freed, c->slabs);
+  }
+}
@@ -0,0 +1,65 @@
+/*
+ *
+ * Copyright 2023 Doğu Kocatepe
+ * This file is part of Theory Lisp.
+
+ * Theory Lisp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Theory Lisp is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with Theory Lisp. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// @file slab.h
+
+#ifndef THEORYLISP_UTILS_SLAB_H
+#define THEORYLISP_UTILS_SLAB_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * \brief Size class allocator for small structures of fixed size.
+ *
+ * Requests are rounded up to a multiple of SLAB_GRANULARITY bytes, and
+ * each size class hands out blocks from large slabs. A freed block is put
+ * on the free list of its size class and is returned by the next request
+ * of the same class, so that objects that are created and deleted
+ * repeatedly do not go through malloc. Every thread has its own free
+ * lists. Slabs are kept until the program exits.
+ *
+ * When the program is built with AddressSanitizer, blocks are allocated
+ * with malloc so that invalid accesses are still detected.
+ */
+
+#define SLAB_GRANULARITY 16
+
+/** Requests larger than this are passed to malloc */
+#define SLAB_MAX_SIZE 256
+
+/**
+ * Returns a block of at least size bytes, aligned like malloc'ed blocks
+ * of the same size.
+ */
+void *slab_alloc(size_t size);
+
+/**
+ * Frees a block returned by slab_alloc. size must be the size that was
+ * given to slab_alloc.
+ */
+void slab_free(void *ptr, size_t size);
+
+/**
+ * Prints the number of blocks allocated and freed in each size class
+ * by the calling thread.
+ */
+void print_slab_stats(FILE *file);
+
+#endif
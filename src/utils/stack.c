@@ -47,7 +47,7 @@ void delete_stack(stackptr st) {
 void stack_push(stackptr st, void *element) {
   if (st->number_of_elements == st->capacity) {
     st->capacity *= 2;
-    st->data = realloc(st->data, st->capacity);
+    st->data = realloc(st->data, st->capacity * sizeof(void *));
   }
 
   st->data[st->number_of_elements++] = element;
@@ -60,7 +60,7 @@ void *stack_pop(stackptr st) {
     size_t new_capacity = st->capacity / 2;
     if (new_capacity >= DEFAULT_STACK_CAPACITY) {
       st->capacity = new_capacity;
-      st->data = realloc(st->data, st->capacity);
+      st->data = realloc(st->data, st->capacity * sizeof(void *));
     }
   }
 
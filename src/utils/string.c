@@ -26,6 +26,10 @@
 #include <assert.h>
 #include <string.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define ERR_FORMAT "Unknown format specifier"
 #define INITIAL_BUFFER_LENGTH 1
 #define MAX_TRIES 16
@@ -149,3 +153,59 @@ char *unique_append_sep(char *first,  const char *space,
   free(second);
   return result;
 }
+
+const char *find_substring(const char *chars, size_t length,
+                           const char *needle, size_t needle_length) {
+  if (needle_length == 0) {
+    return chars;
+  }
+
+  if (needle_length > length) {
+    return NULL;
+  }
+
+  if (needle_length == 1) {
+    return memchr(chars, needle[0], length);
+  }
+
+  /* Positions where the needle may start */
+  size_t positions = length - needle_length + 1;
+  size_t last = needle_length - 1;
+  size_t i = 0;
+
+#ifdef __SSE2__
+  /* The first and the last characters of the needle are compared with 16
+   * positions at once, and the rest of the needle is compared only at the
+   * positions where both of them match */
+  const __m128i first_char = _mm_set1_epi8(needle[0]);
+  const __m128i last_char = _mm_set1_epi8(needle[last]);
+  for (; i + 16 <= positions; i += 16) {
+    __m128i firsts = _mm_loadu_si128((const __m128i *)(chars + i));
+    __m128i lasts = _mm_loadu_si128((const __m128i *)(chars + i + last));
+    unsigned mask = (unsigned)_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(firsts, first_char),
+                      _mm_cmpeq_epi8(lasts, last_char)));
+    while (mask != 0) {
+      size_t position = i + (size_t)__builtin_ctz(mask);
+      if (memcmp(chars + position + 1, needle + 1, last - 1) == 0) {
+        return chars + position;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  while (i < positions) {
+    const char *candidate = memchr(chars + i, needle[0], positions - i);
+    if (!candidate) {
+      return NULL;
+    }
+
+    if (memcmp(candidate + 1, needle + 1, last) == 0) {
+      return candidate;
+    }
+    i = (size_t)(candidate - chars) + 1;
+  }
+
+  return NULL;
+}
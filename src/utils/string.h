@@ -23,6 +23,7 @@
 #define THEORYLISP_UTILS_HEAP_STRING_H
 
 #include <stdarg.h>
+#include <stddef.h>
 
 char *format(const char *format, ...);
 
@@ -40,4 +41,11 @@ char *unique_append(char *first, char *second);
 
 char *unique_append_sep(char *first, const char *space, char *second);
 
+/**
+ * Returns the first occurrence of needle in the given characters, or NULL
+ * if there is none. The characters do not have to be NUL terminated.
+ */
+const char *find_substring(const char *chars, size_t length,
+                           const char *needle, size_t needle_length);
+
 #endif
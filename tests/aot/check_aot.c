@@ -0,0 +1,107 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/aot/aot.h"
+#include "../../src/parser/parser.h"
+#include "../../src/scanner/scanner.h"
+
+/* Translates a program and returns the generated code */
+static char *emit(const char *input) {
+  stack_frame_ptr sf = new_stack_frame(NULL);
+  tokenstreamptr tkns = scanner(input);
+  listptr parse_tree = parser(tkns, sf);
+  delete_tokenstream(tkns);
+  ck_assert(parse_tree != NULL);
+
+  char *code = NULL;
+  size_t size = 0;
+  FILE *out = open_memstream(&code, &size);
+  aot_emit_program(out, parse_tree, sf);
+  fclose(out);
+
+  delete_parse_tree(parse_tree);
+  delete_stack_frame(sf);
+  return code;
+}
+
+START_TEST(test_emit_program) {
+  char *code = emit("(define inc (lambda (n) (+ n 1)))\n"
+                    "(if (< (inc 1) 3) (let ((x 2)) x) \"no\")");
+
+  /* Builtin functions are called through the builtin table */
+  ck_assert(strstr(code, "builtins[0] = find_builtin_function(\"+\");"));
+  ck_assert(strstr(code, "aot_call_builtin(builtins["));
+
+  /* The body of the lambda is translated into its own function */
+  ck_assert(strstr(code, "static objectptr lambda_0(stack_frame_ptr sf) {"));
+  ck_assert(strstr(code, "lambdas[0] = aot_native_lambda("
+                         "\"(lambda (n) (+ n 1))\", lambda_0, sf);"));
+
+  /* Procedures are looked up at runtime */
+  ck_assert(strstr(code, "stack_frame_get_variable(sf, \"inc\");"));
+  ck_assert(strstr(code, "stack_frame_ptr f1 = new_stack_frame(sf);"));
+  ck_assert(strstr(code, "= make_string(\"no\");"));
+  ck_assert(strstr(code, "aot_main(argc, argv, initialize, finalize, program, 2)"));
+  ck_assert(strstr(code, "fallbacks") == NULL);
+  free(code);
+} END_TEST
+
+START_TEST(test_emit_fallback) {
+  char *code = emit("(automaton\\0 (q0 ({#t} halt)))");
+  ck_assert(strstr(code, "t0 = interpret_expr(fallbacks[0], sf);"));
+  ck_assert(strstr(code, "fallbacks[0] = aot_parse(\"(automaton"));
+  free(code);
+} END_TEST
+
+static objectptr twice(stack_frame_ptr sf) {
+  objectptr n = stack_frame_get_variable(sf, "n");
+  objectptr result = make_integer(2 * int_value(n));
+  delete_object(n);
+  return result;
+}
+
+START_TEST(test_native_lambda) {
+  stack_frame_ptr sf = new_stack_frame(NULL);
+  exprptr lambda = aot_native_lambda("(lambda (n) (* n 2))", twice, sf);
+
+  objectptr proc = interpret_expr(lambda, sf);
+  objectptr *args = malloc(sizeof *args);
+  args[0] = make_integer(21);
+  objectptr result = aot_call(proc, 1, args, sf);
+  ck_assert(is_integer(result));
+  ck_assert_int_eq(int_value(result), 42);
+  delete_object(result);
+
+  /* Arity errors are reported like in the interpreter */
+  args[0] = make_integer(1);
+  result = aot_call_builtin(find_builtin_function("car"), 0, args, sf);
+  ck_assert(is_error(result));
+  delete_object(result);
+  delete_object(args[0]);
+
+  free(args);
+  delete_expr(lambda);
+  delete_stack_frame(sf);
+} END_TEST
+
+Suite *aot_suite(void) {
+  Suite *s = suite_create("AOT");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_emit_program);
+  tcase_add_test(tc_core, test_emit_fallback);
+  tcase_add_test(tc_core, test_native_lambda);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite *s = aot_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
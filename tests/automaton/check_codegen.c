@@ -0,0 +1,92 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/automaton/codegen.h"
+#include "../../src/parser/parser.h"
+#include "../../src/scanner/scanner.h"
+#include "../../src/types/error.h"
+#include "../../src/types/string.h"
+
+/* Evaluates an automaton expression and translates it to C */
+static objectptr generate(const char *input, const char *name) {
+  stack_frame_ptr sf = new_stack_frame(NULL);
+  tokenstreamptr tkns = scanner(input);
+  listptr parse_tree = parser(tkns, sf);
+  delete_tokenstream(tkns);
+  ck_assert(parse_tree != NULL);
+
+  objectptr procedure = interpret_expr(list_get(parse_tree, 0), sf);
+  objectptr result = automaton_to_c(procedure, name, sf);
+
+  delete_object(procedure);
+  delete_parse_tree(parse_tree);
+  delete_stack_frame(sf);
+  return result;
+}
+
+START_TEST(test_codegen_tables) {
+  objectptr result = generate("(automaton\\1"
+                              "  (q0 ({= 0} 1 q1)"
+                              "      ({= null} . accept))"
+                              "  (q1 ({#t} -> q0)))", "flip");
+  ck_assert(is_string(result));
+  const char *code = string_value(result);
+
+  /* Symbols are 0: other, 1: (void), 2: null, 3: 0, 4: 1 */
+  ck_assert(strstr(code, "#define flip_SYMBOLS 5"));
+  ck_assert(strstr(code, "static const int q0[flip_SYMBOLS] = {-1, -1, 1, 0, -1};"));
+  ck_assert(strstr(code, "static const int q1[flip_SYMBOLS] = {0, 0, 0, 0, 0};"));
+  ck_assert(strstr(code, "switch (q0[flip_symbol(&tapes[0])]) {"));
+  ck_assert(strstr(code, "tapes[0].symbols[tapes[0].head] = 4;"));
+  ck_assert(strstr(code, "!flip_grow(&tapes[0])"));
+  ck_assert(strstr(code, "return flip_ACCEPT;"));
+  ck_assert(strstr(code, "int flip(struct tlisp_tape *tapes) {"));
+  delete_object(result);
+} END_TEST
+
+START_TEST(test_codegen_base_machine) {
+  objectptr result = generate("(automaton\\1"
+                              "  (q0:(automaton\\1 (r ({#t} -> halt)))"
+                              "      ({= 1} . reject)))", "m");
+  ck_assert(is_string(result));
+  const char *code = string_value(result);
+  ck_assert(strstr(code, "if ((code = m_m1(tapes)) != m_HALT) {"));
+  ck_assert(strstr(code, "static int m_m1(struct tlisp_tape *tapes) {"));
+  delete_object(result);
+} END_TEST
+
+START_TEST(test_codegen_errors) {
+  objectptr result = generate("(automaton\\1 (q0 {(display 1)} ({#t} . halt)))", "m");
+  ck_assert(is_error(result));
+  delete_object(result);
+
+  result = generate("(automaton\\1 (q0 ({< 1} . halt)))", "m");
+  ck_assert(is_error(result));
+  delete_object(result);
+
+  result = generate("(lambda (x) x)", "m");
+  ck_assert(is_error(result));
+  delete_object(result);
+} END_TEST
+
+Suite *codegen_suite(void) {
+  Suite *s = suite_create("Automaton Code Generation");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_codegen_tables);
+  tcase_add_test(tc_core, test_codegen_base_machine);
+  tcase_add_test(tc_core, test_codegen_errors);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite *s = codegen_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -4,6 +4,8 @@
 #include "../../src/expressions/expression_base.h"
 #include "../../src/expressions/let.h"
 #include "../../src/expressions/lambda.h"
+#include "../../src/types/error.h"
+#include "../../src/types/string.h"
 #include "parse.h"
 
 typedef struct {
@@ -87,6 +89,94 @@ START_TEST(test_call_using_expr_complex_params) {
   delete_expr(e);
 } END_TEST
 
+/* Interprets e in sf after setting a and b, and deletes a and b */
+static objectptr interpret_with(exprptr e, stack_frame_ptr sf,
+                                objectptr a, objectptr b) {
+  stack_frame_set_local_variable(sf, "a", a);
+  stack_frame_set_local_variable(sf, "b", b);
+  delete_object(a);
+  delete_object(b);
+  return interpret_expr(e, sf);
+}
+
+START_TEST(test_specialized_arithmetic) {
+  exprptr e = NULL;
+  parse(e, "(- a b)");
+  stack_frame_ptr sf = new_stack_frame(NULL);
+
+  for (int i = 0; i < 4; ++i) {
+    objectptr result = interpret_with(e, sf, make_integer(i), make_integer(1));
+    ck_assert(is_integer(result));
+    ck_assert_int_eq(int_value(result), i - 1);
+    delete_object(result);
+  }
+  ck_assert(e->vtable->interpret != interpret_evaluation);
+
+  /* A real operand returns the call to the generic implementation */
+  objectptr result = interpret_with(e, sf, make_integer(3), make_real(0.5));
+  ck_assert(is_real(result));
+  ck_assert(real_value(result) == 2.5);
+  delete_object(result);
+  ck_assert(e->vtable->interpret == interpret_evaluation);
+
+  delete_stack_frame(sf);
+  delete_expr(e);
+} END_TEST
+
+START_TEST(test_specialized_comparison) {
+  exprptr e = NULL;
+  parse(e, "(>= a b)");
+  stack_frame_ptr sf = new_stack_frame(NULL);
+
+  for (int i = 0; i < 4; ++i) {
+    objectptr result = interpret_with(e, sf, make_real(i), make_real(2));
+    ck_assert(is_boolean(result));
+    ck_assert_int_eq(boolean_value(result), i >= 2);
+    delete_object(result);
+  }
+  ck_assert(e->vtable->interpret != interpret_evaluation);
+
+  objectptr result = interpret_with(e, sf, make_real(1), make_string("x"));
+  ck_assert(is_error(result));
+  delete_object(result);
+  ck_assert(e->vtable->interpret == interpret_evaluation);
+
+  delete_stack_frame(sf);
+  delete_expr(e);
+} END_TEST
+
+START_TEST(test_update_in_place) {
+  exprptr e = NULL;
+  parse(e, "(strcat s x)");
+  stack_frame_ptr sf = new_stack_frame(NULL);
+  stack_frame_set_local_variable(sf, "s", move(make_string("a")));
+  stack_frame_set_local_variable(sf, "x", move(make_string("b")));
+
+  /* The value of s is appended to in place */
+  objectptr value = stack_frame_peek_variable(sf, "s");
+  objectptr result = interpret_update(e, "s", sf);
+  ck_assert(result == value);
+  ck_assert_str_eq(string_value(result), "ab");
+  stack_frame_set_variable(sf, "s", result);
+  delete_object(result);
+
+  /* A value that is shared with another variable is not changed */
+  objectptr t = stack_frame_get_variable(sf, "s");
+  stack_frame_set_local_variable(sf, "t", t);
+  result = interpret_update(e, "s", sf);
+  ck_assert(result != value);
+  ck_assert_str_eq(string_value(result), "abb");
+  ck_assert_str_eq(string_value(t), "ab");
+  delete_object(result);
+  delete_object(t);
+
+  /* Other calls are not updates */
+  ck_assert(interpret_update(e, "x", sf) == NULL);
+
+  delete_stack_frame(sf);
+  delete_expr(e);
+} END_TEST
+
 START_TEST(test_parse_error1) {
   assert_parse_error("(3)");
 } END_TEST
@@ -119,6 +209,9 @@ Suite *evaluation_suite(void) {
   tcase_add_test(tc_valid, test_empty_call_using_expr);
   tcase_add_test(tc_valid, test_call_using_expr);
   tcase_add_test(tc_valid, test_call_using_expr_complex_params);
+  tcase_add_test(tc_valid, test_specialized_arithmetic);
+  tcase_add_test(tc_valid, test_specialized_comparison);
+  tcase_add_test(tc_valid, test_update_in_place);
 
   TCase *tc_invalid = tcase_create("Invalid");
   tcase_add_test(tc_invalid, test_parse_error1);
@@ -1,8 +1,10 @@
 #include <check.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "../../src/interpreter/stack_frame.h"
 #include "../../src/types/integer.h"
+#include "../../src/types/object-base.h"
 #include "../../src/types/void.h"
 #include "../../src/types/error.h"
 
@@ -33,6 +35,27 @@ START_TEST(test_stack_frame) {
 
 } END_TEST
 
+START_TEST(test_peek_variable) {
+  stack_frame_ptr sf_global = new_stack_frame(NULL);
+  objectptr value = make_integer(10);
+  stack_frame_set_local_variable(sf_global, "x", value);
+  stack_frame_ptr sf_local = new_stack_frame(sf_global);
+
+  /* Borrowed references do not change the reference count */
+  ck_assert_int_eq(value->ref_count, 2);
+  objectptr result = stack_frame_peek_variable(sf_local, "x");
+  ck_assert(result == value);
+  ck_assert_int_eq(value->ref_count, 2);
+
+  ck_assert(stack_frame_peek_variable(sf_local, "y") == NULL);
+  ck_assert(stack_frame_defined(sf_local, "x"));
+  ck_assert(!stack_frame_defined(sf_local, "y"));
+
+  delete_stack_frame(sf_local);
+  delete_stack_frame(sf_global);
+  delete_object(value);
+} END_TEST
+
 START_TEST(test_nested_stack_frame) {
   stack_frame_ptr sf_global = new_stack_frame(NULL);
   stack_frame_set_local_variable(sf_global, "x", move(make_integer(10)));
@@ -54,11 +77,49 @@ START_TEST(test_nested_stack_frame) {
 
 } END_TEST
 
+static size_t miss_count = 0;
+
+static objectptr miss_handler(stack_frame_ptr sf, const char *name) {
+  ++miss_count;
+  if (strcmp(name, "lazy") == 0) {
+    return make_integer(42);
+  }
+  return NULL;
+}
+
+START_TEST(test_miss_handler) {
+  stack_frame_ptr sf_global = new_stack_frame(NULL);
+  stack_frame_set_miss_handler(sf_global, miss_handler);
+  stack_frame_ptr sf_local = new_stack_frame(sf_global);
+
+  objectptr result = make_void();
+  assign_object(&result, stack_frame_get_variable(sf_local, "lazy"));
+  ck_assert(is_integer(result));
+  ck_assert_int_eq(int_value(result), 42);
+  ck_assert_uint_eq(miss_count, 1);
+
+  /* The materialized variable is stored in the global frame */
+  assign_object(&result, stack_frame_get_variable(sf_global, "lazy"));
+  ck_assert(is_integer(result));
+  ck_assert_uint_eq(miss_count, 1);
+
+  assign_object(&result, stack_frame_get_variable(sf_local, "missing"));
+  ck_assert(is_error(result));
+  ck_assert_uint_eq(miss_count, 2);
+
+  delete_stack_frame(sf_local);
+  delete_stack_frame(sf_global);
+  delete_object(result);
+
+} END_TEST
+
 Suite *scanner_suite(void) {
   Suite *s = suite_create("Scanner");
   TCase *tc_core = tcase_create("Core");
   tcase_add_test(tc_core, test_stack_frame);
+  tcase_add_test(tc_core, test_peek_variable);
   tcase_add_test(tc_core, test_nested_stack_frame);
+  tcase_add_test(tc_core, test_miss_handler);
   suite_add_tcase(s, tc_core);
   return s;
 }
@@ -0,0 +1,235 @@
+#include <check.h>
+#include <string.h>
+
+#include "../../src/jit/jit.h"
+#include "../../src/parser/parser.h"
+#include "../../src/scanner/scanner.h"
+#include "../../src/types/error.h"
+#include "../../src/types/integer.h"
+#include "../../src/types/procedure.h"
+#include "../../src/types/real.h"
+
+/* Parses a single expression */
+static exprptr parse_expr(const char *input) {
+  tokenstreamptr tkns = scanner(input);
+  listptr parse_tree = parser(tkns, NULL);
+  delete_tokenstream(tkns);
+  ck_assert(parse_tree != NULL);
+  ck_assert_uint_eq(list_size(parse_tree), 1);
+
+  exprptr e = clone_expr(list_get(parse_tree, 0));
+  delete_parse_tree(parse_tree);
+  return e;
+}
+
+/* Runs compiled code with the argument n, deleting n */
+static objectptr run_with(jit_code_ptr code, objectptr n) {
+  stack_frame_ptr sf = new_stack_frame(NULL);
+  stack_frame_set_local_variable(sf, "n", n);
+  objectptr result = jit_run(code, 1, &n, sf);
+  delete_stack_frame(sf);
+  delete_object(n);
+  return result;
+}
+
+/* Compiles body as the body of a lambda with a single parameter n */
+static jit_code_ptr compile_body(exprptr body) {
+  listptr params = new_list();
+  list_add(params, "n");
+  jit_code_ptr code = jit_compile(body, params);
+  delete_list(params);
+  return code;
+}
+
+START_TEST(test_numbers) {
+  exprptr body = parse_expr("(if (< n 2) (* n 3) (- n 0.5))");
+  jit_code_ptr code = compile_body(body);
+  ck_assert(code != NULL);
+
+  objectptr result = run_with(code, make_integer(1));
+  ck_assert(is_integer(result));
+  ck_assert_int_eq(int_value(result), 3);
+  delete_object(result);
+
+  result = run_with(code, make_integer(4));
+  ck_assert(is_real(result));
+  ck_assert(real_value(result) == 3.5);
+  delete_object(result);
+
+  result = run_with(code, make_real(0.5));
+  ck_assert(is_real(result));
+  ck_assert(real_value(result) == 1.5);
+  delete_object(result);
+
+  delete_jit_code(code);
+  delete_expr(body);
+} END_TEST
+
+START_TEST(test_errors) {
+  exprptr body = parse_expr("(if n (+ n 1) (undefined-function n))");
+  jit_code_ptr code = compile_body(body);
+  ck_assert(code != NULL);
+
+  objectptr result = run_with(code, make_integer(1));
+  ck_assert(is_error(result));
+  delete_object(result);
+
+  delete_jit_code(code);
+  delete_expr(body);
+} END_TEST
+
+START_TEST(test_interpreted_body) {
+  exprptr body = parse_expr("(let ((x n)) x)");
+  ck_assert(compile_body(body) == NULL);
+  delete_expr(body);
+} END_TEST
+
+START_TEST(test_check_mode) {
+  jit_set_mode(JIT_CHECK);
+  exprptr body = parse_expr("(if (>= n 1.0) (+ n (* n 2.5)) (!= n 0))");
+  jit_code_ptr code = compile_body(body);
+  ck_assert(code != NULL);
+
+  objectptr result = run_with(code, make_real(2.0));
+  ck_assert(is_real(result));
+  ck_assert(real_value(result) == 7.0);
+  delete_object(result);
+
+  result = run_with(code, make_real(0.0));
+  delete_object(result);
+  ck_assert_uint_eq(jit_check_failures(), 0);
+
+  delete_jit_code(code);
+  delete_expr(body);
+  jit_set_mode(JIT_OFF);
+} END_TEST
+
+/* Checks that compiled code gives the same result as the interpreter
+ * for the argument n, deleting n */
+static void check_same_result(exprptr body, objectptr n) {
+  stack_frame_ptr sf = new_stack_frame(NULL);
+  stack_frame_set_local_variable(sf, "n", n);
+  objectptr expected = interpret_expr(body, sf);
+  delete_stack_frame(sf);
+
+  jit_code_ptr code = compile_body(body);
+  ck_assert(code != NULL);
+  objectptr first = run_with(code, clone_object(n));
+  objectptr second = run_with(code, n);
+
+  char *expected_str = object_tostring(expected);
+  char *first_str = object_tostring(first);
+  char *second_str = object_tostring(second);
+  ck_assert_str_eq(first_str, expected_str);
+  ck_assert_str_eq(second_str, expected_str);
+  free(expected_str);
+  free(first_str);
+  free(second_str);
+
+  delete_object(expected);
+  delete_object(first);
+  delete_object(second);
+  delete_jit_code(code);
+}
+
+START_TEST(test_native_operations) {
+  const char *bodies[] = {
+      "(+ n -0.0)",          "(- n 0.25)",     "(* n -3.0)",
+      "(+ (* n n) (- n 3))", "(* n 1000000007)",
+      "(= n 1.0)",           "(!= n 1.0)",     "(< n 1.0)",
+      "(<= n 1.0)",          "(> n 1.0)",      "(>= n 1.0)",
+      "(if (< n 2) n (- n 2))",
+      "(if (= n n) (< 0.0 n) (> 0.0 n))"};
+  objectptr zero = make_real(0.0);
+  objectptr inf = make_real(1.0 / real_value(zero));
+  objectptr nan = make_real(real_value(inf) - real_value(inf));
+
+  for (size_t i = 0; i < sizeof bodies / sizeof *bodies; ++i) {
+    exprptr body = parse_expr(bodies[i]);
+    /* Operations on reals that are not in the body are left to the
+     * builtin functions */
+    check_same_result(body, make_integer(3));
+    check_same_result(body, make_integer(-7));
+    check_same_result(body, make_real(1.0));
+    check_same_result(body, make_real(-0.0));
+    check_same_result(body, clone_object(inf));
+    check_same_result(body, clone_object(nan));
+    delete_expr(body);
+  }
+
+  delete_object(zero);
+  delete_object(inf);
+  delete_object(nan);
+} END_TEST
+
+/* Calls the procedure f with the argument n in sf */
+static objectptr call_with(stack_frame_ptr sf, integer_t n) {
+  objectptr proc = stack_frame_get_variable(sf, "f");
+  objectptr arg = make_integer(n);
+  objectptr result = object_op_call(proc, 1, &arg, sf);
+  delete_object(arg);
+  delete_object(proc);
+  return result;
+}
+
+START_TEST(test_native_self_calls) {
+  jit_set_mode(JIT_CHECK);
+  exprptr lambda = parse_expr(
+      "(lambda (n) (if (< n 2) n (+ (f (- n 1)) (f (- n 2)))))");
+  exprptr other = parse_expr("(lambda (n) (* n 10))");
+  stack_frame_ptr sf = new_stack_frame(NULL);
+  objectptr proc = interpret_expr(lambda, sf);
+  stack_frame_set_local_variable(sf, "f", proc);
+
+  /* Calls after the first 64 run machine code */
+  objectptr result = call_with(sf, 15);
+  ck_assert(is_integer(result));
+  ck_assert_int_eq(int_value(result), 610);
+  delete_object(result);
+
+  result = call_with(sf, 20);
+  ck_assert_int_eq(int_value(result), 6765);
+  delete_object(result);
+
+  /* If f refers to another procedure, the body calls that one */
+  stack_frame_ptr inner = new_stack_frame(sf);
+  objectptr other_proc = interpret_expr(other, sf);
+  stack_frame_set_local_variable(inner, "f", other_proc);
+  objectptr arg = make_integer(5);
+  result = object_op_call(proc, 1, &arg, inner);
+  ck_assert_int_eq(int_value(result), 70);
+  delete_object(result);
+  delete_object(arg);
+  delete_stack_frame(inner);
+
+  ck_assert_uint_eq(jit_check_failures(), 0);
+  delete_object(other_proc);
+  delete_object(proc);
+  delete_stack_frame(sf);
+  delete_expr(lambda);
+  delete_expr(other);
+  jit_set_mode(JIT_OFF);
+} END_TEST
+
+Suite *jit_suite(void) {
+  Suite *s = suite_create("JIT");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_numbers);
+  tcase_add_test(tc_core, test_errors);
+  tcase_add_test(tc_core, test_interpreted_body);
+  tcase_add_test(tc_core, test_check_mode);
+  tcase_add_test(tc_core, test_native_operations);
+  tcase_add_test(tc_core, test_native_self_calls);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite *s = jit_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,160 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../src/optimizer/optimizer.h"
+#include "../../src/parser/parser.h"
+#include "../../src/scanner/scanner.h"
+
+/* Parses and optimizes the program, and compares the string
+ * representation of each top-level expression with the expected one */
+static void assert_optimized(const char *program, bool whole_program,
+                             const char **expected, size_t n) {
+  stack_frame_ptr sf = new_stack_frame(NULL);
+  tokenstreamptr tkns = scanner(program);
+  listptr parse_tree = parser(tkns, sf);
+  delete_tokenstream(tkns);
+  ck_assert(parse_tree != NULL);
+
+  optimize_parse_tree(parse_tree, whole_program, sf);
+  ck_assert_uint_eq(list_size(parse_tree), n);
+  for (size_t i = 0; i < n; ++i) {
+    char *str = expr_tostring(list_get(parse_tree, i));
+    ck_assert_str_eq(str, expected[i]);
+    free(str);
+  }
+
+  delete_parse_tree(parse_tree);
+  delete_stack_frame(sf);
+}
+
+START_TEST(test_fold_builtin_calls) {
+  const char *expected[] = {"7", "(f 5)", "(/ 1 0)"};
+  assert_optimized("(+ 1 (* 2 3)) (f (- 7 2)) (/ 1 0)", false, expected, 3);
+} END_TEST
+
+START_TEST(test_fold_conditions) {
+  const char *expected[] = {"x", "\"b\"", "(cond ((< x 0) 1) (#t 2))"};
+  assert_optimized(
+      "(if (< 1 2) x y)"
+      "(cond ((= 1 2) \"a\") (#t (strcat \"b\")) (x 3))"
+      "(cond (#f 0) ((< x 0) 1) (#t 2) (#t 3))",
+      false, expected, 3);
+} END_TEST
+
+START_TEST(test_propagate_constants) {
+  const char *expected[] = {"(f N)", "(define N 4)",
+                            "(define f (lambda (x) (+ x 4)))", "20"};
+  assert_optimized(
+      "(f N) (define N 4) (define f (lambda (x) (+ x N))) (* N 5)",
+      true, expected, 4);
+} END_TEST
+
+START_TEST(test_keep_assigned_variables) {
+  const char *expected[] = {"(define N 4)", "(define M 2)",
+                            "(define g (lambda (M) M))", "(set! N 5)",
+                            "(+ N M)"};
+  assert_optimized(
+      "(define N 4) (define M 2) (define g (lambda (M) M))"
+      "(set! N 5) (+ N M)",
+      true, expected, 5);
+} END_TEST
+
+START_TEST(test_keep_variables_with_eval) {
+  const char *expected[] = {"(define N 4)", "(eval s)", "(+ N 1)"};
+  assert_optimized("(define N 4) (eval s) (+ N 1)", true, expected, 3);
+} END_TEST
+
+START_TEST(test_inline_procedures) {
+  const char *expected[] = {
+      "(g 1)",
+      "(define f (lambda (x) (+ x 1)))",
+      "(define g (lambda (y) (* (let ((x%1 y)) (+ x%1 1)) 2)))",
+      "(let ((y%2 z)) (* (let ((x%1 y%2)) (+ x%1 1)) 2))",
+      "(* (let ((x%1 1)) (+ x%1 1)) 2)",
+      "(define h (lambda (n) (if (= n 0) 0 (h (- n 1)))))",
+      "(h 3)",
+      "(f 1 2)"};
+  assert_optimized(
+      "(g 1) (define f (lambda (x) (+ x 1)))"
+      "(define g (lambda (y) (* (f y) 2))) (g z) (g 1)"
+      "(define h (lambda (n) (if (= n 0) 0 (h (- n 1))))) (h 3) (f 1 2)",
+      true, expected, 8);
+} END_TEST
+
+START_TEST(test_keep_procedures_called_by_parameters) {
+  const char *expected[] = {"(define f (lambda (x) (x 1)))",
+                            "(define k (lambda (x) x))", "(set! k f)",
+                            "(f g)", "(k 2)"};
+  assert_optimized(
+      "(define f (lambda (x) (x 1))) (define k (lambda (x) x)) (set! k f)"
+      "(f g) (k 2)",
+      true, expected, 5);
+} END_TEST
+
+START_TEST(test_keep_procedures_reading_free_variables) {
+  /* usep reads the parameter of shadow, so neither is inlined. Reading
+   * a constant does not prevent inlining. */
+  const char *expected[] = {"(define usep (lambda () p))",
+                            "(define shadow (lambda (p) (usep)))",
+                            "(shadow 1)", "(define N 4)",
+                            "(define f (lambda (x) (+ x 4)))",
+                            "(let ((x%1 y)) (+ x%1 4))"};
+  assert_optimized(
+      "(define usep (lambda () p)) (define shadow (lambda (p) (usep)))"
+      "(shadow 1) (define N 4) (define f (lambda (x) (+ x N))) (f y)",
+      true, expected, 6);
+} END_TEST
+
+START_TEST(test_keep_variables_bound_by_libraries) {
+  /* apply-to binds lst while it calls fn, which reads it */
+  char path[] = "/tmp/check_optimizer_XXXXXX";
+  int fd = mkstemp(path);
+  ck_assert(fd >= 0);
+  FILE *library = fdopen(fd, "w");
+  fputs("(define apply-to (lambda (fn lst) (fn)))"
+        "(define unused (lambda (N) N))",
+        library);
+  fclose(library);
+
+  char *program = malloc(strlen(path) + 128);
+  sprintf(program,
+          "(include \"%s\") (define lst 5) (define N 2)"
+          "(apply-to (lambda () lst) 1) (+ N 1)",
+          path);
+  /* The library is run while the program is parsed */
+  const char *expected[] = {"(void)", "(define lst 5)", "(define N 2)",
+                            "(apply-to (lambda () lst) 1)", "3"};
+  assert_optimized(program, true, expected, 5);
+
+  remove(path);
+  free(program);
+} END_TEST
+
+Suite *optimizer_suite(void) {
+  Suite *s = suite_create("Optimizer");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_fold_builtin_calls);
+  tcase_add_test(tc_core, test_fold_conditions);
+  tcase_add_test(tc_core, test_propagate_constants);
+  tcase_add_test(tc_core, test_keep_assigned_variables);
+  tcase_add_test(tc_core, test_keep_variables_with_eval);
+  tcase_add_test(tc_core, test_inline_procedures);
+  tcase_add_test(tc_core, test_keep_procedures_called_by_parameters);
+  tcase_add_test(tc_core, test_keep_procedures_reading_free_variables);
+  tcase_add_test(tc_core, test_keep_variables_bound_by_libraries);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite *s = optimizer_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
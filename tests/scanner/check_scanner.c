@@ -1,4 +1,7 @@
 #include <check.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <wchar.h>
 
 #include "../../src/scanner/scanner.h"
@@ -139,6 +142,102 @@ START_TEST(test_mixed_with_parenthesis) {
 
 } END_TEST
 
+START_TEST(test_strings_and_comments) {
+  /* the input is not null terminated after "b" */
+  static const char words[] = "\"a ; b\" ; comment\n\"x\ny\" b_IGNORED";
+
+  tokenstreamptr tkns = scanner_n(words, sizeof words - 9);
+  ck_assert_uint_eq(list_size(tkns->tokens), 4);
+
+  tokenptr tkn = next_tkn(tkns);
+  ck_assert_int_eq(tkn->type, TOKEN_STRING);
+  ck_assert_str_eq(tkn->value.character_sequence, "a ; b");
+  ck_assert_uint_eq(tkn->line, 1);
+  ck_assert_uint_eq(tkn->column, 1);
+
+  tkn = next_tkn(tkns);
+  ck_assert_int_eq(tkn->type, TOKEN_STRING);
+  ck_assert_str_eq(tkn->value.character_sequence, "x\ny");
+  ck_assert_uint_eq(tkn->line, 2);
+  ck_assert_uint_eq(tkn->column, 1);
+
+  tkn = next_tkn(tkns);
+  ck_assert_int_eq(tkn->type, TOKEN_IDENTIFIER);
+  ck_assert_str_eq(tkn->value.character_sequence, "b");
+  ck_assert_uint_eq(tkn->line, 3);
+  ck_assert_uint_eq(tkn->column, 4);
+
+  tkn = next_tkn(tkns);
+  ck_assert_int_eq(tkn->type, TOKEN_END_OF_FILE);
+  ck_assert_uint_eq(tkn->line, 3);
+  ck_assert_uint_eq(tkn->column, 5);
+
+  delete_tokenstream(tkns);
+} END_TEST
+
+START_TEST(test_top_level_forms) {
+  size_t end = 0;
+  static const char forms[] = " ; (comment\n(f \")\" [x]) %(g) abc\n";
+  ck_assert_int_eq(find_top_level_form(forms, strlen(forms), &end),
+                   FORM_COMPLETE);
+  ck_assert_uint_eq(end, 23);
+
+  const char *rest = forms + end;
+  ck_assert_int_eq(find_top_level_form(rest, strlen(rest), &end),
+                   FORM_COMPLETE);
+  ck_assert_uint_eq(end, 5);
+
+  rest += end;
+  ck_assert_int_eq(find_top_level_form(rest, strlen(rest), &end),
+                   FORM_COMPLETE);
+  ck_assert_uint_eq(end, 4);
+
+  rest += end;
+  ck_assert_int_eq(find_top_level_form(rest, strlen(rest), &end), FORM_EMPTY);
+  ck_assert_int_eq(find_top_level_form("(f\n  (g", 8, &end), FORM_INCOMPLETE);
+  ck_assert_int_eq(find_top_level_form("\"a", 2, &end), FORM_INCOMPLETE);
+  ck_assert_int_eq(find_top_level_form("ab", 2, &end), FORM_INCOMPLETE);
+} END_TEST
+
+START_TEST(test_large_multi_line_form) {
+  /* The form is given one more line at a time, as the stream reader
+   * does, and the lines that are already scanned are not scanned again */
+  const size_t lines = 40000;
+  char *input = malloc(4 * lines + 64);
+  size_t length = 0;
+  form_state_t state;
+  init_form_state(&state);
+  size_t end = 0;
+
+  length += sprintf(input + length, "(+ 0\n");
+  bool incomplete = true;
+  bool scanned_once = true;
+  for (size_t i = 0; i < lines; ++i) {
+    length += sprintf(input + length, " 1\n");
+    incomplete = incomplete &&
+                 find_top_level_form_from(input, length, &state, &end) ==
+                     FORM_INCOMPLETE;
+    scanned_once = scanned_once && state.position == length;
+  }
+  ck_assert(incomplete);
+  ck_assert(scanned_once);
+
+  /* A string may also span lines */
+  length += sprintf(input + length, "\"a\n");
+  ck_assert_int_eq(find_top_level_form_from(input, length, &state, &end),
+                   FORM_INCOMPLETE);
+  ck_assert(state.in_string);
+  ck_assert_uint_eq(state.position, length);
+
+  length += sprintf(input + length, "b\") x\n");
+  ck_assert_int_eq(find_top_level_form_from(input, length, &state, &end),
+                   FORM_COMPLETE);
+  ck_assert_uint_eq(end, length - 3);
+  ck_assert_int_eq(find_top_level_form(input, length, &end), FORM_COMPLETE);
+  ck_assert_uint_eq(end, length - 3);
+  free(input);
+} END_TEST
+
 Suite *scanner_suite(void) {
   Suite *s = suite_create("Scanner");
   TCase *tc_core = tcase_create("Core");
@@ -148,6 +247,9 @@ Suite *scanner_suite(void) {
   tcase_add_test(tc_core, test_numbers);
   tcase_add_test(tc_core, test_mixed_alphanumeric);
   tcase_add_test(tc_core, test_mixed_with_parenthesis);
+  tcase_add_test(tc_core, test_strings_and_comments);
+  tcase_add_test(tc_core, test_top_level_forms);
+  tcase_add_test(tc_core, test_large_multi_line_form);
   suite_add_tcase(s, tc_core);
   return s;
 }
@@ -0,0 +1,127 @@
+#include <check.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../../src/types/collector.h"
+#include "../../src/types/object-base.h"
+#include "../../src/types/pair.h"
+#include "../../src/types/integer.h"
+#include "../../src/types/null.h"
+
+/* Mutable container that can be changed to refer to itself */
+
+static void destroy_box(objectptr self) {
+  delete_object(*(objectptr *)self->value);
+}
+
+static void box_traverse(objectptr self, object_visitor visit,
+                         void *context) {
+  visit(*(objectptr *)self->value, context);
+}
+
+static object_stats_t box_stats;
+
+static const object_type_t box_type_id = {{
+    .destroy = destroy_box,
+    .traverse = box_traverse,
+}, "box", sizeof(objectptr), &box_stats};
+
+static objectptr make_box(objectptr content) {
+  objectptr obj = object_base_new_inline(&box_type_id);
+  *(objectptr *)obj->value = clone_object(content);
+  return obj;
+}
+
+static void box_set(objectptr box, objectptr content) {
+  assign_object(box->value, clone_object(content));
+}
+
+/* Creates a box that refers to itself through a pair */
+static objectptr make_cycle(void) {
+  objectptr null_obj = make_null();
+  objectptr box = make_box(null_obj);
+  objectptr pair = make_pair(box, null_obj);
+  box_set(box, pair);
+  delete_object(pair);
+  delete_object(null_obj);
+  return box;
+}
+
+START_TEST(test_collect_cycle) {
+  size_t freed = box_stats.freed;
+  objectptr box = make_cycle();
+  delete_object(box);
+
+  ck_assert_int_eq(box_stats.freed, freed);
+  ck_assert_int_eq(collect_cycles(), 2);
+  ck_assert_int_eq(box_stats.freed, freed + 1);
+} END_TEST
+
+START_TEST(test_live_cycle) {
+  size_t freed = box_stats.freed;
+  objectptr box = make_cycle();
+  objectptr other = clone_object(box);
+  delete_object(box);
+
+  ck_assert_int_eq(collect_cycles(), 0);
+  ck_assert_int_eq(box_stats.freed, freed);
+
+  delete_object(other);
+  ck_assert_int_eq(collect_cycles(), 2);
+  ck_assert_int_eq(box_stats.freed, freed + 1);
+} END_TEST
+
+START_TEST(test_acyclic_pair) {
+  objectptr first = make_integer(1);
+  objectptr second = make_integer(2);
+  objectptr pair = make_pair(first, second);
+  ck_assert(is_acyclic(pair));
+
+  objectptr copy = clone_object(pair);
+  delete_object(pair);
+  ck_assert_int_eq(collect_cycles(), 0);
+
+  delete_object(copy);
+  delete_object(first);
+  delete_object(second);
+} END_TEST
+
+START_TEST(test_threshold) {
+  size_t previous = collector_set_threshold(2);
+  size_t freed = box_stats.freed;
+
+  objectptr box = make_cycle();
+  delete_object(box);
+  collector_safe_point();
+  ck_assert_int_eq(box_stats.freed, freed + 1);
+
+  collector_set_threshold(0);
+  box = make_cycle();
+  delete_object(box);
+  collector_safe_point();
+  ck_assert_int_eq(box_stats.freed, freed + 1);
+
+  ck_assert_int_eq(collect_cycles(), 2);
+  ck_assert_int_eq(collector_set_threshold(previous), 0);
+} END_TEST
+
+Suite *collector_suite(void) {
+  Suite *s = suite_create("Collector");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_collect_cycle);
+  tcase_add_test(tc_core, test_live_cycle);
+  tcase_add_test(tc_core, test_acyclic_pair);
+  tcase_add_test(tc_core, test_threshold);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite *s = collector_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,262 @@
+#include <check.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../../src/types/dict.h"
+#include "../../src/types/collector.h"
+#include "../../src/types/error.h"
+#include "../../src/types/integer.h"
+#include "../../src/types/null.h"
+#include "../../src/types/pair.h"
+#include "../../src/types/string.h"
+
+static objectptr set_integer(objectptr dict, integer_t key, integer_t value) {
+  objectptr key_obj = make_integer(key);
+  objectptr value_obj = make_integer(value);
+  objectptr result = dict_set(dict, key_obj, value_obj);
+  delete_object(key_obj);
+  delete_object(value_obj);
+  return result;
+}
+
+static objectptr remove_integer(objectptr dict, integer_t key) {
+  objectptr key_obj = make_integer(key);
+  objectptr result = dict_remove(dict, key_obj);
+  delete_object(key_obj);
+  return result;
+}
+
+static bool has_integer(objectptr dict, integer_t key, integer_t value) {
+  objectptr key_obj = make_integer(key);
+  objectptr found = dict_get(dict, key_obj);
+  delete_object(key_obj);
+  return found && is_integer(found) && int_value(found) == value;
+}
+
+START_TEST(test_dict_persistent) {
+  objectptr empty = make_dict();
+  ck_assert(is_dict(empty) && !is_mutable_dict(empty));
+  ck_assert_uint_eq(dict_size(empty), 0);
+
+  objectptr one = set_integer(empty, 1, 10);
+  objectptr two = set_integer(one, 2, 20);
+  objectptr changed = set_integer(two, 1, 30);
+
+  /* Older versions are not changed */
+  ck_assert_uint_eq(dict_size(empty), 0);
+  ck_assert_uint_eq(dict_size(one), 1);
+  ck_assert_uint_eq(dict_size(two), 2);
+  ck_assert_uint_eq(dict_size(changed), 2);
+  ck_assert(has_integer(one, 1, 10));
+  ck_assert(has_integer(two, 1, 10));
+  ck_assert(has_integer(changed, 1, 30));
+  ck_assert(!has_integer(one, 2, 20));
+
+  objectptr removed = remove_integer(changed, 1);
+  ck_assert_uint_eq(dict_size(removed), 1);
+  ck_assert(has_integer(removed, 2, 20));
+  ck_assert(has_integer(changed, 1, 30));
+
+  /* Removing a missing key returns an equal dict */
+  objectptr same = remove_integer(removed, 5);
+  ck_assert(object_equals(same, removed));
+
+  delete_object(empty);
+  delete_object(one);
+  delete_object(two);
+  delete_object(changed);
+  delete_object(removed);
+  delete_object(same);
+} END_TEST
+
+START_TEST(test_dict_many_keys) {
+  objectptr dict = make_dict();
+  for (integer_t i = 0; i < 10000; ++i) {
+    assign_object(&dict, move(set_integer(dict, i, i * 2)));
+  }
+  ck_assert_uint_eq(dict_size(dict), 10000);
+
+  bool found = true;
+  for (integer_t i = 0; i < 10000; ++i) {
+    found = found && has_integer(dict, i, i * 2);
+  }
+  ck_assert(found);
+
+  for (integer_t i = 0; i < 10000; i += 2) {
+    assign_object(&dict, move(remove_integer(dict, i)));
+  }
+  ck_assert_uint_eq(dict_size(dict), 5000);
+  ck_assert(!has_integer(dict, 0, 0));
+  ck_assert(has_integer(dict, 9999, 19998));
+
+  for (integer_t i = 1; i < 10000; i += 2) {
+    assign_object(&dict, move(remove_integer(dict, i)));
+  }
+  ck_assert_uint_eq(dict_size(dict), 0);
+  delete_object(settle(dict));
+} END_TEST
+
+START_TEST(test_dict_mutable) {
+  objectptr dict = make_mutable_dict();
+  ck_assert(is_mutable_dict(dict) && !is_dict(dict));
+
+  for (integer_t i = 0; i < 100; ++i) {
+    objectptr key = make_integer(i);
+    objectptr value = make_integer(-i);
+    delete_object(mutable_dict_set(dict, key, value));
+    delete_object(key);
+    delete_object(value);
+  }
+  ck_assert_uint_eq(dict_size(dict), 100);
+
+  /* Removals move the following entries back, so the remaining keys
+   * must still be found */
+  for (integer_t i = 0; i < 100; i += 3) {
+    objectptr key = make_integer(i);
+    mutable_dict_remove(dict, key);
+    delete_object(key);
+  }
+  ck_assert_uint_eq(dict_size(dict), 66);
+
+  bool correct = true;
+  for (integer_t i = 0; i < 100; ++i) {
+    objectptr key = make_integer(i);
+    objectptr value = dict_get(dict, key);
+    correct = correct && (i % 3 == 0 ? value == NULL
+                                     : int_value(value) == -i);
+    delete_object(key);
+  }
+  ck_assert(correct);
+  delete_object(dict);
+} END_TEST
+
+START_TEST(test_dict_lists) {
+  objectptr null_obj = make_null();
+  objectptr a = make_string("a");
+  objectptr b = make_string("b");
+  objectptr one = make_integer(1);
+  objectptr two = make_integer(2);
+  objectptr first = make_pair(a, one);
+  objectptr second = make_pair(b, two);
+  objectptr third = make_pair(a, two);
+  objectptr tail = make_pair(third, null_obj);
+  objectptr middle = make_pair(second, tail);
+  objectptr alist = make_pair(first, middle);
+
+  /* The first value of a key is used */
+  objectptr dict = list_to_dict(alist);
+  ck_assert_uint_eq(dict_size(dict), 2);
+  ck_assert(object_equals(dict_get(dict, a), one));
+
+  objectptr mutable_dict = list_to_mutable_dict(alist);
+  ck_assert(object_equals(dict_get(mutable_dict, a), one));
+
+  objectptr list = dict_to_list(dict);
+  objectptr again = list_to_dict(list);
+  ck_assert(object_equals(dict, again));
+  ck_assert(!object_equals(dict, mutable_dict));
+
+  /* Keys of the first dict take precedence */
+  objectptr other = list_to_dict(tail);
+  objectptr merged = dict_merge(other, dict);
+  ck_assert_uint_eq(dict_size(merged), 2);
+  ck_assert(object_equals(dict_get(merged, a), two));
+  ck_assert(object_equals(dict_get(merged, b), two));
+
+  objectptr invalid = list_to_dict(one);
+  ck_assert(is_error(invalid));
+
+  char *str = dict_tostring(other);
+  ck_assert_str_eq(str, "(make-dict (cons \"a\" 2))");
+  free(str);
+
+  delete_object(null_obj);
+  delete_object(a);
+  delete_object(b);
+  delete_object(one);
+  delete_object(two);
+  delete_object(first);
+  delete_object(second);
+  delete_object(third);
+  delete_object(tail);
+  delete_object(middle);
+  delete_object(alist);
+  delete_object(dict);
+  delete_object(mutable_dict);
+  delete_object(list);
+  delete_object(again);
+  delete_object(other);
+  delete_object(merged);
+  delete_object(invalid);
+} END_TEST
+
+START_TEST(test_dict_unhashable) {
+  objectptr dict = make_dict();
+  objectptr mutable_dict = make_mutable_dict();
+  objectptr one = make_integer(1);
+
+  objectptr result = dict_set(dict, mutable_dict, one);
+  ck_assert(is_error(result));
+  delete_object(result);
+  result = mutable_dict_set(mutable_dict, dict, one);
+  ck_assert(is_error(result));
+  delete_object(result);
+  ck_assert(dict_get(dict, mutable_dict) == NULL);
+
+  delete_object(dict);
+  delete_object(mutable_dict);
+  delete_object(one);
+} END_TEST
+
+START_TEST(test_dict_cycle) {
+  objectptr dict = make_mutable_dict();
+  objectptr key = make_integer(1);
+  delete_object(mutable_dict_set(dict, key, dict));
+  delete_object(key);
+  delete_object(dict);
+
+  ck_assert_int_eq(collect_cycles(), 1);
+} END_TEST
+
+START_TEST(test_dict_self_reference) {
+  objectptr first = make_mutable_dict();
+  objectptr second = make_mutable_dict();
+  objectptr key = make_integer(1);
+  delete_object(mutable_dict_set(first, key, first));
+  delete_object(mutable_dict_set(second, key, second));
+
+  char *str = dict_tostring(first);
+  ck_assert_str_eq(str, "(make-mutable-dict (cons 1 ...))");
+  free(str);
+  ck_assert(dict_equals(first, second));
+
+  delete_object(key);
+  delete_object(first);
+  delete_object(second);
+  ck_assert_int_eq(collect_cycles(), 2);
+} END_TEST
+
+Suite *dict_suite(void) {
+  Suite *s = suite_create("Dict");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_dict_persistent);
+  tcase_add_test(tc_core, test_dict_many_keys);
+  tcase_add_test(tc_core, test_dict_mutable);
+  tcase_add_test(tc_core, test_dict_lists);
+  tcase_add_test(tc_core, test_dict_unhashable);
+  tcase_add_test(tc_core, test_dict_cycle);
+  tcase_add_test(tc_core, test_dict_self_reference);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+
+int main(void) {
+  Suite *s = dict_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,117 @@
+#include <check.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "../../src/types/input_port.h"
+#include "../../src/types/integer.h"
+#include "../../src/types/pair.h"
+#include "../../src/types/string.h"
+#include "../../src/types/void.h"
+#include "../../src/types/error.h"
+
+/* Larger than a block of an input port */
+#define LONG_SYMBOL_LENGTH 100000
+
+static char file_name[64];
+
+static void write_file(const char *contents, size_t length) {
+  strcpy(file_name, "/tmp/check_input_port_XXXXXX");
+  int fd = mkstemp(file_name);
+  ck_assert(fd >= 0);
+  ck_assert(write(fd, contents, length) == (ssize_t)length);
+  close(fd);
+}
+
+START_TEST(test_read_line) {
+  const char contents[] = "first\n\nthird";
+  write_file(contents, sizeof(contents) - 1);
+  objectptr port = make_input_port(file_name);
+  ck_assert(is_input_port(port));
+
+  objectptr line = input_port_read_line(port);
+  ck_assert_str_eq(string_value(line), "first");
+  delete_object(line);
+  line = input_port_read_line(port);
+  ck_assert_str_eq(string_value(line), "");
+  delete_object(line);
+  line = input_port_read_bytes(port, 2);
+  ck_assert_str_eq(string_value(line), "th");
+  delete_object(line);
+  line = input_port_read_line(port);
+  ck_assert_str_eq(string_value(line), "ird");
+  delete_object(line);
+  line = input_port_read_line(port);
+  ck_assert(is_void(line));
+  delete_object(line);
+
+  input_port_close(port);
+  line = input_port_read_line(port);
+  ck_assert(is_error(line));
+  delete_object(line);
+
+  delete_object(port);
+  unlink(file_name);
+} END_TEST
+
+START_TEST(test_read_symbols) {
+  /* The long symbol spans multiple blocks */
+  size_t length = LONG_SYMBOL_LENGTH + 16;
+  char *contents = malloc(length);
+  memcpy(contents, "  12 -3 ", 8);
+  memset(contents + 8, 'a', LONG_SYMBOL_LENGTH);
+  memcpy(contents + 8 + LONG_SYMBOL_LENGTH, "\nb1 \t 7\n", 8);
+  write_file(contents, length);
+  free(contents);
+
+  objectptr port = make_input_port(file_name);
+  objectptr symbols = input_port_read_symbols(port, 2);
+  ck_assert_int_eq(int_value(pair_first(symbols)), 12);
+  ck_assert_int_eq(int_value(pair_first(pair_second(symbols))), -3);
+  delete_object(symbols);
+
+  symbols = input_port_read_symbols(port, (size_t)-1);
+  objectptr symbol = pair_first(symbols);
+  ck_assert(is_string(symbol));
+  ck_assert_uint_eq(string_size(symbol), LONG_SYMBOL_LENGTH);
+  objectptr rest = pair_second(symbols);
+  ck_assert_str_eq(string_value(pair_first(rest)), "b1");
+  ck_assert_int_eq(int_value(pair_first(pair_second(rest))), 7);
+  ck_assert(!is_pair(pair_second(pair_second(rest))));
+  delete_object(symbols);
+
+  objectptr all = input_port_read_all(port);
+  ck_assert_uint_eq(string_size(all), 0);
+  delete_object(all);
+
+  delete_object(port);
+  unlink(file_name);
+} END_TEST
+
+START_TEST(test_open_error) {
+  objectptr port = make_input_port("/nonexistent/file");
+  ck_assert(is_error(port));
+  delete_object(port);
+} END_TEST
+
+Suite *input_port_suite(void) {
+  Suite *s = suite_create("Input Port");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_read_line);
+  tcase_add_test(tc_core, test_read_symbols);
+  tcase_add_test(tc_core, test_open_error);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+
+int main(void) {
+  Suite *s = input_port_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -54,6 +54,38 @@ START_TEST(test_integer_op_add) {
   delete_object(sum2);
 } END_TEST
 
+START_TEST(test_integer_op_add_reuse) {
+  objectptr self = move(make_integer(1));
+  objectptr int2 = make_integer(2);
+  objectptr real2 = make_real(2.0);
+
+  /* A temporary integer without other references stores the sum */
+  objectptr sum1 = integer_op_add(self, int2);
+  ck_assert(sum1 == self);
+  ck_assert_int_eq(int_value(sum1), 3);
+  delete_object(sum1);
+
+  /* A result of another type is a new object */
+  objectptr sum2 = integer_op_add(self, real2);
+  ck_assert(sum2 != self);
+  ck_assert_int_eq(int_value(self), 3);
+
+  /* A shared integer is not changed */
+  objectptr other = clone_object(settle(self));
+  move(self);
+  objectptr sum3 = integer_op_add(self, int2);
+  ck_assert(sum3 != self);
+  ck_assert_int_eq(int_value(self), 3);
+  ck_assert_int_eq(int_value(sum3), 5);
+
+  delete_object(other);
+  delete_object(self);
+  delete_object(int2);
+  delete_object(real2);
+  delete_object(sum2);
+  delete_object(sum3);
+} END_TEST
+
 START_TEST(test_integer_op_mul) {
   objectptr self = make_integer(3);
   objectptr int4 = make_integer(4);
@@ -159,6 +191,7 @@ Suite *integer_suite(void) {
   TCase *tc_core = tcase_create("Core");
   tcase_add_test(tc_core, test_integer_common);
   tcase_add_test(tc_core, test_integer_op_add);
+  tcase_add_test(tc_core, test_integer_op_add_reuse);
   tcase_add_test(tc_core, test_integer_op_mul);
   tcase_add_test(tc_core, test_integer_op_sub);
   tcase_add_test(tc_core, test_integer_op_div);
@@ -0,0 +1,113 @@
+#include <check.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "../../src/types/mapped_tape.h"
+#include "../../src/types/integer.h"
+#include "../../src/types/null.h"
+#include "../../src/types/pair.h"
+#include "../../src/types/string.h"
+#include "../../src/types/void.h"
+#include "../../src/types/error.h"
+
+static char file_name[64];
+
+static void write_file(const char *contents) {
+  strcpy(file_name, "/tmp/check_mapped_tape_XXXXXX");
+  int fd = mkstemp(file_name);
+  ck_assert(fd >= 0);
+  size_t length = strlen(contents);
+  ck_assert(write(fd, contents, length) == (ssize_t)length);
+  close(fd);
+}
+
+START_TEST(test_mapped_symbols) {
+  write_file(" 0 1\n abc ");
+  objectptr tape = make_mapped_tape(file_name, TAPE_SYMBOLS);
+  ck_assert(is_mapped_tape(tape));
+
+  /* Only the left end and the blank are created at first */
+  listptr cells = new_list();
+  mapped_tape_get_cells(tape, cells);
+  ck_assert_uint_eq(list_size(cells), 2);
+  ck_assert(is_void(list_get(cells, 0)));
+  ck_assert(is_null(list_get(cells, 1)));
+
+  size_t position = mapped_tape_position(tape);
+  objectptr symbol = mapped_tape_next_symbol(tape, &position);
+  ck_assert_int_eq(int_value(symbol), 0);
+  list_add(cells, symbol);
+  symbol = mapped_tape_next_symbol(tape, &position);
+  ck_assert_int_eq(int_value(symbol), 1);
+  delete_object(symbol);
+
+  /* The written cell replaces the symbol of the file */
+  list_add(cells, make_integer(5));
+  objectptr changed = mapped_tape_with_cells(tape, cells, position);
+  delete_object(tape);
+
+  objectptr list = mapped_tape_to_list(changed);
+  objectptr rest = pair_second(pair_second(list));
+  ck_assert_int_eq(int_value(pair_first(rest)), 0);
+  rest = pair_second(rest);
+  ck_assert_int_eq(int_value(pair_first(rest)), 5);
+  rest = pair_second(rest);
+  ck_assert_str_eq(string_value(pair_first(rest)), "abc");
+  ck_assert(is_null(pair_second(rest)));
+
+  /* Blanks follow the end of the file */
+  symbol = mapped_tape_next_symbol(changed, &position);
+  ck_assert_str_eq(string_value(symbol), "abc");
+  delete_object(symbol);
+  symbol = mapped_tape_next_symbol(changed, &position);
+  ck_assert(is_null(symbol));
+  delete_object(symbol);
+
+  delete_object(list);
+  delete_object(changed);
+  unlink(file_name);
+} END_TEST
+
+START_TEST(test_mapped_bytes) {
+  write_file("a\n");
+  objectptr tape = make_mapped_tape(file_name, TAPE_BYTES);
+  size_t position = mapped_tape_position(tape);
+  objectptr symbol = mapped_tape_next_symbol(tape, &position);
+  ck_assert_int_eq(int_value(symbol), 'a');
+  delete_object(symbol);
+  symbol = mapped_tape_next_symbol(tape, &position);
+  ck_assert_int_eq(int_value(symbol), '\n');
+  delete_object(symbol);
+  symbol = mapped_tape_next_symbol(tape, &position);
+  ck_assert(is_null(symbol));
+  delete_object(symbol);
+
+  delete_object(tape);
+  unlink(file_name);
+
+  objectptr error = make_mapped_tape("/nonexistent/file", TAPE_BYTES);
+  ck_assert(is_error(error));
+  delete_object(error);
+} END_TEST
+
+Suite *mapped_tape_suite(void) {
+  Suite *s = suite_create("Mapped Tape");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_mapped_symbols);
+  tcase_add_test(tc_core, test_mapped_bytes);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+
+int main(void) {
+  Suite *s = mapped_tape_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,194 @@
+#include <check.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../../src/types/numeric_vector.h"
+#include "../../src/types/error.h"
+#include "../../src/types/integer.h"
+#include "../../src/types/null.h"
+#include "../../src/types/pair.h"
+#include "../../src/types/real.h"
+
+START_TEST(test_numeric_vector_common) {
+  objectptr reals = make_f64vector(3, 1.5);
+  objectptr integers = make_i64vector(3, 2);
+  ck_assert(is_f64vector(reals) && !is_i64vector(reals));
+  ck_assert(is_i64vector(integers) && is_numeric_vector(integers));
+  ck_assert_uint_eq(numeric_vector_length(reals), 3);
+
+  objectptr seven = make_integer(7);
+  objectptr result = numeric_vector_set(integers, 1, seven);
+  ck_assert(!is_error(result));
+  delete_object(result);
+  result = numeric_vector_set(integers, 3, seven);
+  ck_assert(is_error(result));
+  delete_object(result);
+  objectptr half = make_real(0.5);
+  result = numeric_vector_set(integers, 0, half);
+  ck_assert(is_error(result));
+  delete_object(result);
+
+  objectptr element = numeric_vector_ref(integers, 1);
+  ck_assert_int_eq(int_value(element), 7);
+  delete_object(element);
+
+  char *str = numeric_vector_tostring(integers);
+  ck_assert_str_eq(str, "(i64vector 2 7 2)");
+  free(str);
+  str = numeric_vector_tostring(reals);
+  ck_assert_str_eq(str, "(f64vector 1.500000 1.500000 1.500000)");
+  free(str);
+
+  /* Vectors of different kinds are not equal */
+  objectptr other = make_i64vector(3, 2);
+  ck_assert(!object_equals(integers, other));
+  result = numeric_vector_set(other, 1, seven);
+  delete_object(result);
+  ck_assert(object_equals(integers, other));
+  objectptr twos = make_f64vector(3, 2);
+  objectptr integer_twos = make_i64vector(3, 2);
+  ck_assert(!object_equals(twos, integer_twos));
+
+  delete_object(reals);
+  delete_object(integers);
+  delete_object(seven);
+  delete_object(half);
+  delete_object(other);
+  delete_object(twos);
+  delete_object(integer_twos);
+} END_TEST
+
+START_TEST(test_numeric_vector_lists) {
+  objectptr list = make_null();
+  for (int i = 5; i > 0; --i) {
+    objectptr element = make_integer(i);
+    assign_object(&list, make_pair(element, list));
+    delete_object(element);
+  }
+
+  objectptr integers = list_to_i64vector(list);
+  objectptr reals = list_to_f64vector(list);
+  ck_assert(is_i64vector(integers));
+  ck_assert(is_f64vector(reals));
+  ck_assert_uint_eq(numeric_vector_length(reals), 5);
+  ck_assert(f64vector_data(reals)[4] == 5.0);
+
+  objectptr converted = numeric_vector_to_list(integers);
+  ck_assert(object_equals(converted, list));
+
+  /* Reals cannot be stored in an i64vector */
+  objectptr half = make_real(0.5);
+  objectptr mixed = make_pair(half, list);
+  objectptr error = list_to_i64vector(mixed);
+  ck_assert(is_error(error));
+  delete_object(error);
+  objectptr mixed_reals = list_to_f64vector(mixed);
+  ck_assert_uint_eq(numeric_vector_length(mixed_reals), 6);
+
+  delete_object(list);
+  delete_object(integers);
+  delete_object(reals);
+  delete_object(converted);
+  delete_object(half);
+  delete_object(mixed);
+  delete_object(mixed_reals);
+} END_TEST
+
+START_TEST(test_numeric_vector_operations) {
+  objectptr integers = make_i64vector(5, 3);
+  objectptr reals = make_f64vector(5, 0.5);
+  objectptr two = make_integer(2);
+
+  /* Integers stay integers unless they are divided */
+  objectptr product = numeric_vector_op(KERNEL_MUL, two, integers);
+  ck_assert(is_i64vector(product));
+  ck_assert_int_eq(i64vector_data(product)[4], 6);
+  objectptr quotient = numeric_vector_op(KERNEL_DIV, integers, two);
+  ck_assert(is_f64vector(quotient));
+  ck_assert(f64vector_data(quotient)[0] == 1.5);
+  objectptr sum = numeric_vector_op(KERNEL_ADD, integers, reals);
+  ck_assert(is_f64vector(sum));
+  ck_assert(f64vector_data(sum)[2] == 3.5);
+
+  objectptr shorter = make_f64vector(4, 1);
+  objectptr error = numeric_vector_op(KERNEL_SUB, reals, shorter);
+  ck_assert(is_error(error));
+  delete_object(error);
+  error = numeric_vector_dot(reals, shorter);
+  ck_assert(is_error(error));
+  delete_object(error);
+
+  objectptr total = numeric_vector_sum(integers);
+  ck_assert_int_eq(int_value(total), 15);
+  objectptr dot = numeric_vector_dot(integers, reals);
+  ck_assert(real_value(dot) == 7.5);
+  objectptr prefix = numeric_vector_prefix_sum(integers);
+  ck_assert_int_eq(i64vector_data(prefix)[4], 15);
+  objectptr roots = numeric_vector_sqrt(prefix);
+  ck_assert(f64vector_data(roots)[2] == 3.0);
+
+  objectptr empty = make_i64vector(0, 0);
+  error = numeric_vector_min(empty);
+  ck_assert(is_error(error));
+  delete_object(error);
+  objectptr max = numeric_vector_max(prefix);
+  ck_assert_int_eq(int_value(max), 15);
+
+  delete_object(integers);
+  delete_object(reals);
+  delete_object(two);
+  delete_object(product);
+  delete_object(quotient);
+  delete_object(sum);
+  delete_object(shorter);
+  delete_object(total);
+  delete_object(dot);
+  delete_object(prefix);
+  delete_object(roots);
+  delete_object(empty);
+  delete_object(max);
+} END_TEST
+
+START_TEST(test_numeric_vector_reuse) {
+  /* A temporary operand is used for the result */
+  objectptr reals = move(make_f64vector(4, 4));
+  objectptr roots = numeric_vector_sqrt(reals);
+  ck_assert(roots == reals);
+  ck_assert(f64vector_data(roots)[3] == 2.0);
+  delete_object(reals);
+
+  /* A variable is not changed */
+  objectptr integers = make_i64vector(4, 4);
+  objectptr one = make_integer(1);
+  objectptr sum = numeric_vector_op(KERNEL_ADD, integers, one);
+  ck_assert(sum != integers);
+  ck_assert_int_eq(i64vector_data(integers)[0], 4);
+  ck_assert_int_eq(i64vector_data(sum)[0], 5);
+
+  delete_object(roots);
+  delete_object(integers);
+  delete_object(one);
+  delete_object(sum);
+} END_TEST
+
+Suite *numeric_vector_suite(void) {
+  Suite *s = suite_create("Numeric Vector");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_numeric_vector_common);
+  tcase_add_test(tc_core, test_numeric_vector_lists);
+  tcase_add_test(tc_core, test_numeric_vector_operations);
+  tcase_add_test(tc_core, test_numeric_vector_reuse);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+
+int main(void) {
+  Suite *s = numeric_vector_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
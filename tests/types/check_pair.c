@@ -2,9 +2,12 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "../../src/types/pair.h"
 #include "../../src/types/integer.h"
 #include "../../src/types/real.h"
+#include "../../src/types/null.h"
+#include "../../src/types/error.h"
 
 START_TEST(test_pair_common) {
   objectptr integer_obj = make_integer(1);
@@ -45,11 +48,146 @@ START_TEST(test_list_conversions) {
   }
 } END_TEST
 
+#define LONG_LIST_SIZE 1000000
+
+static objectptr make_long_list(void) {
+  objectptr list = make_null();
+  for (int i = 0; i < LONG_LIST_SIZE; i++) {
+    objectptr element = make_integer(i);
+    objectptr next = make_pair(element, list);
+    delete_object(element);
+    delete_object(list);
+    list = next;
+  }
+  return list;
+}
+
+START_TEST(test_delete_long_list) {
+  objectptr list = make_long_list();
+  objectptr shared = pair_second(pair_second(list));
+  objectptr rest = clone_object(shared);
+
+  /* The pairs after a shared pair are not freed */
+  delete_object(list);
+  ck_assert(is_pair(rest));
+  ck_assert_int_eq(int_value(pair_first(rest)), LONG_LIST_SIZE - 3);
+  delete_object(rest);
+} END_TEST
+
+START_TEST(test_deferred_free) {
+  set_deferred_free(true);
+  objectptr list = make_long_list();
+  delete_object(list);
+  ck_assert_int_eq(deferred_object_count(), 1);
+
+  /* Each allocation frees two pairs and queues the rest of the list */
+  objectptr element = make_integer(0);
+  ck_assert_int_eq(deferred_object_count(), 1);
+
+  delete_object(element);
+  set_deferred_free(false);
+  ck_assert_int_eq(deferred_object_count(), 0);
+} END_TEST
+
+START_TEST(test_long_list_equals) {
+  objectptr list = make_long_list();
+  objectptr other = make_long_list();
+  ck_assert(pair_equals(list, other));
+
+  size_t hash, other_hash;
+  ck_assert(pair_hash(list, &hash));
+  ck_assert(pair_hash(other, &other_hash));
+  ck_assert(hash == other_hash);
+
+  /* Lists that differ only in their last element */
+  objectptr element = make_integer(-1);
+  objectptr longer = make_pair(element, list);
+  objectptr different = make_pair(element, other);
+  delete_object(element);
+  element = make_real(0.5);
+  objectptr changed = make_pair(element, different);
+  delete_object(element);
+  ck_assert(!pair_equals(changed, longer));
+  ck_assert(!pair_equals(longer, list));
+
+  /* Equal numbers of different types have equal hashes */
+  objectptr integer_obj = make_integer(1);
+  objectptr real_obj = make_real(1.0);
+  objectptr integer_pair = make_pair(integer_obj, list);
+  objectptr real_pair = make_pair(real_obj, other);
+  ck_assert(pair_equals(integer_pair, real_pair));
+
+  delete_object(integer_obj);
+  delete_object(real_obj);
+  delete_object(integer_pair);
+  delete_object(real_pair);
+  delete_object(changed);
+  delete_object(different);
+  delete_object(longer);
+  delete_object(list);
+  delete_object(other);
+} END_TEST
+
+START_TEST(test_unhashable_equals) {
+  objectptr error_obj = make_error("error");
+  objectptr null_obj = make_null();
+  objectptr pair_obj = make_pair(error_obj, null_obj);
+  objectptr other_obj = make_pair(error_obj, null_obj);
+
+  size_t hash;
+  ck_assert(!pair_hash(pair_obj, &hash));
+  ck_assert(pair_equals(pair_obj, other_obj));
+
+  delete_object(error_obj);
+  delete_object(null_obj);
+  delete_object(pair_obj);
+  delete_object(other_obj);
+} END_TEST
+
+START_TEST(test_pair_tostring) {
+  objectptr integer_obj = make_integer(1);
+  objectptr real_obj = make_real(2.5);
+  objectptr inner = make_pair(integer_obj, real_obj);
+  objectptr outer = make_pair(inner, integer_obj);
+
+  char *str = pair_tostring(outer);
+  ck_assert_str_eq(str, "(cons (cons 1 2.500000) 1)");
+  free(str);
+
+  delete_object(integer_obj);
+  delete_object(real_obj);
+  delete_object(inner);
+  delete_object(outer);
+} END_TEST
+
+START_TEST(test_print_long_list) {
+  objectptr list = make_long_list();
+  char *str = pair_tostring(list);
+
+  const char *prefix = "(cons 999999 (cons 999998 ";
+  ck_assert(strncmp(str, prefix, strlen(prefix)) == 0);
+
+  /* The list ends with null and the closing parentheses of all pairs */
+  size_t length = strlen(str);
+  ck_assert(length > LONG_LIST_SIZE);
+  ck_assert(strncmp(str + length - LONG_LIST_SIZE - 6, "0 null)", 7) == 0);
+  ck_assert(str[length - 1] == ')');
+
+  free(str);
+  delete_object(list);
+} END_TEST
+
 Suite *pair_suite(void) {
   Suite *s = suite_create("Pair");
   TCase *tc_core = tcase_create("Core");
   tcase_add_test(tc_core, test_pair_common);
   tcase_add_test(tc_core, test_list_conversions);
+  tcase_add_test(tc_core, test_delete_long_list);
+  tcase_add_test(tc_core, test_deferred_free);
+  tcase_add_test(tc_core, test_long_list_equals);
+  tcase_add_test(tc_core, test_unhashable_equals);
+  tcase_add_test(tc_core, test_pair_tostring);
+  tcase_add_test(tc_core, test_print_long_list);
   suite_add_tcase(s, tc_core);
   return s;
 }
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <locale.h>
 #include "../../src/types/string.h"
+#include "../../src/types/integer.h"
+#include "../../src/types/error.h"
 
 #define STRING "test string"
 #define STRING_STR "\"" STRING "\""
@@ -31,10 +33,108 @@ START_TEST(test_symbol_common) {
   free(str2);
 } END_TEST
 
+START_TEST(test_string_concat) {
+  objectptr str_obj = make_string("ab");
+  objectptr int_obj = make_integer(12);
+
+  objectptr result = string_concat(str_obj, int_obj);
+  ck_assert(result != str_obj);
+  ck_assert_str_eq(string_value(result), "ab12");
+  ck_assert_str_eq(string_value(str_obj), "ab");
+
+  /* The second operand is appended to a reusable first operand */
+  move(result);
+  objectptr appended = string_concat(result, str_obj);
+  ck_assert(appended == result);
+  ck_assert_str_eq(string_value(appended), "ab12ab");
+  delete_object(appended);
+
+  objectptr converted = string_concat(int_obj, str_obj);
+  ck_assert_str_eq(string_value(converted), "12ab");
+
+  delete_object(str_obj);
+  delete_object(int_obj);
+  delete_object(result);
+  delete_object(converted);
+} END_TEST
+
+#define ROPE_PARTS 100000
+
+START_TEST(test_string_rope) {
+  /* Each part is prepended to a long string, which is not copied */
+  objectptr part = make_string("0123456789");
+  objectptr result = make_string("");
+  for (int i = 0; i < ROPE_PARTS; i++) {
+    assign_object(&result, string_concat(part, result));
+  }
+  ck_assert_int_eq(string_size(result), 10 * ROPE_PARTS);
+
+  objectptr copy = make_string(string_value(result));
+  ck_assert(string_equals(copy, result));
+  ck_assert_int_eq(string_value(result)[10 * ROPE_PARTS - 1], '9');
+
+  /* A shared part of a rope is not changed when the rope is flattened */
+  objectptr prefix = string_concat(copy, part);
+  objectptr rope = string_concat(prefix, copy);
+  ck_assert_int_eq(string_size(rope), 20 * ROPE_PARTS + 10);
+  ck_assert_int_eq(string_value(rope)[10 * ROPE_PARTS], '0');
+  ck_assert_int_eq(string_size(prefix), 10 * ROPE_PARTS + 10);
+
+  delete_object(rope);
+  delete_object(prefix);
+  delete_object(copy);
+  delete_object(result);
+
+  /* Deleting a long rope does not recurse for each part */
+  result = make_string("");
+  for (int i = 0; i < ROPE_PARTS; i++) {
+    assign_object(&result, string_concat(part, result));
+  }
+  delete_object(result);
+  delete_object(part);
+} END_TEST
+
+START_TEST(test_string_slice) {
+  objectptr str_obj = make_string("string value");
+
+  objectptr slice = string_substring(str_obj, 2, 12);
+  ck_assert_int_eq(string_size(slice), 10);
+  ck_assert(string_chars(slice) == string_chars(str_obj) + 2);
+
+  /* A slice of a slice shares the characters of the original string */
+  objectptr inner = string_substring(slice, 0, 3);
+  ck_assert(string_chars(inner) == string_chars(str_obj) + 2);
+  objectptr expected = make_string("rin");
+  ck_assert(string_equals(inner, expected));
+  char *quoted = string_tostring(inner);
+  ck_assert_str_eq(quoted, "\"rin\"");
+  free(quoted);
+
+  objectptr character = string_charat(slice, 9);
+  ck_assert_str_eq(string_value(character), "e");
+
+  objectptr error = string_substring(str_obj, 3, 13);
+  ck_assert(is_error(error));
+
+  /* The original string outlives its slices */
+  delete_object(str_obj);
+  ck_assert_str_eq(string_value(slice), "ring value");
+  ck_assert_str_eq(string_value(inner), "rin");
+
+  delete_object(slice);
+  delete_object(inner);
+  delete_object(expected);
+  delete_object(character);
+  delete_object(error);
+} END_TEST
+
 Suite *symbol_suite(void) {
   Suite *s = suite_create("Symbol");
   TCase *tc_core = tcase_create("Core");
   tcase_add_test(tc_core, test_symbol_common);
+  tcase_add_test(tc_core, test_string_concat);
+  tcase_add_test(tc_core, test_string_rope);
+  tcase_add_test(tc_core, test_string_slice);
   suite_add_tcase(s, tc_core);
   return s;
 }
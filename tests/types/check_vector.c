@@ -0,0 +1,156 @@
+#include <check.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../../src/types/vector.h"
+#include "../../src/types/collector.h"
+#include "../../src/types/error.h"
+#include "../../src/types/integer.h"
+#include "../../src/types/null.h"
+#include "../../src/types/pair.h"
+
+#define VECTOR_TEST_SIZE 1000
+
+START_TEST(test_vector_common) {
+  objectptr zero = make_integer(0);
+  objectptr vec = make_vector(3, zero);
+  ck_assert(is_vector(vec));
+  ck_assert_uint_eq(vector_length(vec), 3);
+
+  /* Pushing grows the vector past its initial capacity */
+  for (int i = 0; i < VECTOR_TEST_SIZE; ++i) {
+    objectptr element = make_integer(i);
+    vector_push(vec, element);
+    delete_object(element);
+  }
+  ck_assert_uint_eq(vector_length(vec), VECTOR_TEST_SIZE + 3);
+  ck_assert_int_eq(int_value(vector_get(vec, VECTOR_TEST_SIZE + 2)),
+                   VECTOR_TEST_SIZE - 1);
+
+  objectptr one = make_integer(1);
+  objectptr result = vector_set(vec, 1, one);
+  ck_assert(!is_error(result));
+  delete_object(result);
+  ck_assert_int_eq(int_value(vector_get(vec, 1)), 1);
+  result = vector_set(vec, VECTOR_TEST_SIZE + 3, one);
+  ck_assert(is_error(result));
+  delete_object(result);
+
+  char *str = vector_tostring(vec);
+  ck_assert(strncmp(str, "(vector 0 1 0 0 1 2 ", 20) == 0);
+  free(str);
+
+  delete_object(zero);
+  delete_object(one);
+  delete_object(vec);
+} END_TEST
+
+START_TEST(test_vector_lists) {
+  objectptr one = make_integer(1);
+  objectptr null_obj = make_null();
+  objectptr list = make_pair(one, null_obj);
+  objectptr longer = make_pair(one, list);
+
+  objectptr vec = list_to_vector(longer);
+  ck_assert_uint_eq(vector_length(vec), 2);
+  objectptr converted = vector_to_list(vec);
+  ck_assert(pair_equals(converted, longer));
+
+  objectptr other = list_to_vector(converted);
+  ck_assert(vector_equals(vec, other));
+  objectptr shorter = list_to_vector(list);
+  ck_assert(!vector_equals(vec, shorter));
+
+  objectptr improper = make_pair(one, one);
+  objectptr error = list_to_vector(improper);
+  ck_assert(is_error(error));
+
+  delete_object(one);
+  delete_object(null_obj);
+  delete_object(list);
+  delete_object(longer);
+  delete_object(vec);
+  delete_object(converted);
+  delete_object(other);
+  delete_object(shorter);
+  delete_object(improper);
+  delete_object(error);
+} END_TEST
+
+START_TEST(test_vector_cycle) {
+  objectptr null_obj = make_null();
+  objectptr vec = make_vector(1, null_obj);
+  vector_push(vec, vec);
+  delete_object(vec);
+  delete_object(null_obj);
+
+  ck_assert_int_eq(collect_cycles(), 1);
+} END_TEST
+
+START_TEST(test_vector_print_cycle) {
+  objectptr one = make_integer(1);
+  objectptr vec = make_vector(1, one);
+  objectptr result = vector_set(vec, 0, vec);
+  delete_object(result);
+  vector_push(vec, one);
+
+  /* A vector that contains itself through a pair is also printed once */
+  objectptr pair = make_pair(vec, one);
+  vector_push(vec, pair);
+
+  char *str = vector_tostring(vec);
+  ck_assert_str_eq(str, "(vector ... 1 (cons ... 1))");
+  free(str);
+
+  delete_object(pair);
+  delete_object(vec);
+  delete_object(one);
+  ck_assert_int_eq(collect_cycles(), 2);
+} END_TEST
+
+START_TEST(test_vector_equals_cycle) {
+  objectptr one = make_integer(1);
+  objectptr two = make_integer(2);
+  objectptr first = make_vector(2, one);
+  objectptr second = make_vector(2, one);
+  objectptr third = make_vector(2, one);
+  delete_object(vector_set(first, 0, first));
+  delete_object(vector_set(second, 0, second));
+  delete_object(vector_set(third, 0, third));
+  delete_object(vector_set(third, 1, two));
+
+  ck_assert(vector_equals(first, second));
+  ck_assert(!vector_equals(first, third));
+  ck_assert(!vector_equals(third, second));
+
+  delete_object(first);
+  delete_object(second);
+  delete_object(third);
+  delete_object(one);
+  delete_object(two);
+  ck_assert_int_eq(collect_cycles(), 3);
+} END_TEST
+
+Suite *vector_suite(void) {
+  Suite *s = suite_create("Vector");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_vector_common);
+  tcase_add_test(tc_core, test_vector_lists);
+  tcase_add_test(tc_core, test_vector_cycle);
+  tcase_add_test(tc_core, test_vector_print_cycle);
+  tcase_add_test(tc_core, test_vector_equals_cycle);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+
+int main(void) {
+  Suite *s = vector_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,135 @@
+#include <check.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../../src/utils/kernels.h"
+
+/* Lengths up to MAX_KERNEL_LENGTH cover both the vector loops and the
+ * elements that are left after them */
+#define MAX_KERNEL_LENGTH 9
+
+static double doubles[MAX_KERNEL_LENGTH] = {1, -2, 3, 4.5, -5, 6, 7, -8, 9};
+static double others[MAX_KERNEL_LENGTH] = {2, 4, -8, 1, 0.5, 3, -1, 2, 5};
+static long longs[MAX_KERNEL_LENGTH] = {1, -2, 3, 4, -5, 6, 7, -8, 9};
+static long other_longs[MAX_KERNEL_LENGTH] = {2, 4, -8, 1, 5, 3, -1, 2, 5};
+
+START_TEST(test_f64_kernels) {
+  double out[MAX_KERNEL_LENGTH];
+  for (size_t n = 0; n <= MAX_KERNEL_LENGTH; ++n) {
+    f64_elementwise(KERNEL_SUB, out, doubles, others, n);
+    for (size_t i = 0; i < n; ++i) {
+      ck_assert(out[i] == doubles[i] - others[i]);
+    }
+
+    f64_broadcast(KERNEL_DIV, out, doubles, 2, true, n);
+    for (size_t i = 0; i < n; ++i) {
+      ck_assert(out[i] == 2 / doubles[i]);
+    }
+
+    f64_broadcast(KERNEL_MUL, out, doubles, 3, false, n);
+    for (size_t i = 0; i < n; ++i) {
+      ck_assert(out[i] == doubles[i] * 3);
+    }
+
+    /* The elements are small integers, so the sums are exact in any
+     * order */
+    double sum = 0;
+    double dot = 0;
+    f64_prefix_sum(out, doubles, n);
+    for (size_t i = 0; i < n; ++i) {
+      sum += doubles[i];
+      dot += doubles[i] * others[i];
+      ck_assert(out[i] == sum);
+    }
+    ck_assert(f64_sum(doubles, n) == sum);
+    ck_assert(f64_dot(doubles, others, n) == dot);
+
+    if (n > 0) {
+      double min = doubles[0];
+      double max = doubles[0];
+      for (size_t i = 1; i < n; ++i) {
+        min = doubles[i] < min ? doubles[i] : min;
+        max = doubles[i] > max ? doubles[i] : max;
+      }
+      ck_assert(f64_min(doubles, n) == min);
+      ck_assert(f64_max(doubles, n) == max);
+    }
+  }
+} END_TEST
+
+/* NaN is the result wherever it is, in the first element, inside the
+ * vector loop or in the element left after it */
+START_TEST(test_f64_min_max_nan) {
+  for (size_t n = 1; n <= MAX_KERNEL_LENGTH; ++n) {
+    for (size_t position = 0; position < n; ++position) {
+      double a[MAX_KERNEL_LENGTH];
+      for (size_t i = 0; i < n; ++i) {
+        a[i] = i == position ? NAN : doubles[i];
+      }
+      ck_assert(isnan(f64_min(a, n)));
+      ck_assert(isnan(f64_max(a, n)));
+    }
+  }
+
+  double first[] = {NAN, 1, 0.5};
+  double middle[] = {1, NAN, 0.5};
+  ck_assert(isnan(f64_min(first, 3)));
+  ck_assert(isnan(f64_min(middle, 3)));
+  ck_assert(isnan(f64_max(first, 3)));
+  ck_assert(isnan(f64_max(middle, 3)));
+} END_TEST
+
+START_TEST(test_i64_kernels) {
+  long out[MAX_KERNEL_LENGTH];
+  for (size_t n = 0; n <= MAX_KERNEL_LENGTH; ++n) {
+    i64_elementwise(KERNEL_ADD, out, longs, other_longs, n);
+    for (size_t i = 0; i < n; ++i) {
+      ck_assert_int_eq(out[i], longs[i] + other_longs[i]);
+    }
+
+    i64_broadcast(KERNEL_SUB, out, longs, 10, true, n);
+    for (size_t i = 0; i < n; ++i) {
+      ck_assert_int_eq(out[i], 10 - longs[i]);
+    }
+
+    long sum = 0;
+    long dot = 0;
+    i64_prefix_sum(out, longs, n);
+    for (size_t i = 0; i < n; ++i) {
+      sum += longs[i];
+      dot += longs[i] * other_longs[i];
+      ck_assert_int_eq(out[i], sum);
+    }
+    ck_assert_int_eq(i64_sum(longs, n), sum);
+    ck_assert_int_eq(i64_dot(longs, other_longs, n), dot);
+  }
+
+  /* The result is the same array as the operand */
+  long in_place[3] = {1, 2, 3};
+  i64_prefix_sum(in_place, in_place, 3);
+  ck_assert_int_eq(in_place[2], 6);
+  ck_assert_int_eq(i64_min(longs, MAX_KERNEL_LENGTH), -8);
+  ck_assert_int_eq(i64_max(longs, MAX_KERNEL_LENGTH), 9);
+} END_TEST
+
+Suite *kernels_suite(void) {
+  Suite *s = suite_create("Kernels");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_f64_kernels);
+  tcase_add_test(tc_core, test_f64_min_max_nan);
+  tcase_add_test(tc_core, test_i64_kernels);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+
+int main(void) {
+  Suite *s = kernels_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
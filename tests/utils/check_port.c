@@ -0,0 +1,79 @@
+#include <check.h>
+#include <stdlib.h>
+#include "../../src/utils/port.h"
+
+static char contents[256];
+
+/* Returns what has been written to the file so far */
+static const char *file_contents(FILE *file) {
+  long position = ftell(file);
+  rewind(file);
+  size_t length = fread(contents, 1, sizeof(contents) - 1, file);
+  contents[length] = '\0';
+  fseek(file, position, SEEK_SET);
+  return contents;
+}
+
+START_TEST(test_port_when_full) {
+  FILE *file = tmpfile();
+  output_port_ptr port = new_output_port(file, 8, FLUSH_WHEN_FULL);
+
+  ck_assert(port_puts(port, "abc\n"));
+  ck_assert(port_putc(port, 'd'));
+  ck_assert_str_eq(file_contents(file), "");
+
+  /* The buffer is written out when the next write does not fit */
+  ck_assert(port_printf(port, "%d", 1234));
+  ck_assert_str_eq(file_contents(file), "abc\nd");
+
+  /* A write larger than the buffer goes to the file directly */
+  ck_assert(port_puts(port, "0123456789"));
+  ck_assert_str_eq(file_contents(file), "abc\nd12340123456789");
+
+  ck_assert(port_printf(port, "%s", "formatted"));
+  ck_assert_str_eq(file_contents(file), "abc\nd12340123456789formatted");
+
+  delete_output_port(port);
+  fclose(file);
+}
+END_TEST
+
+START_TEST(test_port_on_newline) {
+  FILE *file = tmpfile();
+  output_port_ptr port = new_output_port(file, 64, FLUSH_ON_NEWLINE);
+
+  ck_assert(port_puts(port, "abc"));
+  ck_assert_str_eq(file_contents(file), "");
+  ck_assert(port_putc(port, '\n'));
+  ck_assert_str_eq(file_contents(file), "abc\n");
+  ck_assert(port_printf(port, "%d\n%d", 1, 2));
+  ck_assert_str_eq(file_contents(file), "abc\n1\n2");
+
+  ck_assert(port_puts(port, "3"));
+  ck_assert(port_flush(port));
+  ck_assert_str_eq(file_contents(file), "abc\n1\n23");
+
+  delete_output_port(port);
+  fclose(file);
+}
+END_TEST
+
+Suite *port_suite(void) {
+  Suite *s = suite_create("Port");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_port_when_full);
+  tcase_add_test(tc_core, test_port_on_newline);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+
+int main(void) {
+  Suite *s = port_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,60 @@
+#include <check.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../src/utils/slab.h"
+
+START_TEST(test_slab_alloc) {
+  char *blocks[100];
+  for (size_t i = 0; i < 100; ++i) {
+    blocks[i] = slab_alloc(40);
+    ck_assert_uint_eq((uintptr_t)blocks[i] % SLAB_GRANULARITY, 0);
+    memset(blocks[i], (int)i, 40);
+  }
+
+  for (size_t i = 0; i < 100; ++i) {
+    for (size_t j = 0; j < 40; ++j) {
+      ck_assert_int_eq(blocks[i][j], (char)i);
+    }
+    slab_free(blocks[i], 40);
+  }
+} END_TEST
+
+START_TEST(test_slab_reuse) {
+  void *first = slab_alloc(24);
+  slab_free(first, 24);
+
+  /* Sizes in the same class share freed blocks. AddressSanitizer builds
+   * allocate every block with malloc. */
+  void *second = slab_alloc(32);
+#ifndef __SANITIZE_ADDRESS__
+  ck_assert(first == second);
+#endif
+  slab_free(second, 32);
+} END_TEST
+
+START_TEST(test_slab_large) {
+  char *block = slab_alloc(SLAB_MAX_SIZE + 1);
+  memset(block, 1, SLAB_MAX_SIZE + 1);
+  slab_free(block, SLAB_MAX_SIZE + 1);
+} END_TEST
+
+Suite *slab_suite(void) {
+  Suite *s = suite_create("Slab");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_slab_alloc);
+  tcase_add_test(tc_core, test_slab_reuse);
+  tcase_add_test(tc_core, test_slab_large);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  Suite *s = slab_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
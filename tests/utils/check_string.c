@@ -1,6 +1,7 @@
 #include <check.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../../src/utils/string.h"
 
 #include <stdio.h>
@@ -39,6 +40,46 @@ START_TEST(test_format_double) {
 }
 END_TEST
 
+/* Finds a needle by comparing it at every position */
+static const char *naive_find(const char *chars, size_t length,
+                              const char *needle, size_t needle_length) {
+  for (size_t i = 0; i + needle_length <= length; ++i) {
+    if (memcmp(chars + i, needle, needle_length) == 0) {
+      return chars + i;
+    }
+  }
+  return NULL;
+}
+
+START_TEST(test_find_substring) {
+  const char *text = "abracadabra";
+  ck_assert(find_substring(text, 11, "cad", 3) == text + 4);
+  ck_assert(find_substring(text, 11, "abra", 4) == text);
+  ck_assert(find_substring(text, 11, "bra", 3) == text + 1);
+  ck_assert(find_substring(text, 11, "d", 1) == text + 6);
+  ck_assert(find_substring(text, 11, "", 0) == text);
+  ck_assert(find_substring(text, 11, "abrax", 5) == NULL);
+  ck_assert(find_substring(text + 1, 9, "abra", 4) == NULL);
+
+  /* Long texts over a small alphabet, so that there are many partial
+   * matches in each block */
+  char chars[1000];
+  srand(1);
+  for (int i = 0; i < 1000; ++i) {
+    chars[i] = "ab"[rand() % 2];
+  }
+  for (size_t needle_length = 1; needle_length < 12; ++needle_length) {
+    for (int start = 0; start < 200; start += 7) {
+      const char *needle = chars + 500 + start;
+      for (size_t length = 0; length < 1000; length += 37) {
+        ck_assert(find_substring(chars, length, needle, needle_length) ==
+                  naive_find(chars, length, needle, needle_length));
+      }
+    }
+  }
+}
+END_TEST
+
 Suite *format_suite(void) {
   Suite *s = suite_create("Format");
   TCase *tc_core = tcase_create("Core");
@@ -46,6 +87,7 @@ Suite *format_suite(void) {
   tcase_add_test(tc_core, test_format_integer);
   tcase_add_test(tc_core, test_format_long);
   tcase_add_test(tc_core, test_format_double);
+  tcase_add_test(tc_core, test_find_substring);
   suite_add_tcase(s, tc_core);
   return s;
 }